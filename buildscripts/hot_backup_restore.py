@@ -0,0 +1,107 @@
+#!/usr/bin/env python
+
+'''Reassembles a dbpath from the file sets copied by the hotBackup command.
+
+A backup set is a directory which mirrors the layout of the server's dbpath: every file named in
+the 'fileList' of a hotBackup 'begin' response is copied to its path relative to the 'dbpath'
+field of the same response. The first set must come from a full backup; every following set
+must come from an incremental backup ({hotBackup: 1, stage: 'begin', incremental: <backupId>})
+and holds only journal files.
+
+The sets are overlaid in order. Journal files which appear in several sets are taken from the
+latest one, since the last journal file of a backup keeps growing until the next backup copies
+it again. When mongod is started on the restored dbpath, WiredTiger recovery replays the
+journal on top of the checkpoint of the full backup.
+
+Usage:
+
+hot_backup_restore.py --dbpath <new dbpath> <full set> [<incremental set> ...]
+'''
+
+from __future__ import print_function
+
+import optparse
+import os
+import re
+import shutil
+import sys
+
+LOG_FILE_RE = re.compile(r'^WiredTigerLog\.(\d+)$')
+
+
+def journal_files(backup_set):
+    '''Returns a {log number: path} dict of the journal files in a backup set.'''
+    journal_dir = os.path.join(backup_set, 'journal')
+    files = {}
+    if not os.path.isdir(journal_dir):
+        return files
+    for name in os.listdir(journal_dir):
+        match = LOG_FILE_RE.match(name)
+        if match:
+            files[int(match.group(1))] = os.path.join(journal_dir, name)
+    return files
+
+
+def copy_tree(src, dst):
+    for root, dirs, files in os.walk(src):
+        target_dir = os.path.join(dst, os.path.relpath(root, src))
+        if not os.path.isdir(target_dir):
+            os.makedirs(target_dir)
+        for name in files:
+            shutil.copy2(os.path.join(root, name), os.path.join(target_dir, name))
+
+
+def restore(dbpath, full_set, incremental_sets):
+    if os.path.exists(dbpath) and os.listdir(dbpath):
+        raise ValueError('%s is not empty' % dbpath)
+    if not os.path.isfile(os.path.join(full_set, 'WiredTiger')):
+        raise ValueError('%s is not a full hot backup, it has no WiredTiger metadata' % full_set)
+
+    logs = journal_files(full_set)
+    if incremental_sets and not logs:
+        raise ValueError('%s has no journal files, was the server started with '
+                         '--wiredTigerIncrementalBackup?' % full_set)
+
+    # Check the whole chain before writing anything.
+    last_log = max(logs) if logs else 0
+    for backup_set in incremental_sets:
+        incremental_logs = journal_files(backup_set)
+        if not incremental_logs:
+            raise ValueError('%s has no journal files' % backup_set)
+        # Each incremental backup starts at or before the last journal file of the previous one.
+        if min(incremental_logs) > last_log:
+            raise ValueError('%s starts at journal file %d but the previous backup ends at %d, '
+                             'the chain is broken' % (backup_set, min(incremental_logs), last_log))
+        last_log = max(last_log, max(incremental_logs))
+
+    copy_tree(full_set, dbpath)
+
+    journal_dir = os.path.join(dbpath, 'journal')
+    for backup_set in incremental_sets:
+        for num, path in sorted(journal_files(backup_set).items()):
+            shutil.copy2(path, os.path.join(journal_dir, os.path.basename(path)))
+        print('applied %s' % backup_set)
+
+    print('restored %d backup set(s) into %s, journal ends at file %d' %
+          (1 + len(incremental_sets), dbpath, last_log))
+
+
+def main(argv):
+    parser = optparse.OptionParser(usage='%prog --dbpath <new dbpath> <full set> '
+                                         '[<incremental set> ...]')
+    parser.add_option('--dbpath', help='directory to restore into, must be empty')
+    (opts, args) = parser.parse_args(argv)
+
+    if not opts.dbpath or not args:
+        parser.error('a --dbpath and at least the full backup set are required')
+
+    try:
+        restore(opts.dbpath, args[0], args[1:])
+    except (ValueError, OSError, IOError) as e:
+        print('error: %s' % e, file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -1906,6 +1906,20 @@ var authCommandsLib = {
               }
           ]
         },
+        {
+          testname: "queryShapeStats",
+          command: {queryShapeStats: 1},
+          skipSharded: true,
+          testcases: [
+              {
+                runOnDb: adminDbName,
+                roles: roles_monitoring,
+                privileges: [{resource: {cluster: true}, actions: ["top"]}]
+              },
+              {runOnDb: firstDbName, roles: {}},
+              {runOnDb: secondDbName, roles: {}}
+          ]
+        },
         {
           testname: "renameCollection_sameDb",
           command:
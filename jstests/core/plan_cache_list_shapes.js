@@ -51,3 +51,16 @@ assert.eq({query: {a: 1, b: 1}, sort: {a: -1}, projection: {_id: 1, a: 1}},
 assert.eq(1, t.find({a: 1, b: 1}).itcount(), 'unexpected document count');
 shapes = getShapes();
 assert.eq(2, shapes.length, 'unexpected number of shapes in planCacheListQueryShapes result');
+
+// With 'stats', each shape reports how it has used the cache.
+assert.eq(1, t.find({a: 1, b: 1}).itcount(), 'unexpected document count');
+var res = t.runCommand('planCacheListQueryShapes', {stats: true});
+assert.commandWorked(res, 'planCacheListQueryShapes failed');
+var cached = res.shapes.filter(function(shape) {
+    return bsonWoCompare(shape.sort, {}) === 0;
+});
+assert.eq(1, cached.length, tojson(res));
+assert.gte(cached[0].stats.hits, 1, tojson(cached[0]));
+assert.gte(cached[0].stats.replans, 0, tojson(cached[0]));
+assert(cached[0].stats.lastUsed instanceof Date, tojson(cached[0]));
+assert.commandFailed(t.runCommand('planCacheListQueryShapes', {stats: 'yes'}));
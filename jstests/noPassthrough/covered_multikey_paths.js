@@ -0,0 +1,81 @@
+// Checks that a multikey index which tracks which of its paths contain arrays can cover projections
+// on its other fields, that explain reports the projection as covered, and that the information is
+// dropped when mongod is restarted with trackPathLevelMultikeyInfo=false.
+// @tags: [requires_wiredtiger, requires_persistence]
+
+(function() {
+    'use strict';
+
+    load('jstests/libs/analyze_plan.js');
+
+    var dbpath = MongoRunner.dataPath + 'covered_multikey_paths';
+    resetDbpath(dbpath);
+
+    var conn = MongoRunner.runMongod({dbpath: dbpath, storageEngine: 'wiredTiger'});
+    assert.neq(null, conn, 'mongod failed to start');
+    var testDB = conn.getDB('test');
+    var coll = testDB.covered_multikey_paths;
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 100; i++) {
+        bulk.insert({_id: i, tags: ['t' + (i % 5), 't' + (i % 7)], date: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({tags: 1, date: 1}));
+    assert.commandWorked(coll.createIndex(
+        {date: 1, tags: 1}, {name: 'partial', partialFilterExpression: {date: {$gte: 50}}}));
+
+    var query = {tags: 't3', date: {$gte: 10}};
+    var proj = {_id: 0, date: 1};
+
+    function checkCovered(coll, covered) {
+        var expected = coll.find(query, proj).hint({$natural: 1}).sort({date: 1}).toArray();
+        assert.gt(expected.length, 0);
+        assert.eq(expected,
+                  coll.find(query, proj).hint({tags: 1, date: 1}).sort({date: 1}).toArray());
+
+        var explain = coll.find(query, proj).hint({tags: 1, date: 1}).explain('executionStats');
+        var projStage = getPlanStage(explain.executionStats.executionStages, 'PROJECTION');
+        assert.neq(null, projStage, tojson(explain));
+        assert.eq(covered, !!projStage.covered, tojson(explain));
+        assert.eq(covered, isIndexOnly(explain.queryPlanner.winningPlan), tojson(explain));
+        if (covered) {
+            assert.eq(0, explain.executionStats.totalDocsExamined, tojson(explain));
+        }
+    }
+
+    // Only 'tags' contains arrays, so 'date' can be read from the index keys.
+    checkCovered(coll, true);
+
+    // The array field itself still needs the document.
+    var explain = coll.find(query, {_id: 0, tags: 1}).hint({tags: 1, date: 1}).explain();
+    assert(planHasStage(explain.queryPlanner.winningPlan, 'FETCH'), tojson(explain));
+
+    // A query on a partial index which is multikey in its second field can be covered as well.
+    explain = coll.find({date: {$gte: 60}}, proj).hint('partial').explain('executionStats');
+    assert(isIndexOnly(explain.queryPlanner.winningPlan), tojson(explain));
+    assert.eq(40, explain.executionStats.nReturned, tojson(explain));
+    assert.eq(0, explain.executionStats.totalDocsExamined, tojson(explain));
+
+    // Once a document makes 'date' an array the projection on it has to fetch.
+    var other = testDB.covered_multikey_paths_other;
+    assert.writeOK(other.insert({_id: 0, tags: ['t3', 't4'], date: 20}));
+    assert.commandWorked(other.createIndex({tags: 1, date: 1}));
+    checkCovered(other, true);
+    assert.writeOK(other.insert({_id: 1, tags: 't3', date: [20, 21]}));
+    checkCovered(other, false);
+
+    MongoRunner.stopMongod(conn);
+
+    // Path-level multikey information is removed when it is no longer tracked, so the index is
+    // treated as multikey in every field.
+    conn = MongoRunner.runMongod({
+        dbpath: dbpath,
+        noCleanData: true,
+        storageEngine: 'wiredTiger',
+        setParameter: 'trackPathLevelMultikeyInfo=false'
+    });
+    assert.neq(null, conn, 'mongod failed to start with trackPathLevelMultikeyInfo=false');
+    checkCovered(conn.getDB('test').covered_multikey_paths, false);
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,61 @@
+// Checks that a find with a blocking sort larger than internalQueryExecMaxBlockingSortBytes fails
+// unless allowDiskUse is set, in which case the sort spills to disk and reports the spills in
+// explain and the profiler.
+
+(function() {
+    'use strict';
+
+    var conn =
+        MongoRunner.runMongod({setParameter: 'internalQueryExecMaxBlockingSortBytes=102400'});
+    assert.neq(null, conn, 'mongod failed to start');
+    var testDB = conn.getDB('test');
+    var coll = testDB.find_sort_allow_disk_use;
+
+    var kNumDocs = 2000;
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < kNumDocs; i++) {
+        bulk.insert({_id: i, a: (i * 7919) % kNumDocs, pad: new Array(256).join('x')});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandFailed(testDB.runCommand({find: coll.getName(), sort: {a: 1}}));
+    assert.commandFailed(
+        testDB.runCommand({find: coll.getName(), sort: {a: 1}, allowDiskUse: 'yes'}));
+
+    function checkSorted(docs, expected) {
+        assert.eq(expected, docs.length);
+        for (var i = 0; i < docs.length; i++) {
+            assert.eq(i, docs[i].a, tojson(docs[i]));
+        }
+    }
+
+    checkSorted(coll.find().sort({a: 1}).allowDiskUse().toArray(), kNumDocs);
+    checkSorted(coll.find({}, {a: 1}).sort({a: 1}).allowDiskUse().batchSize(10).toArray(),
+                kNumDocs);
+
+    // A limit keeps the top-K behaviour: a small one fits in memory and does not spill.
+    var explain = coll.find().sort({a: 1}).limit(5).allowDiskUse().explain('executionStats');
+    assert.eq(5, explain.executionStats.nReturned, tojson(explain));
+    var sortStage = explain.executionStats.executionStages.inputStage;
+    assert.eq('SORT', sortStage.stage, tojson(explain));
+    assert(!sortStage.spills, tojson(sortStage));
+
+    explain = coll.find().sort({a: 1}).allowDiskUse().explain('executionStats');
+    assert.eq(kNumDocs, explain.executionStats.nReturned, tojson(explain));
+    sortStage = explain.executionStats.executionStages;
+    assert.eq('SORT', sortStage.stage, tojson(explain));
+    assert.gt(sortStage.spills, 0, tojson(sortStage));
+    assert.gt(sortStage.spilledBytes, 0, tojson(sortStage));
+
+    // The spills show up in the profiler, which gets the same fields as the slow query log.
+    assert.commandWorked(testDB.setProfilingLevel(2));
+    checkSorted(coll.find().sort({a: 1}).limit(1500).allowDiskUse().comment('spilled').toArray(),
+                1500);
+    assert.commandWorked(testDB.setProfilingLevel(0));
+    var profile = testDB.system.profile.findOne({'query.comment': 'spilled'});
+    assert.neq(null, profile, tojson(testDB.system.profile.find().toArray()));
+    assert.gt(profile.sortSpills, 0, tojson(profile));
+    assert.gt(profile.sortSpilledBytes, 0, tojson(profile));
+
+    MongoRunner.stopMongod(conn);
+}());
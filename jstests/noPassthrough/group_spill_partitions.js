@@ -0,0 +1,56 @@
+// Checks that a $group whose groups do not fit in memory spills them to disk by hash partition and
+// returns the same results as when it runs in memory.
+
+(function() {
+    'use strict';
+
+    var conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, 'mongod failed to start');
+    var testDB = conn.getDB('test');
+    var admin = conn.getDB('admin');
+    var coll = testDB.group_spill_partitions;
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 20000; i++) {
+        bulk.insert({_id: i, k: (i * 7919) % 5000, a: i % 13, s: 'x' + (i % 7)});
+    }
+    assert.writeOK(bulk.execute());
+
+    var pipelines = [
+        [{$group: {_id: '$k', n: {$sum: 1}, total: {$sum: '$a'}, first: {$first: '$a'}}}],
+        [{$group: {_id: {k: '$k', s: '$s'}, all: {$push: '$a'}, max: {$max: '$a'}}}],
+        [{$group: {_id: '$k'}}],
+    ];
+
+    function setKnobs(maxMemoryBytes, partitions) {
+        assert.commandWorked(admin.runCommand({
+            setParameter: 1,
+            internalDocumentSourceGroupMaxMemoryBytes: maxMemoryBytes,
+            internalDocumentSourceGroupSpillPartitions: partitions
+        }));
+    }
+
+    function run(pipeline, options) {
+        return coll.aggregate(pipeline.concat([{$sort: {_id: 1}}]), options).toArray();
+    }
+
+    setKnobs(100 * 1024 * 1024, 16);
+    var expected = pipelines.map(function(pipeline) {
+        return run(pipeline, {});
+    });
+
+    setKnobs(16 * 1024, 16);
+    pipelines.forEach(function(pipeline, i) {
+        assert.commandFailedWithCode(
+            testDB.runCommand({aggregate: coll.getName(), pipeline: pipeline}), 16945);
+        assert.eq(expected[i], run(pipeline, {allowDiskUse: true}), tojson(pipeline));
+    });
+
+    // With few partitions per level, the partitions are split several times.
+    setKnobs(4 * 1024, 2);
+    pipelines.forEach(function(pipeline, i) {
+        assert.eq(expected[i], run(pipeline, {allowDiskUse: true}), tojson(pipeline));
+    });
+
+    MongoRunner.stopMongod(conn);
+}());
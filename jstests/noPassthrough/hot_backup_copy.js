@@ -0,0 +1,71 @@
+// Checks that hotBackup with copyTo copies the backup on the server, reports its progress in
+// currentOp and writes a manifest whose checksums match the copied files.
+// @tags: [requires_wiredtiger, requires_persistence]
+
+(function() {
+    'use strict';
+
+    var baseDir = MongoRunner.dataPath + 'hot_backup_copy';
+    resetDbpath(baseDir);
+
+    var conn = MongoRunner.runMongod({storageEngine: 'wiredTiger'});
+    assert.neq(null, conn, 'mongod failed to start');
+    var admin = conn.getDB('admin');
+    var testDB = conn.getDB('test');
+
+    var bulk = testDB.coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 20000; i++) {
+        bulk.insert({_id: i, pad: new Array(512).join(String.fromCharCode(65 + i % 26))});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(testDB.coll.createIndex({pad: 1}));
+    var expected = assert.commandWorked(testDB.runCommand({dbHash: 1}));
+
+    assert.commandFailed(
+        admin.runCommand({hotBackup: 1, stage: 'begin', copyTo: baseDir + '/x', copyThreads: 0}));
+    assert.commandFailed(
+        admin.runCommand({hotBackup: 1, stage: 'begin', copyTo: 1}));
+
+    // A throttled copy shows up in currentOp while it runs.
+    var target = baseDir + '/backup';
+    var awaitCopy = startParallelShell(
+        'assert.commandWorked(db.getSiblingDB("admin").runCommand({hotBackup: 1, stage: "begin",' +
+            ' copyTo: "' + target + '", copyThreads: 2, maxBytesPerSec: 4 * 1024 * 1024}));',
+        conn.port);
+
+    assert.soon(function() {
+        return admin.currentOp().inprog.some(function(op) {
+            return op.msg && op.msg.indexOf('Hot Backup Copy') === 0 && op.progress &&
+                op.progress.total > 0;
+        });
+    }, 'hot backup copy did not show up in currentOp');
+    awaitCopy();
+
+    // The copy ended the backup, so a new one can begin.
+    var res = assert.commandWorked(admin.runCommand({hotBackup: 1, stage: 'begin'}));
+    assert.commandWorked(admin.runCommand({hotBackup: 1, stage: 'end', token: res.token}));
+
+    // A second copy into the same directory is refused.
+    assert.commandFailed(admin.runCommand({hotBackup: 1, stage: 'begin', copyTo: target}));
+
+    // The manifest is MongoDB extended JSON, so 64-bit sizes are {$numberLong: "<n>"}.
+    function toNumber(value) {
+        return typeof value === 'object' ? Number(value.$numberLong) : value;
+    }
+    var manifest = JSON.parse(cat(target + '/backup_manifest.json'));
+    assert.gt(manifest.files.length, 0, tojson(manifest));
+    var total = 0;
+    manifest.files.forEach(function(entry) {
+        assert.eq(entry.md5, md5sumFile(target + '/' + entry.file), tojson(entry));
+        total += toNumber(entry.size);
+    });
+    assert.eq(total, toNumber(manifest.totalBytes), tojson(manifest));
+
+    MongoRunner.stopMongod(conn);
+
+    conn = MongoRunner.runMongod({dbpath: target, noCleanData: true});
+    assert.neq(null, conn, 'mongod failed to start on the copied backup');
+    var restored = assert.commandWorked(conn.getDB('test').runCommand({dbHash: 1}));
+    assert.eq(expected.collections.coll, restored.collections.coll, tojson(restored));
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,98 @@
+// Takes a full hotBackup followed by incremental ones, reassembles them with
+// buildscripts/hot_backup_restore.py and checks that the restored node has the same data.
+// @tags: [requires_wiredtiger, requires_persistence]
+
+(function() {
+    'use strict';
+
+    var baseDir = MongoRunner.dataPath + 'hot_backup_incremental';
+    resetDbpath(baseDir);
+
+    var conn = MongoRunner.runMongod(
+        {storageEngine: 'wiredTiger', wiredTigerIncrementalBackup: '', syncdelay: 1});
+    assert.neq(null, conn, 'mongod failed to start with --wiredTigerIncrementalBackup');
+    var admin = conn.getDB('admin');
+    var testDB = conn.getDB('test');
+
+    // Copies every file of a 'begin' response into 'dir', keeping its path relative to the dbpath.
+    function takeBackup(dir, incrementalFrom) {
+        var cmd = {hotBackup: 1, stage: 'begin'};
+        if (incrementalFrom) {
+            cmd.incremental = incrementalFrom;
+        }
+        var res = assert.commandWorked(admin.runCommand(cmd));
+        assert.eq(!!incrementalFrom, res.incremental, tojson(res));
+        assert(res.backupId, tojson(res));
+
+        // Writes are not blocked while the backup cursor is open. Once journaled they are part
+        // of the journal files copied below.
+        assert.writeOK(testDB.during.insert({x: 1}, {writeConcern: {j: true}}));
+
+        mkdir(dir);
+        mkdir(dir + '/journal');
+        res.fileList.forEach(function(file) {
+            assert.eq(0, file.indexOf(res.dbpath + '/'), file);
+            var relative = file.substr(res.dbpath.length + 1);
+            if (incrementalFrom) {
+                assert.eq(0, relative.indexOf('journal/'), 'incremental backup copied ' + file);
+            }
+            copyFile(file, dir + '/' + relative);
+        });
+
+        assert.commandWorked(admin.runCommand({hotBackup: 1, stage: 'end', token: res.token}));
+        return res.backupId;
+    }
+
+    function writeSome(round) {
+        var bulk = testDB.coll.initializeUnorderedBulkOp();
+        for (var i = 0; i < 1000; i++) {
+            bulk.insert({_id: round * 1000 + i, round: round, pad: new Array(256).join('x')});
+        }
+        bulk.find({round: round - 1}).update({$set: {updatedIn: round}});
+        bulk.find({_id: {$lt: round * 100}}).remove();
+        assert.writeOK(bulk.execute({j: true}));
+    }
+
+    assert.commandWorked(testDB.coll.createIndex({round: 1}));
+    assert.writeOK(testDB.during.insert({x: 0}));
+    writeSome(0);
+    var backupId = takeBackup(baseDir + '/full');
+
+    var sets = [baseDir + '/full'];
+    for (var round = 1; round <= 3; round++) {
+        writeSome(round);
+        var dir = baseDir + '/incr' + round;
+        backupId = takeBackup(dir, backupId);
+        sets.push(dir);
+    }
+
+    // A backupId from another chain is rejected.
+    var bogus = Object.extend({}, backupId);
+    bogus.instanceId = ObjectId();
+    assert.commandFailed(admin.runCommand({hotBackup: 1, stage: 'begin', incremental: bogus}));
+
+    var expected = assert.commandWorked(testDB.runCommand({dbHash: 1}));
+    var expectedCount = testDB.coll.count();
+
+    // A new collection is not in the journal-only chain, so a full backup is required.
+    assert.writeOK(testDB.newColl.insert({x: 1}));
+    assert.commandFailed(admin.runCommand({hotBackup: 1, stage: 'begin', incremental: backupId}));
+
+    MongoRunner.stopMongod(conn);
+
+    var restorePath = baseDir + '/restored';
+    var args = ['python', 'buildscripts/hot_backup_restore.py', '--dbpath', restorePath];
+    assert.eq(0, runProgram.apply(null, args.concat(sets)), 'restore failed');
+
+    conn = MongoRunner.runMongod({dbpath: restorePath, noCleanData: true});
+    assert.neq(null, conn, 'mongod failed to start on the restored dbpath');
+    testDB = conn.getDB('test');
+
+    var restored = assert.commandWorked(testDB.runCommand({dbHash: 1}));
+    assert.eq(expected.collections.coll, restored.collections.coll, tojson(restored));
+    assert.eq(expected.collections.during, restored.collections.during, tojson(restored));
+    assert.eq(expectedCount, testDB.coll.count());
+    assert.eq(null, testDB.newColl.findOne());
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,122 @@
+// Checks that $lookup returns the same results whether it looks up one document at a time, batches
+// its input into $in queries or builds a hash table from the foreign collection, and that explain
+// reports the strategy chosen by the size check.
+
+(function() {
+    'use strict';
+
+    var conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, 'mongod failed to start');
+    var testDB = conn.getDB('test');
+    var admin = conn.getDB('admin');
+    var local = testDB.lookup_local;
+    var foreign = testDB.lookup_foreign;
+
+    var localDocs = [
+        {_id: 0, a: 1},
+        {_id: 1, a: null},
+        {_id: 2},
+        {_id: 3, a: [1, 2]},
+        {_id: 4, a: 2.0},
+        {_id: 5, a: NumberLong(3)},
+        {_id: 6, a: 'x'},
+        {_id: 7, a: /^x/},
+        {_id: 8, a: {b: 1}},
+        {_id: 9, a: 'none'},
+    ];
+    for (var i = 10; i < 250; i++) {
+        localDocs.push({_id: i, a: i % 20});
+    }
+    assert.writeOK(local.insert(localDocs));
+
+    var foreignDocs = [
+        {_id: 0, b: 1},
+        {_id: 1, b: null},
+        {_id: 2},
+        {_id: 3, b: [1, 2, [1, 2]]},
+        {_id: 4, b: NumberInt(2)},
+        {_id: 5, b: 3},
+        {_id: 6, b: 'x'},
+        {_id: 7, b: 'xy'},
+        {_id: 8, b: {b: 1}},
+        {_id: 9, b: [{b: 1}, 1]},
+    ];
+    for (var i = 10; i < 100; i++) {
+        foreignDocs.push({_id: i, b: i % 15});
+    }
+    assert.writeOK(foreign.insert(foreignDocs));
+
+    function setKnobs(batchSize, hashJoinMaxBytes) {
+        assert.commandWorked(admin.runCommand({
+            setParameter: 1,
+            internalDocumentSourceLookupBatchSize: batchSize,
+            internalDocumentSourceLookupHashJoinMaxBytes: hashJoinMaxBytes
+        }));
+    }
+
+    // Sorts the matches of each result by _id, since the order they are found in depends on the
+    // strategy.
+    function run(pipeline) {
+        return local.aggregate(pipeline.concat([{$sort: {_id: 1}}]))
+            .toArray()
+            .map(function(doc) {
+                if (Array.isArray(doc.matches)) {
+                    doc.matches.sort(function(x, y) {
+                        return x._id - y._id;
+                    });
+                }
+                return doc;
+            });
+    }
+
+    function strategyOf(pipeline) {
+        var explain = local.aggregate(pipeline, {explain: true});
+        var lookup = explain.stages.filter(function(stage) {
+            return stage.$lookup;
+        })[0];
+        assert(lookup, tojson(explain));
+        return lookup.$lookup.strategy;
+    }
+
+    var lookupStage = {
+        $lookup: {from: foreign.getName(), localField: 'a', foreignField: 'b', as: 'matches'}
+    };
+    var pipelines = [
+        [lookupStage],
+        [lookupStage, {$unwind: '$matches'}],
+        [lookupStage, {$unwind: {path: '$matches', preserveNullAndEmptyArrays: true}}],
+        [lookupStage, {$unwind: {path: '$matches', includeArrayIndex: 'idx'}}],
+    ];
+
+    setKnobs(1, 32 * 1024 * 1024);
+    assert.eq('nestedLoop', strategyOf(pipelines[0]));
+    var expected = pipelines.map(run);
+
+    // A foreign collection too big for the hash table is looked up a batch at a time.
+    [1000, 7, 2].forEach(function(batchSize) {
+        setKnobs(batchSize, 16);
+        assert.eq('batchedIn', strategyOf(pipelines[0]));
+        pipelines.forEach(function(pipeline, i) {
+            assert.eq(expected[i], run(pipeline), 'batchedIn, batch size ' + batchSize);
+        });
+    });
+
+    [1000, 7, 2].forEach(function(batchSize) {
+        setKnobs(batchSize, 32 * 1024 * 1024);
+        assert.eq('hashJoin', strategyOf(pipelines[0]));
+        pipelines.forEach(function(pipeline, i) {
+            assert.eq(expected[i], run(pipeline), 'hashJoin, batch size ' + batchSize);
+        });
+    });
+
+    // A foreign collection which does not exist matches nothing with any strategy.
+    setKnobs(100, 32 * 1024 * 1024);
+    var missing = {
+        $lookup: {from: 'does_not_exist', localField: 'a', foreignField: 'b', as: 'matches'}
+    };
+    local.aggregate([missing]).forEach(function(doc) {
+        assert.eq([], doc.matches, tojson(doc));
+    });
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,52 @@
+// Checks that the shell and mongod negotiate network message compression through isMaster and
+// that compressed traffic is reported in the 'network.compression' section of serverStatus.
+
+(function() {
+    'use strict';
+
+    function compressionStats(conn) {
+        return assert.commandWorked(conn.getDB('admin').serverStatus()).network.compression;
+    }
+
+    ['snappy', 'zlib'].forEach(function(compressor) {
+        var mongo = MongoRunner.runMongod({networkMessageCompressors: compressor});
+        assert.neq(null, mongo, 'mongod failed to start with ' + compressor + ' compression');
+
+        var isMaster = assert.commandWorked(
+            mongo.getDB('admin').runCommand({isMaster: 1, compression: ['lz4', compressor]}));
+        assert.eq([compressor], isMaster.compression, tojson(isMaster));
+
+        var coll = mongo.getDB('test').compression;
+        var bulk = coll.initializeUnorderedBulkOp();
+        for (var i = 0; i < 1000; i++) {
+            bulk.insert({_id: i, pad: new Array(1024).join('x')});
+        }
+        assert.writeOK(bulk.execute());
+        assert.eq(1000, coll.find().itcount());
+
+        // Only the shell's own compressor is used on this connection, which is snappy unless the
+        // server doesn't offer it.
+        var stats = compressionStats(mongo);
+        if (compressor === 'snappy') {
+            assert.gt(stats.snappy.compressor.bytesIn, stats.snappy.compressor.bytesOut,
+                      tojson(stats));
+            assert.gt(stats.snappy.decompressor.bytesOut, 1000 * 1024, tojson(stats));
+        } else {
+            assert.eq(['zlib'], Object.keys(stats), tojson(stats));
+        }
+
+        MongoRunner.stopMongod(mongo);
+    });
+
+    // With compression disabled the server doesn't agree on any compressor.
+    var mongo = MongoRunner.runMongod({networkMessageCompressors: 'disabled'});
+    var isMaster = assert.commandWorked(
+        mongo.getDB('admin').runCommand({isMaster: 1, compression: ['snappy', 'zlib']}));
+    assert(!isMaster.hasOwnProperty('compression'), tojson(isMaster));
+    assert.eq({}, compressionStats(mongo));
+    MongoRunner.stopMongod(mongo);
+
+    assert.eq(null,
+              MongoRunner.runMongod({networkMessageCompressors: 'snappy,lz4'}),
+              'mongod started with an unknown compressor');
+}());
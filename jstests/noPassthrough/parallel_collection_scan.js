@@ -0,0 +1,77 @@
+// Checks that collection scans split across worker threads return the same documents as a single
+// threaded scan for find and aggregate, keep RecordId order for a $natural sort, and report their
+// workers in explain.
+// @tags: [requires_wiredtiger]
+
+(function() {
+    'use strict';
+
+    var conn = MongoRunner.runMongod({
+        storageEngine: 'wiredTiger',
+        setParameter: {
+            internalQueryExecParallelCollScanMaxDOP: 4,
+            internalQueryExecParallelCollScanMinRecords: 0
+        }
+    });
+    assert.neq(null, conn, 'mongod failed to start');
+    var testDB = conn.getDB('test');
+    var admin = conn.getDB('admin');
+    var coll = testDB.parallel_collection_scan;
+
+    var kNumDocs = 20000;
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < kNumDocs; i++) {
+        bulk.insert({_id: i, a: i % 7, pad: new Array(i % 64).join('x')});
+    }
+    assert.writeOK(bulk.execute());
+
+    function setDOP(dop) {
+        assert.commandWorked(
+            admin.runCommand({setParameter: 1, internalQueryExecParallelCollScanMaxDOP: dop}));
+    }
+
+    function sortedIds(cursor) {
+        return cursor.map(function(doc) {
+                         return doc._id;
+                     })
+            .sort(function(x, y) {
+                return x - y;
+            });
+    }
+
+    var filter = {a: {$in: [1, 3]}};
+    var group = [{$match: filter}, {$group: {_id: '$a', n: {$sum: 1}, total: {$sum: '$_id'}}}];
+
+    setDOP(1);
+    var expectedIds = sortedIds(coll.find(filter).toArray());
+    var expectedGroups = coll.aggregate(group.concat([{$sort: {_id: 1}}])).toArray();
+    var explain = coll.find(filter).explain('executionStats');
+    assert.eq('COLLSCAN', explain.executionStats.executionStages.stage, tojson(explain));
+
+    setDOP(4);
+    explain = coll.find(filter).explain('executionStats');
+    var stage = explain.executionStats.executionStages;
+    assert.eq('PARALLEL_COLLSCAN', stage.stage, tojson(explain));
+    assert.eq(4, stage.workers, tojson(stage));
+    assert.eq(kNumDocs, explain.executionStats.totalDocsExamined, tojson(explain));
+    assert.eq(expectedIds.length, explain.executionStats.nReturned, tojson(explain));
+
+    assert.eq(expectedIds, sortedIds(coll.find(filter).toArray()));
+    assert.eq(expectedIds, sortedIds(coll.find(filter).batchSize(10).toArray()));
+    assert.eq(expectedGroups, coll.aggregate(group.concat([{$sort: {_id: 1}}])).toArray());
+
+    // A $natural sort returns the ranges in order.
+    var natural = coll.find(filter).sort({$natural: 1}).toArray();
+    assert.eq(expectedIds.length, natural.length);
+    for (var j = 1; j < natural.length; j++) {
+        assert.lt(natural[j - 1]._id, natural[j]._id);
+    }
+
+    // Backward scans and $where filters stay in a single thread.
+    explain = coll.find(filter).sort({$natural: -1}).explain();
+    assert.eq('COLLSCAN', explain.queryPlanner.winningPlan.stage, tojson(explain));
+    explain = coll.find({$where: 'this.a == 1'}).explain();
+    assert.eq('COLLSCAN', explain.queryPlanner.winningPlan.stage, tojson(explain));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,82 @@
+// Checks that finds and getMores are recorded by query shape in the queryShapeStats command, and
+// that the statistics are bounded by queryShapeStatsMaxShapes.
+
+(function() {
+    'use strict';
+
+    var conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, 'mongod failed to start');
+    var admin = conn.getDB('admin');
+    var testDB = conn.getDB('test');
+    var coll = testDB.query_shape_stats;
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 500; i++) {
+        bulk.insert({_id: i, a: i % 10, b: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+
+    function shapesOf(ns) {
+        var res = assert.commandWorked(admin.runCommand({queryShapeStats: 1, ns: ns}));
+        return res.shapes;
+    }
+
+    // The same shape with different values is one entry.
+    for (var i = 0; i < 5; i++) {
+        assert.eq(50, coll.find({a: i}).itcount());
+    }
+    // A batch size forces getMores, which count against the shape of their find.
+    assert.eq(500, coll.find({b: {$gte: 0}}).sort({b: 1}).batchSize(10).itcount());
+
+    var shapes = shapesOf(coll.getFullName());
+    assert.eq(2, shapes.length, tojson(shapes));
+    var byA = shapes.filter(function(shape) {
+        return shape.shape.filter.a !== undefined;
+    })[0];
+    assert(byA, tojson(shapes));
+    assert.eq(5, byA.queries, tojson(byA));
+    assert.eq(0, byA.getMores, tojson(byA));
+    assert.eq(250, byA.nreturned, tojson(byA));
+    assert.gte(byA.keysExamined, 250, tojson(byA));
+    assert.gte(byA.latencyMicros.max, byA.latencyMicros.p50, tojson(byA));
+
+    var byB = shapes.filter(function(shape) {
+        return shape.shape.filter.b !== undefined;
+    })[0];
+    assert(byB, tojson(shapes));
+    assert.eq(1, byB.queries, tojson(byB));
+    assert.gt(byB.getMores, 0, tojson(byB));
+    assert.eq(500, byB.nreturned, tojson(byB));
+    assert.eq(500, byB.docsExamined, tojson(byB));
+
+    var res = assert.commandWorked(
+        admin.runCommand({queryShapeStats: 1, ns: coll.getFullName(), limit: 1, histogram: true}));
+    assert.eq(1, res.shapes.length, tojson(res));
+    assert(Array.isArray(res.shapes[0].latencyMicros.histogram), tojson(res));
+
+    assert.commandFailed(admin.runCommand({queryShapeStats: 1, limit: -1}));
+    assert.commandFailed(testDB.runCommand({queryShapeStats: 1}));
+
+    // Resetting forgets all shapes.
+    assert.commandWorked(admin.runCommand({queryShapeStats: 1, reset: true}));
+    assert.eq([], shapesOf(coll.getFullName()));
+
+    // Disabled statistics record nothing.
+    assert.commandWorked(admin.runCommand({setParameter: 1, queryShapeStatsMaxShapes: 0}));
+    assert.eq(50, coll.find({a: 1}).itcount());
+    assert.eq([], shapesOf(coll.getFullName()));
+
+    // A bounded store evicts shapes instead of growing.
+    assert.commandWorked(admin.runCommand({setParameter: 1, queryShapeStatsMaxShapes: 16}));
+    for (var i = 0; i < 100; i++) {
+        var filter = {};
+        filter['f' + i] = 1;
+        coll.find(filter).itcount();
+    }
+    res = assert.commandWorked(admin.runCommand({queryShapeStats: 1}));
+    assert.lte(res.numShapes, 16, tojson(res));
+    assert.gt(res.shapesEvicted, 0, tojson(res));
+
+    MongoRunner.stopMongod(conn);
+}());
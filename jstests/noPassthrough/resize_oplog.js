@@ -0,0 +1,78 @@
+// Checks that replSetResizeOplog changes the oplog size while writes keep going, that a shrink is
+// carried out by the oplog's reclaim thread, which reports it in the 'oplogTruncation' section of
+// serverStatus, and that the new size survives a restart.
+// @tags: [requires_wiredtiger, requires_persistence, requires_replication]
+
+(function() {
+    'use strict';
+
+    var MB = 1024 * 1024;
+
+    var rst = new ReplSetTest({name: 'resize_oplog', nodes: 1, oplogSize: 10});
+    rst.startSet({storageEngine: 'wiredTiger'});
+    rst.initiate();
+
+    var primary = rst.getPrimary();
+    var oplog = primary.getDB('local').oplog.rs;
+    var admin = primary.getDB('admin');
+
+    function fillOplog(db, bytes) {
+        var pad = new Array(1024).join('x');
+        var bulk = db.fill.initializeUnorderedBulkOp();
+        for (var i = 0; i < bytes / 1024; i++) {
+            bulk.insert({pad: pad});
+        }
+        assert.writeOK(bulk.execute());
+    }
+
+    assert.commandFailed(admin.runCommand({replSetResizeOplog: 1, size: 'big'}));
+    assert.commandFailed(admin.runCommand({replSetResizeOplog: 1, size: 0}));
+    assert.commandFailed(admin.runCommand({replSetResizeOplog: 1, size: -MB}));
+
+    fillOplog(primary.getDB('test'), 9 * MB);
+    assert.gt(oplog.stats().size, 8 * MB);
+
+    // The reclaim thread is a regular client in currentOp, where it reports its truncations.
+    assert(admin.currentOp(true).inprog.some(function(op) {
+        return op.desc === 'WT RecordStoreThread: local.oplog.rs';
+    }), 'oplog reclaim thread not found in currentOp');
+
+    // Shrink while another client keeps writing.
+    var awaitWrites = startParallelShell(function() {
+        for (var i = 0; i < 2000; i++) {
+            assert.writeOK(db.getSiblingDB('test').during.insert({i: i}));
+        }
+    }, primary.port);
+
+    assert.commandWorked(admin.runCommand({replSetResizeOplog: 1, size: 2 * MB}));
+    assert.eq(2 * MB, oplog.stats().maxSize);
+
+    assert.soon(function() {
+        return oplog.stats().size < 4 * MB;
+    }, 'oplog was not truncated after the shrink: ' + tojson(oplog.stats()));
+    awaitWrites();
+    assert.eq(2000, primary.getDB('test').during.count());
+
+    // The truncations show up in serverStatus, and the backlog drains.
+    assert.soon(function() {
+        return admin.serverStatus().oplogTruncation.bytesToReclaim == 0;
+    }, 'oplog truncation backlog did not drain: ' + tojson(admin.serverStatus().oplogTruncation));
+    var truncation = admin.serverStatus().oplogTruncation;
+    assert.gt(truncation.truncateCount, 0, tojson(truncation));
+    assert.gt(truncation.bytesTruncated, 5 * MB, tojson(truncation));
+    assert.gte(truncation.totalTimeTruncatingMicros, 0, tojson(truncation));
+
+    // Growing keeps everything that is there.
+    var count = oplog.count();
+    assert.commandWorked(admin.runCommand({replSetResizeOplog: 1, size: 20 * MB}));
+    assert.eq(20 * MB, oplog.stats().maxSize);
+    fillOplog(primary.getDB('test'), 4 * MB);
+    assert.gt(oplog.count(), count);
+    assert.gt(oplog.stats().size, 4 * MB);
+
+    rst.restart(0);
+    primary = rst.getPrimary();
+    assert.eq(20 * MB, primary.getDB('local').oplog.rs.stats().maxSize);
+
+    rst.stopSet();
+}());
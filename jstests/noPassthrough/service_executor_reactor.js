@@ -0,0 +1,78 @@
+// Checks that mongod services requests with --serviceExecutor=reactor and reports the worker pool
+// in the 'network.serviceExecutor' section of db.serverStatus().
+
+(function() {
+    'use strict';
+
+    var mongo = MongoRunner.runMongod(
+        {serviceExecutor: 'reactor', reactorIOThreads: 2, reactorWorkerThreads: 4});
+    assert.neq(null, mongo, 'mongod failed to start with serviceExecutor=reactor');
+
+    // More connections than worker threads, each issuing several requests.
+    var conns = [];
+    for (var i = 0; i < 16; i++) {
+        conns.push(new Mongo(mongo.host));
+    }
+    conns.forEach(function(conn, i) {
+        var coll = conn.getDB('test').reactor;
+        for (var j = 0; j < 10; j++) {
+            assert.writeOK(coll.insert({conn: i, seq: j}));
+        }
+        assert.eq(10, coll.find({conn: i}).itcount());
+    });
+
+    // A batch larger than a single reply still goes through getMore on the same connection.
+    var bulk = mongo.getDB('test').big.initializeUnorderedBulkOp();
+    for (var i = 0; i < 2000; i++) {
+        bulk.insert({_id: i, pad: new Array(512).join('x')});
+    }
+    assert.writeOK(bulk.execute());
+    assert.eq(2000, mongo.getDB('test').big.find().batchSize(10).itcount());
+
+    // Requests are still serviced while every core worker is blocked in a long operation.
+    assert.writeOK(mongo.getDB('test').blocking.insert({_id: 0}));
+    var awaitShells = [];
+    for (var i = 0; i < 4; i++) {
+        awaitShells.push(startParallelShell(function() {
+            assert.eq(1,
+                      db.getSiblingDB('test')
+                          .blocking.find({$where: 'sleep(5000); return true;'})
+                          .itcount());
+        }, mongo.port));
+    }
+    assert.soon(function() {
+        var ops = mongo.getDB('admin').currentOp({ns: 'test.blocking'}).inprog;
+        return ops.length == 4;
+    }, 'the blocking queries did not start');
+    var start = new Date();
+    assert.commandWorked(mongo.getDB('admin').runCommand({ping: 1}));
+    assert.lt(new Date() - start, 2000, 'ping waited for the blocked workers');
+    awaitShells.forEach(function(awaitShell) {
+        awaitShell();
+    });
+
+    var serverStatus = assert.commandWorked(mongo.getDB('admin').serverStatus());
+    var executor = serverStatus.network.serviceExecutor;
+    assert(executor, 'missing network.serviceExecutor: ' + tojson(serverStatus.network));
+    assert.eq('reactor', executor.executor, tojson(executor));
+    assert.eq(2, executor.ioThreads, tojson(executor));
+    assert.eq(4, executor.workerThreads, tojson(executor));
+    assert.gte(executor.connections, 17, tojson(executor));
+    assert.gt(executor.requests, 160, tojson(executor));
+    assert.gte(executor.tasksEnqueued, executor.tasksRun, tojson(executor));
+
+    // The extra workers started while the core workers were blocked are reported.
+    var workers = executor.workers;
+    assert(workers, tojson(executor));
+    assert.gte(workers.current, 4, tojson(workers));
+    assert.gte(workers.extraStarted, 1, tojson(workers));
+    assert.eq(0, workers.blocked, tojson(workers));
+
+    MongoRunner.stopMongod(mongo);
+
+    // The default thread-per-connection mode does not report the section.
+    mongo = MongoRunner.runMongod({});
+    serverStatus = assert.commandWorked(mongo.getDB('admin').serverStatus());
+    assert(!serverStatus.network.serviceExecutor, tojson(serverStatus.network));
+    MongoRunner.stopMongod(mongo);
+}());
@@ -0,0 +1,72 @@
+// Checks that queries and distincts which leave the leading field of a compound index unconstrained
+// can seek across its distinct values, that explain reports it, and that the results are the same
+// as those of a collection scan.
+
+(function() {
+    'use strict';
+
+    load('jstests/libs/analyze_plan.js');
+
+    var conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, 'mongod failed to start');
+    var testDB = conn.getDB('test');
+    var admin = conn.getDB('admin');
+    var coll = testDB.skip_scan;
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 2000; i++) {
+        bulk.insert({_id: i, a: i % 4, b: i % 100, c: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+
+    function setSkipScan(enabled) {
+        assert.commandWorked(
+            admin.runCommand({setParameter: 1, internalQueryPlannerEnableSkipScan: enabled}));
+    }
+
+    var query = {b: {$in: [3, 42]}};
+    var expected = coll.find(query).hint({$natural: 1}).sort({_id: 1}).toArray();
+    assert.eq(80, expected.length);
+
+    // The hinted index is scanned in full when skip scans are disabled.
+    setSkipScan(false);
+    var explain = coll.find(query).hint({a: 1, b: 1}).explain('executionStats');
+    var ixscan = getPlanStage(explain.executionStats.executionStages, 'IXSCAN');
+    assert.eq(2000, ixscan.keysExamined, tojson(ixscan));
+    assert(!ixscan.skipScanPrefixLen, tojson(ixscan));
+
+    setSkipScan(true);
+    explain = coll.find(query).hint({a: 1, b: 1}).explain('executionStats');
+    ixscan = getPlanStage(explain.executionStats.executionStages, 'IXSCAN');
+    assert.eq(1, ixscan.skipScanPrefixLen, tojson(ixscan));
+    assert.gt(ixscan.seeks, 0, tojson(ixscan));
+    assert.lt(ixscan.keysExamined, 200, tojson(ixscan));
+    assert.eq(80, explain.executionStats.nReturned, tojson(explain));
+
+    // Without a hint the skip scan competes with the collection scan, and wins.
+    explain = coll.find(query).explain();
+    assert(isIxscan(explain.queryPlanner.winningPlan), tojson(explain));
+    assert.eq(1, explain.queryPlanner.rejectedPlans.length, tojson(explain));
+    assert(isCollscan(explain.queryPlanner.rejectedPlans[0]), tojson(explain));
+    assert.eq(expected, coll.find(query).sort({_id: 1}).toArray());
+    assert.eq(expected, coll.find(query).hint({a: 1, b: 1}).sort({_id: 1}).toArray());
+
+    // A distinct over the second field of the index skips to the next pair of values.
+    var res = assert.commandWorked(testDB.runCommand({distinct: coll.getName(), key: 'b'}));
+    assert.eq(100, res.values.length, tojson(res));
+    assert.eq(0, res.stats.nscannedObjects, tojson(res.stats));
+    assert.eq(0, res.stats.planSummary.indexOf('DISTINCT_SCAN'), tojson(res.stats));
+
+    res = assert.commandWorked(
+        testDB.runCommand({distinct: coll.getName(), key: 'b', query: {b: {$gte: 90}}}));
+    assert.eq(10, res.values.length, tojson(res));
+    assert.eq(0, res.stats.nscannedObjects, tojson(res.stats));
+
+    setSkipScan(false);
+    res = assert.commandWorked(testDB.runCommand({distinct: coll.getName(), key: 'b'}));
+    assert.eq(100, res.values.length, tojson(res));
+    assert.eq(2000, res.stats.nscannedObjects, tojson(res.stats));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,63 @@
+//
+// Tests that the balancer moves chunks of collections on different shards in the same round, and
+// reports its rounds in serverStatus and the changelog.
+//
+
+(function() {
+    'use strict';
+
+    var st = new ShardingTest({shards: 4, mongos: 1, other: {chunkSize: 1}});
+
+    st.stopBalancer();
+
+    var mongos = st.s0;
+    var admin = mongos.getDB('admin');
+
+    assert.commandFailed(admin.runCommand({setParameter: 1, balancerMaxConcurrentMigrations: 0}));
+    assert.commandFailed(admin.runCommand({setParameter: 1, balancerMaxMigrationsPerShard: 3}));
+    assert.commandWorked(admin.runCommand(
+        {setParameter: 1, balancerMaxConcurrentMigrations: 4, balancerMaxMigrationsPerShard: 2}));
+
+    // Two collections whose chunks all start on different shards.
+    var colls = [mongos.getCollection('db0.coll'), mongos.getCollection('db1.coll')];
+    colls.forEach(function(coll, i) {
+        assert.commandWorked(admin.runCommand({enableSharding: coll.getDB().getName()}));
+        st.ensurePrimaryShard(coll.getDB().getName(), 'shard000' + i);
+        assert.commandWorked(
+            admin.runCommand({shardCollection: coll.getFullName(), key: {_id: 1}}));
+        for (var j = 1; j < 16; j++) {
+            assert.commandWorked(admin.runCommand({split: coll.getFullName(), middle: {_id: j}}));
+        }
+    });
+
+    var status = assert.commandWorked(admin.runCommand({serverStatus: 1})).sharding.balancer;
+    assert.eq(false, status.inBalancerRound, tojson(status));
+    assert.eq(4, status.maxConcurrentMigrations, tojson(status));
+    assert.eq(2, status.maxMigrationsPerShard, tojson(status));
+
+    st.startBalancer();
+
+    var config = mongos.getDB('config');
+    assert.soon(function() {
+        return colls.every(function(coll) {
+            return config.chunks.distinct('shard', {ns: coll.getFullName()}).length == 4;
+        });
+    }, 'chunks were not moved to every shard', 5 * 60 * 1000);
+
+    st.stopBalancer();
+
+    var round = config.changelog.find({what: 'balancer.round', 'details.chunksMoved': {$gt: 0}})
+                    .sort({time: -1})
+                    .limit(1)
+                    .next();
+    assert.eq(false, round.details.errorOccured, tojson(round));
+    assert.gte(round.details.maxConcurrentMigrations, 1, tojson(round));
+    assert.eq('number', typeof round.details.migrationsFailed, tojson(round));
+
+    status = assert.commandWorked(admin.runCommand({serverStatus: 1})).sharding.balancer;
+    assert.gt(status.numBalancerRounds, 0, tojson(status));
+    assert.eq(0, status.migrationsInProgress, tojson(status));
+    assert(status.lastRound, tojson(status));
+
+    st.stop();
+})();
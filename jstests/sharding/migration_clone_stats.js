@@ -0,0 +1,47 @@
+//
+// Tests that a migration clones every document of the chunk in batches and records the amount and
+// throughput of the clone in the moveChunk changelog entries of both shards.
+//
+
+(function() {
+    'use strict';
+
+    var st = new ShardingTest({shards: 2, mongos: 1});
+    st.stopBalancer();
+
+    var mongos = st.s0;
+    var admin = mongos.getDB('admin');
+    var coll = mongos.getCollection('test.clone_stats');
+
+    assert.commandWorked(admin.runCommand({enableSharding: 'test'}));
+    st.ensurePrimaryShard('test', 'shard0000');
+    assert.commandWorked(admin.runCommand({shardCollection: coll.getFullName(), key: {x: 1}}));
+    assert.commandWorked(admin.runCommand({split: coll.getFullName(), middle: {x: 0}}));
+
+    // Interleave the two chunks on disk, so that the donor cannot read the moved one sequentially.
+    var kNumDocs = 20000;
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < kNumDocs; i++) {
+        bulk.insert({x: (i % 2 ? i : -i - 1), pad: new Array(100).join('x')});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandWorked(admin.runCommand(
+        {moveChunk: coll.getFullName(), find: {x: 0}, to: 'shard0001', _waitForDelete: true}));
+
+    assert.eq(kNumDocs / 2, st.shard0.getCollection(coll.getFullName()).count());
+    assert.eq(kNumDocs / 2, st.shard1.getCollection(coll.getFullName()).count());
+    assert.eq(kNumDocs, coll.find().itcount());
+
+    var config = mongos.getDB('config');
+    ['moveChunk.to', 'moveChunk.from'].forEach(function(what) {
+        var entry = config.changelog.findOne({what: what, ns: coll.getFullName()});
+        assert.neq(null, entry, what);
+        assert.eq('success', entry.details.note, tojson(entry));
+        assert.eq(kNumDocs / 2, entry.details.clonedDocs, tojson(entry));
+        assert.gt(entry.details.clonedBytes, 0, tojson(entry));
+        assert.gte(entry.details.cloneBytesPerSec, 0, tojson(entry));
+    });
+
+    st.stop();
+})();
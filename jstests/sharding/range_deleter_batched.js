@@ -0,0 +1,51 @@
+//
+// Tests that the range deleter removes the documents of a migrated chunk in batches at the rate
+// allowed by its server parameters, and reports the deleted ranges in serverStatus.
+//
+
+(function() {
+    'use strict';
+
+    var st = new ShardingTest({shards: 2, mongos: 1});
+    st.stopBalancer();
+
+    var mongos = st.s0;
+    var admin = mongos.getDB('admin');
+    var coll = mongos.getCollection('test.range_deleter_batched');
+    var donor = st.shard0.getDB('admin');
+
+    assert.commandFailed(donor.runCommand({setParameter: 1, rangeDeleterBatchSize: 0}));
+    assert.commandFailed(donor.runCommand({setParameter: 1, rangeDeleterMaxDocsPerSec: -1}));
+    assert.commandWorked(donor.runCommand(
+        {setParameter: 1, rangeDeleterBatchSize: 10, rangeDeleterMaxDocsPerSec: 1000}));
+
+    assert.commandWorked(admin.runCommand({enableSharding: 'test'}));
+    st.ensurePrimaryShard('test', 'shard0000');
+    assert.commandWorked(admin.runCommand({shardCollection: coll.getFullName(), key: {x: 1}}));
+    assert.commandWorked(admin.runCommand({split: coll.getFullName(), middle: {x: 0}}));
+
+    var kNumDocs = 2000;
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < kNumDocs; i++) {
+        bulk.insert({x: i - kNumDocs / 2});
+    }
+    assert.writeOK(bulk.execute());
+
+    var start = new Date();
+    assert.commandWorked(admin.runCommand(
+        {moveChunk: coll.getFullName(), find: {x: 0}, to: 'shard0001', _waitForDelete: true}));
+
+    // Deleting 1000 documents at 1000 per second takes about a second.
+    assert.gte(new Date() - start, 900);
+    assert.eq(kNumDocs / 2, st.shard0.getCollection(coll.getFullName()).count());
+    assert.eq(kNumDocs, coll.find().itcount());
+
+    var status = assert.commandWorked(donor.runCommand({serverStatus: 1, rangeDeleter: 1}));
+    var rangeDeleter = status.rangeDeleter;
+    assert.eq([], rangeDeleter.inProgress, tojson(rangeDeleter));
+    var last = rangeDeleter.lastDeleteStats[rangeDeleter.lastDeleteStats.length - 1];
+    assert.eq(kNumDocs / 2, last.deletedDocs, tojson(rangeDeleter));
+    assert.gt(last.deletedBytes, 0, tojson(rangeDeleter));
+
+    st.stop();
+})();
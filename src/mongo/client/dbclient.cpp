@@ -878,6 +878,8 @@ StatusWith<executor::RemoteCommandResponse> initWireVersion(DBClientConnection*
             bob.append("hostInfo", sb.str());
         }
 
+        conn->port().compressorManager().clientBegin(&bob);
+
         Date_t start{Date_t::now()};
         auto result =
             conn->runCommandWithMetadata("admin", "isMaster", rpc::makeEmptyMetadata(), bob.done());
@@ -891,6 +893,8 @@ StatusWith<executor::RemoteCommandResponse> initWireVersion(DBClientConnection*
             conn->setWireVersions(minWireVersion, maxWireVersion);
         }
 
+        conn->port().compressorManager().clientFinish(isMasterObj);
+
         return executor::RemoteCommandResponse{
             std::move(isMasterObj), result->getMetadata().getOwned(), finish - start};
 
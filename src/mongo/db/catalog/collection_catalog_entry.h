@@ -32,6 +32,7 @@
 
 #include "mongo/base/string_data.h"
 #include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/index/multikey_paths.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/record_id.h"
 
@@ -63,11 +64,26 @@ public:
 
     virtual BSONObj getIndexSpec(OperationContext* txn, StringData idxName) const = 0;
 
-    virtual bool isIndexMultikey(OperationContext* txn, StringData indexName) const = 0;
+    /**
+     * Returns true if the index identified by 'indexName' is multikey, and returns false
+     * otherwise.
+     *
+     * If 'multikeyPaths' is not null, it is set to the path components of the index's key
+     * pattern fields which traverse an array, or left empty if the storage engine does not track
+     * them for this index.
+     */
+    virtual bool isIndexMultikey(OperationContext* txn,
+                                 StringData indexName,
+                                 MultikeyPaths* multikeyPaths) const = 0;
 
+    /**
+     * Marks the index identified by 'indexName' as multikey and adds 'multikeyPaths' to the
+     * paths recorded for it, if the storage engine tracks them for this index. Returns true if
+     * the metadata for the index was changed, and returns false otherwise.
+     */
     virtual bool setIndexIsMultikey(OperationContext* txn,
                                     StringData indexName,
-                                    bool multikey = true) = 0;
+                                    const MultikeyPaths& multikeyPaths) = 0;
 
     /**
      * Removes metadata about which path components cause an index to be multikey from all indexes
@@ -324,67 +324,83 @@ CursorManager::~CursorManager() {
 }
 
 void CursorManager::invalidateAll(bool collectionGoingAway, const std::string& reason) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
     fassert(28819, !BackgroundOperation::inProgForNs(_nss));
 
-    for (ExecSet::iterator it = _nonCachedExecutors.begin(); it != _nonCachedExecutors.end();
-         ++it) {
-        // we kill the executor, but it deletes itself
-        PlanExecutor* exec = *it;
-        exec->kill(reason);
-        invariant(exec->collection() == NULL);
-    }
-    _nonCachedExecutors.clear();
+    for (Partition& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
-    if (collectionGoingAway) {
-        // we're going to wipe out the world
-        for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-            ClientCursor* cc = i->second;
+        for (ExecSet::iterator it = partition.nonCachedExecutors.begin();
+             it != partition.nonCachedExecutors.end();
+             ++it) {
+            // we kill the executor, but it deletes itself
+            PlanExecutor* exec = *it;
+            exec->kill(reason);
+            invariant(exec->collection() == NULL);
+        }
+        partition.numRegistered.subtractAndFetch(partition.nonCachedExecutors.size());
+        partition.nonCachedExecutors.clear();
 
-            cc->kill();
+        if (collectionGoingAway) {
+            // we're going to wipe out the world
+            for (CursorMap::const_iterator i = partition.cursors.begin();
+                 i != partition.cursors.end();
+                 ++i) {
+                ClientCursor* cc = i->second;
 
-            invariant(cc->getExecutor() == NULL || cc->getExecutor()->collection() == NULL);
+                cc->kill();
 
-            // If the CC is pinned, somebody is actively using it and we do not delete it.
-            // Instead we notify the holder that we killed it.  The holder will then delete the
-            // CC.
-            //
-            // If the CC is not pinned, there is nobody actively holding it.  We can safely
-            // delete it.
-            if (!cc->isPinned()) {
-                delete cc;
+                invariant(cc->getExecutor() == NULL || cc->getExecutor()->collection() == NULL);
+
+                // If the CC is pinned, somebody is actively using it and we do not delete it.
+                // Instead we notify the holder that we killed it.  The holder will then delete
+                // the CC.
+                //
+                // If the CC is not pinned, there is nobody actively holding it.  We can safely
+                // delete it.
+                if (!cc->isPinned()) {
+                    delete cc;
+                }
             }
-        }
-    } else {
-        CursorMap newMap;
-
-        // collection will still be around, just all PlanExecutors are invalid
-        for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-            ClientCursor* cc = i->second;
-
-            // Note that a valid ClientCursor state is "no cursor no executor."  This is because
-            // the set of active cursor IDs in ClientCursor is used as representation of query
-            // state.  See sharding_block.h.  TODO(greg,hk): Move this out.
-            if (NULL == cc->getExecutor()) {
-                newMap.insert(*i);
-                continue;
+            partition.numRegistered.subtractAndFetch(partition.cursors.size());
+            _numCursors.subtractAndFetch(partition.cursors.size());
+            partition.cursors.clear();
+        } else {
+            CursorMap newMap;
+
+            // collection will still be around, just all PlanExecutors are invalid
+            for (CursorMap::const_iterator i = partition.cursors.begin();
+                 i != partition.cursors.end();
+                 ++i) {
+                ClientCursor* cc = i->second;
+
+                // Note that a valid ClientCursor state is "no cursor no executor."  This is
+                // because the set of active cursor IDs in ClientCursor is used as
+                // representation of query state.  See sharding_block.h.  TODO(greg,hk): Move
+                // this out.
+                if (NULL == cc->getExecutor()) {
+                    newMap.insert(*i);
+                    continue;
+                }
+
+                if (cc->isPinned() || cc->isAggCursor()) {
+                    // Pinned cursors need to stay alive, so we leave them around.  Aggregation
+                    // cursors also can stay alive (since they don't have their lifetime bound to
+                    // the underlying collection).  However, if they have an associated executor,
+                    // we need to kill it, because it's now invalid.
+                    if (cc->getExecutor())
+                        cc->getExecutor()->kill(reason);
+                    newMap.insert(*i);
+                } else {
+                    cc->kill();
+                    delete cc;
+                }
             }
 
-            if (cc->isPinned() || cc->isAggCursor()) {
-                // Pinned cursors need to stay alive, so we leave them around.  Aggregation
-                // cursors also can stay alive (since they don't have their lifetime bound to
-                // the underlying collection).  However, if they have an associated executor, we
-                // need to kill it, because it's now invalid.
-                if (cc->getExecutor())
-                    cc->getExecutor()->kill(reason);
-                newMap.insert(*i);
-            } else {
-                cc->kill();
-                delete cc;
-            }
+            const size_t numErased = partition.cursors.size() - newMap.size();
+            partition.numRegistered.subtractAndFetch(numErased);
+            _numCursors.subtractAndFetch(numErased);
+            partition.cursors.swap(newMap);
         }
-
-        _cursors = newMap;
     }
 }
 
@@ -397,72 +413,97 @@ void CursorManager::invalidateDocument(OperationContext* txn,
         return;
     }
 
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    for (Partition& partition : _partitions) {
+        // Executors and cursors are registered under the collection lock, which the caller holds
+        // exclusively, so a partition seen as empty here cannot gain any before the write.
+        if (partition.numRegistered.load() == 0) {
+            continue;
+        }
 
-    for (ExecSet::iterator it = _nonCachedExecutors.begin(); it != _nonCachedExecutors.end();
-         ++it) {
-        PlanExecutor* exec = *it;
-        exec->invalidate(txn, dl, type);
-    }
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
-    for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        PlanExecutor* exec = i->second->getExecutor();
-        if (exec) {
+        for (ExecSet::iterator it = partition.nonCachedExecutors.begin();
+             it != partition.nonCachedExecutors.end();
+             ++it) {
+            PlanExecutor* exec = *it;
             exec->invalidate(txn, dl, type);
         }
+
+        for (CursorMap::const_iterator i = partition.cursors.begin();
+             i != partition.cursors.end();
+             ++i) {
+            PlanExecutor* exec = i->second->getExecutor();
+            if (exec) {
+                exec->invalidate(txn, dl, type);
+            }
+        }
     }
 }
 
 std::size_t CursorManager::timeoutCursors(int millisSinceLastCall) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    std::size_t numTimedOut = 0;
 
-    vector<ClientCursor*> toDelete;
+    for (Partition& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
-    for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        ClientCursor* cc = i->second;
-        if (cc->shouldTimeout(millisSinceLastCall))
-            toDelete.push_back(cc);
-    }
+        vector<ClientCursor*> toDelete;
+
+        for (CursorMap::const_iterator i = partition.cursors.begin();
+             i != partition.cursors.end();
+             ++i) {
+            ClientCursor* cc = i->second;
+            if (cc->shouldTimeout(millisSinceLastCall))
+                toDelete.push_back(cc);
+        }
+
+        for (vector<ClientCursor*>::const_iterator i = toDelete.begin(); i != toDelete.end();
+             ++i) {
+            ClientCursor* cc = *i;
+            _deregisterCursor_inlock(&partition, cc);
+            cc->kill();
+            delete cc;
+        }
 
-    for (vector<ClientCursor*>::const_iterator i = toDelete.begin(); i != toDelete.end(); ++i) {
-        ClientCursor* cc = *i;
-        _deregisterCursor_inlock(cc);
-        cc->kill();
-        delete cc;
+        numTimedOut += toDelete.size();
     }
 
-    return toDelete.size();
+    return numTimedOut;
 }
 
 void CursorManager::registerExecutor(PlanExecutor* exec) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    const std::pair<ExecSet::iterator, bool> result = _nonCachedExecutors.insert(exec);
+    Partition& partition = _partitionForExecutor(exec);
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+    const std::pair<ExecSet::iterator, bool> result = partition.nonCachedExecutors.insert(exec);
     invariant(result.second);  // make sure this was inserted
+    partition.numRegistered.fetchAndAdd(1);
 }
 
 void CursorManager::deregisterExecutor(PlanExecutor* exec) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    _nonCachedExecutors.erase(exec);
+    Partition& partition = _partitionForExecutor(exec);
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+    if (partition.nonCachedExecutors.erase(exec)) {
+        partition.numRegistered.fetchAndSubtract(1);
+    }
 }
 
 ClientCursor* CursorManager::find(CursorId id, bool pin) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    CursorMap::const_iterator it = _cursors.find(id);
-    if (it == _cursors.end())
+    Partition& partition = _partitionForCursor(id);
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+    CursorMap::const_iterator it = partition.cursors.find(id);
+    if (it == partition.cursors.end())
         return NULL;
 
     ClientCursor* cursor = it->second;
     if (pin) {
-        uassert(12051, "clientcursor already in use? driver problem?", !cursor->isPinned());
-        cursor->setPinned();
+        uassert(12051, "clientcursor already in use? driver problem?", cursor->trySetPinned());
     }
 
     return cursor;
 }
 
 void CursorManager::unpin(ClientCursor* cursor) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-
+    // The cursor cannot be deleted while it is pinned, and a cursor is only pinned or deleted
+    // under its partition's lock, so it is enough to clear the flag.
     invariant(cursor->isPinned());
     cursor->unsetPinned();
 }
@@ -472,47 +513,69 @@ bool CursorManager::ownsCursorId(CursorId cursorId) const {
 }
 
 void CursorManager::getCursorIds(std::set<CursorId>* openCursors) const {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    for (const Partition& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
-    for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        ClientCursor* cc = i->second;
-        openCursors->insert(cc->cursorid());
+        for (CursorMap::const_iterator i = partition.cursors.begin();
+             i != partition.cursors.end();
+             ++i) {
+            ClientCursor* cc = i->second;
+            openCursors->insert(cc->cursorid());
+        }
     }
 }
 
 size_t CursorManager::numCursors() const {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    return _cursors.size();
+    return _numCursors.load();
 }
 
-CursorId CursorManager::_allocateCursorId_inlock() {
-    for (int i = 0; i < 10000; i++) {
-        unsigned mypart = static_cast<unsigned>(_random->nextInt32());
-        CursorId id = cursorIdFromParts(_collectionCacheRuntimeId, mypart);
-        if (_cursors.count(id) == 0)
-            return id;
-    }
-    fassertFailed(17360);
+CursorManager::Partition& CursorManager::_partitionForCursor(CursorId id) {
+    return _partitions[static_cast<unsigned>(id) % kNumPartitions];
+}
+
+const CursorManager::Partition& CursorManager::_partitionForCursor(CursorId id) const {
+    return _partitions[static_cast<unsigned>(id) % kNumPartitions];
+}
+
+CursorManager::Partition& CursorManager::_partitionForExecutor(PlanExecutor* exec) {
+    // Skip the low bits, which are the same for every executor because of alignment.
+    return _partitions[(reinterpret_cast<uintptr_t>(exec) >> 4) % kNumPartitions];
+}
+
+CursorId CursorManager::_newCursorId() {
+    stdx::lock_guard<SimpleMutex> lk(_randomMutex);
+    unsigned mypart = static_cast<unsigned>(_random->nextInt32());
+    return cursorIdFromParts(_collectionCacheRuntimeId, mypart);
 }
 
 CursorId CursorManager::registerCursor(ClientCursor* cc) {
     invariant(cc);
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    CursorId id = _allocateCursorId_inlock();
-    _cursors[id] = cc;
-    return id;
+    for (int i = 0; i < 10000; i++) {
+        CursorId id = _newCursorId();
+        Partition& partition = _partitionForCursor(id);
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+        if (partition.cursors.insert(std::make_pair(id, cc)).second) {
+            partition.numRegistered.fetchAndAdd(1);
+            _numCursors.fetchAndAdd(1);
+            return id;
+        }
+    }
+    fassertFailed(17360);
 }
 
 void CursorManager::deregisterCursor(ClientCursor* cc) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    _deregisterCursor_inlock(cc);
+    invariant(cc);
+    Partition& partition = _partitionForCursor(cc->cursorid());
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+    _deregisterCursor_inlock(&partition, cc);
 }
 
 Status CursorManager::eraseCursor(OperationContext* txn, CursorId id, bool shouldAudit) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    Partition& partition = _partitionForCursor(id);
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
-    CursorMap::iterator it = _cursors.find(id);
-    if (it == _cursors.end()) {
+    CursorMap::iterator it = partition.cursors.find(id);
+    if (it == partition.cursors.end()) {
         if (shouldAudit) {
             audit::logKillCursorsAuthzCheck(txn->getClient(), _nss, id, ErrorCodes::CursorNotFound);
         }
@@ -534,14 +597,17 @@ Status CursorManager::eraseCursor(OperationContext* txn, CursorId id, bool shoul
     }
 
     cursor->kill();
-    _deregisterCursor_inlock(cursor);
+    _deregisterCursor_inlock(&partition, cursor);
     delete cursor;
     return Status::OK();
 }
 
-void CursorManager::_deregisterCursor_inlock(ClientCursor* cc) {
+void CursorManager::_deregisterCursor_inlock(Partition* partition, ClientCursor* cc) {
     invariant(cc);
     CursorId id = cc->cursorid();
-    _cursors.erase(id);
+    if (partition->cursors.erase(id)) {
+        partition->numRegistered.fetchAndSubtract(1);
+        _numCursors.fetchAndSubtract(1);
+    }
 }
 }
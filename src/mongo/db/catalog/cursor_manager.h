@@ -31,10 +31,13 @@
 #pragma once
 
 
+#include <array>
+
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/invalidation_type.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/record_id.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/unordered_set.h"
 #include "mongo/util/concurrency/mutex.h"
 
@@ -68,6 +71,8 @@ public:
     /**
      * Broadcast a document invalidation to all relevant PlanExecutor(s).  invalidateDocument
      * must called *before* the provided RecordId is about to be deleted or mutated.
+     *
+     * The partitions are notified one at a time, so only the partition being notified is locked.
      */
     void invalidateDocument(OperationContext* txn, const RecordId& dl, InvalidationType type);
 
@@ -126,6 +131,9 @@ public:
      */
     ClientCursor* find(CursorId id, bool pin);
 
+    /**
+     * Marks a cursor returned by a pinning find() as no longer in use.  Does not take any lock.
+     */
     void unpin(ClientCursor* cursor);
 
     // ----------------------
@@ -143,19 +151,42 @@ public:
     static std::size_t timeoutCursorsGlobal(OperationContext* txn, int millisSinceLastCall);
 
 private:
-    CursorId _allocateCursorId_inlock();
-    void _deregisterCursor_inlock(ClientCursor* cc);
+    typedef unordered_set<PlanExecutor*> ExecSet;
+    typedef std::map<CursorId, ClientCursor*> CursorMap;
+
+    /**
+     * The cursors and executors are split across partitions, each with its own lock, so that
+     * operations on different cursors of the same collection do not contend.  A cursor lives in
+     * the partition given by the low bits of its id and an executor in the one given by its
+     * address.
+     */
+    struct Partition {
+        mutable SimpleMutex mutex;
+        ExecSet nonCachedExecutors;
+        CursorMap cursors;
+
+        // Number of executors and cursors registered in this partition.  Written under 'mutex',
+        // read without it to skip empty partitions.
+        AtomicUInt32 numRegistered;
+    };
+
+    static const std::size_t kNumPartitions = 16;
+
+    Partition& _partitionForCursor(CursorId id);
+    const Partition& _partitionForCursor(CursorId id) const;
+    Partition& _partitionForExecutor(PlanExecutor* exec);
+
+    CursorId _newCursorId();
+    void _deregisterCursor_inlock(Partition* partition, ClientCursor* cc);
 
     NamespaceString _nss;
     unsigned _collectionCacheRuntimeId;
-    std::unique_ptr<PseudoRandom> _random;
 
-    mutable SimpleMutex _mutex;
+    SimpleMutex _randomMutex;
+    std::unique_ptr<PseudoRandom> _random;
 
-    typedef unordered_set<PlanExecutor*> ExecSet;
-    ExecSet _nonCachedExecutors;
+    std::array<Partition, kNumPartitions> _partitions;
 
-    typedef std::map<CursorId, ClientCursor*> CursorMap;
-    CursorMap _cursors;
+    AtomicInt64 _numCursors;
 };
 }
@@ -212,6 +212,12 @@ public:
 
     bool isMultikey(OperationContext* txn, const IndexDescriptor* idex);
 
+    /**
+     * Returns the path components of each field of 'idx' which traverse an array, or an empty
+     * vector if the index does not track them. See IndexCatalogEntry::getMultikeyPaths().
+     */
+    MultikeyPaths getMultikeyPaths(OperationContext* txn, const IndexDescriptor* idx);
+
     // --- these probably become private?
 
 
@@ -34,6 +34,8 @@
 
 #include "mongo/db/catalog/index_catalog_entry.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/head_manager.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -97,7 +99,8 @@ void IndexCatalogEntry::init(OperationContext* txn, IndexAccessMethod* accessMet
 
     _isReady = _catalogIsReady(txn);
     _head = _catalogHead(txn);
-    _isMultikey = _catalogIsMultikey(txn);
+    _isMultikey = _catalogIsMultikey(txn, &_indexMultikeyPaths);
+    _indexTracksPathLevelMultikeyInfo = !_indexMultikeyPaths.empty();
 
     BSONElement filterElement = _descriptor->getInfoElement("partialFilterExpression");
     if (filterElement.type()) {
@@ -126,6 +129,11 @@ bool IndexCatalogEntry::isMultikey() const {
     return _isMultikey;
 }
 
+MultikeyPaths IndexCatalogEntry::getMultikeyPaths(OperationContext* txn) const {
+    stdx::lock_guard<stdx::mutex> lk(_indexMultikeyPathsMutex);
+    return _indexMultikeyPaths;
+}
+
 // ---
 
 void IndexCatalogEntry::setIsReady(bool newIsReady) {
@@ -184,8 +192,8 @@ private:
     const std::unique_ptr<RecoveryUnit> _newRecoveryUnit;
 };
 
-void IndexCatalogEntry::setMultikey(OperationContext* txn) {
-    if (isMultikey()) {
+void IndexCatalogEntry::setMultikey(OperationContext* txn, const MultikeyPaths& multikeyPaths) {
+    if (!_hasNewMultikeyInfo(multikeyPaths)) {
         return;
     }
 
@@ -195,7 +203,7 @@ void IndexCatalogEntry::setMultikey(OperationContext* txn) {
 
     // Check again in case we blocked on the MD lock and another thread beat us to setting the
     // multiKey metadata for this index.
-    if (isMultikey()) {
+    if (!_hasNewMultikeyInfo(multikeyPaths)) {
         return;
     }
 
@@ -208,7 +216,9 @@ void IndexCatalogEntry::setMultikey(OperationContext* txn) {
 
         WriteUnitOfWork wuow(txn);
 
-        if (_collection->setIndexIsMultikey(txn, _descriptor->indexName())) {
+        // Cached plans may have used the paths which just became multikey to cover a query, so
+        // the cache must be cleared even if the index already was multikey.
+        if (_collection->setIndexIsMultikey(txn, _descriptor->indexName(), multikeyPaths)) {
             if (_infoCache) {
                 LOG(1) << _ns << ": clearing plan cache - index " << _descriptor->keyPattern()
                        << " set to multi key.";
@@ -219,9 +229,38 @@ void IndexCatalogEntry::setMultikey(OperationContext* txn) {
         wuow.commit();
     }
 
+    if (_indexTracksPathLevelMultikeyInfo) {
+        stdx::lock_guard<stdx::mutex> lk(_indexMultikeyPathsMutex);
+        for (size_t i = 0; i < multikeyPaths.size(); ++i) {
+            _indexMultikeyPaths[i].insert(multikeyPaths[i].begin(), multikeyPaths[i].end());
+        }
+    }
+
     _isMultikey = true;
 }
 
+bool IndexCatalogEntry::_hasNewMultikeyInfo(const MultikeyPaths& multikeyPaths) const {
+    if (!isMultikey()) {
+        return true;
+    }
+
+    if (!_indexTracksPathLevelMultikeyInfo || multikeyPaths.empty()) {
+        return false;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_indexMultikeyPathsMutex);
+    invariant(multikeyPaths.size() == _indexMultikeyPaths.size());
+    for (size_t i = 0; i < multikeyPaths.size(); ++i) {
+        if (!std::includes(_indexMultikeyPaths[i].begin(),
+                           _indexMultikeyPaths[i].end(),
+                           multikeyPaths[i].begin(),
+                           multikeyPaths[i].end())) {
+            return true;
+        }
+    }
+    return false;
+}
+
 // ----
 
 bool IndexCatalogEntry::_catalogIsReady(OperationContext* txn) const {
@@ -232,8 +271,9 @@ RecordId IndexCatalogEntry::_catalogHead(OperationContext* txn) const {
     return _collection->getIndexHead(txn, _descriptor->indexName());
 }
 
-bool IndexCatalogEntry::_catalogIsMultikey(OperationContext* txn) const {
-    return _collection->isIndexMultikey(txn, _descriptor->indexName());
+bool IndexCatalogEntry::_catalogIsMultikey(OperationContext* txn,
+                                           MultikeyPaths* multikeyPaths) const {
+    return _collection->isIndexMultikey(txn, _descriptor->indexName(), multikeyPaths);
 }
 
 // ------------------
@@ -34,8 +34,10 @@
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/ordering.h"
+#include "mongo/db/index/multikey_paths.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/snapshot_name.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
@@ -102,7 +104,19 @@ public:
 
     bool isMultikey() const;
 
-    void setMultikey(OperationContext* txn);
+    /**
+     * Returns the path components of each key pattern field which traverse an array, or an empty
+     * vector if this index does not track them. A field whose set is empty is never an array, so
+     * a multikey index can still provide its values.
+     */
+    MultikeyPaths getMultikeyPaths(OperationContext* txn) const;
+
+    /**
+     * Marks the index as multikey and records 'multikeyPaths', the paths of a document being
+     * indexed which traverse an array, if the index tracks them. Does nothing if the index is
+     * already multikey and already knows all of 'multikeyPaths'.
+     */
+    void setMultikey(OperationContext* txn, const MultikeyPaths& multikeyPaths);
 
     // if this ready is ready for queries
     bool isReady(OperationContext* txn) const;
@@ -123,9 +137,14 @@ private:
     class SetMultikeyChange;
     class SetHeadChange;
 
+    /**
+     * Returns true if marking the index multikey with 'multikeyPaths' would change its metadata.
+     */
+    bool _hasNewMultikeyInfo(const MultikeyPaths& multikeyPaths) const;
+
     bool _catalogIsReady(OperationContext* txn) const;
     RecordId _catalogHead(OperationContext* txn) const;
-    bool _catalogIsMultikey(OperationContext* txn) const;
+    bool _catalogIsMultikey(OperationContext* txn, MultikeyPaths* multikeyPaths) const;
 
     // -----
 
@@ -150,6 +169,15 @@ private:
     RecordId _head;      // cache of IndexDetails
     bool _isMultikey;    // cache of NamespaceDetails info
 
+    // Set to true if the index records which of its paths are multikey.
+    bool _indexTracksPathLevelMultikeyInfo = false;
+
+    // Protects '_indexMultikeyPaths', which is read by the query planner while writers add to it.
+    mutable stdx::mutex _indexMultikeyPathsMutex;
+
+    // Cache of the paths recorded in the catalog. Empty unless '_indexTracksPathLevelMultikeyInfo'.
+    MultikeyPaths _indexMultikeyPaths;
+
     // The earliest snapshot that is allowed to read this index.
     boost::optional<SnapshotName> _minVisibleSnapshot;
 };
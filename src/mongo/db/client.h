@@ -90,6 +90,18 @@ public:
      */
     static void destroy();
 
+    /**
+     * Detaches the Client object stored in TLS for the current thread and returns it, leaving the
+     * current thread without a Client. Used to hand a connection's Client from one worker thread
+     * to another between requests.
+     */
+    static ServiceContext::UniqueClient releaseCurrent();
+
+    /**
+     * Attaches "client" to the current thread, which must not already have a Client.
+     */
+    static void setCurrent(ServiceContext::UniqueClient client);
+
     std::string clientAddress(bool includePort = false) const;
     const std::string& desc() const {
         return _desc;
@@ -111,7 +111,7 @@ ClientCursor::ClientCursor(const Collection* collection)
 void ClientCursor::init() {
     invariant(_cursorManager);
 
-    _isPinned = false;
+    _isPinned.store(false);
     _isNoTimeout = false;
 
     _idleAgeMillis = 0;
@@ -138,7 +138,7 @@ ClientCursor::~ClientCursor() {
         return;
     }
 
-    invariant(!_isPinned);  // Must call unsetPinned() before invoking destructor.
+    invariant(!isPinned());  // Must call unsetPinned() before invoking destructor.
 
     if (_countedYet) {
         _countedYet = false;
@@ -171,7 +171,7 @@ void ClientCursor::kill() {
 
 bool ClientCursor::shouldTimeout(int millis) {
     _idleAgeMillis += millis;
-    if (_isNoTimeout || _isPinned) {
+    if (_isNoTimeout || isPinned()) {
         return false;
     }
     return _idleAgeMillis > cursorTimeoutMillis;
@@ -221,7 +221,6 @@ void ClientCursorPin::release() {
         // kill it.
         deleteUnderlying();
     } else {
-        // Unpin the cursor under the collection cursor manager lock.
         _cursor->cursorManager()->unpin(_cursor);
     }
 
@@ -234,10 +233,9 @@ void ClientCursorPin::deleteUnderlying() {
     // Note the following subtleties of this method's implementation:
     // - We must unpin the cursor before destruction, since it is an error to destroy a pinned
     //   cursor.
-    // - In addition, we must deregister the cursor before unpinning, since it is an
-    //   error to unpin a registered cursor without holding the cursor manager lock (note that
-    //   we can't simply unpin with the cursor manager lock here, since we need to guarantee
-    //   exclusive ownership of the cursor when we are deleting it).
+    // - In addition, we must deregister the cursor before unpinning, since once a registered
+    //   cursor is unpinned another thread may pin it or delete it, and we need to guarantee
+    //   exclusive ownership of the cursor when we are deleting it.
     if (_cursor->cursorManager()) {
         _cursor->cursorManager()->deregisterCursor(_cursor);
         _cursor->kill();
@@ -32,12 +32,14 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/record_id.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/net/message.h"
 
 namespace mongo {
 
 class Collection;
 class CursorManager;
+class QueryShapeMetrics;
 class RecoveryUnit;
 
 /**
@@ -94,22 +96,23 @@ public:
     //
 
     /**
-     * Marks this ClientCursor as in use.  unsetPinned() must be called before the destructor of
-     * this ClientCursor is invoked.
+     * Marks this ClientCursor as in use.  Returns false, leaving the cursor as it is, if it was
+     * already in use.  unsetPinned() must be called before the destructor of this ClientCursor is
+     * invoked.
      */
-    void setPinned() {
-        _isPinned = true;
+    bool trySetPinned() {
+        return !_isPinned.compareAndSwap(false, true);
     }
 
     /**
      * Marks this ClientCursor as no longer in use.
      */
     void unsetPinned() {
-        _isPinned = false;
+        _isPinned.store(false);
     }
 
     bool isPinned() const {
-        return _isPinned;
+        return _isPinned.load();
     }
 
     /**
@@ -182,6 +185,15 @@ public:
         _pos = n;
     }
 
+    // The query shape statistics the getMores of the cursor are recorded into, looked up once by
+    // the find that created it.
+    const std::shared_ptr<QueryShapeMetrics>& getQueryShape() const {
+        return _queryShape;
+    }
+    void setQueryShape(std::shared_ptr<QueryShapeMetrics> queryShape) {
+        _queryShape = std::move(queryShape);
+    }
+
     static long long totalOpen();
 
 private:
@@ -235,8 +247,9 @@ private:
     // Note: This should *not* be set for the internal cursor used as input to an aggregation.
     const bool _isAggCursor;
 
-    // Is this cursor in use?  Defaults to false.
-    bool _isPinned;
+    // Is this cursor in use?  Defaults to false.  Atomic so that a cursor can be unpinned without
+    // taking its CursorManager's lock.
+    AtomicWord<bool> _isPinned;
 
     // Is the "no timeout" flag set on this cursor?  If false, this cursor may be targeted for
     // deletion after an interval of inactivity.  Defaults to false.
@@ -251,6 +264,8 @@ private:
     // TODO: Document.
     uint64_t _leftoverMaxTimeMicros;
 
+    std::shared_ptr<QueryShapeMetrics> _queryShape;
+
     //
     // The underlying execution machinery.
     //
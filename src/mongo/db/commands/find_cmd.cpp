@@ -373,6 +373,7 @@ public:
 
             // Fill out curop based on the results.
             endQueryOp(txn, collection, *cursorExec, dbProfilingLevel, numResults, cursorId);
+            cursor->setQueryShape(CurOp::get(txn)->debug().queryShape);
         } else {
             endQueryOp(txn, collection, *exec, dbProfilingLevel, numResults, cursorId);
         }
@@ -382,6 +382,7 @@ public:
             postExecutionStats.totalKeysExamined - preExecutionStats.totalKeysExamined;
         CurOp::get(txn)->debug().docsExamined =
             postExecutionStats.totalDocsExamined - preExecutionStats.totalDocsExamined;
+        CurOp::get(txn)->debug().queryShape = cursor->getQueryShape();
 
         if (shouldSaveCursorGetMore(state, exec, isCursorTailable(cursor))) {
             respondWithId = request.cursorid;
@@ -19,6 +19,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -29,7 +30,9 @@
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/dbhash.h"
+#include "mongo/db/commands/hot_backup_copier.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/jsobj.h"
@@ -37,15 +40,124 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
 #include "mongo/util/log.h"
+#include "mongo/util/progress_meter.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
 using std::string;
 using std::stringstream;
 
+namespace {
+
+/**
+ * Copies the files of the backup started with 'begin' into options.targetDir, keeping the backup
+ * alive and reporting progress through currentOp until done, then ends the backup.
+ */
+bool copyHotBackup(OperationContext* txn,
+                   StorageEngine* storageEngine,
+                   const BSONObj& begin,
+                   HotBackupCopier::Options options,
+                   BSONObjBuilder& result) {
+    const int64_t token = begin["token"].numberLong();
+    std::vector<std::string> files;
+    for (const auto& file : begin["fileList"].Obj()) {
+        files.push_back(file.String());
+    }
+    options.sourceRoot = begin["dbpath"].String();
+
+    Timer timer;
+    HotBackupCopier copier(options, std::move(files));
+    Status status = copier.start();
+    if (status.isOK()) {
+        ProgressMeter* pm;
+        {
+            stdx::lock_guard<Client> lk(*txn->getClient());
+            pm = &CurOp::get(txn)->setMessage_inlock(
+                "Hot Backup Copy: ", "Hot Backup Copy Progress", copier.totalBytes(), 3);
+            pm->setUnits("bytes");
+        }
+        ProgressMeterHolder progress(*pm);
+
+        long long reported = 0;
+        auto reportProgress = [&] {
+            long long copied = copier.bytesCopied();
+            // Files still being written, like the journal, can end up larger than at the start.
+            if ((unsigned long long)copied > progress->total()) {
+                progress->setTotalWhileRunning(copied);
+            }
+            while (reported < copied) {
+                int n = std::min<long long>(copied - reported, std::numeric_limits<int>::max());
+                progress.hit(n);
+                reported += n;
+            }
+        };
+
+        while (!copier.waitFor(Milliseconds(500))) {
+            reportProgress();
+            Status interrupted = txn->checkForInterruptNoAssert();
+            if (interrupted.isOK()) {
+                // Heartbeat on behalf of the client, which is blocked in this command.
+                interrupted = storageEngine->continueHotBackup(txn, token);
+            }
+            if (!interrupted.isOK()) {
+                copier.cancel();
+                status = interrupted;
+                break;
+            }
+        }
+        reportProgress();
+        if (status.isOK()) {
+            status = copier.getStatus();
+        }
+    }
+
+    if (status.isOK()) {
+        BSONObjBuilder manifest;
+        manifest.append("createdAt", jsTime());
+        manifest.append("dbpath", options.sourceRoot);
+        for (const char* field : {"incremental", "backupId"}) {
+            if (begin.hasField(field)) {
+                manifest.append(begin[field]);
+            }
+        }
+        manifest.append("totalBytes", copier.bytesCopied());
+        manifest.append("files", copier.fileEntries());
+        status = copier.writeManifest(manifest.obj());
+    }
+
+    // Only a complete copy may let the engine archive the journal files it contains.
+    Status endStatus = storageEngine->endHotBackup(txn, token, !status.isOK());
+    if (status.isOK()) {
+        status = endStatus;
+    }
+    if (!status.isOK()) {
+        log() << "hot backup copy to " << options.targetDir << " failed: " << status;
+        return Command::appendCommandStatus(result, status);
+    }
+
+    log() << "hot backup copied " << copier.bytesCopied() << " bytes to " << options.targetDir
+          << " in " << timer.millis() << "ms";
+    for (const auto& elem : begin) {
+        if (elem.fieldNameStringData() != "fileList") {
+            result.append(elem);
+        }
+    }
+    BSONObjBuilder copy(result.subobjStart("copy"));
+    copy.append("targetDir", options.targetDir);
+    copy.append("manifest", options.targetDir + "/" + HotBackupCopier::kManifestFileName);
+    copy.append("files", static_cast<int>(begin["fileList"].Obj().nFields()));
+    copy.append("bytes", copier.bytesCopied());
+    copy.append("durationMillis", timer.millis());
+    copy.done();
+    return true;
+}
+
+}  // namespace
+
 class CmdHotBackup : public Command  {
 public:
     virtual bool slaveOk() const {
@@ -55,7 +167,11 @@ public:
 		return false;
 	}
     virtual void help(stringstream& help) const {
-        help << "hot backup with checkpoint, only support wiredTiger";
+        help << "hot backup with checkpoint, only support wiredTiger\n"
+             << "{hotBackup: 1, stage: 'begin'|'continue'|'end', token: <token>,"
+             << " incremental: <backupId of the previous backup>}\n"
+             << "with copyTo: <dir>, the server copies the files itself and ends the backup,"
+             << " optional copyThreads: <n> (default 4), maxBytesPerSec: <n> (default 0, no limit)";
     }
     virtual void addRequiredPrivileges(const std::string& dbname,
                                        const BSONObj& cmdObj,
@@ -75,21 +191,54 @@ public:
         StorageEngine* storageEngine = getGlobalServiceContext()->getGlobalStorageEngine();
         
         if(stage == "begin") {
-			ScopedTransaction transaction(txn, MODE_X);
-			Lock::GlobalWrite global(txn->lockState());
-			try {
-				// NOTE(deyukong): thie ensures the count and datasize
-				// synced and can be seen by backup checkpoint
-				storageEngine->flushAllFiles(true);
-			} catch (std::exception& e) {
-				LOG(0) << "error doing flushAll: " << e.what();
-				return appendCommandStatus(result, {ErrorCodes::InternalError,
-						str::stream() << "flushAllFiles failed:" << e.what()});
+			// The backup cursor pins a consistent checkpoint by itself, so no lock is taken
+			// here and writes continue while the files are copied.
+			BSONObj incrementalFrom;
+			if (jsobj["incremental"].type() == Object) {
+				incrementalFrom = jsobj["incremental"].Obj();
+			} else if (!jsobj["incremental"].eoo()) {
+				return appendCommandStatus(result, {ErrorCodes::TypeMismatch,
+						"incremental must be the backupId returned by a previous backup"});
+			}
+			const bool copy = !jsobj["copyTo"].eoo();
+			HotBackupCopier::Options copyOptions;
+			if (copy) {
+				if (jsobj["copyTo"].type() != String || jsobj["copyTo"].String().empty()) {
+					return appendCommandStatus(result, {ErrorCodes::TypeMismatch,
+							"copyTo must be a directory path"});
+				}
+				copyOptions.targetDir = jsobj["copyTo"].String();
+				if (!jsobj["copyThreads"].eoo()) {
+					copyOptions.threads = jsobj["copyThreads"].numberInt();
+				}
+				if (copyOptions.threads < 1 || copyOptions.threads > 64) {
+					return appendCommandStatus(result, {ErrorCodes::BadValue,
+							"copyThreads must be between 1 and 64"});
+				}
+				copyOptions.maxBytesPerSec = jsobj["maxBytesPerSec"].numberLong();
+				if (copyOptions.maxBytesPerSec < 0) {
+					return appendCommandStatus(result, {ErrorCodes::BadValue,
+							"maxBytesPerSec must not be negative"});
+				}
 			}
-			auto res = storageEngine->beginHotBackup(txn);
+			if (incrementalFrom.isEmpty()) {
+				try {
+					// NOTE(deyukong): thie ensures the count and datasize
+					// synced and can be seen by backup checkpoint
+					storageEngine->flushAllFiles(true);
+				} catch (std::exception& e) {
+					LOG(0) << "error doing flushAll: " << e.what();
+					return appendCommandStatus(result, {ErrorCodes::InternalError,
+							str::stream() << "flushAllFiles failed:" << e.what()});
+				}
+			}
+			auto res = storageEngine->beginHotBackup(txn, incrementalFrom);
 			if(!res.isOK()) {
 				return appendCommandStatus(result, res.getStatus());
 			}
+			if (copy) {
+				return copyHotBackup(txn, storageEngine, res.getValue(), copyOptions, result);
+			}
 
 			result.appendElements(res.getValue());
 			return true;
@@ -97,8 +246,8 @@ public:
 			auto status = storageEngine->continueHotBackup(txn, token);
 			return appendCommandStatus(result, status);
         } else if(stage == "end") {
-			storageEngine->endHotBackup(txn, token);
-			return appendCommandStatus(result, Status::OK());
+			auto status = storageEngine->endHotBackup(txn, token);
+			return appendCommandStatus(result, status);
         } else {
 			LOG(0) <<  "invaild type: " << stage;       
         }
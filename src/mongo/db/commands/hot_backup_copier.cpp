@@ -0,0 +1,246 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/commands/hot_backup_copier.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <memory>
+
+#include "mongo/util/log.h"
+#include "mongo/util/md5.hpp"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+
+const size_t kChunkSize = 1024 * 1024;
+
+}  // namespace
+
+const char HotBackupCopier::kManifestFileName[] = "backup_manifest.json";
+
+HotBackupCopyThrottle::HotBackupCopyThrottle(long long bytesPerSec)
+    : _bytesPerSec(bytesPerSec), _start(Date_t::now()) {}
+
+void HotBackupCopyThrottle::acquire(size_t bytes) {
+    if (_bytesPerSec <= 0) {
+        return;
+    }
+
+    Date_t due;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _granted += bytes;
+        due = _start + Milliseconds(_granted * 1000 / _bytesPerSec);
+    }
+
+    const Date_t now = Date_t::now();
+    if (due > now) {
+        sleepmillis(durationCount<Milliseconds>(due - now));
+    }
+}
+
+HotBackupCopier::HotBackupCopier(Options options, std::vector<std::string> files)
+    : _options(std::move(options)),
+      _files(std::move(files)),
+      _throttle(_options.maxBytesPerSec),
+      _entries(_files.size()) {}
+
+HotBackupCopier::~HotBackupCopier() {
+    cancel();
+}
+
+Status HotBackupCopier::start() {
+    namespace fs = boost::filesystem;
+
+    try {
+        const fs::path target(_options.targetDir);
+        if (fs::exists(target) && !fs::is_empty(target)) {
+            return Status(ErrorCodes::IllegalOperation,
+                          str::stream() << "backup target " << _options.targetDir
+                                        << " is not empty");
+        }
+        fs::create_directories(target);
+
+        for (const auto& file : _files) {
+            _totalBytes += fs::file_size(file);
+        }
+    } catch (const fs::filesystem_error& e) {
+        return Status(ErrorCodes::FileStreamFailed, e.what());
+    }
+
+    const int threads = std::max(1, std::min<int>(_options.threads, _files.size()));
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _running = threads;
+    for (int i = 0; i < threads; i++) {
+        _threads.emplace_back([this] { _copyFiles(); });
+    }
+    return Status::OK();
+}
+
+bool HotBackupCopier::waitFor(Milliseconds timeout) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    return _finishedCV.wait_for(lk, timeout, [this] { return _running == 0; });
+}
+
+void HotBackupCopier::cancel() {
+    _cancelled.store(true);
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (_joined) {
+        return;
+    }
+    _finishedCV.wait(lk, [this] { return _running == 0; });
+    _joined = true;
+    lk.unlock();
+
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+Status HotBackupCopier::getStatus() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(_running == 0);
+    return _status;
+}
+
+BSONArray HotBackupCopier::fileEntries() const {
+    BSONArrayBuilder arr;
+    for (const auto& entry : _entries) {
+        arr.append(entry);
+    }
+    return arr.arr();
+}
+
+Status HotBackupCopier::writeManifest(const BSONObj& manifest) const {
+    const std::string path = _options.targetDir + "/" + kManifestFileName;
+    std::ofstream out(path.c_str(), std::ios::out | std::ios::trunc);
+    out << manifest.jsonString(Strict, 1) << std::endl;
+    out.close();
+    if (!out) {
+        return Status(ErrorCodes::FileStreamFailed,
+                      str::stream() << "failed to write backup manifest " << path);
+    }
+    return Status::OK();
+}
+
+void HotBackupCopier::_copyFiles() {
+    while (!_cancelled.load()) {
+        const size_t i = _nextFile.fetchAndAdd(1);
+        if (i >= _files.size()) {
+            break;
+        }
+
+        Status status = _copyFile(_files[i], &_entries[i]);
+        if (!status.isOK()) {
+            _setError(status);
+        }
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (--_running == 0) {
+        _finishedCV.notify_all();
+    }
+}
+
+Status HotBackupCopier::_copyFile(const std::string& file, BSONObj* entry) {
+    const std::string prefix = _options.sourceRoot + "/";
+    if (file.compare(0, prefix.size(), prefix) != 0) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << file << " is not under " << _options.sourceRoot);
+    }
+    const std::string relative = file.substr(prefix.size());
+    const boost::filesystem::path target =
+        boost::filesystem::path(_options.targetDir) / relative;
+
+    try {
+        boost::filesystem::create_directories(target.parent_path());
+    } catch (const boost::filesystem::filesystem_error& e) {
+        return Status(ErrorCodes::FileStreamFailed, e.what());
+    }
+
+    std::ifstream in(file.c_str(), std::ios::in | std::ios::binary);
+    if (!in) {
+        return Status(ErrorCodes::FileStreamFailed, str::stream() << "failed to open " << file);
+    }
+    std::ofstream out(target.string().c_str(),
+                      std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return Status(ErrorCodes::FileStreamFailed,
+                      str::stream() << "failed to create " << target.string());
+    }
+
+    md5_state_t md5State;
+    md5_init(&md5State);
+
+    // The last journal file keeps growing while it is copied, so read to its current end
+    // rather than to the size it had when the copy started.
+    std::unique_ptr<char[]> buf(new char[kChunkSize]);
+    long long size = 0;
+    while (in) {
+        if (_cancelled.load()) {
+            return Status(ErrorCodes::Interrupted, "hot backup copy was cancelled");
+        }
+
+        in.read(buf.get(), kChunkSize);
+        const std::streamsize n = in.gcount();
+        if (n <= 0) {
+            break;
+        }
+
+        _throttle.acquire(n);
+        md5_append(&md5State, reinterpret_cast<const md5_byte_t*>(buf.get()), n);
+        out.write(buf.get(), n);
+        if (!out) {
+            return Status(ErrorCodes::FileStreamFailed,
+                          str::stream() << "failed to write " << target.string());
+        }
+        size += n;
+        _bytesCopied.fetchAndAdd(n);
+    }
+    if (in.bad()) {
+        return Status(ErrorCodes::FileStreamFailed, str::stream() << "failed to read " << file);
+    }
+
+    out.close();
+    if (!out) {
+        return Status(ErrorCodes::FileStreamFailed,
+                      str::stream() << "failed to write " << target.string());
+    }
+
+    md5digest digest;
+    md5_finish(&md5State, digest);
+    *entry = BSON("file" << relative << "size" << size << "md5" << digestToString(digest));
+    LOG(1) << "hot backup copied " << relative << " (" << size << " bytes)";
+    return Status::OK();
+}
+
+void HotBackupCopier::_setError(Status status) {
+    _cancelled.store(true);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_status.isOK()) {
+        _status = std::move(status);
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,141 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * Limits the combined rate of the copy threads to a number of bytes per second.
+ */
+class HotBackupCopyThrottle {
+    MONGO_DISALLOW_COPYING(HotBackupCopyThrottle);
+
+public:
+    /**
+     * A 'bytesPerSec' of 0 disables throttling.
+     */
+    explicit HotBackupCopyThrottle(long long bytesPerSec);
+
+    /**
+     * Blocks until 'bytes' more bytes may be copied without exceeding the configured rate.
+     */
+    void acquire(size_t bytes);
+
+private:
+    const long long _bytesPerSec;
+
+    stdx::mutex _mutex;
+    Date_t _start;
+    long long _granted = 0;
+};
+
+/**
+ * Copies the files of a hot backup into a target directory with a pool of threads, computing
+ * the md5 of every file on the way. The files keep their path relative to 'sourceRoot'.
+ *
+ * The copy runs in the background once started; the owner polls it with waitFor(), which lets
+ * it keep the backup alive and report progress in the meantime.
+ */
+class HotBackupCopier {
+    MONGO_DISALLOW_COPYING(HotBackupCopier);
+
+public:
+    static const char kManifestFileName[];
+
+    struct Options {
+        std::string sourceRoot;
+        std::string targetDir;
+        int threads = 4;
+        long long maxBytesPerSec = 0;
+    };
+
+    HotBackupCopier(Options options, std::vector<std::string> files);
+    ~HotBackupCopier();
+
+    /**
+     * Creates the target directory, which must not exist or be empty, and starts the copy.
+     */
+    Status start();
+
+    /**
+     * Waits up to 'timeout' for the copy to finish and returns whether it has.
+     */
+    bool waitFor(Milliseconds timeout);
+
+    /**
+     * Stops copying after the chunk each thread is working on and waits for the threads.
+     */
+    void cancel();
+
+    /**
+     * Valid once the copy has finished: the first error any thread ran into, or OK.
+     */
+    Status getStatus();
+
+    long long bytesCopied() const {
+        return _bytesCopied.load();
+    }
+    long long totalBytes() const {
+        return _totalBytes;
+    }
+
+    /**
+     * Valid once the copy has finished successfully: one {file, size, md5} document per file.
+     */
+    BSONArray fileEntries() const;
+
+    /**
+     * Writes 'manifest' as JSON to kManifestFileName in the target directory.
+     */
+    Status writeManifest(const BSONObj& manifest) const;
+
+private:
+    void _copyFiles();
+    Status _copyFile(const std::string& file, BSONObj* entry);
+    void _setError(Status status);
+
+    const Options _options;
+    const std::vector<std::string> _files;
+    long long _totalBytes = 0;
+
+    HotBackupCopyThrottle _throttle;
+    std::vector<stdx::thread> _threads;
+    std::vector<BSONObj> _entries;  // one per file, each written by the thread copying it
+
+    AtomicUInt32 _nextFile;
+    AtomicInt64 _bytesCopied;
+    AtomicWord<bool> _cancelled;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _finishedCV;
+    int _running = 0;
+    bool _joined = false;
+    Status _status = Status::OK();
+};
+
+}  // namespace mongo
@@ -0,0 +1,161 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+
+#include "mongo/db/commands/hot_backup_copier.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/md5.hpp"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace {
+
+void writeFile(const std::string& path, const std::string& contents) {
+    boost::filesystem::create_directories(boost::filesystem::path(path).parent_path());
+    std::ofstream out(path.c_str(), std::ios::out | std::ios::binary);
+    out << contents;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+std::string makeContents(size_t size, char seed) {
+    std::string contents(size, '\0');
+    for (size_t i = 0; i < size; i++) {
+        contents[i] = static_cast<char>(seed + i * 31);
+    }
+    return contents;
+}
+
+bool runToCompletion(HotBackupCopier* copier) {
+    while (!copier->waitFor(Milliseconds(100))) {
+    }
+    return copier->getStatus().isOK();
+}
+
+TEST(HotBackupCopierTest, CopiesFilesWithChecksums) {
+    unittest::TempDir source("hot_backup_copier_source");
+    unittest::TempDir target("hot_backup_copier_target");
+
+    std::map<std::string, std::string> contents = {
+        {"WiredTiger", "WiredTiger 2.8.1"},
+        {"collection-1.wt", makeContents(3 * 1024 * 1024 + 17, 1)},
+        {"index-2.wt", makeContents(4096, 2)},
+        {"journal/WiredTigerLog.0000000001", makeContents(1024 * 1024, 3)},
+        {"empty.wt", ""},
+    };
+    std::vector<std::string> files;
+    for (const auto& file : contents) {
+        files.push_back(source.path() + "/" + file.first);
+        writeFile(files.back(), file.second);
+    }
+
+    HotBackupCopier::Options options;
+    options.sourceRoot = source.path();
+    options.targetDir = target.path() + "/backup";
+    options.threads = 3;
+    HotBackupCopier copier(options, files);
+    ASSERT_OK(copier.start());
+    ASSERT(runToCompletion(&copier));
+
+    long long totalSize = 0;
+    for (const auto& file : contents) {
+        totalSize += file.second.size();
+    }
+    ASSERT_EQ(totalSize, copier.totalBytes());
+    ASSERT_EQ(totalSize, copier.bytesCopied());
+
+    BSONArray entries = copier.fileEntries();
+    ASSERT_EQ(contents.size(), static_cast<size_t>(entries.nFields()));
+    for (const auto& elem : entries) {
+        BSONObj entry = elem.Obj();
+        const std::string relative = entry["file"].String();
+        ASSERT(contents.count(relative)) << relative;
+
+        const std::string& expected = contents[relative];
+        ASSERT_EQ(static_cast<long long>(expected.size()), entry["size"].numberLong());
+        ASSERT_EQ(md5simpledigest(expected), entry["md5"].String());
+        ASSERT_EQ(expected, readFile(options.targetDir + "/" + relative));
+    }
+
+    ASSERT_OK(copier.writeManifest(BSON("files" << entries)));
+    ASSERT(boost::filesystem::exists(options.targetDir + "/" +
+                                     HotBackupCopier::kManifestFileName));
+}
+
+TEST(HotBackupCopierTest, ThrottlesCombinedRate) {
+    unittest::TempDir source("hot_backup_copier_source");
+    unittest::TempDir target("hot_backup_copier_target");
+
+    std::vector<std::string> files;
+    for (int i = 0; i < 4; i++) {
+        files.push_back(source.path() + "/file-" + std::to_string(i) + ".wt");
+        writeFile(files.back(), makeContents(512 * 1024, i));
+    }
+
+    // 2MB at 4MB/s takes at least half a second however many threads copy it.
+    HotBackupCopier::Options options;
+    options.sourceRoot = source.path();
+    options.targetDir = target.path() + "/backup";
+    options.threads = 4;
+    options.maxBytesPerSec = 4 * 1024 * 1024;
+    HotBackupCopier copier(options, files);
+
+    Timer timer;
+    ASSERT_OK(copier.start());
+    ASSERT(runToCompletion(&copier));
+    ASSERT_GTE(timer.millis(), 450);
+}
+
+TEST(HotBackupCopierTest, RejectsNonEmptyTarget) {
+    unittest::TempDir source("hot_backup_copier_source");
+    unittest::TempDir target("hot_backup_copier_target");
+    writeFile(target.path() + "/leftover", "x");
+
+    HotBackupCopier::Options options;
+    options.sourceRoot = source.path();
+    options.targetDir = target.path();
+    HotBackupCopier copier(options, {});
+    ASSERT_EQUALS(ErrorCodes::IllegalOperation, copier.start());
+}
+
+TEST(HotBackupCopierTest, FailsOnFileOutsideSourceRoot) {
+    unittest::TempDir source("hot_backup_copier_source");
+    unittest::TempDir other("hot_backup_copier_other");
+    unittest::TempDir target("hot_backup_copier_target");
+    writeFile(source.path() + "/a.wt", "a");
+    writeFile(other.path() + "/b.wt", "b");
+
+    HotBackupCopier::Options options;
+    options.sourceRoot = source.path();
+    options.targetDir = target.path() + "/backup";
+    HotBackupCopier copier(options, {source.path() + "/a.wt", other.path() + "/b.wt"});
+    ASSERT_OK(copier.start());
+    ASSERT_FALSE(runToCompletion(&copier));
+    ASSERT_EQUALS(ErrorCodes::BadValue, copier.getStatus());
+}
+
+}  // namespace
+}  // namespace mongo
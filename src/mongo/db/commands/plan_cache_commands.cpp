@@ -35,6 +35,7 @@
 
 #include "mongo/base/init.h"
 #include "mongo/base/status.h"
+#include "mongo/bson/util/bson_extract.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
@@ -239,11 +240,19 @@ Status PlanCacheListQueryShapes::runPlanCacheCommand(OperationContext* txn,
         arrayBuilder.doneFast();
         return Status::OK();
     }
-    return list(*planCache, bob);
+
+    bool includeStats;
+    status = bsonExtractBooleanFieldWithDefault(cmdObj, "stats", false, &includeStats);
+    if (!status.isOK()) {
+        return status;
+    }
+    return list(*planCache, bob, includeStats);
 }
 
 // static
-Status PlanCacheListQueryShapes::list(const PlanCache& planCache, BSONObjBuilder* bob) {
+Status PlanCacheListQueryShapes::list(const PlanCache& planCache,
+                                      BSONObjBuilder* bob,
+                                      bool includeStats) {
     invariant(bob);
 
     // Fetch all cached solutions from plan cache.
@@ -258,6 +267,11 @@ Status PlanCacheListQueryShapes::list(const PlanCache& planCache, BSONObjBuilder
         shapeBuilder.append("query", entry->query);
         shapeBuilder.append("sort", entry->sort);
         shapeBuilder.append("projection", entry->projection);
+        if (includeStats) {
+            BSONObjBuilder statsBuilder(shapeBuilder.subobjStart("stats"));
+            entry->shapeStats->appendTo(&statsBuilder);
+            statsBuilder.doneFast();
+        }
         shapeBuilder.doneFast();
 
         // Release resources for cached solution after extracting query shape.
@@ -106,8 +106,10 @@ private:
 /**
  * planCacheListQueryShapes
  *
- * { planCacheListQueryShapes: <collection> }
+ * { planCacheListQueryShapes: <collection>, stats: <bool> }
  *
+ * With 'stats', each shape also reports how it has used the cache: hits, replans, completed
+ * trial runs, average works per run and the last time it was used.
  */
 class PlanCacheListQueryShapes : public PlanCacheCommand {
 public:
@@ -119,9 +121,12 @@ public:
 
     /**
      * Looks up cache keys for collection's plan cache.
-     * Inserts keys for query into BSON builder.
+     * Inserts keys for query into BSON builder, with the usage counters of each shape if
+     * 'includeStats' is true.
      */
-    static Status list(const PlanCache& planCache, BSONObjBuilder* bob);
+    static Status list(const PlanCache& planCache,
+                       BSONObjBuilder* bob,
+                       bool includeStats = false);
 };
 
 /**
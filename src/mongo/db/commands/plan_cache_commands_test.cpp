@@ -142,6 +142,37 @@ TEST(PlanCacheCommandsTest, planCacheListQueryShapesOneKey) {
     ASSERT_EQUALS(shapes[0].getObjectField("query"), cq->getQueryObj());
     ASSERT_EQUALS(shapes[0].getObjectField("sort"), cq->getParsed().getSort());
     ASSERT_EQUALS(shapes[0].getObjectField("projection"), cq->getParsed().getProj());
+    ASSERT_FALSE(shapes[0].hasField("stats"));
+}
+
+TEST(PlanCacheCommandsTest, planCacheListQueryShapesStats) {
+    auto statusWithCQ = CanonicalQuery::canonicalize(nss, fromjson("{a: 1}"));
+    ASSERT_OK(statusWithCQ.getStatus());
+    unique_ptr<CanonicalQuery> cq = std::move(statusWithCQ.getValue());
+
+    PlanCache planCache;
+    QuerySolution qs;
+    qs.cacheData.reset(createSolutionCacheData());
+    std::vector<QuerySolution*> solns;
+    solns.push_back(&qs);
+    planCache.add(*cq, solns, createDecision(1U));
+
+    CachedSolution* rawCS;
+    ASSERT_OK(planCache.get(*cq, &rawCS));
+    delete rawCS;
+    ASSERT_OK(planCache.noteReplan(*cq));
+
+    BSONObjBuilder bob;
+    ASSERT_OK(PlanCacheListQueryShapes::list(planCache, &bob, true));
+    BSONObj resultObj = bob.obj();
+    vector<BSONElement> shapes = resultObj["shapes"].Array();
+    ASSERT_EQUALS(shapes.size(), 1U);
+    BSONObj stats = shapes[0].Obj().getObjectField("stats");
+    ASSERT_EQUALS(stats["hits"].numberLong(), 1);
+    ASSERT_EQUALS(stats["replans"].numberLong(), 1);
+    ASSERT_EQUALS(stats["runs"].numberLong(), 0);
+    ASSERT_EQUALS(stats["avgWorks"].numberDouble(), 0.0);
+    ASSERT_EQUALS(stats["lastUsed"].type(), Date);
 }
 
 /**
@@ -0,0 +1,112 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/base/init.h"
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/stats/query_shape_stats.h"
+
+namespace {
+
+using namespace mongo;
+
+/**
+ * { queryShapeStats: 1, ns: <string>, limit: <number>, histogram: <bool>, reset: <bool> }
+ *
+ * Lists the query shapes executed by finds and getMores, with their execution counters and
+ * latency percentiles, sorted by decreasing total latency. 'ns' restricts the output to one
+ * collection, 'histogram' adds the latency buckets and 'reset' forgets all shapes after listing
+ * them.
+ */
+class QueryShapeStatsCommand : public Command {
+public:
+    QueryShapeStatsCommand() : Command("queryShapeStats", true) {}
+
+    virtual bool slaveOk() const {
+        return true;
+    }
+    virtual bool adminOnly() const {
+        return true;
+    }
+    virtual bool isWriteCommandForConfigServer() const {
+        return false;
+    }
+    virtual void help(std::stringstream& help) const {
+        help << "execution statistics by query shape, in micros";
+    }
+    virtual void addRequiredPrivileges(const std::string& dbname,
+                                       const BSONObj& cmdObj,
+                                       std::vector<Privilege>* out) {
+        ActionSet actions;
+        actions.addAction(ActionType::top);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+    virtual bool run(OperationContext* txn,
+                     const std::string& db,
+                     BSONObj& cmdObj,
+                     int options,
+                     std::string& errmsg,
+                     BSONObjBuilder& result) {
+        std::string ns;
+        Status status = bsonExtractStringFieldWithDefault(cmdObj, "ns", "", &ns);
+        if (!status.isOK()) {
+            return appendCommandStatus(result, status);
+        }
+
+        long long limit;
+        status = bsonExtractIntegerFieldWithDefault(cmdObj, "limit", 0, &limit);
+        if (!status.isOK()) {
+            return appendCommandStatus(result, status);
+        }
+        if (limit < 0) {
+            return appendCommandStatus(
+                result, Status(ErrorCodes::BadValue, "limit must not be negative"));
+        }
+
+        bool histogram;
+        status = bsonExtractBooleanFieldWithDefault(cmdObj, "histogram", false, &histogram);
+        if (!status.isOK()) {
+            return appendCommandStatus(result, status);
+        }
+
+        bool reset;
+        status = bsonExtractBooleanFieldWithDefault(cmdObj, "reset", false, &reset);
+        if (!status.isOK()) {
+            return appendCommandStatus(result, status);
+        }
+
+        auto& stats = QueryShapeStats::get(txn->getServiceContext());
+        stats.append(&result, ns, limit, histogram);
+        if (reset) {
+            stats.clear();
+        }
+        return true;
+    }
+};
+
+MONGO_INITIALIZER(RegisterQueryShapeStatsCommand)(InitializerContext* context) {
+    new QueryShapeStatsCommand();
+
+    return Status::OK();
+}
+}  // namespace
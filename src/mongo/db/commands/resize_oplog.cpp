@@ -30,6 +30,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/dbhash.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/jsobj.h"
@@ -41,6 +42,7 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/service_context.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/base/status.h"
@@ -78,32 +80,57 @@ public:
             int,
             string& errmsg,
             BSONObjBuilder& result) {
-        StringData dbName("local");
+        const NamespaceString nss("local.oplog.rs");
+        if (!jsobj["size"].isNumber()) {
+            return appendCommandStatus(result, Status(ErrorCodes::InvalidOptions, "invalid size field, size should be a number"));
+        }
+        long long size = jsobj["size"].numberLong();
+        if (size <= 0) {
+            return appendCommandStatus(result, Status(ErrorCodes::InvalidOptions, "invalid size field, size should be positive"));
+        }
+
+        if (!getGlobalServiceContext()->getGlobalStorageEngine()->supportsDocLocking()) {
+            return appendCommandStatus(
+                result,
+                Status(ErrorCodes::CommandNotSupported,
+                       "resizing the oplog is only supported by wiredTiger"));
+        }
+
+        // Oplog writers only take intent locks, so intent locks here keep them running while the
+        // size changes. A shrink is done by the oplog's reclaim thread, which truncates whole
+        // stones in the background and reports its progress in currentOp. Every other change to
+        // the oplog's catalog entry takes an exclusive database lock, so the mutex only has to
+        // order concurrent resizes.
+        stdx::lock_guard<stdx::mutex> resizeLock(_resizeMutex);
         ScopedTransaction transaction(txn, MODE_IX);
-        AutoGetDb autoDb(txn, dbName, MODE_X);
+        AutoGetDb autoDb(txn, nss.db(), MODE_IX);
+        Lock::CollectionLock collLock(txn->lockState(), nss.ns(), MODE_IX);
         Database* const db = autoDb.getDb();
-        Collection* coll = db ? db->getCollection("local.oplog.rs") : nullptr;
+        Collection* coll = db ? db->getCollection(nss) : nullptr;
         if (!coll) {
             return appendCommandStatus(result, Status(ErrorCodes::NamespaceNotFound, "ns does not exist"));
         }
         if (!coll->isCapped()) {
             return appendCommandStatus(result, Status(ErrorCodes::InternalError, "ns does not exist"));
         }
-        if (!jsobj["size"].isNumber()) {
-            return appendCommandStatus(result, Status(ErrorCodes::InvalidOptions, "invalid size field, size should be a number"));
-        }
 
-        long long size = jsobj["size"].numberLong();
+        MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
             WriteUnitOfWork wunit(txn);
-        Status status = coll->getRecordStore()->updateCappedSize(txn, size);
-        if (!status.isOK()) {
-            return appendCommandStatus(result, status);
+            // Persist first, so that a write conflict leaves the record store untouched.
+            coll->getCatalogEntry()->updateCappedSize(txn, size);
+            Status status = coll->getRecordStore()->updateCappedSize(txn, size);
+            if (!status.isOK()) {
+                return appendCommandStatus(result, status);
+            }
+            wunit.commit();
         }
-        CollectionCatalogEntry* entry = coll->getCatalogEntry();
-        entry->updateCappedSize(txn, size);
-        wunit.commit();
+        MONGO_WRITE_CONFLICT_RETRY_LOOP_END(txn, "replSetResizeOplog", nss.ns());
+
         LOG(0) << "resizeOplog success, currentSize:" << size;
         return appendCommandStatus(result, Status::OK());
     }
+
+private:
+    stdx::mutex _resizeMutex;
 } cmdReplSetResizeOplog;
 }
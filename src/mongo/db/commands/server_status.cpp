@@ -50,6 +50,7 @@
 #include "mongo/util/log.h"
 #include "mongo/util/net/hostname_canonicalization_worker.h"
 #include "mongo/util/net/listen.h"
+#include "mongo/util/net/message_compressor_registry.h"
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/ramlog.h"
@@ -282,6 +283,17 @@ public:
     BSONObj generateSection(OperationContext* txn, const BSONElement& configElement) const {
         BSONObjBuilder b;
         networkCounter.append(b);
+        if (serverGlobalParams.serviceExecutor == "reactor") {
+            BSONObjBuilder executor(b.subobjStart("serviceExecutor"));
+            executor.append("executor", serverGlobalParams.serviceExecutor);
+            executor.append("ioThreads", serverGlobalParams.reactorIOThreads);
+            executor.append("workerThreads", serverGlobalParams.reactorWorkerThreads);
+            serviceExecutorCounter.append(executor);
+        }
+        {
+            BSONObjBuilder compression(b.subobjStart("compression"));
+            MessageCompressorRegistry::get().appendStats(&compression);
+        }
         return b.obj();
     }
 
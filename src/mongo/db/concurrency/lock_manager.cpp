@@ -32,11 +32,16 @@
 
 #include <vector>
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 #include "mongo/db/concurrency/lock_manager.h"
 
 #include "mongo/config.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/spin_lock.h"
 #include "mongo/util/log.h"
 #include "mongo/util/stringutils.h"
 #include "mongo/util/timer.h"
@@ -71,6 +76,9 @@ static const int LockConflictsTable[] = {
 // Mask of modes
 const uint64_t intentModes = (1 << MODE_IS) | (1 << MODE_IX);
 
+// How many slots of the fast path table to look at for a resource before giving up
+const unsigned kMaxFastPathProbes = 8;
+
 // Ensure we do not add new modes without updating the conflicts table
 static_assert((sizeof(LockConflictsTable) / sizeof(LockConflictsTable[0])) == LockModesCount,
               "(sizeof(LockConflictsTable) / sizeof(LockConflictsTable[0])) == LockModesCount");
@@ -154,6 +162,8 @@ struct LockHead {
 
         conversionsCount = 0;
         compatibleFirstCount = 0;
+
+        fastPath = NULL;
     }
 
     /**
@@ -164,6 +174,18 @@ struct LockHead {
         return !partitions.empty();
     }
 
+    /**
+     * True iff intent requests may currently be granted through the FastPathLockHead, which
+     * implies that there may be such requests. Must be called with the bucket locked.
+     */
+    bool fastPathOpen() const;
+
+    /**
+     * Opens the FastPathLockHead if the lock has no conflicts and only intent modes as
+     * grantedModes. Must be called with the bucket locked after changing either.
+     */
+    void updateFastPath();
+
     /**
      * Locates the request corresponding to the particular locker or returns NULL. Must be
      * called with the bucket holding this lock head locked.
@@ -194,7 +216,7 @@ struct LockHead {
         request->mode = mode;
         request->lock = this;
         request->partitionedLock = NULL;
-        if (!partitioned()) {
+        if (!partitioned() && !request->fastPathLock) {
             request->recursiveCount = 1;
         }
         // request->partitioned cannot be set to false, as this might be a migration, in
@@ -238,6 +260,12 @@ struct LockHead {
      */
     void migratePartitionedLockHeads();
 
+    /**
+     * Closes the FastPathLockHead and moves all requests granted through it to this lock, which
+     * must itself already be locked.
+     */
+    void migrateFastPathLockHead();
+
     // Methods to maintain the granted queue
     void incGrantedModeCount(LockMode mode) {
         invariant(grantedCounts[mode] >= 0);
@@ -316,6 +344,9 @@ struct LockHead {
     // TODO: Remove this vector and make LockHead a POD
     std::vector<LockManager::Partition*> partitions;
 
+    // The FastPathLockHead assigned to this resource, if any. It outlives the LockHead.
+    FastPathLockHead* fastPath;
+
     //
     // Conversion
     //
@@ -378,6 +409,145 @@ struct PartitionedLockHead {
     LockRequestList grantedList;
 };
 
+/**
+ * The FastPathLockHead is the lock-free counterpart of the PartitionedLockHead. Resources which
+ * are locked in intent modes get one assigned from a fixed table, which is looked up without
+ * any locking. Instead of per-locker partitions, it has a number of cache-line sized stripes,
+ * picked by the CPU on which the requesting thread runs, each with a spin lock and a list of
+ * granted intent requests. An uncontended intent request therefore only touches the table slot
+ * and the cache line of its own CPU's stripe, rather than a bucket or partition mutex shared
+ * with other CPUs.
+ *
+ * As long as the resource's LockHead has no conflicts and only intent modes as grantedModes,
+ * the FastPathLockHead is open. Before a conflicting request is made on the LockHead, it is
+ * closed and all its requests are migrated to the LockHead, just like those of the
+ * PartitionedLockHeads. It is opened again once the conflicting modes are gone.
+ *
+ * The 'open' flag is only written under the resource's bucket mutex and is read under the
+ * stripe's spin lock, so a request either makes it onto a stripe before the migration locks
+ * that stripe, or sees the FastPathLockHead closed and falls back to the LockHead.
+ *
+ * Each stripe must be accessed under its spin lock. May not lock a LockManager bucket while
+ * holding a stripe lock.
+ */
+struct FastPathLockHead {
+    static const unsigned kNumStripes = 16;
+
+    /**
+     * Picks the stripe for a request. The stripe is remembered on the request, because the
+     * thread may have moved to another CPU by the time the request is released.
+     */
+    static unsigned stripeFor(const LockRequest* request) {
+#if defined(__linux__)
+        const int cpu = sched_getcpu();
+        if (cpu >= 0) {
+            return cpu % kNumStripes;
+        }
+#endif
+        return request->locker->getId() % kNumStripes;
+    }
+
+    /**
+     * Grants the intent request on the current CPU's stripe unless the FastPathLockHead is
+     * closed, in which case the request must go through the LockHead.
+     */
+    bool tryGrant(LockRequest* request, LockMode mode) {
+        if (!open.loadRelaxed()) {
+            return false;
+        }
+
+        const unsigned stripe = stripeFor(request);
+        scoped_spinlock scopedLock(stripes[stripe].lock);
+
+        if (!open.loadRelaxed()) {
+            return false;
+        }
+
+        request->lock = NULL;
+        request->partitionedLock = NULL;
+        request->fastPathLock = this;
+        request->fastPathStripe = stripe;
+        request->recursiveCount = 1;
+        request->status = LockRequest::STATUS_GRANTED;
+        request->mode = mode;
+
+        stripes[stripe].grantedList.push_back(request);
+        return true;
+    }
+
+    /**
+     * Removes a request granted by tryGrant, unless it has since been migrated to the LockHead.
+     * Returns whether the request was removed.
+     */
+    bool release(LockRequest* request) {
+        Stripe& stripe = stripes[request->fastPathStripe];
+        scoped_spinlock scopedLock(stripe.lock);
+
+        // Migration assigns the request to the LockHead under this lock
+        if (request->lock) {
+            return false;
+        }
+
+        stripe.grantedList.remove(request);
+        return true;
+    }
+
+    struct Stripe {
+        SpinLock lock;
+
+        // Requests granted on this stripe. Only contains granted requests with intent modes.
+        LockRequestList grantedList;
+    };
+
+    // Hash of the resource to which this slot is assigned, or zero if the slot is still free
+    AtomicUInt64 resourceHash;
+
+    // Non-zero while intent requests may be granted on the stripes. New slots start closed.
+    AtomicUInt32 open;
+
+    // Keeps the stripes off the cache line of the fields above, which every request reads
+    char _pad[64 - sizeof(AtomicUInt64) - sizeof(AtomicUInt32)];
+
+    // Each stripe takes up a cache line of its own
+    struct PaddedStripe : public Stripe {
+        char _pad[64 - sizeof(Stripe)];
+    };
+    PaddedStripe stripes[kNumStripes];
+};
+
+bool LockHead::fastPathOpen() const {
+    return fastPath && fastPath->open.load();
+}
+
+void LockHead::updateFastPath() {
+    if (fastPath) {
+        fastPath->open.store(!(grantedModes & ~intentModes) && !conflictModes ? 1 : 0);
+    }
+}
+
+void LockHead::migrateFastPathLockHead() {
+    invariant(fastPathOpen());
+    // There can't be non-intent modes or conflicts while the fast path is open
+    invariant(!(grantedModes & ~intentModes) && !conflictModes);
+
+    fastPath->open.store(0);
+
+    // Lock each stripe in turn and transfer its requests, if any
+    for (unsigned i = 0; i < FastPathLockHead::kNumStripes; i++) {
+        FastPathLockHead::Stripe& stripe = fastPath->stripes[i];
+        scoped_spinlock scopedLock(stripe.lock);
+
+        while (!stripe.grantedList.empty()) {
+            LockRequest* request = stripe.grantedList._front;
+            stripe.grantedList.remove(request);
+            // Ordering is important here, as the next/prev fields are shared.
+            // Note that newRequest() will preserve the recursiveCount in this case
+            LockResult res = newRequest(request, request->mode);
+            invariant(res == LOCK_OK);  // Lock must still be granted
+        }
+    }
+}
+
 void LockHead::migratePartitionedLockHeads() {
     invariant(partitioned());
     // There can't be non-intent modes or conflicts when the lock is partitioned
@@ -420,9 +590,13 @@ const unsigned LockManager::_numLockBuckets(128);
 // The exact value doesn't appear very important, but should be power of two
 const unsigned LockManager::_numPartitions = 32;
 
+// Enough for the global, flush and metadata resources and the busiest databases and collections
+const unsigned LockManager::_numFastPathLocks = 256;
+
 LockManager::LockManager() {
     _lockBuckets = new LockBucket[_numLockBuckets];
     _partitions = new Partition[_numPartitions];
+    _fastPathLocks = new FastPathLockHead[_numFastPathLocks];
 }
 
 LockManager::~LockManager() {
@@ -435,6 +609,7 @@ LockManager::~LockManager() {
 
     delete[] _lockBuckets;
     delete[] _partitions;
+    delete[] _fastPathLocks;
 }
 
 LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mode) {
@@ -443,21 +618,36 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
 
     request->partitioned = (mode == MODE_IX || mode == MODE_IS);
 
-    // For intent modes, try the PartitionedLockHead
-    if (request->partitioned) {
-        Partition* partition = _getPartition(request);
-        stdx::lock_guard<SimpleMutex> scopedLock(partition->mutex);
+    // Requests which change the queueing policy must go through the LockHead
+    const bool fastPathAllowed =
+        request->partitioned && !request->enqueueAtFront && !request->compatibleFirst;
 
-        // Fast path for intent locks
-        PartitionedLockHead* partitionedLock = partition->find(resId);
+    // For intent modes, try the FastPathLockHead or, if the resource does not have one, the
+    // PartitionedLockHead
+    if (request->partitioned) {
+        FastPathLockHead* fastPathLock = _findFastPathLock(resId);
 
-        if (partitionedLock) {
-            partitionedLock->newRequest(request, mode);
-            return LOCK_OK;
+        if (fastPathLock) {
+            if (fastPathAllowed && fastPathLock->tryGrant(request, mode)) {
+                return LOCK_OK;
+            }
+            // Unsuccessful: the FastPathLockHead is closed because of a conflicting request,
+            // so use regular LockHead.
+        } else {
+            Partition* partition = _getPartition(request);
+            stdx::lock_guard<SimpleMutex> scopedLock(partition->mutex);
+
+            // Fast path for intent locks
+            PartitionedLockHead* partitionedLock = partition->find(resId);
+
+            if (partitionedLock) {
+                partitionedLock->newRequest(request, mode);
+                return LOCK_OK;
+            }
+            // Unsuccessful: there was no PartitionedLockHead yet, so use regular LockHead.
+            // Must not hold any locks. It is OK for requests with intent modes to be on
+            // both a PartitionedLockHead and a regular LockHead, so the race here is benign.
         }
-        // Unsuccessful: there was no PartitionedLockHead yet, so use regular LockHead.
-        // Must not hold any locks. It is OK for requests with intent modes to be on
-        // both a PartitionedLockHead and a regular LockHead, so the race here is benign.
     }
 
     // Use regular LockHead, maybe start partitioning
@@ -466,8 +656,26 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
 
     LockHead* lock = bucket->findOrInsert(resId);
 
-    // Start a partitioned lock if possible
-    if (request->partitioned && !(lock->grantedModes & (~intentModes)) && !lock->conflictModes) {
+    // The FastPathLockHead outlives the LockHead, so a new LockHead has to look it up
+    if (!lock->fastPath) {
+        lock->fastPath = _findFastPathLock(resId);
+        if (!lock->fastPath && request->partitioned) {
+            lock->fastPath = _claimFastPathLock(resId);
+        }
+    }
+
+    const bool intentOnly = !(lock->grantedModes & (~intentModes)) && !lock->conflictModes;
+
+    if (lock->fastPath) {
+        // (Re)open the FastPathLockHead if possible. Nobody else can close it while we hold
+        // the bucket mutex.
+        if (fastPathAllowed && intentOnly) {
+            lock->updateFastPath();
+            invariant(lock->fastPath->tryGrant(request, mode));
+            return LOCK_OK;
+        }
+    } else if (request->partitioned && intentOnly) {
+        // Start a partitioned lock
         Partition* partition = _getPartition(request);
         stdx::lock_guard<SimpleMutex> scopedLock(partition->mutex);
         PartitionedLockHead* partitionedLock = partition->findOrInsert(resId);
@@ -482,8 +690,15 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
         lock->migratePartitionedLockHeads();
     }
 
+    if (lock->fastPathOpen()) {
+        lock->migrateFastPathLockHead();
+    }
+
     request->partitioned = false;
-    return lock->newRequest(request, mode);
+    const LockResult result = lock->newRequest(request, mode);
+    lock->updateFastPath();
+
+    return result;
 }
 
 LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode newMode) {
@@ -512,15 +727,29 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
     LockBucket* bucket = _getBucket(resId);
     stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
 
-    LockBucket::Map::iterator it = bucket->data.find(resId);
-    invariant(it != bucket->data.end());
+    LockHead* lock;
 
-    LockHead* const lock = it->second;
+    if (request->fastPathLock) {
+        // Requests on a FastPathLockHead do not keep the LockHead alive
+        lock = bucket->findOrInsert(resId);
+        if (!lock->fastPath) {
+            lock->fastPath = request->fastPathLock;
+        }
+    } else {
+        LockBucket::Map::iterator it = bucket->data.find(resId);
+        invariant(it != bucket->data.end());
+
+        lock = it->second;
+    }
 
     if (lock->partitioned()) {
         lock->migratePartitionedLockHeads();
     }
 
+    if (lock->fastPathOpen()) {
+        lock->migrateFastPathLockHead();
+    }
+
     // Construct granted mask without our current mode, so that it is not counted as
     // conflicting
     uint32_t grantedModesWithoutCurrentRequest = 0;
@@ -550,12 +779,14 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
 
         lock->conversionsCount++;
         lock->incGrantedModeCount(request->convertMode);
+        lock->updateFastPath();
 
         return LOCK_WAITING;
     } else {  // No conflict, existing request
         lock->incGrantedModeCount(newMode);
         lock->decGrantedModeCount(request->mode);
         request->mode = newMode;
+        lock->updateFastPath();
 
         return LOCK_OK;
     }
@@ -578,12 +809,19 @@ bool LockManager::unlock(LockRequest* request) {
         // thorough the partition mutex. Migrations are expected to be rare.
         invariant(request->status == LockRequest::STATUS_GRANTED ||
                   request->status == LockRequest::STATUS_CONVERTING);
-        Partition* partition = _getPartition(request);
-        stdx::lock_guard<SimpleMutex> scopedLock(partition->mutex);
-        //  Fast path: still partitioned.
-        if (request->partitionedLock) {
-            request->partitionedLock->grantedList.remove(request);
-            return true;
+        if (request->fastPathLock) {
+            // Fast path: still on the FastPathLockHead.
+            if (request->fastPathLock->release(request)) {
+                return true;
+            }
+        } else {
+            Partition* partition = _getPartition(request);
+            stdx::lock_guard<SimpleMutex> scopedLock(partition->mutex);
+            //  Fast path: still partitioned.
+            if (request->partitionedLock) {
+                request->partitionedLock->grantedList.remove(request);
+                return true;
+            }
         }
 
         // not partitioned anymore, fall through to regular case
@@ -798,6 +1036,8 @@ void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
     // with the bitmask on the modes.
     dassert((lock->grantedModes == 0) ^ (lock->grantedList._front != NULL));
     dassert((lock->conflictModes == 0) ^ (lock->conflictList._front != NULL));
+
+    lock->updateFastPath();
 }
 
 LockManager::LockBucket* LockManager::_getBucket(ResourceId resId) const {
@@ -808,6 +1048,39 @@ LockManager::Partition* LockManager::_getPartition(LockRequest* request) const {
     return &_partitions[request->locker->getId() % _numPartitions];
 }
 
+FastPathLockHead* LockManager::_findFastPathLock(ResourceId resId) const {
+    for (unsigned i = 0; i < kMaxFastPathProbes; i++) {
+        FastPathLockHead* fastPathLock = &_fastPathLocks[(resId + i) % _numFastPathLocks];
+
+        const uint64_t resourceHash = fastPathLock->resourceHash.load();
+        if (resourceHash == resId) {
+            return fastPathLock;
+        }
+
+        // Slots are claimed in probe order and never released
+        if (resourceHash == 0) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+FastPathLockHead* LockManager::_claimFastPathLock(ResourceId resId) {
+    for (unsigned i = 0; i < kMaxFastPathProbes; i++) {
+        FastPathLockHead* fastPathLock = &_fastPathLocks[(resId + i) % _numFastPathLocks];
+
+        // Resources in other buckets may be claiming slots at the same time
+        const uint64_t resourceHash = fastPathLock->resourceHash.compareAndSwap(0, resId);
+        if (resourceHash == 0) {
+            return fastPathLock;
+        }
+        invariant(resourceHash != resId);
+    }
+
+    return NULL;
+}
+
 void LockManager::dump() const {
     log() << "Dumping LockManager @ " << static_cast<const void*>(this) << '\n';
 
@@ -1090,6 +1363,9 @@ void LockRequest::initNew(Locker* locker, LockGrantNotification* notify) {
     recursiveCount = 0;
 
     lock = NULL;
+    partitionedLock = NULL;
+    fastPathLock = NULL;
+    fastPathStripe = 0;
     prev = NULL;
     next = NULL;
     status = STATUS_NEW;
@@ -160,6 +160,20 @@ private:
      */
     Partition* _getPartition(LockRequest* request) const;
 
+    /**
+     * Returns the FastPathLockHead assigned to the given resource or NULL if it has not been
+     * assigned one yet. There is no need to hold a lock when calling this function.
+     */
+    FastPathLockHead* _findFastPathLock(ResourceId resId) const;
+
+    /**
+     * Assigns a FastPathLockHead to the given resource and returns it, or returns NULL if all
+     * candidate slots are taken by other resources. The new FastPathLockHead starts out closed.
+     *
+     * MUST be called under the resource's lock bucket mutex.
+     */
+    FastPathLockHead* _claimFastPathLock(ResourceId resId);
+
     /**
      * Prints the contents of a bucket to the log.
      */
@@ -183,6 +197,12 @@ private:
 
     static const unsigned _numPartitions;
     Partition* _partitions;
+
+    // Open-addressed table of FastPathLockHeads. Slots are assigned to resources on first use and
+    // are never released, so the table may fill up, in which case the remaining resources use
+    // the partitions above.
+    static const unsigned _numFastPathLocks;
+    FastPathLockHead* _fastPathLocks;
 };
 
 
@@ -40,6 +40,7 @@ namespace mongo {
 
 class Locker;
 
+struct FastPathLockHead;
 struct LockHead;
 struct PartitionedLockHead;
 
@@ -376,9 +377,9 @@ struct LockRequest {
 
 
     // Pointer to the lock to which this request belongs, or null if this request has not yet
-    // been assigned to a lock or if it belongs to the PartitionedLockHead for locker. The
-    // LockHead should be alive as long as there are LockRequests on it, so it is safe to have
-    // this pointer hanging around.
+    // been assigned to a lock or if it belongs to the PartitionedLockHead for locker or to a
+    // FastPathLockHead. The LockHead should be alive as long as there are LockRequests on it,
+    // so it is safe to have this pointer hanging around.
     LockHead* lock;
 
     // Pointer to the partitioned lock to which this request belongs, or null if it is not
@@ -386,6 +387,14 @@ struct LockRequest {
     // only transition from 'partitionedLock' to 'lock', never the other way around.
     PartitionedLockHead* partitionedLock;
 
+    // Pointer to the FastPathLockHead through which this request was granted, or null. Like
+    // 'partitioned', this is only written by the thread which owns the request and stays set
+    // after the request has been migrated to 'lock'.
+    FastPathLockHead* fastPathLock;
+
+    // Stripe of 'fastPathLock' on which this request was granted.
+    unsigned fastPathStripe;
+
     // The reason intrusive linked list is used instead of the std::list class is to allow
     // for entries to be removed from the middle of the list in O(1) time, if they are known
     // instead of having to search for them and we cannot persist iterators, because the list
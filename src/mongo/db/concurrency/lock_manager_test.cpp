@@ -26,8 +26,20 @@
  *    it in the license file.
  */
 
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include <memory>
+#include <vector>
+
+#include "mongo/config.h"
 #include "mongo/db/concurrency/lock_manager_test_help.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -890,4 +902,155 @@ TEST(LockManager, Fairness) {
     ASSERT(lockMgr.unlock(&requestIX1));
 }
 
+TEST(LockManager, IntentConversionWaitsForIntentLocks) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    MMAPV1LockerImpl locker1;
+    MMAPV1LockerImpl locker2;
+    MMAPV1LockerImpl locker3;
+
+    LockRequestCombo request1(&locker1);
+    LockRequestCombo request2(&locker2);
+    LockRequestCombo request3(&locker3);
+
+    // Both IX requests are granted right away
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request1, MODE_IX));
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request2, MODE_IX));
+
+    // The upgrade conflicts with the other IX request
+    ASSERT(LOCK_WAITING == lockMgr.convert(resId, &request1, MODE_X));
+    ASSERT(request1.numNotifies == 0);
+
+    // New intent requests queue up behind the pending conversion
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &request3, MODE_IS));
+
+    // Freeing the other IX request grants the conversion, but not the IS request
+    ASSERT(lockMgr.unlock(&request2));
+    ASSERT(request1.numNotifies == 1);
+    ASSERT(request1.mode == MODE_X);
+    ASSERT(request3.numNotifies == 0);
+
+    ASSERT(!lockMgr.unlock(&request1));
+    ASSERT(lockMgr.unlock(&request1));
+    ASSERT(request3.numNotifies == 1);
+    ASSERT(request3.lastResult == LOCK_OK);
+
+    // Once the conflicts are gone intent requests are granted right away again
+    ASSERT(lockMgr.unlock(&request3));
+
+    LockRequestCombo request4(&locker2);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request4, MODE_IS));
+    ASSERT(lockMgr.unlock(&request4));
+}
+
+TEST(LockManager, IntentLocksSurviveCleanup) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    MMAPV1LockerImpl locker1;
+    MMAPV1LockerImpl locker2;
+
+    LockRequestCombo request1(&locker1);
+    LockRequestCombo request2(&locker2);
+
+    // Neither request keeps the LockHead alive, so cleanup deletes it
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request1, MODE_IX));
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request2, MODE_IX));
+    lockMgr.cleanupUnusedLocks();
+
+    // The upgrade must still see the other IX request
+    ASSERT(LOCK_WAITING == lockMgr.convert(resId, &request1, MODE_X));
+
+    ASSERT(lockMgr.unlock(&request2));
+    ASSERT(request1.numNotifies == 1);
+    ASSERT(request1.mode == MODE_X);
+
+    ASSERT(!lockMgr.unlock(&request1));
+    ASSERT(lockMgr.unlock(&request1));
+}
+
+TEST(LockManager, IntentLocksExcludeConcurrentX) {
+    AtomicUInt32 intentHolders;
+    AtomicUInt32 exclusiveHolders;
+    AtomicUInt32 violations;
+
+    // Goes through the Locker, which waits for the grant, so it uses the global lock manager
+    std::vector<stdx::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t] {
+            DefaultLockerImpl locker;
+            for (int i = 0; i < 20000; i++) {
+                if (t == 0 && i % 16 == 0) {
+                    invariant(LOCK_OK == locker.lockGlobal(MODE_X));
+                    exclusiveHolders.fetchAndAdd(1);
+                    if (intentHolders.load() != 0) {
+                        violations.fetchAndAdd(1);
+                    }
+                    exclusiveHolders.fetchAndSubtract(1);
+                } else {
+                    invariant(LOCK_OK == locker.lockGlobal(MODE_IX));
+                    intentHolders.fetchAndAdd(1);
+                    if (exclusiveHolders.load() != 0) {
+                        violations.fetchAndAdd(1);
+                    }
+                    intentHolders.fetchAndSubtract(1);
+                }
+                locker.unlockAll();
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(0U, violations.load());
+}
+
+
+// Exercises throughput of uncontended intent lock acquisition on the same resource from a
+// growing number of threads. It is not practical to run this on debug builds.
+#ifndef MONGO_CONFIG_DEBUG_BUILD
+
+TEST(LockManager, PerformanceIntentLocks) {
+    const int kItersPerThread = 200 * 1000;
+    const ResourceId resId(RESOURCE_GLOBAL, ResourceId::SINGLETON_GLOBAL);
+
+    LockManager lockMgr;
+
+    for (int numThreads = 1; numThreads <= 16; numThreads = numThreads * 2) {
+        std::vector<std::unique_ptr<MMAPV1LockerImpl>> lockers;
+        for (int t = 0; t < numThreads; t++) {
+            lockers.emplace_back(new MMAPV1LockerImpl());
+        }
+
+        Timer timer;
+
+        std::vector<stdx::thread> threads;
+        for (int t = 0; t < numThreads; t++) {
+            MMAPV1LockerImpl* locker = lockers[t].get();
+            threads.emplace_back([&lockMgr, &resId, locker] {
+                for (int i = 0; i < kItersPerThread; i++) {
+                    LockRequestCombo request(locker);
+                    const LockMode mode = (i & 1) ? MODE_IX : MODE_IS;
+                    invariant(LOCK_OK == lockMgr.lock(resId, &request, mode));
+                    lockMgr.unlock(&request);
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        const double seconds = static_cast<double>(timer.micros()) / (1000.0 * 1000.0);
+        log() << numThreads << " threads: "
+              << static_cast<long long>(numThreads * kItersPerThread / seconds)
+              << " acquisitions/sec";
+    }
+}
+
+#endif  // MONGO_CONFIG_DEBUG_BUILD
+
 }  // namespace mongo
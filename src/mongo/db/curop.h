@@ -31,6 +31,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/server_options.h"
@@ -47,6 +49,7 @@ class Client;
 class Command;
 class CurOp;
 class OperationContext;
+class QueryShapeMetrics;
 
 /**
  * stores a copy of a bson obj in a fixed size buffer
@@ -171,6 +174,10 @@ public:
 
     bool hasSortStage{false};  // true if the query plan involves an in-memory sort
 
+    // Sorted runs, and their total size in bytes, written to disk by a sort with allowDiskUse.
+    long long sortSpills{-1};
+    long long sortSpilledBytes{-1};
+
     // True if the plan came from the multi-planner (not from the plan cache and not a query with a
     // single solution).
     bool fromMultiPlanner{false};
@@ -178,6 +185,10 @@ public:
     // True if a replan was triggered during the execution of this operation.
     bool replanned{false};
 
+    // Statistics of the query shape run by a find or getMore, which the operation is recorded
+    // into once it has finished. Empty for other operations.
+    std::shared_ptr<QueryShapeMetrics> queryShape;
+
     long long nMatched{-1};   // number of records that match the query
     long long nModified{-1};  // number of records written (no no-ops)
     long long nmoved{-1};     // updates resulted in a move (moves are expensive)
@@ -721,7 +721,7 @@ static void _initAndListen(int listenPort) {
                      "data." << startupWarningsLog;
         }
 
-        getDeleter()->startWorkers();
+        getDeleter()->startWorkers(getDeleterNumWorkers());
 
         restartInProgressIndexesFromLastShutdown(startupOpCtx.get());
 
@@ -34,9 +34,11 @@
 
 #include <boost/filesystem/operations.hpp>
 #include <fstream>
+#include <unordered_set>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/index_create.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/working_set_common.h"
@@ -68,6 +70,8 @@
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -301,16 +305,51 @@ static bool findShardKeyIndexPattern(OperationContext* txn,
     return true;
 }
 
+namespace {
+
+/**
+ * Sleeps until deleting 'numDeleted' documents totalling 'bytesDeleted' bytes in the time measured
+ * by 'timer' is within the rate limits of 'options'. Checks for interrupts while sleeping.
+ */
+void throttleRemoveRange(OperationContext* txn,
+                         const Timer& timer,
+                         const Helpers::RemoveRangeOptions& options,
+                         long long numDeleted,
+                         long long bytesDeleted) {
+    long long targetMillis = 0;
+    if (options.maxDocsPerSec > 0) {
+        targetMillis = numDeleted * 1000 / options.maxDocsPerSec;
+    }
+    if (options.maxBytesPerSec > 0) {
+        targetMillis = std::max(targetMillis, bytesDeleted * 1000 / options.maxBytesPerSec);
+    }
+
+    for (long long waitMillis = targetMillis - timer.millis(); waitMillis > 0;
+         waitMillis = targetMillis - timer.millis()) {
+        txn->checkForInterrupt();
+        sleepmillis(std::min(waitMillis, 100LL));
+    }
+}
+
+}  // namespace
+
 long long Helpers::removeRange(OperationContext* txn,
                                const KeyRange& range,
                                bool maxInclusive,
                                const WriteConcernOptions& writeConcern,
                                RemoveSaver* callback,
                                bool fromMigrate,
-                               bool onlyRemoveOrphanedDocs) {
+                               bool onlyRemoveOrphanedDocs,
+                               const RemoveRangeOptions* options) {
     Timer rangeRemoveTimer;
     const string& ns = range.ns;
 
+    const RemoveRangeOptions defaultOptions;
+    if (!options) {
+        options = &defaultOptions;
+    }
+    const int batchSize = std::max(1, options->batchSize);
+
     // The IndexChunk has a keyPattern that may apply to more than one index - we need to
     // select the index and get the full index keyPattern here.
     BSONObj indexKeyPatternDoc;
@@ -334,23 +373,51 @@ long long Helpers::removeRange(OperationContext* txn,
 
     MONGO_LOG_COMPONENT(1, LogComponent::kSharding)
         << "begin removal of " << min << " to " << max << " in " << ns
-        << " with write concern: " << writeConcern.toBSON() << endl;
+        << " with write concern: " << writeConcern.toBSON() << ", batch size: " << batchSize
+        << endl;
 
+    const NamespaceString nss(ns);
     long long numDeleted = 0;
+    long long bytesDeleted = 0;
+    int writeConflictAttempts = 0;
+    bool done = false;
 
     Milliseconds millisWaitingForReplication{0};
 
-    while (1) {
-        // Scoping for write lock.
-        {
+    // Documents of the current batch already saved by 'callback'.
+    std::unordered_set<RecordId, RecordId::Hasher> savedBatch;
+
+    while (!done) {
+        long long batchDeleted = 0;
+        long long batchBytes = 0;
+
+        try {
+            // Scoping for write lock.
             OldClientWriteContext ctx(txn, ns);
             Collection* collection = ctx.getCollection();
             if (!collection)
                 break;
 
+            if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(nss)) {
+                warning() << "stepped down from primary while deleting chunk; "
+                          << "orphaning data in " << ns << " in range [" << min << ", " << max
+                          << ")";
+                return numDeleted;
+            }
+
+            // In write lock, so will be the most up-to-date version. We should never be able to
+            // turn off the sharding state once enabled, but in the future we might want to.
+            std::shared_ptr<CollectionMetadata> metadataNow;
+            if (onlyRemoveOrphanedDocs) {
+                verify(ShardingState::get(txn)->enabled());
+                metadataNow = ShardingState::get(txn)->getCollectionMetadata(ns);
+            }
+
             IndexDescriptor* desc =
                 collection->getIndexCatalog()->findIndexByKeyPattern(txn, indexKeyPattern.toBSON());
 
+            // The scan does not yield, so the documents it returns stay in place until the batch
+            // is deleted below.
             unique_ptr<PlanExecutor> exec(
                 InternalPlanner::indexScan(txn,
                                            collection,
@@ -361,82 +428,98 @@ long long Helpers::removeRange(OperationContext* txn,
                                            PlanExecutor::YIELD_MANUAL,
                                            InternalPlanner::FORWARD,
                                            InternalPlanner::IXSCAN_FETCH));
-            exec->setYieldPolicy(PlanExecutor::YIELD_AUTO);
-
-            RecordId rloc;
-            BSONObj obj;
-            PlanExecutor::ExecState state;
-            // This may yield so we cannot touch nsd after this.
-            state = exec->getNext(&obj, &rloc);
-            if (PlanExecutor::IS_EOF == state) {
-                break;
-            }
-
-            if (PlanExecutor::FAILURE == state || PlanExecutor::DEAD == state) {
-                warning(LogComponent::kSharding)
-                    << PlanExecutor::statestr(state) << " - cursor error while trying to delete "
-                    << min << " to " << max << " in " << ns << ": "
-                    << WorkingSetCommon::toStatusString(obj)
-                    << ", stats: " << Explain::getWinningPlanStats(exec.get()) << endl;
-                break;
-            }
-
-            verify(PlanExecutor::ADVANCED == state);
-
-            WriteUnitOfWork wuow(txn);
-
-            if (onlyRemoveOrphanedDocs) {
-                // Do a final check in the write lock to make absolutely sure that our
-                // collection hasn't been modified in a way that invalidates our migration
-                // cleanup.
-
-                // We should never be able to turn off the sharding state once enabled, but
-                // in the future we might want to.
-                verify(ShardingState::get(txn)->enabled());
 
-                bool docIsOrphan;
-
-                // In write lock, so will be the most up-to-date version
-                std::shared_ptr<CollectionMetadata> metadataNow =
-                    ShardingState::get(txn)->getCollectionMetadata(ns);
-                if (metadataNow) {
-                    ShardKeyPattern kp(metadataNow->getKeyPattern());
-                    BSONObj key = kp.extractShardKeyFromDoc(obj);
-                    docIsOrphan =
-                        !metadataNow->keyBelongsToMe(key) && !metadataNow->keyIsPending(key);
-                } else {
-                    docIsOrphan = false;
+            std::vector<RecordId> batch;
+            batch.reserve(batchSize);
+            while (static_cast<int>(batch.size()) < batchSize) {
+                RecordId rloc;
+                BSONObj obj;
+                PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
+                if (PlanExecutor::IS_EOF == state) {
+                    done = true;
+                    break;
                 }
 
-                if (!docIsOrphan) {
+                if (PlanExecutor::FAILURE == state || PlanExecutor::DEAD == state) {
                     warning(LogComponent::kSharding)
-                        << "aborting migration cleanup for chunk " << min << " to " << max
-                        << (metadataNow ? (string) " at document " + obj.toString() : "")
-                        << ", collection " << ns << " has changed " << endl;
+                        << PlanExecutor::statestr(state)
+                        << " - cursor error while trying to delete " << min << " to " << max
+                        << " in " << ns << ": " << WorkingSetCommon::toStatusString(obj)
+                        << ", stats: " << Explain::getWinningPlanStats(exec.get()) << endl;
+                    done = true;
                     break;
                 }
-            }
 
-            NamespaceString nss(ns);
-            if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(nss)) {
-                warning() << "stepped down from primary while deleting chunk; "
-                          << "orphaning data in " << ns << " in range [" << min << ", " << max
-                          << ")";
-                return numDeleted;
+                verify(PlanExecutor::ADVANCED == state);
+
+                if (onlyRemoveOrphanedDocs) {
+                    // Do a final check in the write lock to make absolutely sure that our
+                    // collection hasn't been modified in a way that invalidates our migration
+                    // cleanup.
+                    bool docIsOrphan;
+                    if (metadataNow) {
+                        ShardKeyPattern kp(metadataNow->getKeyPattern());
+                        BSONObj key = kp.extractShardKeyFromDoc(obj);
+                        docIsOrphan =
+                            !metadataNow->keyBelongsToMe(key) && !metadataNow->keyIsPending(key);
+                    } else {
+                        docIsOrphan = false;
+                    }
+
+                    if (!docIsOrphan) {
+                        warning(LogComponent::kSharding)
+                            << "aborting migration cleanup for chunk " << min << " to " << max
+                            << (metadataNow ? (string) " at document " + obj.toString() : "")
+                            << ", collection " << ns << " has changed " << endl;
+                        done = true;
+                        break;
+                    }
+                }
+
+                // Save the document before it is deleted, but only once if the batch is retried.
+                if (callback && savedBatch.insert(rloc).second) {
+                    callback->goingToDelete(obj);
+                }
+
+                batch.push_back(rloc);
+                batchBytes += obj.objsize();
             }
 
-            if (callback)
-                callback->goingToDelete(obj);
+            exec.reset();
 
-            collection->deleteDocument(txn, rloc, fromMigrate);
+            WriteUnitOfWork wuow(txn);
+            for (const RecordId& rloc : batch) {
+                collection->deleteDocument(txn, rloc, fromMigrate);
+            }
             wuow.commit();
-            numDeleted++;
+            batchDeleted = batch.size();
+            savedBatch.clear();
+        } catch (const WriteConflictException&) {
+            // Nothing of the batch was deleted, so scan it again from the start of the range.
+            txn->recoveryUnit()->abandonSnapshot();
+            WriteConflictException::logAndBackoff(writeConflictAttempts++, "removeRange", ns);
+            done = false;
+            continue;
+        }
+
+        writeConflictAttempts = 0;
+        numDeleted += batchDeleted;
+        bytesDeleted += batchBytes;
+        if (options->deletedDocs) {
+            options->deletedDocs->fetchAndAdd(batchDeleted);
+        }
+        if (options->deletedBytes) {
+            options->deletedBytes->fetchAndAdd(batchBytes);
+        }
+
+        if (batchDeleted == 0) {
+            break;
         }
 
         // TODO remove once the yielding below that references this timer has been removed
         Timer secondaryThrottleTime;
 
-        if (writeConcern.shouldWaitForOtherNodes() && numDeleted > 0) {
+        if (writeConcern.shouldWaitForOtherNodes()) {
             repl::ReplicationCoordinator::StatusAndDuration replStatus =
                 repl::getGlobalReplicationCoordinator()->awaitReplication(
                     txn,
@@ -450,6 +533,10 @@ long long Helpers::removeRange(OperationContext* txn,
             }
             millisWaitingForReplication += replStatus.duration;
         }
+
+        if (!done) {
+            throttleRemoveRange(txn, rangeRemoveTimer, *options, numDeleted, bytesDeleted);
+        }
     }
 
     if (writeConcern.shouldWaitForOtherNodes())
@@ -457,9 +544,10 @@ long long Helpers::removeRange(OperationContext* txn,
             << "Helpers::removeRangeUnlocked time spent waiting for replication: "
             << durationCount<Milliseconds>(millisWaitingForReplication) << "ms" << endl;
 
-    MONGO_LOG_COMPONENT(1, LogComponent::kSharding) << "end removal of " << min << " to " << max
-                                                    << " in " << ns << " (took "
-                                                    << rangeRemoveTimer.millis() << "ms)" << endl;
+    MONGO_LOG_COMPONENT(1, LogComponent::kSharding)
+        << "end removal of " << min << " to " << max << " in " << ns << " (took "
+        << rangeRemoveTimer.millis() << "ms, deleted " << numDeleted << " documents, "
+        << bytesDeleted << " bytes)" << endl;
 
     return numDeleted;
 }
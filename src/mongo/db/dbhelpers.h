@@ -33,6 +33,7 @@
 
 #include "mongo/db/db.h"
 #include "mongo/db/record_id.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/db/storage/data_protector.h"
 
 namespace mongo {
@@ -52,6 +53,7 @@ struct WriteConcernOptions;
  */
 struct Helpers {
     class RemoveSaver;
+    struct RemoveRangeOptions;
 
     /* ensure the specified index exists.
 
@@ -166,7 +168,9 @@ struct Helpers {
      *
      * Returns -1 when no usable index exists
      *
-     * Does oplog the individual document deletions.
+     * Does oplog the individual document deletions. Documents are deleted in batches, one write
+     * lock acquisition and storage transaction per batch, and the pace of the deletes is limited
+     * according to 'options'.
      * // TODO: Refactor this mechanism, it is growing too large
      */
     static long long removeRange(OperationContext* txn,
@@ -175,7 +179,8 @@ struct Helpers {
                                  const WriteConcernOptions& secondaryThrottle,
                                  RemoveSaver* callback = NULL,
                                  bool fromMigrate = false,
-                                 bool onlyRemoveOrphanedDocs = false);
+                                 bool onlyRemoveOrphanedDocs = false,
+                                 const RemoveRangeOptions* options = NULL);
 
     /**
      * Remove all documents from a collection.
@@ -207,6 +212,22 @@ struct Helpers {
         std::unique_ptr<DataProtector> _protector;
         std::unique_ptr<std::ostream> _out;
     };
+
+    /**
+     * Controls how fast removeRange deletes, and where it reports its progress.
+     */
+    struct RemoveRangeOptions {
+        // Number of documents deleted under one acquisition of the write lock.
+        int batchSize = 1;
+
+        // Ceilings on the number of documents and bytes deleted per second, 0 means unlimited.
+        long long maxDocsPerSec = 0;
+        long long maxBytesPerSec = 0;
+
+        // If set, incremented after every batch with the documents and bytes it deleted.
+        AtomicInt64* deletedDocs = nullptr;
+        AtomicInt64* deletedBytes = nullptr;
+    };
 };
 
 }  // namespace mongo
@@ -203,6 +203,9 @@ Status CachedPlanStage::replan(PlanYieldPolicy* yieldPolicy, bool shouldCache) {
 
     _specificStats.replanned = true;
 
+    // Count the replan against the query shape before the cache entry is evicted or replaced.
+    _collection->infoCache()->getPlanCache()->noteReplan(*_canonicalQuery);
+
     // Use the query planning module to plan the whole query.
     std::vector<QuerySolution*> rawSolutions;
     Status status = QueryPlanner::plan(*_canonicalQuery, _plannerParams, &rawSolutions);
@@ -175,6 +175,7 @@ PlanStage::StageState IndexScan::work(WorkingSetID* out) {
                 break;
 
             case IndexBoundsChecker::MUST_ADVANCE:
+                ++_specificStats.seeks;
                 _scanState = NEED_SEEK;
                 _commonStats.needTime++;
                 return PlanStage::NEED_TIME;
@@ -291,6 +292,8 @@ std::unique_ptr<PlanStageStats> IndexScan::getStats() {
         _specificStats.indexType = "BtreeCursor";  // TODO amName;
 
         _specificStats.indexBounds = _params.bounds.toBSON();
+        _specificStats.skipScanPrefixLen =
+            IndexBoundsBuilder::getSkipScanPrefixLen(_params.bounds);
 
         _specificStats.direction = _params.direction;
     }
@@ -0,0 +1,505 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/parallel_collection_scan.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/scoped_timer.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+using std::unique_ptr;
+using std::vector;
+using stdx::make_unique;
+
+// static
+const char* ParallelCollectionScan::kStageType = "PARALLEL_COLLSCAN";
+
+namespace {
+
+// Each worker gets several ranges, so that a worker which finishes early can take over some of
+// the work of one which is slowed down by a denser part of the collection.
+const size_t kRangesPerWorker = 4;
+
+// A worker hands its documents over in batches of at most this many documents or bytes...
+const size_t kBatchDocs = 1000;
+const size_t kBatchBytes = 1024 * 1024;
+
+// ...and waits while the buffer of its range holds more than this.
+const size_t kMaxBufferedBytes = 4 * kBatchBytes;
+
+// How long a worker waits for a lock, and work() for a document, before checking again whether
+// it should give up or yield.
+const unsigned kLockTimeoutMillis = 100;
+const stdx::chrono::milliseconds kWaitForDataMillis(5);
+
+// Workers running over all parallel collection scans.
+AtomicInt32 activeWorkers;
+
+/**
+ * Reserves up to 'wanted' of the workers allowed by internalQueryExecParallelCollScanMaxWorkers.
+ * Returns 0 if fewer than two are available, as one worker is no better than a CollectionScan.
+ */
+int reserveWorkers(int wanted) {
+    const int limit = internalQueryExecParallelCollScanMaxWorkers.load();
+    int current = activeWorkers.load();
+    while (true) {
+        const int granted = std::min(wanted, limit - current);
+        if (granted < 2) {
+            return 0;
+        }
+        const int previous = activeWorkers.compareAndSwap(current, current + granted);
+        if (previous == current) {
+            return granted;
+        }
+        current = previous;
+    }
+}
+
+/**
+ * Holds the global, database and collection locks in MODE_IS for a worker. Unlike
+ * AutoGetCollectionForRead it gives up after kLockTimeoutMillis: the operation running the stage
+ * holds its own intent locks while it waits for the workers, so a worker queued behind an exclusive
+ * request must be able to let go and check whether it was cancelled.
+ */
+class TimedReadLock {
+    MONGO_DISALLOW_COPYING(TimedReadLock);
+
+public:
+    TimedReadLock(Locker* locker, const NamespaceString& nss)
+        : _locker(locker),
+          _dbId(RESOURCE_DATABASE, nss.db()),
+          _collectionId(RESOURCE_COLLECTION, nss.ns()) {
+        if (_locker->lockGlobal(MODE_IS, kLockTimeoutMillis) != LOCK_OK) {
+            return;
+        }
+        if (_locker->lock(_dbId, MODE_IS, kLockTimeoutMillis) != LOCK_OK) {
+            _locker->unlockAll();
+            return;
+        }
+        if (_locker->lock(_collectionId, MODE_IS, kLockTimeoutMillis) != LOCK_OK) {
+            _locker->unlock(_dbId);
+            _locker->unlockAll();
+            return;
+        }
+        _locked = true;
+    }
+
+    ~TimedReadLock() {
+        if (_locked) {
+            _locker->unlock(_collectionId);
+            _locker->unlock(_dbId);
+            _locker->unlockAll();
+        }
+    }
+
+    bool isLocked() const {
+        return _locked;
+    }
+
+private:
+    Locker* const _locker;
+    const ResourceId _dbId;
+    const ResourceId _collectionId;
+    bool _locked = false;
+};
+
+}  // namespace
+
+ParallelCollectionScan::ParallelCollectionScan(OperationContext* txn,
+                                               const CollectionScanParams& params,
+                                               WorkingSet* workingSet,
+                                               const MatchExpression* filter,
+                                               bool ordered)
+    : PlanStage(kStageType, txn),
+      _workingSet(workingSet),
+      _filter(filter),
+      _params(params),
+      _nss(params.collection->ns()),
+      _ordered(ordered) {
+    invariant(_params.direction == CollectionScanParams::FORWARD);
+    invariant(!_params.tailable);
+    _children.emplace_back(make_unique<CollectionScan>(txn, params, workingSet, filter));
+    _specificStats.ordered = ordered;
+}
+
+ParallelCollectionScan::~ParallelCollectionScan() {
+    _stopWorkers();
+}
+
+// static
+bool ParallelCollectionScan::canUseFilter(const MatchExpression* filter) {
+    if (!filter) {
+        return true;
+    }
+    if (filter->matchType() == MatchExpression::WHERE ||
+        filter->matchType() == MatchExpression::TEXT) {
+        return false;
+    }
+    for (size_t i = 0; i < filter->numChildren(); ++i) {
+        if (!canUseFilter(filter->getChild(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ParallelCollectionScan::_startWorkers() {
+    OperationContext* txn = getOpCtx();
+
+    // The workers need the operation to yield its locks now and then: a DBDirectClient call or a
+    // write lock would keep them from ever getting theirs. Nor can they read from the majority
+    // committed snapshot of the operation.
+    const int dop = internalQueryExecParallelCollScanMaxDOP.load();
+    if (dop < 2 || txn->getClient()->isInDirectClient() || txn->lockState()->isWriteLocked() ||
+        txn->recoveryUnit()->isReadingFromMajorityCommittedSnapshot()) {
+        return;
+    }
+
+    const Collection* collection = _params.collection;
+    const long long minRecords = internalQueryExecParallelCollScanMinRecords.load();
+    if (collection->numRecords(txn) < static_cast<uint64_t>(std::max(0LL, minRecords))) {
+        return;
+    }
+
+    const RecordStore* rs = collection->getRecordStore();
+    if (!rs->getCursorForRange(txn, RecordId(), RecordId())) {
+        return;
+    }
+
+    // Split [first, last] evenly. The first and last ranges are open so that they pick up records
+    // inserted outside of it while the scan runs, like a CollectionScan would.
+    auto first = rs->getCursor(txn, true)->next();
+    auto last = rs->getCursor(txn, false)->next();
+    if (!first || !last) {
+        return;
+    }
+
+    const int workers = reserveWorkers(dop);
+    if (workers == 0) {
+        return;
+    }
+
+    const long long span = last->id.repr() - first->id.repr() + 1;
+    const long long numRanges =
+        std::max(1LL, std::min<long long>(span, workers * kRangesPerWorker));
+    const long long step = span / numRanges;
+    for (long long i = 0; i < numRanges; i++) {
+        RecordId start = (i == 0) ? RecordId() : RecordId(first->id.repr() + i * step);
+        RecordId end =
+            (i == numRanges - 1) ? RecordId() : RecordId(first->id.repr() + (i + 1) * step);
+        _ranges.push_back(make_unique<Range>(std::move(start), std::move(end)));
+    }
+
+    _specificStats.ranges = _ranges.size();
+    _specificStats.workers = workers;
+
+    for (int i = 0; i < workers; i++) {
+        try {
+            _workers.emplace_back([this] { _runWorker(); });
+        } catch (const std::exception& ex) {
+            // The workers which did start can do all of the work.
+            warning() << "could not start parallel collection scan worker: " << ex.what();
+            activeWorkers.subtractAndFetch(workers - i);
+            _specificStats.workers = i;
+            break;
+        }
+    }
+
+    if (_workers.empty()) {
+        _ranges.clear();
+        _specificStats.ranges = 0;
+    }
+}
+
+void ParallelCollectionScan::_runWorker() {
+    Client::initThread("parallelCollScan");
+    auto txn = cc().makeOperationContext();
+
+    while (true) {
+        Range* range;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (_cancelled || _nextRange == _ranges.size()) {
+                break;
+            }
+            range = _ranges[_nextRange++].get();
+        }
+
+        bool keepGoing;
+        try {
+            keepGoing = _scanRange(txn.get(), range);
+        } catch (const DBException& ex) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (_workerStatus.isOK()) {
+                _workerStatus = ex.toStatus();
+            }
+            _dataReady.notify_all();
+            keepGoing = false;
+        }
+
+        if (!keepGoing) {
+            break;
+        }
+    }
+
+    activeWorkers.subtractAndFetch(1);
+}
+
+bool ParallelCollectionScan::_scanRange(OperationContext* txn, Range* range) {
+    RecordId start = range->start;
+    bool done = false;
+    while (!done) {
+        vector<BSONObj> batch;
+        size_t batchBytes = 0;
+        size_t docsTested = 0;
+        {
+            ScopedTransaction transaction(txn, MODE_IS);
+            TimedReadLock lock(txn->lockState(), _nss);
+            if (!lock.isLocked()) {
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                if (_cancelled) {
+                    return false;
+                }
+                continue;
+            }
+
+            Database* db = dbHolder().get(txn, _nss.db());
+            Collection* collection = db ? db->getCollection(_nss) : nullptr;
+            auto cursor = collection
+                ? collection->getRecordStore()->getCursorForRange(txn, start, range->end)
+                : nullptr;
+            uassert(ErrorCodes::QueryPlanKilled,
+                    str::stream() << "collection " << _nss.ns()
+                                  << " was dropped during a parallel collection scan",
+                    cursor);
+
+            try {
+                while (batch.size() < kBatchDocs && batchBytes < kBatchBytes) {
+                    auto record = cursor->next();
+                    if (!record) {
+                        done = true;
+                        break;
+                    }
+                    start = RecordId(record->id.repr() + 1);
+                    ++docsTested;
+
+                    BSONObj obj = record->data.releaseToBson();
+                    if (!_filter || _filter->matchesBSON(obj)) {
+                        batchBytes += obj.objsize();
+                        batch.push_back(obj.getOwned());
+                    }
+                }
+            } catch (const WriteConflictException&) {
+                // Keep what was read so far and carry on from 'start' in a new snapshot.
+            }
+        }
+        txn->recoveryUnit()->abandonSnapshot();
+
+        if (!_deliver(range, std::move(batch), docsTested, done)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ParallelCollectionScan::_deliver(Range* range,
+                                      vector<BSONObj> batch,
+                                      size_t docsTested,
+                                      bool done) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _spaceReady.wait(lk, [&] { return _cancelled || range->bufferedBytes < kMaxBufferedBytes; });
+    if (_cancelled) {
+        return false;
+    }
+
+    for (auto&& obj : batch) {
+        range->bufferedBytes += obj.objsize();
+        range->buffer.push_back(std::move(obj));
+    }
+    range->done = done;
+    _docsTested += docsTested;
+    _dataReady.notify_all();
+    return true;
+}
+
+ParallelCollectionScan::Range* ParallelCollectionScan::_nextReadyRange(bool* eof) {
+    *eof = false;
+    if (_ordered) {
+        while (_currentRange < _ranges.size()) {
+            Range* range = _ranges[_currentRange].get();
+            if (!range->buffer.empty()) {
+                return range;
+            }
+            if (!range->done) {
+                return nullptr;
+            }
+            ++_currentRange;
+        }
+        *eof = true;
+        return nullptr;
+    }
+
+    // Take turns between the ranges so that none of their workers waits on a full buffer for long.
+    bool allDone = true;
+    for (size_t i = 0; i < _ranges.size(); i++) {
+        const size_t index = (_currentRange + i) % _ranges.size();
+        Range* range = _ranges[index].get();
+        if (!range->buffer.empty()) {
+            _currentRange = index + 1;
+            return range;
+        }
+        allDone = allDone && range->done;
+    }
+    *eof = allDone;
+    return nullptr;
+}
+
+PlanStage::StageState ParallelCollectionScan::work(WorkingSetID* out) {
+    ++_commonStats.works;
+
+    // Adds the amount of time taken by work() to executionTimeMillis.
+    ScopedTimer timer(&_commonStats.executionTimeMillis);
+
+    if (!_started) {
+        _started = true;
+        try {
+            _startWorkers();
+        } catch (const WriteConflictException&) {
+            // Reading the bounds of the collection conflicted. Scan it in a single thread.
+            _stopWorkers();
+        }
+    }
+
+    if (_workers.empty()) {
+        StageState state = child()->work(out);
+        if (PlanStage::ADVANCED == state) {
+            ++_commonStats.advanced;
+        } else if (PlanStage::NEED_TIME == state) {
+            ++_commonStats.needTime;
+        } else if (PlanStage::NEED_YIELD == state) {
+            ++_commonStats.needYield;
+        } else if (PlanStage::IS_EOF == state) {
+            _commonStats.isEOF = true;
+        }
+        return state;
+    }
+
+    BSONObj obj;
+    {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        if (!_workerStatus.isOK()) {
+            *out = WorkingSetCommon::allocateStatusMember(_workingSet, _workerStatus);
+            return PlanStage::FAILURE;
+        }
+
+        _specificStats.docsTested = _docsTested;
+
+        bool eof;
+        Range* range = _nextReadyRange(&eof);
+        if (eof) {
+            _commonStats.isEOF = true;
+            return PlanStage::IS_EOF;
+        }
+
+        if (!range) {
+            // Wait a little for the workers, then let the executor yield: while it holds its locks
+            // a pending exclusive request can keep the workers from taking theirs.
+            _dataReady.wait_for(lk, kWaitForDataMillis);
+            ++_commonStats.needTime;
+            return PlanStage::NEED_TIME;
+        }
+
+        obj = std::move(range->buffer.front());
+        range->buffer.pop_front();
+        range->bufferedBytes -= obj.objsize();
+        _spaceReady.notify_all();
+    }
+
+    WorkingSetID id = _workingSet->allocate();
+    WorkingSetMember* member = _workingSet->get(id);
+    member->obj = Snapshotted<BSONObj>(SnapshotId(), std::move(obj));
+    _workingSet->transitionToOwnedObj(id);
+
+    *out = id;
+    ++_commonStats.advanced;
+    return PlanStage::ADVANCED;
+}
+
+bool ParallelCollectionScan::isEOF() {
+    if (!_started) {
+        return false;
+    }
+    if (_workers.empty()) {
+        return child()->isEOF();
+    }
+    return _commonStats.isEOF;
+}
+
+void ParallelCollectionScan::_stopWorkers() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _cancelled = true;
+        _spaceReady.notify_all();
+    }
+    for (auto&& worker : _workers) {
+        worker.join();
+    }
+    _workers.clear();
+}
+
+unique_ptr<PlanStageStats> ParallelCollectionScan::getStats() {
+    // Add a BSON representation of the filter to the stats tree, if there is one.
+    if (NULL != _filter) {
+        BSONObjBuilder bob;
+        _filter->toBSON(&bob);
+        _commonStats.filter = bob.obj();
+    }
+
+    unique_ptr<PlanStageStats> ret =
+        make_unique<PlanStageStats>(_commonStats, STAGE_PARALLEL_COLLSCAN);
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _specificStats.docsTested = _docsTested;
+    }
+    ret->specific = make_unique<ParallelCollectionScanStats>(_specificStats);
+    ret->children.emplace_back(child()->getStats());
+    return ret;
+}
+
+const SpecificStats* ParallelCollectionScan::getSpecificStats() const {
+    return &_specificStats;
+}
+
+}  // namespace mongo
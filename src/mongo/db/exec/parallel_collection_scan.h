@@ -0,0 +1,171 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/db/exec/collection_scan_common.h"
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/plan_stats.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+
+class MatchExpression;
+class WorkingSet;
+class OperationContext;
+
+/**
+ * Scans a collection with several worker threads.
+ *
+ * The RecordId space of the collection is split into ranges which the workers claim one at a
+ * time. Each worker has its own Client and OperationContext, so it reads through its own storage
+ * snapshot, and scans its range with RecordStore::getCursorForRange(), applying the filter as it
+ * goes. The documents which match are buffered per range and returned by work() as owned objects,
+ * either in RecordId order (range after range) or from whichever range has some ready.
+ *
+ * Workers release their locks and snapshot after every batch, which is when they hand the batch
+ * over, so a long scan does not pin a snapshot or block exclusive lock requests.
+ *
+ * The results carry no RecordId and are not read from the snapshot of the calling operation, so
+ * this stage is only planned for reads which need neither (see
+ * QueryPlannerParams::PARALLEL_COLLSCAN). If the collection is small, the record store cannot scan
+ * ranges or no workers are available, the stage runs its CollectionScan child instead.
+ */
+class ParallelCollectionScan final : public PlanStage {
+public:
+    ParallelCollectionScan(OperationContext* txn,
+                           const CollectionScanParams& params,
+                           WorkingSet* workingSet,
+                           const MatchExpression* filter,
+                           bool ordered);
+
+    ~ParallelCollectionScan();
+
+    StageState work(WorkingSetID* out) final;
+    bool isEOF() final;
+
+    StageType stageType() const final {
+        return STAGE_PARALLEL_COLLSCAN;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats() final;
+
+    const SpecificStats* getSpecificStats() const final;
+
+    /**
+     * Returns true if 'filter' can be evaluated by several threads at once. $where cannot, as it
+     * runs in the JavaScript scope of the operation.
+     */
+    static bool canUseFilter(const MatchExpression* filter);
+
+    static const char* kStageType;
+
+private:
+    struct Range {
+        Range(RecordId start, RecordId end) : start(std::move(start)), end(std::move(end)) {}
+
+        // [start, end), a null bound is open.
+        const RecordId start;
+        const RecordId end;
+
+        std::deque<BSONObj> buffer;
+        size_t bufferedBytes = 0;
+
+        // Set when the worker has scanned the whole range.
+        bool done = false;
+    };
+
+    /**
+     * Splits the collection into ranges and starts the workers. Leaves _workers empty if the scan
+     * should run in a single thread.
+     */
+    void _startWorkers();
+
+    /**
+     * Body of a worker thread. Scans ranges until there are none left or the stage is cancelled.
+     */
+    void _runWorker();
+
+    /**
+     * Scans 'range' one batch at a time. Returns false if the stage was cancelled.
+     */
+    bool _scanRange(OperationContext* txn, Range* range);
+
+    /**
+     * Appends a batch to the buffer of 'range', waiting for the buffer to drain below its limit
+     * first. Returns false if the stage was cancelled.
+     */
+    bool _deliver(Range* range, std::vector<BSONObj> batch, size_t docsTested, bool done);
+
+    /**
+     * Returns the range whose buffer work() should take the next document from, or nullptr if none
+     * has one yet. Sets *eof if every range has been returned.
+     */
+    Range* _nextReadyRange(bool* eof);
+
+    void _stopWorkers();
+
+    WorkingSet* const _workingSet;
+
+    // Not owned by us. Shared with the workers, which only read it.
+    const MatchExpression* const _filter;
+
+    const CollectionScanParams _params;
+    const NamespaceString _nss;
+    const bool _ordered;
+
+    bool _started = false;
+    bool _eof = false;
+
+    std::vector<stdx::thread> _workers;
+
+    // Protects everything below, which is shared with the workers.
+    stdx::mutex _mutex;
+
+    // Signalled when a range gets documents or is done, or a worker fails.
+    stdx::condition_variable _dataReady;
+
+    // Signalled when work() drains a buffer or the stage is cancelled.
+    stdx::condition_variable _spaceReady;
+
+    std::vector<std::unique_ptr<Range>> _ranges;
+
+    // The next range for a worker to claim.
+    size_t _nextRange = 0;
+
+    // The range work() is returning documents from.
+    size_t _currentRange = 0;
+
+    bool _cancelled = false;
+
+    // The first error hit by a worker.
+    Status _workerStatus = Status::OK();
+
+    // Documents checked by the workers, copied into _specificStats by the thread running the stage.
+    size_t _docsTested = 0;
+
+    ParallelCollectionScanStats _specificStats;
+};
+
+}  // namespace mongo
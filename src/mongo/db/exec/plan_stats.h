@@ -208,6 +208,27 @@ struct CollectionScanStats : public SpecificStats {
     int direction;
 };
 
+struct ParallelCollectionScanStats : public SpecificStats {
+    ParallelCollectionScanStats() : docsTested(0), workers(0), ranges(0), ordered(false) {}
+
+    SpecificStats* clone() const final {
+        ParallelCollectionScanStats* specific = new ParallelCollectionScanStats(*this);
+        return specific;
+    }
+
+    // How many documents did the workers check against the filter?
+    size_t docsTested;
+
+    // How many worker threads scanned the collection? 0 if the scan ran in a single thread.
+    size_t workers;
+
+    // Into how many RecordId ranges was the collection split?
+    size_t ranges;
+
+    // Were the results returned in RecordId order?
+    bool ordered;
+};
+
 struct CountStats : public SpecificStats {
     CountStats() : nCounted(0), nSkipped(0), trivialCount(false) {}
 
@@ -370,7 +391,9 @@ struct IndexScanStats : public SpecificStats {
           dupsTested(0),
           dupsDropped(0),
           seenInvalidated(0),
-          keysExamined(0) {}
+          keysExamined(0),
+          seeks(0),
+          skipScanPrefixLen(0) {}
 
     SpecificStats* clone() const final {
         IndexScanStats* specific = new IndexScanStats(*this);
@@ -413,6 +436,12 @@ struct IndexScanStats : public SpecificStats {
 
     // Number of entries retrieved from the index during the scan.
     size_t keysExamined;
+
+    // Number of times the scan repositioned its cursor because a key fell outside the bounds.
+    size_t seeks;
+
+    // Number of leading index fields the bounds leave unconstrained and the scan skips across.
+    size_t skipScanPrefixLen;
 };
 
 struct LimitStats : public SpecificStats {
@@ -458,7 +487,7 @@ struct OrStats : public SpecificStats {
 };
 
 struct ProjectionStats : public SpecificStats {
-    ProjectionStats() {}
+    ProjectionStats() : covered(false) {}
 
     SpecificStats* clone() const final {
         ProjectionStats* specific = new ProjectionStats(*this);
@@ -467,10 +496,13 @@ struct ProjectionStats : public SpecificStats {
 
     // Object specifying the projection transformation to apply.
     BSONObj projObj;
+
+    // True if the results are built from the keys of a single index without fetching.
+    bool covered;
 };
 
 struct SortStats : public SpecificStats {
-    SortStats() : forcedFetches(0), memUsage(0), memLimit(0) {}
+    SortStats() : forcedFetches(0), memUsage(0), memLimit(0), spills(0), spilledBytes(0) {}
 
     SpecificStats* clone() const final {
         SortStats* specific = new SortStats(*this);
@@ -491,6 +523,12 @@ struct SortStats : public SpecificStats {
 
     // The pattern according to which we are sorting.
     BSONObj sortPattern;
+
+    // How many sorted runs did we write to disk? Only non-zero with allowDiskUse.
+    size_t spills;
+
+    // The total size of those runs on disk.
+    unsigned long long spilledBytes;
 };
 
 struct MergeSortStats : public SpecificStats {
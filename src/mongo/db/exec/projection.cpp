@@ -242,6 +242,7 @@ unique_ptr<PlanStageStats> ProjectionStage::getStats() {
 
     unique_ptr<ProjectionStats> projStats = make_unique<ProjectionStats>(_specificStats);
     projStats->projObj = _projObj;
+    projStats->covered = ProjectionStageParams::COVERED_ONE_INDEX == _projImpl;
     ret->specific = std::move(projStats);
 
     ret->children.emplace_back(child()->getStats());
@@ -55,6 +55,19 @@ using stdx::make_unique;
 // static
 const char* SortStage::kStageType = "SORT";
 
+namespace {
+
+// Field names of the BSONObj a spilled working set member is serialized to. The RecordId comes
+// first so that SpillComparator can break ties without searching for it.
+const char kSpillLocField[] = "loc";
+const char kSpillObjField[] = "obj";
+const char kSpillTextScoreField[] = "textScore";
+const char kSpillGeoDistanceField[] = "geoDistance";
+const char kSpillIndexKeyField[] = "indexKey";
+const char kSpillGeoNearPointField[] = "geoNearPoint";
+
+}  // namespace
+
 SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p) : pattern(p) {}
 
 bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
@@ -68,6 +81,19 @@ bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
     return lhs.loc < rhs.loc;
 }
 
+SortStage::SpillComparator::SpillComparator(BSONObj p) : pattern(p) {}
+
+int SortStage::SpillComparator::operator()(const SpillSorter::Data& lhs,
+                                           const SpillSorter::Data& rhs) const {
+    int result = lhs.first.woCompare(rhs.first, pattern, false);
+    if (0 != result) {
+        return result;
+    }
+    long long lhsLoc = lhs.second.firstElement().numberLong();
+    long long rhsLoc = rhs.second.firstElement().numberLong();
+    return lhsLoc < rhsLoc ? -1 : (lhsLoc > rhsLoc ? 1 : 0);
+}
+
 SortStage::SortStage(OperationContext* opCtx,
                      const SortStageParams& params,
                      WorkingSet* ws,
@@ -77,6 +103,8 @@ SortStage::SortStage(OperationContext* opCtx,
       _ws(ws),
       _pattern(params.pattern),
       _limit(params.limit),
+      _allowDiskUse(params.allowDiskUse),
+      _tempDir(params.tempDir),
       _sorted(false),
       _resultIterator(_data.end()),
       _memUsage(0) {
@@ -98,7 +126,10 @@ SortStage::~SortStage() {}
 bool SortStage::isEOF() {
     // We're done when our child has no more results, we've sorted the child's results, and
     // we've returned all sorted results.
-    return child()->isEOF() && _sorted && (_data.end() == _resultIterator);
+    if (!child()->isEOF() || !_sorted) {
+        return false;
+    }
+    return _spilledResults ? !_spilledResults->more() : (_data.end() == _resultIterator);
 }
 
 PlanStage::StageState SortStage::work(WorkingSetID* out) {
@@ -109,12 +140,16 @@ PlanStage::StageState SortStage::work(WorkingSetID* out) {
 
     const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes);
     if (_memUsage > maxBytes) {
-        mongoutils::str::stream ss;
-        ss << "Sort operation used more than the maximum " << maxBytes
-           << " bytes of RAM. Add an index, or specify a smaller limit.";
-        Status status(ErrorCodes::OperationFailed, ss);
-        *out = WorkingSetCommon::allocateStatusMember(_ws, status);
-        return PlanStage::FAILURE;
+        if (!_allowDiskUse) {
+            mongoutils::str::stream ss;
+            ss << "Sort operation used more than the maximum " << maxBytes
+               << " bytes of RAM. Add an index, or specify a smaller limit."
+               << " Pass allowDiskUse:true to sort on disk.";
+            Status status(ErrorCodes::OperationFailed, ss);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+            return PlanStage::FAILURE;
+        }
+        spillBuffer();
     }
 
     if (isEOF()) {
@@ -189,8 +224,14 @@ PlanStage::StageState SortStage::work(WorkingSetID* out) {
     }
 
     // Returning results.
-    verify(_resultIterator != _data.end());
     verify(_sorted);
+    if (_spilledResults) {
+        *out = nextSpilledResult();
+        ++_commonStats.advanced;
+        return PlanStage::ADVANCED;
+    }
+
+    verify(_resultIterator != _data.end());
     *out = _resultIterator->wsid;
     _resultIterator++;
 
@@ -233,7 +274,7 @@ unique_ptr<PlanStageStats> SortStage::getStats() {
     _commonStats.isEOF = isEOF();
     const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes);
     _specificStats.memLimit = maxBytes;
-    _specificStats.memUsage = _memUsage;
+    _specificStats.memUsage = _sorter ? _sorter->memUsed() : _memUsage;
     _specificStats.limit = _limit;
     _specificStats.sortPattern = _pattern.getOwned();
 
@@ -268,6 +309,11 @@ const SpecificStats* SortStage::getSpecificStats() const {
  *     sortBuffer() - Copies items from set to vectors.
  */
 void SortStage::addToBuffer(const SortableDataItem& item) {
+    if (_sorter) {
+        addToSorter(item);
+        return;
+    }
+
     // Holds ID of working set member to be freed at end of this function.
     WorkingSetID wsidToFree = WorkingSet::INVALID_ID;
 
@@ -336,6 +382,14 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
 }
 
 void SortStage::sortBuffer() {
+    if (_sorter) {
+        _spilledResults.reset(_sorter->done());
+        _specificStats.spills = _sorter->numFiles();
+        _specificStats.spilledBytes = _sorter->bytesSpilled();
+        _sorter.reset();
+        return;
+    }
+
     if (_limit == 0) {
         const WorkingSetComparator& cmp = *_sortKeyComparator;
         std::sort(_data.begin(), _data.end(), cmp);
@@ -352,4 +406,104 @@ void SortStage::sortBuffer() {
     }
 }
 
+/**
+ * Once spilling starts every buffered item, and every item read from the child afterwards, is
+ * serialized into the Sorter together with its computed data, and its working set member is
+ * freed. The Sorter applies the same limit as the in-memory buffers: with a limit it keeps only
+ * the top items seen so far and only spills when those alone outgrow memory.
+ */
+void SortStage::spillBuffer() {
+    if (!_sorter) {
+        SortOptions opts;
+        opts.limit = _limit;
+        opts.maxMemoryUsageBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes);
+        opts.extSortAllowed = true;
+        opts.tempDir = _tempDir;
+        _sorter.reset(SpillSorter::make(opts, SpillComparator(_sortKeyComparator->pattern)));
+        LOG(1) << "Sort with pattern " << _pattern << " exceeded " << opts.maxMemoryUsageBytes
+               << " bytes, spilling to " << _tempDir;
+    }
+
+    for (const SortableDataItem& item : _data) {
+        addToSorter(item);
+    }
+    _data.clear();
+
+    if (_dataSet) {
+        for (const SortableDataItem& item : *_dataSet) {
+            addToSorter(item);
+        }
+        _dataSet->clear();
+    }
+
+    _memUsage = 0;
+}
+
+void SortStage::addToSorter(const SortableDataItem& item) {
+    WorkingSetMember* member = _ws->get(item.wsid);
+
+    BSONObjBuilder bob;
+    bob.append(kSpillLocField, static_cast<long long>(item.loc.repr()));
+    bob.append(kSpillObjField, member->obj.value());
+    if (member->hasComputed(WSM_COMPUTED_TEXT_SCORE)) {
+        auto score = static_cast<const TextScoreComputedData*>(
+            member->getComputed(WSM_COMPUTED_TEXT_SCORE));
+        bob.append(kSpillTextScoreField, score->getScore());
+    }
+    if (member->hasComputed(WSM_COMPUTED_GEO_DISTANCE)) {
+        auto dist = static_cast<const GeoDistanceComputedData*>(
+            member->getComputed(WSM_COMPUTED_GEO_DISTANCE));
+        bob.append(kSpillGeoDistanceField, dist->getDist());
+    }
+    if (member->hasComputed(WSM_INDEX_KEY)) {
+        auto key = static_cast<const IndexKeyComputedData*>(member->getComputed(WSM_INDEX_KEY));
+        bob.append(kSpillIndexKeyField, key->getKey());
+    }
+    if (member->hasComputed(WSM_GEO_NEAR_POINT)) {
+        auto point =
+            static_cast<const GeoNearPointComputedData*>(member->getComputed(WSM_GEO_NEAR_POINT));
+        bob.append(kSpillGeoNearPointField, point->getPoint());
+    }
+
+    _sorter->add(item.sortKey.getOwned(), bob.obj());
+
+    if (member->hasLoc()) {
+        _wsidByDiskLoc.erase(member->loc);
+    }
+    _ws->free(item.wsid);
+}
+
+WorkingSetID SortStage::nextSpilledResult() {
+    // Data from the Sorter is only valid until its next call, so everything is copied out here.
+    SpillSorter::Data data = _spilledResults->next();
+    const BSONObj& spilled = data.second;
+
+    WorkingSetID id = _ws->allocate();
+    WorkingSetMember* member = _ws->get(id);
+    member->obj = Snapshotted<BSONObj>(SnapshotId(), spilled[kSpillObjField].Obj().getOwned());
+    member->transitionToOwnedObj();
+    member->addComputed(new SortKeyComputedData(data.first));
+
+    BSONElement elt = spilled[kSpillTextScoreField];
+    if (!elt.eoo()) {
+        member->addComputed(new TextScoreComputedData(elt.numberDouble()));
+    }
+    elt = spilled[kSpillGeoDistanceField];
+    if (!elt.eoo()) {
+        member->addComputed(new GeoDistanceComputedData(elt.numberDouble()));
+    }
+    elt = spilled[kSpillIndexKeyField];
+    if (!elt.eoo()) {
+        member->addComputed(new IndexKeyComputedData(elt.Obj()));
+    }
+    elt = spilled[kSpillGeoNearPointField];
+    if (!elt.eoo()) {
+        member->addComputed(new GeoNearPointComputedData(elt.Obj()));
+    }
+    return id;
+}
+
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
@@ -28,8 +28,9 @@
 
 #pragma once
 
-#include <vector>
 #include <set>
+#include <string>
+#include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/sort_key_generator.h"
@@ -37,6 +38,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/sorter/sorter.h"
 #include "mongo/platform/unordered_map.h"
 
 namespace mongo {
@@ -46,7 +48,7 @@ class BtreeKeyGenerator;
 // Parameters that must be provided to a SortStage
 class SortStageParams {
 public:
-    SortStageParams() : collection(NULL), limit(0) {}
+    SortStageParams() : collection(NULL), limit(0), allowDiskUse(false) {}
 
     // Used for resolving RecordIds to BSON
     const Collection* collection;
@@ -56,6 +58,13 @@ public:
 
     // Equal to 0 for no limit.
     size_t limit;
+
+    // If true, data beyond internalQueryExecMaxBlockingSortBytes is spilled to sorted runs in
+    // 'tempDir' instead of failing the query.
+    bool allowDiskUse;
+
+    // Where spilled runs are written. Must be set if 'allowDiskUse' is true.
+    std::string tempDir;
 };
 
 /**
@@ -65,6 +74,11 @@ public:
  *   -- For each field in 'pattern', all inputs in the child must handle a getFieldDotted for that
  *   field.
  *   -- All WSMs produced by the child stage must have the sort key available as WSM computed data.
+ *
+ * If 'allowDiskUse' is set and the buffered data grows past the memory limit, everything buffered
+ * so far and all further input is handed to a Sorter, which writes sorted runs to disk and merges
+ * them once the child is exhausted. Members coming out of the Sorter are owned objects without a
+ * RecordId, the same as members which were fetched because of an invalidation.
  */
 class SortStage final : public PlanStage {
 public:
@@ -106,6 +120,10 @@ private:
     // Equal to 0 for no limit.
     size_t _limit;
 
+    // May we spill to disk once we exceed our memory limit? See SortStageParams.
+    bool _allowDiskUse;
+    std::string _tempDir;
+
     //
     // Data storage
     //
@@ -150,6 +168,38 @@ private:
      */
     void sortBuffer();
 
+    //
+    // Spilling to disk
+    //
+
+    typedef Sorter<BSONObj, BSONObj> SpillSorter;
+
+    // Orders spilled (sort key, member) pairs the same way WorkingSetComparator orders buffered
+    // items.
+    struct SpillComparator {
+        explicit SpillComparator(BSONObj p);
+
+        int operator()(const SpillSorter::Data& lhs, const SpillSorter::Data& rhs) const;
+
+        BSONObj pattern;
+    };
+
+    /**
+     * Moves everything buffered so far into _sorter, creating it if needed, and frees the
+     * corresponding working set members.
+     */
+    void spillBuffer();
+
+    /**
+     * Adds one item to _sorter and frees its working set member.
+     */
+    void addToSorter(const SortableDataItem& item);
+
+    /**
+     * Allocates an owned working set member for the next result of _spilledResults.
+     */
+    WorkingSetID nextSpilledResult();
+
     // Comparator for data buffer
     // Initialization follows sort key generator
     std::unique_ptr<WorkingSetComparator> _sortKeyComparator;
@@ -172,6 +222,13 @@ private:
     typedef unordered_map<RecordId, WorkingSetID, RecordId::Hasher> DataMap;
     DataMap _wsidByDiskLoc;
 
+    // Set once the buffered data has outgrown memory and 'allowDiskUse' is set. From then on
+    // input goes straight into the Sorter rather than into _data or _dataSet.
+    std::unique_ptr<SpillSorter> _sorter;
+
+    // Merged output of _sorter, replacing _resultIterator when we spilled.
+    std::unique_ptr<SpillSorter::Iterator> _spilledResults;
+
     SortStats _specificStats;
 
     // The usage in bytes of all buffered data that we're sorting.
@@ -34,7 +34,9 @@
 
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/json.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 
 using namespace mongo;
@@ -246,4 +248,124 @@ TEST(SortStageTest, SortDescendingWithLimitOfOne) {
     testWork("{a: -1}", "{}", 1, "{input: [{a: 2}, {a: 1}, {a: 3}]}", "{output: [{a: 3}]}");
 }
 
+//
+// Spilling to disk
+// With allowDiskUse, input beyond internalQueryExecMaxBlockingSortBytes is written out as sorted
+// runs which are merged when the child is exhausted.
+//
+
+/**
+ * Lowers the blocking sort memory limit for the lifetime of the object.
+ */
+class MaxBlockingSortBytesGuard {
+public:
+    explicit MaxBlockingSortBytesGuard(int bytes)
+        : _saved(internalQueryExecMaxBlockingSortBytes.load()) {
+        internalQueryExecMaxBlockingSortBytes.store(bytes);
+    }
+    ~MaxBlockingSortBytesGuard() {
+        internalQueryExecMaxBlockingSortBytes.store(_saved);
+    }
+
+private:
+    const int _saved;
+};
+
+/**
+ * Sorts 'numDocs' documents of the form {a: <permuted 0..numDocs-1>, pad: <string>} on {a: 1}
+ * with a 16KB memory limit. Appends the 'a' values of the results to 'out' and returns the final
+ * state of the stage along with its stats.
+ */
+PlanStage::StageState runSpillingSort(int numDocs,
+                                      size_t limit,
+                                      bool allowDiskUse,
+                                      std::vector<int>* out,
+                                      SortStats* statsOut) {
+    MaxBlockingSortBytesGuard guard(16 * 1024);
+    unittest::TempDir tempDir("sort_stage_spill");
+
+    WorkingSet ws;
+    auto queuedDataStage = stdx::make_unique<QueuedDataStage>(nullptr, &ws);
+    const std::string pad(100, 'x');
+    for (int i = 0; i < numDocs; ++i) {
+        WorkingSetID id = ws.allocate();
+        WorkingSetMember* wsm = ws.get(id);
+        BSONObj obj = BSON("a" << (i * 7919) % numDocs << "pad" << pad);
+        wsm->obj = Snapshotted<BSONObj>(SnapshotId(), obj);
+        wsm->transitionToOwnedObj();
+        queuedDataStage->pushBack(id);
+    }
+
+    SortStageParams params;
+    params.pattern = BSON("a" << 1);
+    params.limit = limit;
+    params.allowDiskUse = allowDiskUse;
+    params.tempDir = tempDir.path();
+
+    auto sortKeyGen = stdx::make_unique<SortKeyGeneratorStage>(
+        nullptr, queuedDataStage.release(), &ws, params.pattern, BSONObj());
+    SortStage sort(nullptr, params, &ws, sortKeyGen.release());
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    PlanStage::StageState state = PlanStage::NEED_TIME;
+    while (state == PlanStage::NEED_TIME || state == PlanStage::ADVANCED) {
+        state = sort.work(&id);
+        if (state == PlanStage::ADVANCED) {
+            WorkingSetMember* member = ws.get(id);
+            ASSERT_TRUE(member->hasComputed(WSM_SORT_KEY));
+            out->push_back(member->obj.value()["a"].numberInt());
+            ws.free(id);
+        }
+    }
+
+    *statsOut = *static_cast<const SortStats*>(sort.getSpecificStats());
+    return state;
+}
+
+TEST(SortStageTest, SortFailsWhenOverMemoryLimitWithoutAllowDiskUse) {
+    std::vector<int> results;
+    SortStats stats;
+    ASSERT_EQUALS(PlanStage::FAILURE, runSpillingSort(2000, 0, false, &results, &stats));
+    ASSERT_EQUALS(0U, stats.spills);
+}
+
+TEST(SortStageTest, SortSpillsToDiskWithAllowDiskUse) {
+    std::vector<int> results;
+    SortStats stats;
+    ASSERT_EQUALS(PlanStage::IS_EOF, runSpillingSort(2000, 0, true, &results, &stats));
+
+    ASSERT_EQUALS(2000U, results.size());
+    for (int i = 0; i < 2000; ++i) {
+        ASSERT_EQUALS(i, results[i]);
+    }
+    ASSERT_GREATER_THAN(stats.spills, 1U);
+    ASSERT_GREATER_THAN(stats.spilledBytes, 0U);
+}
+
+TEST(SortStageTest, SortSpillsToDiskWithAllowDiskUseAndLimit) {
+    // Each kept document is ~130 bytes, so a limit of 500 does not fit in 16KB either.
+    std::vector<int> results;
+    SortStats stats;
+    ASSERT_EQUALS(PlanStage::IS_EOF, runSpillingSort(2000, 500, true, &results, &stats));
+
+    ASSERT_EQUALS(500U, results.size());
+    for (int i = 0; i < 500; ++i) {
+        ASSERT_EQUALS(i, results[i]);
+    }
+    ASSERT_GREATER_THAN(stats.spills, 0U);
+}
+
+TEST(SortStageTest, SortWithSmallLimitDoesNotSpill) {
+    // The top-K buffer stays under the memory limit, so nothing is written to disk.
+    std::vector<int> results;
+    SortStats stats;
+    ASSERT_EQUALS(PlanStage::IS_EOF, runSpillingSort(2000, 10, true, &results, &stats));
+
+    ASSERT_EQUALS(10U, results.size());
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQUALS(i, results[i]);
+    }
+    ASSERT_EQUALS(0U, stats.spills);
+}
+
 }  // namespace
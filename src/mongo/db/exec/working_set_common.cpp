@@ -114,7 +114,7 @@ bool WorkingSetCommon::fetch(OperationContext* txn,
         invariant(!member->keyData.empty());
         for (size_t i = 0; i < member->keyData.size(); i++) {
             BSONObjSet keys;
-            member->keyData[i].index->getKeys(member->obj.value(), &keys);
+            member->keyData[i].index->getKeys(member->obj.value(), &keys, nullptr);
             if (!keys.count(member->keyData[i].keyData)) {
                 // document would no longer be at this position in the index.
                 return false;
@@ -41,10 +41,12 @@
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/controller.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/operation_context.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/query_shape_stats.h"
 #include "mongo/db/storage/storage_options.h"
 
 namespace mongo {
@@ -286,6 +288,20 @@ private:
     Command* _command;
 };
 
+/**
+ * Collects the execution statistics of the query shapes with the highest total latency.
+ */
+class FTDCQueryShapeStatsCollector final : public FTDCCollectorInterface {
+public:
+    void collect(OperationContext* txn, BSONObjBuilder& builder) override {
+        QueryShapeStats::get(txn->getServiceContext()).appendForFTDC(&builder);
+    }
+
+    std::string name() const override {
+        return "queryShapeStats";
+    }
+};
+
 }  // namespace
 
 
@@ -315,6 +331,9 @@ void startFTDC() {
     controller->addPeriodicCollector(stdx::make_unique<FTDCSimpleInternalCommandCollector>(
         "serverStatus", "serverStatus", "", BSON("tcMalloc" << true)));
 
+    // QueryShapeStats
+    controller->addPeriodicCollector(stdx::make_unique<FTDCQueryShapeStatsCollector>());
+
     // These metrics are only collected if replication is enabled
     if (repl::getGlobalReplicationCoordinator()->getReplicationMode() !=
         repl::ReplicationCoordinator::modeNone) {
@@ -54,7 +54,9 @@ private:
     // This really gets the 'locs' from the provided obj.
     void getKeys(const BSONObj& obj, std::vector<BSONObj>& locs) const;
 
-    virtual void getKeys(const BSONObj& obj, BSONObjSet* keys) const;
+    virtual void getKeys(const BSONObj& obj,
+                         BSONObjSet* keys,
+                         MultikeyPaths* multikeyPaths) const;
 
     TwoDIndexingParams _params;
 };
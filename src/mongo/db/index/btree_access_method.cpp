@@ -61,8 +61,10 @@ BtreeAccessMethod::BtreeAccessMethod(IndexCatalogEntry* btreeState, SortedDataIn
     }
 }
 
-void BtreeAccessMethod::getKeys(const BSONObj& obj, BSONObjSet* keys) const {
-    _keyGenerator->getKeys(obj, keys);
+void BtreeAccessMethod::getKeys(const BSONObj& obj,
+                                BSONObjSet* keys,
+                                MultikeyPaths* multikeyPaths) const {
+    _keyGenerator->getKeys(obj, keys, multikeyPaths);
 }
 
 }  // namespace mongo
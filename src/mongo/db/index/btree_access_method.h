@@ -48,7 +48,9 @@ public:
     BtreeAccessMethod(IndexCatalogEntry* btreeState, SortedDataInterface* btree);
 
 private:
-    virtual void getKeys(const BSONObj& obj, BSONObjSet* keys) const;
+    virtual void getKeys(const BSONObj& obj,
+                         BSONObjSet* keys,
+                         MultikeyPaths* multikeyPaths) const;
 
     // Our keys differ for V0 and V1.
     std::unique_ptr<BtreeKeyGenerator> _keyGenerator;
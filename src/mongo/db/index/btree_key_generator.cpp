@@ -26,8 +26,11 @@
 *    it in the license file.
 */
 
-#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/index/btree_key_generator.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
@@ -43,6 +46,17 @@ const BSONElement nullElt = nullObj.firstElement();
 const BSONObj undefinedObj = BSON("" << BSONUndefined);
 const BSONElement undefinedElt = undefinedObj.firstElement();
 
+/**
+ * Returns the component of the indexed path 'fullPath' which holds an array, given the part of
+ * the path 'remainingPath' which is left to traverse below that array. Both point into the same
+ * field name, since path traversal only ever advances through it.
+ */
+size_t arrayComponent(const char* fullPath, const char* remainingPath) {
+    size_t component = std::count(fullPath, remainingPath, '.');
+    // Unless the array is the last component, the traversal consumed the dot after it as well.
+    return *remainingPath == '\0' ? component : component - 1;
+}
+
 }  // namespace
 
 BtreeKeyGenerator::BtreeKeyGenerator(std::vector<const char*> fieldNames,
@@ -58,8 +72,15 @@ BtreeKeyGenerator::BtreeKeyGenerator(std::vector<const char*> fieldNames,
     _isIdIndex = fieldNames.size() == 1 && std::string("_id") == fieldNames[0];
 }
 
-void BtreeKeyGenerator::getKeys(const BSONObj& obj, BSONObjSet* keys) const {
+void BtreeKeyGenerator::getKeys(const BSONObj& obj,
+                                BSONObjSet* keys,
+                                MultikeyPaths* multikeyPaths) const {
     if (_isIdIndex) {
+        // The _id field can't be an array, so it never makes the index multikey.
+        if (multikeyPaths) {
+            multikeyPaths->assign(1, std::set<size_t>());
+        }
+
         // we special case for speed
         BSONElement e = obj["_id"];
         if (e.eoo()) {
@@ -76,7 +97,10 @@ void BtreeKeyGenerator::getKeys(const BSONObj& obj, BSONObjSet* keys) const {
 
     // '_fieldNames' and '_fixed' are passed by value so that they can be mutated as part of the
     // getKeys call.  :|
-    getKeysImpl(_fieldNames, _fixed, obj, keys);
+    if (multikeyPaths) {
+        multikeyPaths->clear();
+    }
+    getKeysImpl(_fieldNames, _fixed, obj, keys, multikeyPaths);
     if (keys->empty() && !_isSparse) {
         keys->insert(_nullKey);
     }
@@ -96,7 +120,9 @@ BtreeKeyGeneratorV0::BtreeKeyGeneratorV0(std::vector<const char*> fieldNames,
 void BtreeKeyGeneratorV0::getKeysImpl(std::vector<const char*> fieldNames,
                                       std::vector<BSONElement> fixed,
                                       const BSONObj& obj,
-                                      BSONObjSet* keys) const {
+                                      BSONObjSet* keys,
+                                      MultikeyPaths* multikeyPaths) const {
+    // V0 indexes don't track which of their paths are multikey, so 'multikeyPaths' stays empty.
     BSONElement arrElt;
     unsigned arrIdx = ~0;
     unsigned numNotFound = 0;
@@ -181,7 +207,7 @@ void BtreeKeyGeneratorV0::getKeysImpl(std::vector<const char*> fieldNames,
             while (i.more()) {
                 BSONElement e = i.next();
                 if (e.type() == Object) {
-                    getKeysImpl(fieldNames, fixed, e.embeddedObject(), keys);
+                    getKeysImpl(fieldNames, fixed, e.embeddedObject(), keys, multikeyPaths);
                 }
             }
         } else {
@@ -247,6 +273,7 @@ void BtreeKeyGeneratorV1::_getKeysArrEltFixed(
     std::vector<BSONElement>* fixed,
     const BSONElement& arrEntry,
     BSONObjSet* keys,
+    MultikeyPaths* multikeyPaths,
     unsigned numNotFound,
     const BSONElement& arrObjElt,
     const std::set<unsigned>& arrIdxs,
@@ -265,6 +292,7 @@ void BtreeKeyGeneratorV1::_getKeysArrEltFixed(
                          *fixed,
                          arrEntry.type() == Object ? arrEntry.embeddedObject() : BSONObj(),
                          keys,
+                         multikeyPaths,
                          numNotFound,
                          positionalInfo);
 }
@@ -272,8 +300,12 @@ void BtreeKeyGeneratorV1::_getKeysArrEltFixed(
 void BtreeKeyGeneratorV1::getKeysImpl(std::vector<const char*> fieldNames,
                                       std::vector<BSONElement> fixed,
                                       const BSONObj& obj,
-                                      BSONObjSet* keys) const {
-    getKeysImplWithArray(fieldNames, fixed, obj, keys, 0, _emptyPositionalInfo);
+                                      BSONObjSet* keys,
+                                      MultikeyPaths* multikeyPaths) const {
+    if (multikeyPaths) {
+        multikeyPaths->resize(fieldNames.size());
+    }
+    getKeysImplWithArray(fieldNames, fixed, obj, keys, multikeyPaths, 0, _emptyPositionalInfo);
 }
 
 void BtreeKeyGeneratorV1::getKeysImplWithArray(
@@ -281,6 +313,7 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
     std::vector<BSONElement> fixed,
     const BSONObj& obj,
     BSONObjSet* keys,
+    MultikeyPaths* multikeyPaths,
     unsigned numNotFound,
     const std::vector<PositionalPathInfo>& positionalInfo) const {
     BSONElement arrElt;
@@ -304,6 +337,9 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
             numNotFound++;
         } else if (e.type() == Array) {
             arrIdxs.insert(i);
+            if (multikeyPaths) {
+                (*multikeyPaths)[i].insert(arrayComponent(_fieldNames[i], fieldNames[i]));
+            }
             if (arrElt.eoo()) {
                 // we only expand arrays on a single path -- track the path here
                 arrElt = e;
@@ -336,6 +372,7 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
                             &fixed,
                             undefinedElt,
                             keys,
+                            multikeyPaths,
                             numNotFound,
                             arrElt,
                             arrIdxs,
@@ -378,6 +415,7 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
                                 &fixed,
                                 i.next(),
                                 keys,
+                                multikeyPaths,
                                 numNotFound,
                                 arrElt,
                                 arrIdxs,
@@ -30,6 +30,7 @@
 
 #include <vector>
 #include <set>
+#include "mongo/db/index/multikey_paths.h"
 #include "mongo/db/jsobj.h"
 
 namespace mongo {
@@ -46,7 +47,14 @@ public:
 
     virtual ~BtreeKeyGenerator() {}
 
-    void getKeys(const BSONObj& obj, BSONObjSet* keys) const;
+    /**
+     * Generates the index keys for 'obj' into 'keys'. If 'multikeyPaths' is not null, it is set
+     * to the components of each indexed path which traverse an array in 'obj', or left empty if
+     * this version of the key format does not track them.
+     */
+    void getKeys(const BSONObj& obj,
+                 BSONObjSet* keys,
+                 MultikeyPaths* multikeyPaths = nullptr) const;
 
     static const int ParallelArraysCode;
 
@@ -63,7 +71,8 @@ private:
     virtual void getKeysImpl(std::vector<const char*> fieldNames,
                              std::vector<BSONElement> fixed,
                              const BSONObj& obj,
-                             BSONObjSet* keys) const = 0;
+                             BSONObjSet* keys,
+                             MultikeyPaths* multikeyPaths) const = 0;
 
     std::vector<BSONElement> _fixed;
 };
@@ -80,7 +89,8 @@ private:
     virtual void getKeysImpl(std::vector<const char*> fieldNames,
                              std::vector<BSONElement> fixed,
                              const BSONObj& obj,
-                             BSONObjSet* keys) const;
+                             BSONObjSet* keys,
+                             MultikeyPaths* multikeyPaths) const;
 };
 
 class BtreeKeyGeneratorV1 : public BtreeKeyGenerator {
@@ -151,6 +161,7 @@ private:
      * @param fixed - values that have already been identified for their index fields
      * @param obj - object from which keys should be extracted, based on names in fieldNames
      * @param keys - set where index keys are written
+     * @param multikeyPaths - if not null, the array components of each path are added here
      * @param numNotFound - number of index fields that have already been identified as missing
      * @param array - array from which keys should be extracted, based on names in fieldNames
      *        If obj and array are both nonempty, obj will be one of the elements of array.
@@ -158,7 +169,8 @@ private:
     virtual void getKeysImpl(std::vector<const char*> fieldNames,
                              std::vector<BSONElement> fixed,
                              const BSONObj& obj,
-                             BSONObjSet* keys) const;
+                             BSONObjSet* keys,
+                             MultikeyPaths* multikeyPaths) const;
 
     /**
      * This recursive method does the heavy-lifting for getKeysImpl().
@@ -167,6 +179,7 @@ private:
                               std::vector<BSONElement> fixed,
                               const BSONObj& obj,
                               BSONObjSet* keys,
+                              MultikeyPaths* multikeyPaths,
                               unsigned numNotFound,
                               const std::vector<PositionalPathInfo>& positionalInfo) const;
     /**
@@ -215,6 +228,7 @@ private:
                              std::vector<BSONElement>* fixed,
                              const BSONElement& arrEntry,
                              BSONObjSet* keys,
+                             MultikeyPaths* multikeyPaths,
                              unsigned numNotFound,
                              const BSONElement& arrObjElt,
                              const std::set<unsigned>& arrIdxs,
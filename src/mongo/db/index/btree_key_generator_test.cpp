@@ -108,6 +108,27 @@ bool testKeygen(const BSONObj& kp,
     return match;
 }
 
+MultikeyPaths getMultikeyPaths(const BSONObj& kp, const BSONObj& obj, bool useV0 = false) {
+    vector<const char*> fieldNames;
+    vector<BSONElement> fixed;
+    for (auto&& elt : kp) {
+        fieldNames.push_back(elt.fieldName());
+        fixed.push_back(BSONElement());
+    }
+
+    unique_ptr<BtreeKeyGenerator> keyGen;
+    if (useV0) {
+        keyGen.reset(new BtreeKeyGeneratorV0(fieldNames, fixed, false));
+    } else {
+        keyGen.reset(new BtreeKeyGeneratorV1(fieldNames, fixed, false));
+    }
+
+    BSONObjSet keys;
+    MultikeyPaths multikeyPaths;
+    keyGen->getKeys(obj, &keys, &multikeyPaths);
+    return multikeyPaths;
+}
+
 //
 // Unit tests
 //
@@ -827,4 +848,54 @@ TEST(BtreeKeyGeneratorTest, PositionalKeyPatternNestedArrays7) {
     ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys));
 }
 
+//
+// Multikey path tracking
+//
+
+TEST(BtreeKeyGeneratorTest, MultikeyPathsNoArrays) {
+    MultikeyPaths expected{std::set<size_t>{}, std::set<size_t>{}};
+    ASSERT(expected ==
+           getMultikeyPaths(fromjson("{a: 1, 'b.c': 1}"), fromjson("{a: 1, b: {c: 2}}")));
+    ASSERT(expected == getMultikeyPaths(fromjson("{a: 1, 'b.c': 1}"), fromjson("{}")));
+}
+
+TEST(BtreeKeyGeneratorTest, MultikeyPathsIdIndex) {
+    MultikeyPaths expected{std::set<size_t>{}};
+    ASSERT(expected == getMultikeyPaths(fromjson("{_id: 1}"), fromjson("{_id: 1}")));
+}
+
+TEST(BtreeKeyGeneratorTest, MultikeyPathsOnlyArrayFieldIsMultikey) {
+    MultikeyPaths expected{{0U}, std::set<size_t>{}};
+    ASSERT(expected == getMultikeyPaths(fromjson("{a: 1, b: 1}"), fromjson("{a: [1, 2], b: 3}")));
+}
+
+TEST(BtreeKeyGeneratorTest, MultikeyPathsSingleElementAndEmptyArrays) {
+    MultikeyPaths expected{{0U}};
+    ASSERT(expected == getMultikeyPaths(fromjson("{a: 1}"), fromjson("{a: [1]}")));
+    ASSERT(expected == getMultikeyPaths(fromjson("{a: 1}"), fromjson("{a: []}")));
+}
+
+TEST(BtreeKeyGeneratorTest, MultikeyPathsRecordsComponentOfDottedPath) {
+    MultikeyPaths expected{{1U}, std::set<size_t>{}};
+    ASSERT(expected ==
+           getMultikeyPaths(fromjson("{'a.b': 1, 'a.c': 1}"), fromjson("{a: {b: [1, 2], c: 3}}")));
+}
+
+TEST(BtreeKeyGeneratorTest, MultikeyPathsNestedArrays) {
+    MultikeyPaths expected{{0U, 1U}};
+    ASSERT(expected == getMultikeyPaths(fromjson("{'a.b': 1}"), fromjson("{a: [{b: [1, 2]}]}")));
+}
+
+TEST(BtreeKeyGeneratorTest, MultikeyPathsPositional) {
+    MultikeyPaths expected{{0U}};
+    ASSERT(expected == getMultikeyPaths(fromjson("{'a.0.b': 1}"), fromjson("{a: [{b: 1}]}")));
+
+    expected = {{0U, 1U}};
+    ASSERT(expected == getMultikeyPaths(fromjson("{'a.0': 1}"), fromjson("{a: [[1, 2]]}")));
+}
+
+TEST(BtreeKeyGeneratorTest, MultikeyPathsNotTrackedByV0) {
+    ASSERT(getMultikeyPaths(fromjson("{a: 1}"), fromjson("{a: [1, 2]}"), true).empty());
+}
+
 }  // namespace
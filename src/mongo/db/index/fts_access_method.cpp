@@ -34,7 +34,9 @@ namespace mongo {
 FTSAccessMethod::FTSAccessMethod(IndexCatalogEntry* btreeState, SortedDataInterface* btree)
     : IndexAccessMethod(btreeState, btree), _ftsSpec(btreeState->descriptor()->infoObj()) {}
 
-void FTSAccessMethod::getKeys(const BSONObj& obj, BSONObjSet* keys) const {
+void FTSAccessMethod::getKeys(const BSONObj& obj,
+                              BSONObjSet* keys,
+                              MultikeyPaths* multikeyPaths) const {
     ExpressionKeysPrivate::getFTSKeys(obj, _ftsSpec, keys);
 }
 
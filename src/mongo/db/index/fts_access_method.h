@@ -46,7 +46,9 @@ public:
 
 private:
     // Implemented:
-    virtual void getKeys(const BSONObj& obj, BSONObjSet* keys) const;
+    virtual void getKeys(const BSONObj& obj,
+                         BSONObjSet* keys,
+                         MultikeyPaths* multikeyPaths) const;
 
     fts::FTSSpec _ftsSpec;
 };
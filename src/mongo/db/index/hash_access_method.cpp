@@ -49,7 +49,9 @@ HashAccessMethod::HashAccessMethod(IndexCatalogEntry* btreeState, SortedDataInte
     ExpressionParams::parseHashParams(descriptor->infoObj(), &_seed, &_hashVersion, &_hashedField);
 }
 
-void HashAccessMethod::getKeys(const BSONObj& obj, BSONObjSet* keys) const {
+void HashAccessMethod::getKeys(const BSONObj& obj,
+                               BSONObjSet* keys,
+                               MultikeyPaths* multikeyPaths) const {
     ExpressionKeysPrivate::getHashKeys(
         obj, _hashedField, _seed, _hashVersion, _descriptor->isSparse(), keys);
 }
@@ -46,7 +46,9 @@ public:
     HashAccessMethod(IndexCatalogEntry* btreeState, SortedDataInterface* btree);
 
 private:
-    virtual void getKeys(const BSONObj& obj, BSONObjSet* keys) const;
+    virtual void getKeys(const BSONObj& obj,
+                         BSONObjSet* keys,
+                         MultikeyPaths* multikeyPaths) const;
 
     // Only one of our fields is hashed.  This is the field name for it.
     std::string _hashedField;
@@ -69,7 +69,9 @@ protected:
                        unsigned limit);
 
 private:
-    virtual void getKeys(const BSONObj& obj, BSONObjSet* keys) const;
+    virtual void getKeys(const BSONObj& obj,
+                         BSONObjSet* keys,
+                         MultikeyPaths* multikeyPaths) const;
 
     std::string _geoField;
     std::vector<std::string> _otherFields;
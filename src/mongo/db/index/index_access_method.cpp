@@ -32,6 +32,7 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <algorithm>
 #include <vector>
 #include <utility>
 
@@ -57,6 +58,19 @@ using std::vector;
 
 MONGO_EXPORT_SERVER_PARAMETER(failIndexKeyTooLong, bool, true);
 
+namespace {
+
+/**
+ * Returns true if at least one path component of 'multikeyPaths' traverses an array.
+ */
+bool isMultikeyFromPaths(const MultikeyPaths& multikeyPaths) {
+    return std::any_of(multikeyPaths.cbegin(),
+                       multikeyPaths.cend(),
+                       [](const std::set<std::size_t>& components) { return !components.empty(); });
+}
+
+}  // namespace
+
 //
 // Comparison for external sorter interface
 //
@@ -107,8 +121,9 @@ Status IndexAccessMethod::insert(OperationContext* txn,
     *numInserted = 0;
 
     BSONObjSet keys;
+    MultikeyPaths multikeyPaths;
     // Delegate to the subclass.
-    getKeys(obj, &keys);
+    getKeys(obj, &keys, &multikeyPaths);
 
     Status ret = Status::OK();
     for (BSONObjSet::const_iterator i = keys.begin(); i != keys.end(); ++i) {
@@ -144,8 +159,8 @@ Status IndexAccessMethod::insert(OperationContext* txn,
         return status;
     }
 
-    if (*numInserted > 1) {
-        _btreeState->setMultikey(txn);
+    if (*numInserted > 1 || isMultikeyFromPaths(multikeyPaths)) {
+        _btreeState->setMultikey(txn, multikeyPaths);
     }
 
     return ret;
@@ -182,7 +197,7 @@ Status IndexAccessMethod::remove(OperationContext* txn,
                                  const InsertDeleteOptions& options,
                                  int64_t* numDeleted) {
     BSONObjSet keys;
-    getKeys(obj, &keys);
+    getKeys(obj, &keys, nullptr);
     *numDeleted = 0;
 
     for (BSONObjSet::const_iterator i = keys.begin(); i != keys.end(); ++i) {
@@ -199,7 +214,7 @@ Status IndexAccessMethod::initializeAsEmpty(OperationContext* txn) {
 
 Status IndexAccessMethod::touch(OperationContext* txn, const BSONObj& obj) {
     BSONObjSet keys;
-    getKeys(obj, &keys);
+    getKeys(obj, &keys, nullptr);
 
     std::unique_ptr<SortedDataInterface::Cursor> cursor(_newInterface->newCursor(txn));
     for (BSONObjSet::const_iterator i = keys.begin(); i != keys.end(); ++i) {
@@ -294,9 +309,9 @@ Status IndexAccessMethod::validateUpdate(OperationContext* txn,
                                          UpdateTicket* ticket,
                                          const MatchExpression* indexFilter) {
     if (indexFilter == NULL || indexFilter->matchesBSON(from))
-        getKeys(from, &ticket->oldKeys);
+        getKeys(from, &ticket->oldKeys, nullptr);
     if (indexFilter == NULL || indexFilter->matchesBSON(to))
-        getKeys(to, &ticket->newKeys);
+        getKeys(to, &ticket->newKeys, &ticket->newMultikeyPaths);
     ticket->loc = record;
     ticket->dupsAllowed = options.dupsAllowed;
 
@@ -314,8 +329,9 @@ Status IndexAccessMethod::update(OperationContext* txn,
         return Status(ErrorCodes::InternalError, "Invalid UpdateTicket in update");
     }
 
-    if (ticket.oldKeys.size() + ticket.added.size() - ticket.removed.size() > 1) {
-        _btreeState->setMultikey(txn);
+    if (ticket.oldKeys.size() + ticket.added.size() - ticket.removed.size() > 1 ||
+        isMultikeyFromPaths(ticket.newMultikeyPaths)) {
+        _btreeState->setMultikey(txn, ticket.newMultikeyPaths);
     }
 
     for (size_t i = 0; i < ticket.removed.size(); ++i) {
@@ -359,9 +375,21 @@ Status IndexAccessMethod::BulkBuilder::insert(OperationContext* txn,
                                               const InsertDeleteOptions& options,
                                               int64_t* numInserted) {
     BSONObjSet keys;
-    _real->getKeys(obj, &keys);
+    MultikeyPaths multikeyPaths;
+    _real->getKeys(obj, &keys, &multikeyPaths);
+
+    _everGeneratedMultipleKeys = _everGeneratedMultipleKeys || (keys.size() > 1);
 
-    _isMultiKey = _isMultiKey || (keys.size() > 1);
+    if (!multikeyPaths.empty()) {
+        if (_indexMultikeyPaths.empty()) {
+            _indexMultikeyPaths = multikeyPaths;
+        } else {
+            invariant(_indexMultikeyPaths.size() == multikeyPaths.size());
+            for (size_t i = 0; i < multikeyPaths.size(); ++i) {
+                _indexMultikeyPaths[i].insert(multikeyPaths[i].begin(), multikeyPaths[i].end());
+            }
+        }
+    }
 
     for (BSONObjSet::iterator it = keys.begin(); it != keys.end(); ++it) {
         _sorter->add(*it, loc);
@@ -375,6 +403,10 @@ Status IndexAccessMethod::BulkBuilder::insert(OperationContext* txn,
     return Status::OK();
 }
 
+bool IndexAccessMethod::BulkBuilder::isMultikey() const {
+    return _everGeneratedMultipleKeys || isMultikeyFromPaths(_indexMultikeyPaths);
+}
+
 
 Status IndexAccessMethod::commitBulk(OperationContext* txn,
                                      std::unique_ptr<BulkBuilder> bulk,
@@ -397,8 +429,8 @@ Status IndexAccessMethod::commitBulk(OperationContext* txn,
     MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
         WriteUnitOfWork wunit(txn);
 
-        if (bulk->_isMultiKey) {
-            _btreeState->setMultikey(txn);
+        if (bulk->isMultikey()) {
+            _btreeState->setMultikey(txn, bulk->_indexMultikeyPaths);
         }
 
         builder.reset(_newInterface->getBulkBuilder(txn, dupsAllowed));
@@ -32,6 +32,7 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index/multikey_paths.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/record_id.h"
@@ -204,10 +205,19 @@ public:
 
         BulkBuilder(const IndexAccessMethod* index, const IndexDescriptor* descriptor);
 
+        bool isMultikey() const;
+
         std::unique_ptr<Sorter> _sorter;
         const IndexAccessMethod* _real;
         int64_t _keysInserted = 0;
-        bool _isMultiKey = false;
+
+        // Set to true if any document added to the BulkBuilder causes the index to become
+        // multikey.
+        bool _everGeneratedMultipleKeys = false;
+
+        // The union of the multikey paths of every document added to the BulkBuilder. Empty if
+        // the index does not track which of its paths are multikey.
+        MultikeyPaths _indexMultikeyPaths;
     };
 
     /**
@@ -236,8 +246,13 @@ public:
 
     /**
      * Fills 'keys' with the keys that should be generated for 'obj' on this index.
+     *
+     * If 'multikeyPaths' is not null, it is set to the path components of each key pattern
+     * field which traverse an array in 'obj'. Index types which do not track this leave it empty.
      */
-    virtual void getKeys(const BSONObj& obj, BSONObjSet* keys) const = 0;
+    virtual void getKeys(const BSONObj& obj,
+                         BSONObjSet* keys,
+                         MultikeyPaths* multikeyPaths) const = 0;
 
     /**
      * Splits the sets 'left' and 'right' into two vectors, the first containing the elements that
@@ -280,6 +295,9 @@ private:
     BSONObjSet oldKeys;
     BSONObjSet newKeys;
 
+    // The multikey paths of the new version of the document.
+    MultikeyPaths newMultikeyPaths;
+
     std::vector<BSONObj> removed;
     std::vector<BSONObj> added;
 
@@ -158,6 +158,12 @@ public:
         return _collection->getIndexCatalog()->isMultikey(txn, this);
     }
 
+    // Which path components of each key pattern field traverse an array? Empty if not tracked.
+    MultikeyPaths getMultikeyPaths(OperationContext* txn) const {
+        _checkOk();
+        return _collection->getIndexCatalog()->getMultikeyPaths(txn, this);
+    }
+
     bool isIdIndex() const {
         _checkOk();
         return _isIdIndex;
@@ -0,0 +1,35 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <set>
+#include <vector>
+
+namespace mongo {
+
+/**
+ * For each field of an index's key pattern, the set of components of that field's path which
+ * traverse an array in at least one indexed document. Components are numbered from zero, so for
+ * the key pattern {'a.b': 1, c: 1} and the document {a: [{b: 1}, {b: 2}], c: 3} the paths are
+ * [{0U}, {}].
+ *
+ * An empty vector means that the index does not track which of its paths are multikey. Callers
+ * must then treat every path of a multikey index as if it traversed an array.
+ */
+using MultikeyPaths = std::vector<std::set<std::size_t>>;
+
+}  // namespace mongo
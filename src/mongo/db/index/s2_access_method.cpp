@@ -102,7 +102,9 @@ BSONObj S2AccessMethod::fixSpec(const BSONObj& specObj) {
     return specObj;
 }
 
-void S2AccessMethod::getKeys(const BSONObj& obj, BSONObjSet* keys) const {
+void S2AccessMethod::getKeys(const BSONObj& obj,
+                             BSONObjSet* keys,
+                             MultikeyPaths* multikeyPaths) const {
     ExpressionKeysPrivate::getS2Keys(obj, _descriptor->keyPattern(), _params, keys);
 }
 
@@ -49,7 +49,9 @@ public:
     static BSONObj fixSpec(const BSONObj& specObj);
 
 private:
-    virtual void getKeys(const BSONObj& obj, BSONObjSet* keys) const;
+    virtual void getKeys(const BSONObj& obj,
+                         BSONObjSet* keys,
+                         MultikeyPaths* multikeyPaths) const;
 
     S2IndexingParams _params;
 };
@@ -83,6 +83,7 @@
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/query_shape_stats.h"
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/platform/atomic_word.h"
@@ -593,6 +594,14 @@ void assembleResponse(OperationContext* txn,
     currentOp.done();
     debug.executionTime = currentOp.totalTimeMillis();
 
+    if (debug.queryShape) {
+        debug.queryShape->record(currentOp.getLogicalOp() == LogicalOp::opGetMore,
+                                 currentOp.totalTimeMicros(),
+                                 debug.keysExamined,
+                                 debug.docsExamined,
+                                 debug.nreturned);
+    }
+
     logThreshold += currentOp.getExpectedLatencyMs();
 
     if (shouldLogOpDebug || debug.executionTime > logThreshold) {
@@ -31,6 +31,7 @@
 #include <string>
 
 #include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/column_batch.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/util/string_map.h"
 #include "mongo/util/mongoutils/str.h"
@@ -52,6 +53,12 @@ void Accumulator::registerAccumulator(std::string name, Factory factory) {
     factoryMap[name] = factory;
 }
 
+void Accumulator::processColumn(const ColumnVector& column, const std::vector<uint32_t>& rows) {
+    for (uint32_t row : rows) {
+        processInternal(column.getValue(row), false);
+    }
+}
+
 Factory Accumulator::getFactory(StringData name) {
     auto it = factoryMap.find(name);
     uassert(
@@ -40,6 +40,9 @@
 #include "mongo/stdx/functional.h"
 
 namespace mongo {
+
+class ColumnVector;
+
 /**
  * Registers an Accumulator to have the name 'key'. When an accumulator with name '$key' is found
  * during parsing of a $group stage, 'factory' will be called to construct the Accumulator.
@@ -67,6 +70,13 @@ public:
         processInternal(input, merging);
     }
 
+    /**
+     * Processes the entries of 'column' at 'rows', in order, as process() would one at a time
+     * with merging false. Subclasses override this with loops over the typed arrays of the column
+     * where they can.
+     */
+    virtual void processColumn(const ColumnVector& column, const std::vector<uint32_t>& rows);
+
     /** Marks the end of the evaluate() phase and return accumulated result.
      *  toBeMerged should be true when the outputs will be merged by process().
      */
@@ -138,6 +148,7 @@ public:
     AccumulatorFirst();
 
     void processInternal(const Value& input, bool merging) final;
+    void processColumn(const ColumnVector& column, const std::vector<uint32_t>& rows) final;
     Value getValue(bool toBeMerged) const final;
     const char* getOpName() const final;
     void reset() final;
@@ -155,6 +166,7 @@ public:
     AccumulatorLast();
 
     void processInternal(const Value& input, bool merging) final;
+    void processColumn(const ColumnVector& column, const std::vector<uint32_t>& rows) final;
     Value getValue(bool toBeMerged) const final;
     const char* getOpName() const final;
     void reset() final;
@@ -171,6 +183,7 @@ public:
     AccumulatorSum();
 
     void processInternal(const Value& input, bool merging) final;
+    void processColumn(const ColumnVector& column, const std::vector<uint32_t>& rows) final;
     Value getValue(bool toBeMerged) const final;
     const char* getOpName() const final;
     void reset() final;
@@ -198,6 +211,7 @@ public:
     explicit AccumulatorMinMax(Sense sense);
 
     void processInternal(const Value& input, bool merging) final;
+    void processColumn(const ColumnVector& column, const std::vector<uint32_t>& rows) final;
     Value getValue(bool toBeMerged) const final;
     const char* getOpName() const final;
     void reset() final;
@@ -245,6 +259,7 @@ public:
     AccumulatorAvg();
 
     void processInternal(const Value& input, bool merging) final;
+    void processColumn(const ColumnVector& column, const std::vector<uint32_t>& rows) final;
     Value getValue(bool toBeMerged) const final;
     const char* getOpName() const final;
     void reset() final;
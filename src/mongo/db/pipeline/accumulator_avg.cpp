@@ -29,6 +29,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/column_batch.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
@@ -67,6 +68,38 @@ void AccumulatorAvg::processInternal(const Value& input, bool merging) {
     }
 }
 
+void AccumulatorAvg::processColumn(const ColumnVector& column, const std::vector<uint32_t>& rows) {
+    const double* doubles = column.doubles();
+    const size_t n = rows.size();
+
+    if (n == column.size() && column.numIntegral() + column.numDoubles() == n) {
+        // Every entry is a number.
+        double total = _total;
+        for (size_t i = 0; i < n; i++) {
+            total += doubles[i];
+        }
+        _total = total;
+        _count += n;
+        return;
+    }
+
+    for (uint32_t row : rows) {
+        switch (column.kind(row)) {
+            case ColumnVector::Kind::kInt:
+            case ColumnVector::Kind::kLong:
+            case ColumnVector::Kind::kDouble:
+                _total += doubles[row];
+                _count += 1;
+                break;
+            case ColumnVector::Kind::kMissing:
+                break;
+            default:
+                processInternal(column.getValue(row), false);
+                break;
+        }
+    }
+}
+
 intrusive_ptr<Accumulator> AccumulatorAvg::create() {
     return new AccumulatorAvg();
 }
@@ -29,6 +29,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/column_batch.h"
 #include "mongo/db/pipeline/value.h"
 
 namespace mongo {
@@ -51,6 +52,13 @@ void AccumulatorFirst::processInternal(const Value& input, bool merging) {
     }
 }
 
+void AccumulatorFirst::processColumn(const ColumnVector& column,
+                                     const std::vector<uint32_t>& rows) {
+    if (!_haveFirst && !rows.empty()) {
+        processInternal(column.getValue(rows.front()), false);
+    }
+}
+
 Value AccumulatorFirst::getValue(bool toBeMerged) const {
     return _first;
 }
@@ -29,6 +29,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/column_batch.h"
 #include "mongo/db/pipeline/value.h"
 
 namespace mongo {
@@ -47,6 +48,13 @@ void AccumulatorLast::processInternal(const Value& input, bool merging) {
     _memUsageBytes = sizeof(*this) + _last.getApproximateSize() - sizeof(Value);
 }
 
+void AccumulatorLast::processColumn(const ColumnVector& column,
+                                    const std::vector<uint32_t>& rows) {
+    if (!rows.empty()) {
+        processInternal(column.getValue(rows.back()), false);
+    }
+}
+
 Value AccumulatorLast::getValue(bool toBeMerged) const {
     return _last;
 }
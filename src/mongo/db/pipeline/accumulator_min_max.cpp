@@ -28,7 +28,10 @@
 
 #include "mongo/platform/basic.h"
 
+#include <cmath>
+
 #include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/column_batch.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/value.h"
 
@@ -59,6 +62,51 @@ void AccumulatorMinMax::processInternal(const Value& input, bool merging) {
     }
 }
 
+namespace {
+/**
+ * Returns the index of the first of the 'n' values which is the smallest for MIN or the largest
+ * for MAX.
+ */
+template <typename T>
+size_t findExtreme(const T* values, size_t n, AccumulatorMinMax::Sense sense) {
+    size_t best = 0;
+    for (size_t i = 1; i < n; i++) {
+        if (sense == AccumulatorMinMax::MIN ? values[i] < values[best]
+                                            : values[best] < values[i]) {
+            best = i;
+        }
+    }
+    return best;
+}
+}  // namespace
+
+void AccumulatorMinMax::processColumn(const ColumnVector& column,
+                                      const std::vector<uint32_t>& rows) {
+    const size_t n = rows.size();
+    if (n > 0 && n == column.size()) {
+        // Only the first extreme value of the batch can replace the current one, since ties keep
+        // the earlier value. Values of one type compare like the C++ numbers, except for NaN.
+        if (column.numIntegral() == n) {
+            processInternal(column.getValue(findExtreme(column.longs(), n, _sense)), false);
+            return;
+        }
+
+        if (column.numDoubles() == n) {
+            const double* doubles = column.doubles();
+            bool hasNaN = false;
+            for (size_t i = 0; i < n; i++) {
+                hasNaN |= std::isnan(doubles[i]);
+            }
+            if (!hasNaN) {
+                processInternal(column.getValue(findExtreme(doubles, n, _sense)), false);
+                return;
+            }
+        }
+    }
+
+    Accumulator::processColumn(column, rows);
+}
+
 Value AccumulatorMinMax::getValue(bool toBeMerged) const {
     if (_val.missing()) {
         return Value(BSONNULL);
@@ -28,7 +28,10 @@
 
 #include "mongo/platform/basic.h"
 
+#include <cmath>
+
 #include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/column_batch.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/value.h"
 
@@ -64,6 +67,75 @@ void AccumulatorSum::processInternal(const Value& input, bool merging) {
     }
 }
 
+namespace {
+// Integers up to this size can be added to a double total below kMaxExactDoubleTotal a whole batch
+// at a time without rounding any of the partial sums, so the order of the additions is irrelevant.
+const unsigned long long kMaxExactAddend = 1ULL << 31;
+const double kMaxExactDoubleTotal = 4503599627370496.0;  // 2^52
+}  // namespace
+
+void AccumulatorSum::processColumn(const ColumnVector& column, const std::vector<uint32_t>& rows) {
+    const size_t n = rows.size();
+    const bool dense = n == column.size();
+
+    if (dense && column.numIntegral() == n && totalType != NumberDouble &&
+        column.maxAbsIntegral() <= kMaxExactAddend &&
+        std::abs(doubleTotal) < kMaxExactDoubleTotal) {
+        // A loop the compiler can vectorize.
+        const long long* longs = column.longs();
+        long long sum = 0;
+        for (size_t i = 0; i < n; i++) {
+            sum += longs[i];
+        }
+
+        totalType = Value::getWidestNumeric(totalType, column.hasLongs() ? NumberLong : NumberInt);
+        longTotal += sum;
+        doubleTotal += sum;
+        return;
+    }
+
+    if (dense && column.numDoubles() == n) {
+        // Doubles are still added in order, so that the total is the same as one row at a time.
+        const double* doubles = column.doubles();
+        double total = doubleTotal;
+        for (size_t i = 0; i < n; i++) {
+            total += doubles[i];
+        }
+
+        totalType = NumberDouble;
+        doubleTotal = total;
+        return;
+    }
+
+    const long long* longs = column.longs();
+    const double* doubles = column.doubles();
+    for (uint32_t row : rows) {
+        switch (column.kind(row)) {
+            case ColumnVector::Kind::kMissing:
+                break;
+            case ColumnVector::Kind::kInt:
+            case ColumnVector::Kind::kLong:
+                totalType = Value::getWidestNumeric(
+                    totalType,
+                    column.kind(row) == ColumnVector::Kind::kInt ? NumberInt : NumberLong);
+                if (totalType == NumberDouble) {
+                    doubleTotal += doubles[row];
+                } else {
+                    longTotal += longs[row];
+                    doubleTotal += longs[row];
+                }
+                break;
+            case ColumnVector::Kind::kDouble:
+                totalType = NumberDouble;
+                doubleTotal += doubles[row];
+                break;
+            default:
+                processInternal(column.getValue(row), false);
+                break;
+        }
+    }
+}
+
 intrusive_ptr<Accumulator> AccumulatorSum::create() {
     return new AccumulatorSum();
 }
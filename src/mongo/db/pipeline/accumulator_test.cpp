@@ -29,9 +29,11 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/column_batch.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/stdx/memory.h"
 
 namespace AccumulatorTests {
 
@@ -39,6 +41,21 @@ using boost::intrusive_ptr;
 using std::numeric_limits;
 using std::string;
 
+/**
+ * Returns a batch of documents with the values in field 'a' and a column for 'a'. A missing value
+ * becomes a document without the field.
+ */
+static std::unique_ptr<ColumnBatch> makeBatch(const std::vector<Value>& values) {
+    auto batch = stdx::make_unique<ColumnBatch>();
+    batch->addColumn("a");
+    for (auto&& val : values) {
+        MutableDocument doc;
+        doc["a"] = val;
+        batch->appendRow(doc.freeze().toBson());
+    }
+    return batch;
+}
+
 /**
  * Takes the name of an Accumulator as its first argument and a list of pairs of arguments and
  * expected results as its second argument, and asserts that for the given Accumulator the arguments
@@ -86,6 +103,16 @@ static void assertExpectedResults(
                 ASSERT_EQUALS(op.second, result);
                 ASSERT_EQUALS(op.second.getType(), result.getType());
             }
+
+            // Asserts that result equals expected result when the input is read from a column.
+            if (op.first.size() <= ColumnBatch::kMaxRows) {
+                boost::intrusive_ptr<Accumulator> accum = factory();
+                auto batch = makeBatch(op.first);
+                accum->processColumn(batch->getColumn(0), batch->getSelection());
+                Value result = accum->getValue(false);
+                ASSERT_EQUALS(op.second, result);
+                ASSERT_EQUALS(op.second.getType(), result.getType());
+            }
         } catch (...) {
             log() << "failed with arguments: " << Value(op.first);
             throw;
@@ -277,4 +304,74 @@ TEST(Accumulators, Sum) {
          {{Value(9), Value()}, Value(9)}});
 }
 
+/**
+ * Asserts that processing 'values' through columns, split into batches of 'batchSize' documents
+ * and filtered to every 'stride'th document, gives the same result as processing them one at a
+ * time.
+ */
+static void assertColumnMatchesRows(const std::string& accumulator,
+                                    const std::vector<Value>& values,
+                                    size_t batchSize,
+                                    size_t stride) {
+    auto factory = Accumulator::getFactory(accumulator);
+    boost::intrusive_ptr<Accumulator> rowAccum = factory();
+    boost::intrusive_ptr<Accumulator> columnAccum = factory();
+
+    for (size_t start = 0; start < values.size(); start += batchSize) {
+        std::vector<Value> batchValues(values.begin() + start,
+                                       values.begin() + std::min(values.size(), start + batchSize));
+        auto batch = makeBatch(batchValues);
+        std::vector<uint32_t> rows;
+        for (size_t i = 0; i < batchValues.size(); i += stride) {
+            rowAccum->process(batchValues[i], false);
+            rows.push_back(i);
+        }
+        columnAccum->processColumn(batch->getColumn(0), rows);
+    }
+
+    Value expected = rowAccum->getValue(false);
+    Value result = columnAccum->getValue(false);
+    ASSERT_EQUALS(expected, result);
+    ASSERT_EQUALS(expected.getType(), result.getType());
+    ASSERT_EQUALS(rowAccum->getValue(true), columnAccum->getValue(true));
+}
+
+TEST(Accumulators, ProcessColumnMatchesProcess) {
+    std::vector<std::vector<Value>> inputs(6);
+    for (int i = 0; i < 3000; i++) {
+        // Small ints, with ties for $min and $max.
+        inputs[0].push_back(Value((i * 7919) % 1000 - 500));
+        // Ints and longs which widen the sum past an int.
+        inputs[1].push_back(i % 3 ? Value(numeric_limits<int>::max() - i)
+                                  : Value(static_cast<long long>(i) << 20));
+        // Doubles whose sum depends on the order they are added in.
+        inputs[2].push_back(Value(1.0 / (i + 1) * (i % 2 ? 1e10 : -1.0)));
+        // Mixed numbers.
+        inputs[3].push_back(i % 4 == 0 ? Value(i) : i % 4 == 1 ? Value(i * 0.5)
+                                                                 : Value(-3LL * i));
+        // Numbers mixed with values which are not numbers.
+        inputs[4].push_back(i % 5 == 0 ? Value(BSONNULL) : i % 5 == 1 ? Value()
+                                : i % 5 == 2 ? Value(StringData("str")) : Value(i));
+        // Longs which do not fit in a double.
+        inputs[5].push_back(Value(numeric_limits<long long>::max() / (i + 2)));
+    }
+    inputs[2].push_back(Value(numeric_limits<double>::quiet_NaN()));
+
+    for (auto&& accumulator : {"$sum", "$avg", "$min", "$max", "$first", "$last"}) {
+        for (auto&& input : inputs) {
+            for (size_t batchSize : {size_t(1), size_t(7), ColumnBatch::kMaxRows}) {
+                for (size_t stride : {1, 3}) {
+                    try {
+                        assertColumnMatchesRows(accumulator, input, batchSize, stride);
+                    } catch (...) {
+                        log() << "failed with " << accumulator << ", batch size " << batchSize
+                              << ", stride " << stride;
+                        throw;
+                    }
+                }
+            }
+        }
+    }
+}
+
 }  // namespace AccumulatorTests
@@ -0,0 +1,237 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/column_batch.h"
+
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+const size_t ColumnBatch::kMaxRows;
+
+ColumnVector::ColumnVector(const std::string& path)
+    : _isConstant(false), _path(path), _fieldPath(FieldPath(path)) {
+    VariablesIdGenerator idGenerator;
+    VariablesParseState vps(&idGenerator);
+    _arrayPath = ExpressionFieldPath::parse("$" + path, vps);
+}
+
+ColumnVector::ColumnVector(const Value& constant) : _isConstant(true), _constant(constant) {}
+
+ColumnVector::~ColumnVector() = default;
+
+void ColumnVector::clear() {
+    _kinds.clear();
+    _longs.clear();
+    _doubles.clear();
+    _elements.clear();
+    _values.clear();
+    _numIntegral = 0;
+    _numDoubles = 0;
+    _hasLongs = false;
+    _maxAbsIntegral = 0;
+}
+
+void ColumnVector::append(const BSONObj& row) {
+    if (_isConstant) {
+        appendUnread(1);
+        return;
+    }
+
+    // Walks down the path like ExpressionFieldPath, which is only needed for the arrays.
+    BSONObj obj = row;
+    const size_t last = _fieldPath->getPathLength() - 1;
+    for (size_t i = 0;; i++) {
+        BSONElement elem = obj[_fieldPath->getFieldName(i)];
+        if (i == last) {
+            appendElement(elem);
+            return;
+        }
+
+        switch (elem.type()) {
+            case Object:
+                obj = elem.embeddedObject();
+                break;
+            case Array: {
+                Variables vars(0, Document(row));
+                appendValue(_arrayPath->evaluate(&vars));
+                return;
+            }
+            default:
+                appendElement(BSONElement());
+                return;
+        }
+    }
+}
+
+void ColumnVector::appendUnread(size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (_isConstant) {
+            appendValue(_constant);
+        } else {
+            appendElement(BSONElement());
+        }
+    }
+}
+
+void ColumnVector::appendElement(const BSONElement& elem) {
+    switch (elem.type()) {
+        case EOO:
+            appendEntry(Kind::kMissing, 0, 0, BSONElement());
+            return;
+        case NumberInt:
+            appendIntegral(elem._numberInt(), false);
+            return;
+        case NumberLong:
+            appendIntegral(elem._numberLong(), true);
+            return;
+        case NumberDouble:
+            appendEntry(Kind::kDouble, 0, elem._numberDouble(), BSONElement());
+            _numDoubles++;
+            return;
+        default:
+            appendEntry(Kind::kElement, 0, 0, elem);
+            return;
+    }
+}
+
+void ColumnVector::appendValue(const Value& value) {
+    switch (value.getType()) {
+        case EOO:
+            appendEntry(Kind::kMissing, 0, 0, BSONElement());
+            return;
+        case NumberInt:
+            appendIntegral(value.getInt(), false);
+            return;
+        case NumberLong:
+            appendIntegral(value.getLong(), true);
+            return;
+        case NumberDouble:
+            appendEntry(Kind::kDouble, 0, value.getDouble(), BSONElement());
+            _numDoubles++;
+            return;
+        default:
+            appendEntry(Kind::kValue, _values.size(), 0, BSONElement());
+            _values.push_back(value);
+            return;
+    }
+}
+
+void ColumnVector::appendIntegral(long long value, bool isLong) {
+    appendEntry(
+        isLong ? Kind::kLong : Kind::kInt, value, static_cast<double>(value), BSONElement());
+
+    const unsigned long long absValue = value < 0 ? 0ULL - static_cast<unsigned long long>(value)
+                                                  : static_cast<unsigned long long>(value);
+    _maxAbsIntegral = std::max(_maxAbsIntegral, absValue);
+    _hasLongs |= isLong;
+    _numIntegral++;
+}
+
+void ColumnVector::appendEntry(Kind kind, long long l, double d, const BSONElement& elem) {
+    _kinds.push_back(kind);
+    _longs.push_back(l);
+    _doubles.push_back(d);
+    _elements.push_back(elem);
+}
+
+void ColumnVector::copyEntriesFrom(const ColumnVector& other) {
+    _kinds = other._kinds;
+    _longs = other._longs;
+    _doubles = other._doubles;
+    _elements = other._elements;
+    _values = other._values;
+    _numIntegral = other._numIntegral;
+    _numDoubles = other._numDoubles;
+    _hasLongs = other._hasLongs;
+    _maxAbsIntegral = other._maxAbsIntegral;
+}
+
+Value ColumnVector::getValue(size_t row) const {
+    switch (_kinds[row]) {
+        case Kind::kMissing:
+            return Value();
+        case Kind::kInt:
+            return Value(static_cast<int>(_longs[row]));
+        case Kind::kLong:
+            return Value(_longs[row]);
+        case Kind::kDouble:
+            return Value(_doubles[row]);
+        case Kind::kElement:
+            return Value(_elements[row]);
+        case Kind::kValue:
+            return _values[_longs[row]];
+    }
+    MONGO_UNREACHABLE;
+}
+
+size_t ColumnBatch::addColumn(const std::string& path) {
+    for (size_t i = 0; i < _columns.size(); i++) {
+        if (!_columns[i]->isConstant() && _columns[i]->getPath() == path) {
+            return i;
+        }
+    }
+    invariant(_numRows == 0);
+    _columns.push_back(stdx::make_unique<ColumnVector>(path));
+    return _columns.size() - 1;
+}
+
+size_t ColumnBatch::addConstant(const Value& constant) {
+    invariant(_numRows == 0);
+    _columns.push_back(stdx::make_unique<ColumnVector>(constant));
+    return _columns.size() - 1;
+}
+
+void ColumnBatch::clear() {
+    for (auto&& column : _columns) {
+        column->clear();
+    }
+    _rows.clear();
+    _selection.clear();
+    _numRows = 0;
+    _hasRows = true;
+}
+
+void ColumnBatch::appendRow(BSONObj row) {
+    invariant(_hasRows && _numRows < kMaxRows);
+    for (auto&& column : _columns) {
+        column->append(row);
+    }
+    _rows.push_back(std::move(row));
+    _selection.push_back(_numRows++);
+}
+
+void ColumnBatch::assignColumns(const ColumnBatch& source, const std::vector<int>& sourceColumns) {
+    invariant(sourceColumns.size() == _columns.size());
+
+    clear();
+    _numRows = source._numRows;
+    _selection = source._selection;
+    _hasRows = false;
+
+    for (size_t i = 0; i < _columns.size(); i++) {
+        if (sourceColumns[i] >= 0) {
+            _columns[i]->copyEntriesFrom(*source._columns[sourceColumns[i]]);
+        } else {
+            _columns[i]->appendUnread(_numRows);
+        }
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,277 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#pragma once
+
+#include <boost/intrusive_ptr.hpp>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/pipeline/field_path.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+
+class ExpressionFieldPath;
+
+/**
+ * The values of one field path, or of a constant, for every document of a ColumnBatch. Numbers
+ * are kept in typed arrays so that accumulators can run tight loops over them instead of going
+ * through a Value per document.
+ */
+class ColumnVector {
+public:
+    /**
+     * How the value of a document is stored.
+     */
+    enum class Kind : uint8_t {
+        kMissing,  // The document has no value at the path.
+        kInt,      // In longs() and doubles().
+        kLong,     // In longs() and doubles().
+        kDouble,   // In doubles().
+        kElement,  // Any other type, kept as the BSONElement in the document.
+        kValue,    // A Value owned by the column: a constant, or a path which crosses an array.
+    };
+
+    /**
+     * A column of the values at 'path' of the documents, not including a leading '$'.
+     */
+    explicit ColumnVector(const std::string& path);
+
+    /**
+     * A column which holds 'constant' for every document.
+     */
+    explicit ColumnVector(const Value& constant);
+
+    ~ColumnVector();
+
+    bool isConstant() const {
+        return _isConstant;
+    }
+
+    /**
+     * The field path of the column, or an empty string for a constant.
+     */
+    const std::string& getPath() const {
+        return _path;
+    }
+
+    /**
+     * Appends the value of the next document, which must outlive the current batch.
+     */
+    void append(const BSONObj& row);
+
+    /**
+     * Appends 'n' entries of the constant or of missing, for a column whose values do not come
+     * from the documents.
+     */
+    void appendUnread(size_t n);
+
+    /**
+     * Replaces the entries of this column with those of 'other'.
+     */
+    void copyEntriesFrom(const ColumnVector& other);
+
+    void clear();
+
+    size_t size() const {
+        return _kinds.size();
+    }
+
+    Kind kind(size_t row) const {
+        return _kinds[row];
+    }
+
+    /**
+     * The values of the kInt and kLong entries. Other entries are undefined.
+     */
+    const long long* longs() const {
+        return _longs.data();
+    }
+
+    /**
+     * The values of the numeric entries, converted to double for integers.
+     */
+    const double* doubles() const {
+        return _doubles.data();
+    }
+
+    /**
+     * Returns the value of an entry as ExpressionFieldPath would evaluate it on the document.
+     */
+    Value getValue(size_t row) const;
+
+    /**
+     * The number of kInt and kLong entries, and whether any is a kLong.
+     */
+    size_t numIntegral() const {
+        return _numIntegral;
+    }
+    bool hasLongs() const {
+        return _hasLongs;
+    }
+
+    /**
+     * The largest absolute value of the kInt and kLong entries.
+     */
+    unsigned long long maxAbsIntegral() const {
+        return _maxAbsIntegral;
+    }
+
+    /**
+     * The number of kDouble entries.
+     */
+    size_t numDoubles() const {
+        return _numDoubles;
+    }
+
+private:
+    void appendElement(const BSONElement& elem);
+    void appendValue(const Value& value);
+    void appendIntegral(long long value, bool isLong);
+    void appendEntry(Kind kind, long long l, double d, const BSONElement& elem);
+
+    const bool _isConstant;
+    const std::string _path;
+    const boost::optional<FieldPath> _fieldPath;
+    const Value _constant;
+
+    // Evaluates the path on the documents where it crosses an array.
+    boost::intrusive_ptr<ExpressionFieldPath> _arrayPath;
+
+    std::vector<Kind> _kinds;
+    std::vector<long long> _longs;  // For kValue entries, the index in _values.
+    std::vector<double> _doubles;
+    std::vector<BSONElement> _elements;
+    std::vector<Value> _values;
+
+    size_t _numIntegral = 0;
+    size_t _numDoubles = 0;
+    bool _hasLongs = false;
+    unsigned long long _maxAbsIntegral = 0;
+};
+
+/**
+ * A batch of documents passed between pipeline stages by DocumentSource::getNextBatch(). It holds
+ * up to kMaxRows documents and a ColumnVector for every field the consumer asked for, along with
+ * a selection of the documents which are still part of the batch after filtering.
+ *
+ * The consumer registers its columns once with addColumn() or addConstant(). The stages between
+ * the consumer and the source translate them to the paths of their own input.
+ */
+class ColumnBatch {
+    MONGO_DISALLOW_COPYING(ColumnBatch);
+
+public:
+    static const size_t kMaxRows = 1024;
+
+    ColumnBatch() = default;
+
+    /**
+     * Registers a column for 'path' and returns its index. A path registered twice gets the same
+     * column.
+     */
+    size_t addColumn(const std::string& path);
+
+    /**
+     * Registers a column which holds 'constant' for every document and returns its index.
+     */
+    size_t addConstant(const Value& constant);
+
+    size_t numColumns() const {
+        return _columns.size();
+    }
+
+    const ColumnVector& getColumn(size_t column) const {
+        return *_columns[column];
+    }
+
+    /**
+     * Removes all documents, keeping the columns.
+     */
+    void clear();
+
+    bool isFull() const {
+        return _numRows == kMaxRows;
+    }
+
+    /**
+     * Appends an owned document and extracts the value of every column from it.
+     */
+    void appendRow(BSONObj row);
+
+    /**
+     * The number of documents in the batch, including those which were filtered out.
+     */
+    size_t numRows() const {
+        return _numRows;
+    }
+
+    /**
+     * The indexes of the documents which are part of the batch, in order.
+     */
+    const std::vector<uint32_t>& getSelection() const {
+        return _selection;
+    }
+
+    /**
+     * Whether the batch has the input documents themselves, in addition to the columns. A batch
+     * whose columns have been translated by a $project only has the columns.
+     */
+    bool hasRows() const {
+        return _hasRows;
+    }
+
+    const BSONObj& getRow(size_t row) const {
+        dassert(_hasRows);
+        return _rows[row];
+    }
+
+    /**
+     * Removes the documents for which 'predicate' returns false from the selection.
+     */
+    template <typename Predicate>
+    void filter(Predicate predicate) {
+        invariant(_hasRows);
+        size_t kept = 0;
+        for (uint32_t row : _selection) {
+            if (predicate(_rows[row])) {
+                _selection[kept++] = row;
+            }
+        }
+        _selection.resize(kept);
+    }
+
+    /**
+     * Makes this batch hold the documents of 'source', without the documents themselves. Each
+     * column is a copy of the column of 'source' at the same index of 'sourceColumns', or missing
+     * for an index of -1. The entries of 'source' must outlive those of this batch.
+     */
+    void assignColumns(const ColumnBatch& source, const std::vector<int>& sourceColumns);
+
+private:
+    std::vector<std::unique_ptr<ColumnVector>> _columns;
+    std::vector<BSONObj> _rows;
+    std::vector<uint32_t> _selection;
+    size_t _numRows = 0;
+    bool _hasRows = true;
+};
+
+}  // namespace mongo
@@ -0,0 +1,176 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/column_batch.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Asserts that every entry of the column at 'path' is what ExpressionFieldPath evaluates to on
+ * the document.
+ */
+void assertMatchesFieldPath(const ColumnBatch& batch, size_t column, const std::string& path) {
+    VariablesIdGenerator idGenerator;
+    VariablesParseState vps(&idGenerator);
+    auto expression = ExpressionFieldPath::parse("$" + path, vps);
+    for (size_t row = 0; row < batch.numRows(); row++) {
+        Variables vars(0, Document(batch.getRow(row)));
+        Value expected = expression->evaluate(&vars);
+        Value actual = batch.getColumn(column).getValue(row);
+        ASSERT_EQUALS(expected, actual);
+        ASSERT_EQUALS(expected.getType(), actual.getType());
+    }
+}
+
+TEST(ColumnBatchTest, ExtractsTypedColumns) {
+    ColumnBatch batch;
+    ASSERT_EQUALS(0U, batch.addColumn("a"));
+    batch.appendRow(BSON("a" << 1));
+    batch.appendRow(BSON("a" << 2LL));
+    batch.appendRow(BSON("a" << -2.5));
+    batch.appendRow(BSON("a"
+                         << "str"));
+    batch.appendRow(BSON("b" << 1));
+
+    const ColumnVector& column = batch.getColumn(0);
+    ASSERT_EQUALS(5U, column.size());
+    ASSERT(column.kind(0) == ColumnVector::Kind::kInt);
+    ASSERT(column.kind(1) == ColumnVector::Kind::kLong);
+    ASSERT(column.kind(2) == ColumnVector::Kind::kDouble);
+    ASSERT(column.kind(3) == ColumnVector::Kind::kElement);
+    ASSERT(column.kind(4) == ColumnVector::Kind::kMissing);
+
+    ASSERT_EQUALS(1LL, column.longs()[0]);
+    ASSERT_EQUALS(2LL, column.longs()[1]);
+    ASSERT_EQUALS(1.0, column.doubles()[0]);
+    ASSERT_EQUALS(-2.5, column.doubles()[2]);
+    ASSERT_EQUALS(2U, column.numIntegral());
+    ASSERT(column.hasLongs());
+    ASSERT_EQUALS(2ULL, column.maxAbsIntegral());
+    ASSERT_EQUALS(1U, column.numDoubles());
+
+    assertMatchesFieldPath(batch, 0, "a");
+}
+
+TEST(ColumnBatchTest, DottedPathsMatchFieldPathExpression) {
+    ColumnBatch batch;
+    batch.addColumn("a.b");
+    batch.addColumn("a.b.c");
+    batch.appendRow(BSON("a" << BSON("b" << 5)));
+    batch.appendRow(BSON("a" << BSON("b" << BSON("c" << 6))));
+    batch.appendRow(BSON("a" << BSON_ARRAY(BSON("b" << 1) << BSON("b" << 2LL) << 3)));
+    batch.appendRow(BSON("a" << BSON("b" << BSON_ARRAY(BSON("c" << 1) << BSON("x" << 1)))));
+    batch.appendRow(BSON("a" << 1));
+    batch.appendRow(BSONObj());
+
+    assertMatchesFieldPath(batch, 0, "a.b");
+    assertMatchesFieldPath(batch, 1, "a.b.c");
+
+    // A path which crosses an array has the array of values.
+    ASSERT(batch.getColumn(0).kind(2) == ColumnVector::Kind::kValue);
+    ASSERT(batch.getColumn(1).kind(3) == ColumnVector::Kind::kValue);
+}
+
+TEST(ColumnBatchTest, SamePathGetsSameColumn) {
+    ColumnBatch batch;
+    ASSERT_EQUALS(0U, batch.addColumn("a"));
+    ASSERT_EQUALS(1U, batch.addConstant(Value(3)));
+    ASSERT_EQUALS(2U, batch.addColumn("b"));
+    ASSERT_EQUALS(0U, batch.addColumn("a"));
+    ASSERT_EQUALS(3U, batch.addConstant(Value(3)));
+    ASSERT_EQUALS(4U, batch.numColumns());
+}
+
+TEST(ColumnBatchTest, ConstantColumns) {
+    ColumnBatch batch;
+    batch.addConstant(Value(7));
+    batch.addConstant(Value(StringData("x")));
+    batch.appendRow(BSON("a" << 1));
+    batch.appendRow(BSON("a" << 2));
+
+    const ColumnVector& number = batch.getColumn(0);
+    ASSERT(number.isConstant());
+    ASSERT_EQUALS(2U, number.numIntegral());
+    ASSERT_EQUALS(Value(7), number.getValue(1));
+
+    const ColumnVector& str = batch.getColumn(1);
+    ASSERT(str.kind(0) == ColumnVector::Kind::kValue);
+    ASSERT_EQUALS(Value(StringData("x")), str.getValue(1));
+}
+
+TEST(ColumnBatchTest, FilterAndClear) {
+    ColumnBatch batch;
+    batch.addColumn("a");
+    for (int i = 0; i < 10; i++) {
+        batch.appendRow(BSON("a" << i));
+    }
+    batch.filter([](const BSONObj& row) { return row["a"].numberInt() % 3 == 0; });
+
+    ASSERT_EQUALS(10U, batch.numRows());
+    ASSERT((std::vector<uint32_t>{0, 3, 6, 9}) == batch.getSelection());
+    ASSERT_EQUALS(9LL, batch.getColumn(0).longs()[9]);
+
+    batch.clear();
+    ASSERT_EQUALS(0U, batch.numRows());
+    ASSERT(batch.getSelection().empty());
+    ASSERT_EQUALS(0U, batch.getColumn(0).size());
+    ASSERT_EQUALS(0U, batch.getColumn(0).numIntegral());
+}
+
+TEST(ColumnBatchTest, IsFullAtMaxRows) {
+    ColumnBatch batch;
+    for (size_t i = 0; i < ColumnBatch::kMaxRows; i++) {
+        ASSERT(!batch.isFull());
+        batch.appendRow(BSONObj());
+    }
+    ASSERT(batch.isFull());
+}
+
+TEST(ColumnBatchTest, AssignColumnsFromSource) {
+    ColumnBatch source;
+    source.addColumn("x");
+    source.addColumn("y");
+    for (int i = 0; i < 4; i++) {
+        source.appendRow(BSON("x" << i << "y" << i * 1.5));
+    }
+    source.filter([](const BSONObj& row) { return row["x"].numberInt() != 1; });
+
+    ColumnBatch batch;
+    batch.addColumn("renamedY");
+    batch.addColumn("notProjected");
+    batch.addConstant(Value(2));
+    batch.assignColumns(source, {1, -1, -1});
+
+    ASSERT(!batch.hasRows());
+    ASSERT_EQUALS(4U, batch.numRows());
+    ASSERT((std::vector<uint32_t>{0, 2, 3}) == batch.getSelection());
+    for (size_t row = 0; row < 4; row++) {
+        ASSERT_EQUALS(Value(row * 1.5), batch.getColumn(0).getValue(row));
+        ASSERT(batch.getColumn(1).kind(row) == ColumnVector::Kind::kMissing);
+        ASSERT_EQUALS(Value(2), batch.getColumn(2).getValue(row));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -46,10 +46,12 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/matcher.h"
 #include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/column_batch.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/group_table.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/sorter/sorter.h"
 #include "mongo/stdx/functional.h"
@@ -91,6 +93,27 @@ public:
      */
     virtual boost::optional<Document> getNext() = 0;
 
+    /**
+     * Returns whether this source can return its results through getNextBatch(), as columns for
+     * the paths registered in 'batch'. 'needRows' is true if the caller also reads the documents
+     * themselves from the batches. Must be asked before the first result is requested.
+     */
+    virtual bool canProduceBatches(const ColumnBatch& batch, bool needRows) const {
+        return false;
+    }
+
+    /**
+     * Replaces the contents of 'batch' with the next results of this source and returns true, or
+     * returns false at EOF. A batch may have no selected documents left after filtering. The
+     * entries of a batch stay valid until the next call.
+     *
+     * Only called if canProduceBatches() returned true for 'batch', and never mixed with
+     * getNext(). Subclasses must call pExpCtx->checkForInterrupt().
+     */
+    virtual bool getNextBatch(ColumnBatch* batch) {
+        MONGO_UNREACHABLE;
+    }
+
     /**
      * Inform the source that it is no longer needed and may release its resources.  After
      * dispose() is called the source must still be able to handle iteration requests, but may
@@ -332,6 +355,8 @@ public:
     // virtuals from DocumentSource
     ~DocumentSourceCursor() final;
     boost::optional<Document> getNext() final;
+    bool canProduceBatches(const ColumnBatch& batch, bool needRows) const final;
+    bool getNextBatch(ColumnBatch* batch) final;
     const char* getSourceName() const final;
     Value serialize(bool explain = false) const final;
     bool coalesce(const boost::intrusive_ptr<DocumentSource>& nextSource) final;
@@ -469,11 +494,37 @@ public:
 private:
     explicit DocumentSourceGroup(const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
 
-    /// Spill groups map to disk and returns an iterator to the file.
-    std::shared_ptr<Sorter<Value, Value>::Iterator> spill();
+    typedef GroupTable::Accumulators Accumulators;
+    GroupTable groups;
+
+    /**
+     * A file of groups spilled to disk, all of whose keys hash to the same partition. Their
+     * accumulators are serialized for merging. A key may appear in it more than once.
+     */
+    struct SpilledPartition {
+        std::shared_ptr<Sorter<Value, Value>::Iterator> data;
+        // How many times the groups have been partitioned, which selects the bits of the hash.
+        int level;
+    };
+
+    /**
+     * Writes every group in memory to the partition its hash falls into at 'level', and empties
+     * the table.
+     */
+    void spillToPartitions(int level);
+
+    /**
+     * Closes the partitions written by spillToPartitions() and queues them for
+     * loadNextPartition().
+     */
+    void finishPartitions(int level);
 
-    // Only used by spill. Would be function-local if that were legal in C++03.
-    class SpillSTLComparator;
+    /**
+     * Replaces the groups in memory with the merged groups of the next spilled partition. A
+     * partition which does not fit in memory is split into partitions of the next level instead.
+     * Returns false when no partitions are left.
+     */
+    bool loadNextPartition();
 
     /*
       Before returning anything, this source must fetch everything from
@@ -484,6 +535,42 @@ private:
     void populate();
     bool populated;
 
+    /**
+     * Sets up _batch with a column for every _id expression and accumulator argument. Returns
+     * whether populate() can read its input through getNextBatch(), which is the case when all of
+     * them are fields of the input document or constants and the source supports it.
+     */
+    bool prepareBatches();
+
+    /**
+     * The part of populate() which reads the input through getNextBatch(). The accumulators of a
+     * group are fed all its documents of a batch at once.
+     */
+    void populateFromBatches(int* memoryUsageBytes);
+
+    /**
+     * Spills the groups to disk if they use more than the memory limit, or fails if that is not
+     * allowed.
+     */
+    void checkMemoryUsage(int* memoryUsageBytes);
+
+    /**
+     * Returns the accumulators of the group with key 'id', creating them if it is new.
+     */
+    Accumulators& getGroup(const Value& id, int* memoryUsageBytes, bool* inserted);
+
+    /**
+     * Spills the groups in memory after a 'duplicate' group key, to exercise the merging of
+     * spilled groups in debug builds.
+     */
+    void spillOnDuplicateForTesting(bool duplicate);
+
+    /**
+     * Merges the state of the accumulators of a spilled group, as serialized by
+     * spillToPartitions(), into 'accumulators'.
+     */
+    void mergeSpilledState(const Value& state, Accumulators* accumulators, int* memoryUsageBytes);
+
     /**
      * Parses the raw id expression into _idExpressions and possibly _idFieldNames.
      */
@@ -501,10 +588,6 @@ private:
     Value expandId(const Value& val);
 
 
-    typedef std::vector<boost::intrusive_ptr<Accumulator>> Accumulators;
-    typedef std::unordered_map<Value, Accumulators, Value::Hash> GroupsMap;
-    GroupsMap groups;
-
     /*
       The field names for the result documents and the accumulator
       factories for the result documents.  The Expressions are the
@@ -528,18 +611,23 @@ private:
     bool _spilled;
     const bool _extSortAllowed;
     const int _maxMemoryUsageBytes;
+    const size_t _numSpillPartitions;
     std::unique_ptr<Variables> _variables;
     std::vector<std::string> _idFieldNames;  // used when id is a document
     std::vector<boost::intrusive_ptr<Expression>> _idExpressions;
 
-    // only used when !_spilled
-    GroupsMap::iterator groupsIterator;
+    // only used when reading the input through getNextBatch()
+    std::unique_ptr<ColumnBatch> _batch;
+    std::vector<size_t> _idColumns;
+    std::vector<size_t> _argColumns;
+
+    // The position in groups of the next group to return.
+    size_t _nextGroup;
 
     // only used when _spilled
-    std::unique_ptr<Sorter<Value, Value>::Iterator> _sorterIterator;
-    std::pair<Value, Value> _firstPartOfNextGroup;
-    Value _currentId;
-    Accumulators _currentAccumulators;
+    std::vector<std::unique_ptr<SortedFileWriter<Value, Value>>> _partitionWriters;
+    std::vector<SpilledPartition> _partitions;  // waiting to be loaded
+    int _numSpills;
 };
 
 /**
@@ -572,6 +660,8 @@ class DocumentSourceMatch final : public DocumentSource {
 public:
     // virtuals from DocumentSource
     boost::optional<Document> getNext() final;
+    bool canProduceBatches(const ColumnBatch& batch, bool needRows) const final;
+    bool getNextBatch(ColumnBatch* batch) final;
     const char* getSourceName() const final;
     bool coalesce(const boost::intrusive_ptr<DocumentSource>& nextSource) final;
     Value serialize(bool explain = false) const final;
@@ -697,9 +787,17 @@ public:
     static boost::intrusive_ptr<DocumentSourceMock> create(
         const std::initializer_list<const char*>& jsons);
 
+    bool canProduceBatches(const ColumnBatch& batch, bool needRows) const override {
+        return produceBatches;
+    }
+    bool getNextBatch(ColumnBatch* batch) override;
+
     // Return documents from front of queue.
     std::deque<Document> queue;
     bool disposed = false;
+
+    // Whether the documents can also be read through getNextBatch(), as their BSON.
+    bool produceBatches = false;
 };
 
 class DocumentSourceOut final : public DocumentSource,
@@ -761,6 +859,8 @@ class DocumentSourceProject final : public DocumentSource {
 public:
     // virtuals from DocumentSource
     boost::optional<Document> getNext() final;
+    bool canProduceBatches(const ColumnBatch& batch, bool needRows) const final;
+    bool getNextBatch(ColumnBatch* batch) final;
     const char* getSourceName() const final;
     boost::intrusive_ptr<DocumentSource> optimize() final;
     Value serialize(bool explain = false) const final;
@@ -789,10 +889,22 @@ private:
     DocumentSourceProject(const boost::intrusive_ptr<ExpressionContext>& pExpCtx,
                           const boost::intrusive_ptr<ExpressionObject>& exprObj);
 
+    /**
+     * Returns a batch with a column for the input path of every column of 'batch', filling in
+     * '*inputColumns' with the index of each, or -1 for the columns which are always missing
+     * from the output. Returns null if a column of 'batch' is computed by the projection.
+     */
+    std::unique_ptr<ColumnBatch> makeInputBatch(const ColumnBatch& batch,
+                                                std::vector<int>* inputColumns) const;
+
     // configuration state
     std::unique_ptr<Variables> _variables;
     boost::intrusive_ptr<ExpressionObject> pEO;
     BSONObj _raw;
+
+    // The batch read from the source by getNextBatch(), and where its columns go in the output.
+    std::unique_ptr<ColumnBatch> _inputBatch;
+    std::vector<int> _inputColumns;
 };
 
 class DocumentSourceRedact final : public DocumentSource {
@@ -1300,6 +1412,66 @@ private:
         invariant(false);
     }
 
+    /**
+     * How the matches of the input documents are looked up in the foreign collection.
+     */
+    enum class JoinStrategy {
+        // One {foreignField: {$eq: <local value>}} query per input document.
+        kNestedLoop,
+        // One {foreignField: {$in: [<local values>]}} query per batch of input documents.
+        kBatchedIn,
+        // Probe a hash table built from a single scan of the whole foreign collection.
+        kHashJoin,
+    };
+
+    static const char* joinStrategyName(JoinStrategy strategy);
+
+    /**
+     * An input document read ahead as part of a batch, and its matches once they are known.
+     */
+    struct PendingInput {
+        Document doc;
+        Value localValue;
+        // If false, 'matches' is unused and the matches are found by a query for this document
+        // alone once it is returned.
+        bool resolved = false;
+        std::vector<BSONObj> matches;
+    };
+
+    /**
+     * The cost check: picks a strategy for a full batch of input from the size of the foreign
+     * collection. At run time a hash join falls back to batched $in queries if the whole input
+     * fits in a single batch or the hash table outgrows its memory limit.
+     */
+    JoinStrategy plannedJoinStrategy() const;
+
+    /**
+     * Reads the next batch of input documents into _batch and resolves as many of them as the
+     * strategy allows. Chooses the strategy on the first call.
+     */
+    void fillBatch();
+    void resolveWithInQuery();
+    void resolveWithHashTable();
+
+    /**
+     * Loads the foreign collection into _foreignDocs and _hashTable. Returns false, leaving both
+     * empty, if they would take more than internalDocumentSourceLookupHashJoinMaxBytes.
+     */
+    bool buildHashTable();
+
+    /**
+     * Returns every value of the foreign field in 'foreignDoc' which an {$eq: <value>} query on
+     * the foreign field could match. Candidates still have to be confirmed with the query itself.
+     */
+    std::vector<Value> matchCandidates(const BSONObj& foreignDoc) const;
+
+    /**
+     * Moves the next input document into _input and either its matches into _matches or a
+     * query for them into _cursor. Returns false once the input is exhausted.
+     */
+    bool nextInput();
+    bool haveMoreMatches();
+
     boost::optional<Document> unwindResult();
     BSONObj queryForInput(const Document& input) const;
 
@@ -1314,5 +1486,19 @@ private:
     std::unique_ptr<DBClientCursor> _cursor;
     long long _cursorIndex = 0;
     boost::optional<Document> _input;
+
+    // Matches of _input when they were resolved as part of a batch, in which case _cursor is
+    // null. _matchIndex is the next one to return when unwinding.
+    std::vector<BSONObj> _matches;
+    size_t _matchIndex = 0;
+
+    // Set by the first call to fillBatch().
+    boost::optional<JoinStrategy> _strategy;
+    std::deque<PendingInput> _batch;
+
+    // The build side of a hash join: the foreign documents, and the positions in _foreignDocs of
+    // the documents each candidate value (see matchCandidates()) occurs in.
+    std::vector<BSONObj> _foreignDocs;
+    std::unordered_map<Value, std::vector<size_t>, Value::Hash> _hashTable;
 };
 }
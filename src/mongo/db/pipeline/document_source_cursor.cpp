@@ -47,6 +47,29 @@ using boost::intrusive_ptr;
 using std::shared_ptr;
 using std::string;
 
+namespace {
+
+/**
+ * Checks how the PlanExecutor ended once it stopped returning documents.
+ */
+void checkFinalState(PlanExecutor::ExecState state, const BSONObj& obj) {
+    uassert(16028,
+            str::stream() << "collection or index disappeared when cursor yielded: "
+                          << WorkingSetCommon::toStatusString(obj),
+            state != PlanExecutor::DEAD);
+
+    uassert(
+        17285,
+        str::stream() << "cursor encountered an error: " << WorkingSetCommon::toStatusString(obj),
+        state != PlanExecutor::FAILURE);
+
+    massert(17286,
+            str::stream() << "Unexpected return from PlanExecutor::getNext: " << state,
+            state == PlanExecutor::IS_EOF || state == PlanExecutor::ADVANCED);
+}
+
+}  // namespace
+
 DocumentSourceCursor::~DocumentSourceCursor() {
     dispose();
 }
@@ -119,20 +142,52 @@ void DocumentSourceCursor::loadBatch() {
     // If we got here, there won't be any more documents, so destroy the executor. Can't use
     // dispose since we want to keep the _currentBatch.
     _exec.reset();
+    checkFinalState(state, obj);
+}
 
-    uassert(16028,
-            str::stream() << "collection or index disappeared when cursor yielded: "
-                          << WorkingSetCommon::toStatusString(obj),
-            state != PlanExecutor::DEAD);
+bool DocumentSourceCursor::canProduceBatches(const ColumnBatch& batch, bool needRows) const {
+    // The text score is only available from the Documents made by getNext().
+    return _exec && !_projection.hasField(Document::metaFieldTextScore);
+}
 
-    uassert(
-        17285,
-        str::stream() << "cursor encountered an error: " << WorkingSetCommon::toStatusString(obj),
-        state != PlanExecutor::FAILURE);
+bool DocumentSourceCursor::getNextBatch(ColumnBatch* batch) {
+    pExpCtx->checkForInterrupt();
 
-    massert(17286,
-            str::stream() << "Unexpected return from PlanExecutor::getNext: " << state,
-            state == PlanExecutor::IS_EOF || state == PlanExecutor::ADVANCED);
+    batch->clear();
+    if (!_exec) {
+        dispose();
+        return false;
+    }
+
+    // Like loadBatch(), but keeps the BSON of the results rather than making Documents.
+    const NamespaceString nss(_ns);
+    AutoGetCollectionForRead autoColl(pExpCtx->opCtx, nss);
+
+    _exec->restoreState();
+
+    int memUsageBytes = 0;
+    BSONObj obj;
+    PlanExecutor::ExecState state;
+    while ((state = _exec->getNext(&obj, NULL)) == PlanExecutor::ADVANCED) {
+        memUsageBytes += obj.objsize();
+        batch->appendRow(obj.getOwned());
+
+        if (_limit) {
+            if (++_docsAddedToBatches == _limit->getLimit()) {
+                break;
+            }
+            verify(_docsAddedToBatches < _limit->getLimit());
+        }
+
+        if (batch->isFull() || memUsageBytes > FindCommon::kMaxBytesToReturnToClientAtOnce) {
+            _exec->saveState();
+            return true;
+        }
+    }
+
+    _exec.reset();
+    checkFinalState(state, obj);
+    return batch->numRows() > 0;
 }
 
 long long DocumentSourceCursor::getLimit() const {
@@ -28,6 +28,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/accumulator.h"
@@ -36,6 +37,8 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
 
 namespace mongo {
 
@@ -44,6 +47,17 @@ using std::shared_ptr;
 using std::pair;
 using std::vector;
 
+// Lets $group read fields of its input as column batches rather than one document at a time.
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGroupUseBatches, bool, true);
+
+// How much memory the groups of a $group may use before they are spilled to disk.
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGroupMaxMemoryBytes, int, 100 * 1024 * 1024);
+
+// How many files $group splits its groups into by hash when they do not fit in memory. Each file is
+// merged on its own, so one only needs memory for its share of the groups. Between 2 and 256, since
+// each level of splitting uses one byte of the hash.
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGroupSpillPartitions, int, 16);
+
 REGISTER_DOCUMENT_SOURCE(group, DocumentSourceGroup::createFromBson);
 
 const char* DocumentSourceGroup::getSourceName() const {
@@ -56,71 +70,27 @@ boost::optional<Document> DocumentSourceGroup::getNext() {
     if (!populated)
         populate();
 
-    if (_spilled) {
-        if (!_sorterIterator)
-            return boost::none;
-
-        const size_t numAccumulators = vpAccumulatorFactory.size();
-        for (size_t i = 0; i < numAccumulators; i++) {
-            _currentAccumulators[i]->reset();  // prep accumulators for a new group
-        }
-
-        _currentId = _firstPartOfNextGroup.first;
-        while (_currentId == _firstPartOfNextGroup.first) {
-            // Inside of this loop, _firstPartOfNextGroup is the current data being processed.
-            // At loop exit, it is the first value to be processed in the next group.
-
-            switch (numAccumulators) {  // mirrors switch in spill()
-                case 0:                 // no Accumulators so no Values
-                    break;
-
-                case 1:  // single accumulators serialize as a single Value
-                    _currentAccumulators[0]->process(_firstPartOfNextGroup.second,
-                                                     /*merging=*/true);
-                    break;
-
-                default: {  // multiple accumulators serialize as an array
-                    const vector<Value>& accumulatorStates =
-                        _firstPartOfNextGroup.second.getArray();
-                    for (size_t i = 0; i < numAccumulators; i++) {
-                        _currentAccumulators[i]->process(accumulatorStates[i],
-                                                         /*merging=*/true);
-                    }
-                    break;
-                }
-            }
-
-            if (!_sorterIterator->more()) {
-                dispose();
-                break;
-            }
-
-            _firstPartOfNextGroup = _sorterIterator->next();
-        }
-
-        return makeDocument(_currentId, _currentAccumulators, pExpCtx->inShard);
-
-    } else {
-        if (groups.empty())
-            return boost::none;
+    // Once spilled, the groups are in partitions which are merged in memory one at a time.
+    if (_nextGroup == groups.size() && !loadNextPartition())
+        return boost::none;
 
-        Document out =
-            makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->inShard);
+    GroupTable::Group& group = groups[_nextGroup++];
+    Document out = makeDocument(group.id, group.accumulators, pExpCtx->inShard);
 
-        if (++groupsIterator == groups.end())
-            dispose();
+    if (_nextGroup == groups.size() && _partitions.empty())
+        dispose();
 
-        return out;
-    }
+    return out;
 }
 
 void DocumentSourceGroup::dispose() {
     // free our resources
-    GroupsMap().swap(groups);
-    _sorterIterator.reset();
+    groups.releaseMemory();
+    _partitionWriters.clear();
+    _partitions.clear();
 
     // make us look done
-    groupsIterator = groups.end();
+    _nextGroup = 0;
 
     // free our source's resources
     pSource->dispose();
@@ -203,7 +173,11 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
       _doingMerge(false),
       _spilled(false),
       _extSortAllowed(pExpCtx->extSortAllowed && !pExpCtx->inRouter),
-      _maxMemoryUsageBytes(100 * 1024 * 1024) {}
+      _maxMemoryUsageBytes(internalDocumentSourceGroupMaxMemoryBytes.load()),
+      _numSpillPartitions(
+          std::min(std::max(internalDocumentSourceGroupSpillPartitions.load(), 2), 256)),
+      _nextGroup(0),
+      _numSpills(0) {}
 
 void DocumentSourceGroup::addAccumulator(const std::string& fieldName,
                                          Accumulator::Factory accumulatorFactory,
@@ -296,165 +270,352 @@ intrusive_ptr<DocumentSource> DocumentSourceGroup::createFromBson(
 }
 
 namespace {
-class SorterComparator {
-public:
-    typedef pair<Value, Value> Data;
-    int operator()(const Data& lhs, const Data& rhs) const {
-        return Value::compare(lhs.first, rhs.first);
-    }
-};
+
+// Each level of partitioning of the spilled groups uses the next byte of the hash, starting from
+// the top, so that the groups of one partition are spread over all partitions of the next level.
+// The table places groups by the low bits of the hash.
+const int kMaxPartitionLevels = 4;
+
+size_t partitionOf(uint64_t hash, int level, size_t numPartitions) {
+    return ((hash >> (56 - 8 * level)) & 0xff) % numPartitions;
 }
 
+}  // namespace
+
 void DocumentSourceGroup::populate() {
     const size_t numAccumulators = vpAccumulatorFactory.size();
     dassert(numAccumulators == vpExpression.size());
 
-    // pushed to on spill()
-    vector<shared_ptr<Sorter<Value, Value>::Iterator>> sortedFiles;
     int memoryUsageBytes = 0;
 
-    // This loop consumes all input from pSource and buckets it based on pIdExpression.
-    while (boost::optional<Document> input = pSource->getNext()) {
-        if (memoryUsageBytes > _maxMemoryUsageBytes) {
-            uassert(16945,
-                    "Exceeded memory limit for $group, but didn't allow external sort."
-                    " Pass allowDiskUse:true to opt in.",
-                    _extSortAllowed);
-            sortedFiles.push_back(spill());
-            memoryUsageBytes = 0;
-        }
+    if (prepareBatches()) {
+        populateFromBatches(&memoryUsageBytes);
+    } else {
+        // This loop consumes all input from pSource and buckets it based on pIdExpression.
+        while (boost::optional<Document> input = pSource->getNext()) {
+            checkMemoryUsage(&memoryUsageBytes);
 
-        _variables->setRoot(*input);
+            _variables->setRoot(*input);
 
-        /* get the _id value */
-        Value id = computeId(_variables.get());
+            /* get the _id value */
+            Value id = computeId(_variables.get());
 
-        /* treat missing values the same as NULL SERVER-4674 */
-        if (id.missing())
-            id = Value(BSONNULL);
+            /* treat missing values the same as NULL SERVER-4674 */
+            if (id.missing())
+                id = Value(BSONNULL);
 
-        /*
-          Look for the _id value in the map; if it's not there, add a
-          new entry with a blank accumulator.
-        */
-        const size_t oldSize = groups.size();
-        vector<intrusive_ptr<Accumulator>>& group = groups[id];
-        const bool inserted = groups.size() != oldSize;
-
-        if (inserted) {
-            memoryUsageBytes += id.getApproximateSize();
+            /*
+              Look for the _id value in the map; if it's not there, add a
+              new entry with a blank accumulator.
+            */
+            bool inserted;
+            Accumulators& group = getGroup(id, &memoryUsageBytes, &inserted);
 
-            // Add the accumulators
-            group.reserve(numAccumulators);
-            for (size_t i = 0; i < numAccumulators; i++) {
-                group.push_back(vpAccumulatorFactory[i]());
-            }
-        } else {
+            /* tickle all the accumulators for the group we found */
+            dassert(numAccumulators == group.size());
             for (size_t i = 0; i < numAccumulators; i++) {
                 // subtract old mem usage. New usage added back after processing.
                 memoryUsageBytes -= group[i]->memUsageForSorter();
+                group[i]->process(vpExpression[i]->evaluate(_variables.get()), _doingMerge);
+                memoryUsageBytes += group[i]->memUsageForSorter();
             }
-        }
 
-        /* tickle all the accumulators for the group we found */
-        dassert(numAccumulators == group.size());
-        for (size_t i = 0; i < numAccumulators; i++) {
-            group[i]->process(vpExpression[i]->evaluate(_variables.get()), _doingMerge);
-            memoryUsageBytes += group[i]->memUsageForSorter();
-        }
+            // We are done with the ROOT document so release it.
+            _variables->clearRoot();
 
-        // We are done with the ROOT document so release it.
-        _variables->clearRoot();
-
-        DEV {
-            // In debug mode, spill every time we have a duplicate id to stress merge logic.
-            if (!inserted  // is a dup
-                &&
-                !pExpCtx->inRouter  // can't spill to disk in router
-                &&
-                !_extSortAllowed  // don't change behavior when testing external sort
-                &&
-                sortedFiles.size() < 20  // don't open too many FDs
-                ) {
-                sortedFiles.push_back(spill());
-            }
+            spillOnDuplicateForTesting(!inserted);
         }
     }
 
     // These blocks do any final steps necessary to prepare to output results.
-    if (!sortedFiles.empty()) {
-        _spilled = true;
-        if (!groups.empty()) {
-            sortedFiles.push_back(spill());
+    if (_spilled) {
+        // The groups left in memory join the partitions, which getNext() merges one at a time.
+        spillToPartitions(0);
+        finishPartitions(0);
+    }
+    _nextGroup = 0;
+
+    populated = true;
+}
+
+void DocumentSourceGroup::checkMemoryUsage(int* memoryUsageBytes) {
+    if (*memoryUsageBytes > _maxMemoryUsageBytes) {
+        uassert(16945,
+                "Exceeded memory limit for $group, but didn't allow external sort."
+                " Pass allowDiskUse:true to opt in.",
+                _extSortAllowed);
+        spillToPartitions(0);
+        *memoryUsageBytes = 0;
+    }
+}
+
+void DocumentSourceGroup::spillOnDuplicateForTesting(bool duplicate) {
+    DEV {
+        // In debug mode, spill every time we have a duplicate id to stress merge logic. Not in the
+        // router, which can't spill to disk, nor when testing external sort.
+        if (duplicate && !pExpCtx->inRouter && !_extSortAllowed && _numSpills < 20) {
+            spillToPartitions(0);
         }
+    }
+}
 
-        // We won't be using groups again so free its memory.
-        GroupsMap().swap(groups);
+DocumentSourceGroup::Accumulators& DocumentSourceGroup::getGroup(const Value& id,
+                                                                 int* memoryUsageBytes,
+                                                                 bool* inserted) {
+    GroupTable::Group& group = groups.findOrInsert(id, GroupTable::hash(id), inserted);
 
-        _sorterIterator.reset(
-            Sorter<Value, Value>::Iterator::merge(sortedFiles, SortOptions(), SorterComparator()));
+    if (*inserted) {
+        *memoryUsageBytes += id.getApproximateSize();
 
-        // prepare current to accumulate data
-        _currentAccumulators.reserve(numAccumulators);
+        // Add the accumulators
+        const size_t numAccumulators = vpAccumulatorFactory.size();
+        group.accumulators.reserve(numAccumulators);
         for (size_t i = 0; i < numAccumulators; i++) {
-            _currentAccumulators.push_back(vpAccumulatorFactory[i]());
+            group.accumulators.push_back(vpAccumulatorFactory[i]());
+            *memoryUsageBytes += group.accumulators.back()->memUsageForSorter();
+        }
+    }
+    return group.accumulators;
+}
+
+bool DocumentSourceGroup::prepareBatches() {
+    // Merging reads the partial results of the shards, which batches have no use for.
+    if (_doingMerge || !internalDocumentSourceGroupUseBatches.load())
+        return false;
+
+    auto batch = stdx::make_unique<ColumnBatch>();
+    auto addColumn = [&batch](const intrusive_ptr<Expression>& expr, vector<size_t>* columns) {
+        if (auto fieldPath = dynamic_cast<ExpressionFieldPath*>(expr.get())) {
+            if (!fieldPath->isInputField())
+                return false;
+            columns->push_back(batch->addColumn(fieldPath->getFieldPath().tail().getPath(false)));
+            return true;
         }
+        if (auto constant = dynamic_cast<ExpressionConstant*>(expr.get())) {
+            columns->push_back(batch->addConstant(constant->getValue()));
+            return true;
+        }
+        return false;
+    };
 
-        verify(_sorterIterator->more());  // we put data in, we should get something out.
-        _firstPartOfNextGroup = _sorterIterator->next();
-    } else {
-        // start the group iterator
-        groupsIterator = groups.begin();
+    vector<size_t> idColumns;
+    for (auto&& idExpression : _idExpressions) {
+        if (!addColumn(idExpression, &idColumns))
+            return false;
     }
 
-    populated = true;
+    vector<size_t> argColumns;
+    for (auto&& argExpression : vpExpression) {
+        if (!addColumn(argExpression, &argColumns))
+            return false;
+    }
+
+    if (!pSource->canProduceBatches(*batch, /*needRows=*/false))
+        return false;
+
+    _batch = std::move(batch);
+    _idColumns = std::move(idColumns);
+    _argColumns = std::move(argColumns);
+    return true;
 }
 
-class DocumentSourceGroup::SpillSTLComparator {
-public:
-    bool operator()(const GroupsMap::value_type* lhs, const GroupsMap::value_type* rhs) const {
-        return Value::compare(lhs->first, rhs->first) < 0;
-    }
-};
+void DocumentSourceGroup::populateFromBatches(int* memoryUsageBytes) {
+    const size_t numAccumulators = vpAccumulatorFactory.size();
 
-shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
-    vector<const GroupsMap::value_type*> ptrs;  // using pointers to speed sorting
-    ptrs.reserve(groups.size());
-    for (GroupsMap::const_iterator it = groups.begin(), end = groups.end(); it != end; ++it) {
-        ptrs.push_back(&*it);
+    bool constantId = true;
+    for (size_t column : _idColumns) {
+        constantId = constantId && _batch->getColumn(column).isConstant();
     }
 
-    stable_sort(ptrs.begin(), ptrs.end(), SpillSTLComparator());
+    // The groups of the current batch in order of appearance, with the rows of each.
+    vector<pair<Accumulators*, vector<uint32_t>>> batchGroups;
+    std::unordered_map<Accumulators*, size_t> batchGroupIndexes;
+
+    while (pSource->getNextBatch(_batch.get())) {
+        checkMemoryUsage(memoryUsageBytes);
+
+        const vector<uint32_t>& rows = _batch->getSelection();
+        if (rows.empty())
+            continue;
+
+        size_t numBatchGroups = 0;
+        bool sawDuplicate = false;
+        for (size_t r = 0; r < rows.size(); r++) {
+            Value id;
+            if (_idColumns.size() == 1) {
+                id = _batch->getColumn(_idColumns[0]).getValue(rows[r]);
+            } else {
+                vector<Value> vals;
+                vals.reserve(_idColumns.size());
+                for (size_t column : _idColumns) {
+                    vals.push_back(_batch->getColumn(column).getValue(rows[r]));
+                }
+                id = Value(std::move(vals));
+            }
+
+            /* treat missing values the same as NULL SERVER-4674 */
+            if (id.missing())
+                id = Value(BSONNULL);
 
-    SortedFileWriter<Value, Value> writer(SortOptions().TempDir(pExpCtx->tempDir));
-    switch (vpAccumulatorFactory.size()) {  // same as ptrs[i]->second.size() for all i.
-        case 0:                             // no values, essentially a distinct
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first, Value());
+            bool inserted;
+            Accumulators* group = &getGroup(id, memoryUsageBytes, &inserted);
+            sawDuplicate = sawDuplicate || !inserted;
+
+            if (constantId) {
+                // Every row of the batch is in this group.
+                batchGroups.resize(1);
+                batchGroups[0].first = group;
+                numBatchGroups = 1;
+                break;
             }
-            break;
 
-        case 1:  // just one value, use optimized serialization as single Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first,
-                                        ptrs[i]->second[0]->getValue(/*toBeMerged=*/true));
+            auto it = batchGroupIndexes.emplace(group, numBatchGroups);
+            if (it.second) {
+                if (batchGroups.size() == numBatchGroups)
+                    batchGroups.emplace_back();
+                batchGroups[numBatchGroups].first = group;
+                batchGroups[numBatchGroups].second.clear();
+                numBatchGroups++;
             }
-            break;
+            batchGroups[it.first->second].second.push_back(rows[r]);
+        }
+        batchGroupIndexes.clear();
+
+        for (size_t g = 0; g < numBatchGroups; g++) {
+            Accumulators& group = *batchGroups[g].first;
+            const vector<uint32_t>& groupRows = constantId ? rows : batchGroups[g].second;
+            for (size_t i = 0; i < numAccumulators; i++) {
+                *memoryUsageBytes -= group[i]->memUsageForSorter();
+                group[i]->processColumn(_batch->getColumn(_argColumns[i]), groupRows);
+                *memoryUsageBytes += group[i]->memUsageForSorter();
+            }
+        }
 
-        default:  // multiple values, serialize as array-typed Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
+        // Like populate(), but once per batch.
+        spillOnDuplicateForTesting(sawDuplicate);
+    }
+}
+
+void DocumentSourceGroup::spillToPartitions(int level) {
+    if (_partitionWriters.empty())
+        _partitionWriters.resize(_numSpillPartitions);
+
+    const size_t numAccumulators = vpAccumulatorFactory.size();
+    for (size_t g = 0; g < groups.size(); g++) {
+        const GroupTable::Group& group = groups[g];
+
+        auto& writer = _partitionWriters[partitionOf(group.hash, level, _partitionWriters.size())];
+        if (!writer) {
+            writer = stdx::make_unique<SortedFileWriter<Value, Value>>(
+                SortOptions().TempDir(pExpCtx->tempDir));
+        }
+
+        switch (numAccumulators) {  // mirrors switch in mergeSpilledState()
+            case 0:                 // no values, essentially a distinct
+                writer->addAlreadySorted(group.id, Value());
+                break;
+
+            case 1:  // just one value, use optimized serialization as single Value
+                writer->addAlreadySorted(group.id,
+                                         group.accumulators[0]->getValue(/*toBeMerged=*/true));
+                break;
+
+            default: {  // multiple values, serialize as array-typed Value
                 vector<Value> accums;
-                for (size_t j = 0; j < ptrs[i]->second.size(); j++) {
-                    accums.push_back(ptrs[i]->second[j]->getValue(/*toBeMerged=*/true));
+                accums.reserve(numAccumulators);
+                for (size_t i = 0; i < numAccumulators; i++) {
+                    accums.push_back(group.accumulators[i]->getValue(/*toBeMerged=*/true));
                 }
-                writer.addAlreadySorted(ptrs[i]->first, Value(std::move(accums)));
+                writer->addAlreadySorted(group.id, Value(std::move(accums)));
+                break;
             }
-            break;
+        }
     }
 
     groups.clear();
+    _spilled = true;
+    _numSpills++;
+}
+
+void DocumentSourceGroup::finishPartitions(int level) {
+    // Only the partitions which were written to have a writer, so none of the files is empty.
+    for (auto&& writer : _partitionWriters) {
+        if (writer) {
+            _partitions.push_back(
+                {std::shared_ptr<Sorter<Value, Value>::Iterator>(writer->done()), level});
+            writer.reset();
+        }
+    }
+}
+
+void DocumentSourceGroup::mergeSpilledState(const Value& state,
+                                            Accumulators* accumulators,
+                                            int* memoryUsageBytes) {
+    const size_t numAccumulators = accumulators->size();
+    for (size_t i = 0; i < numAccumulators; i++) {
+        *memoryUsageBytes -= (*accumulators)[i]->memUsageForSorter();
+    }
 
-    return shared_ptr<Sorter<Value, Value>::Iterator>(writer.done());
+    switch (numAccumulators) {  // mirrors switch in spillToPartitions()
+        case 0:                 // no Accumulators so no Values
+            break;
+
+        case 1:  // single accumulators serialize as a single Value
+            (*accumulators)[0]->process(state, /*merging=*/true);
+            break;
+
+        default: {  // multiple accumulators serialize as an array
+            const vector<Value>& accumulatorStates = state.getArray();
+            for (size_t i = 0; i < numAccumulators; i++) {
+                (*accumulators)[i]->process(accumulatorStates[i], /*merging=*/true);
+            }
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < numAccumulators; i++) {
+        *memoryUsageBytes += (*accumulators)[i]->memUsageForSorter();
+    }
+}
+
+bool DocumentSourceGroup::loadNextPartition() {
+    while (!_partitions.empty()) {
+        SpilledPartition partition = std::move(_partitions.back());
+        _partitions.pop_back();
+
+        groups.clear();
+        _nextGroup = 0;
+
+        int memoryUsageBytes = 0;
+        bool split = false;
+        while (partition.data->more()) {
+            // Past the last level, a partition which does not fit is merged in memory anyway.
+            if (memoryUsageBytes > _maxMemoryUsageBytes &&
+                partition.level + 1 < kMaxPartitionLevels) {
+                spillToPartitions(partition.level + 1);
+                memoryUsageBytes = 0;
+                split = true;
+            }
+
+            std::pair<Value, Value> spilled = partition.data->next();
+            bool inserted;
+            Accumulators& accumulators = getGroup(spilled.first, &memoryUsageBytes, &inserted);
+            mergeSpilledState(spilled.second, &accumulators, &memoryUsageBytes);
+        }
+
+        // Deletes the file.
+        partition.data.reset();
+
+        if (split) {
+            spillToPartitions(partition.level + 1);
+            finishPartitions(partition.level + 1);
+            continue;
+        }
+
+        if (!groups.empty())
+            return true;
+    }
+    return false;
 }
 
 void DocumentSourceGroup::parseIdExpression(BSONElement groupField,
@@ -26,22 +26,81 @@
  *    it in the license file.
  */
 
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
 #include "mongo/platform/basic.h"
 
 #include "document_source.h"
 
 #include "mongo/base/init.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/log.h"
 
 namespace mongo {
 
 using boost::intrusive_ptr;
 
+// How many input documents $lookup reads ahead and looks up together. 1 disables batching.
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupBatchSize, int, 100);
+
+// $lookup builds a hash table from foreign collections up to this size.
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupHashJoinMaxBytes, int, 32 * 1024 * 1024);
+
+// If the matches of one batch take more than this, the batch is looked up one document at a time.
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupBatchMaxBytes, int, 64 * 1024 * 1024);
+
+namespace {
+
+// Keeps the $in array of a batch well within the maximum BSON size.
+const size_t kMaxBatchValueBytes = 1024 * 1024;
+
+/**
+ * Returns whether the inputs with 'localValue' can be looked up through an $in query or a hash
+ * table probe. {$eq: null} also matches missing fields and a regex inside $in is a pattern match,
+ * so such inputs are looked up on their own.
+ */
+bool isBatchableLocalValue(const Value& localValue) {
+    switch (localValue.getType()) {
+        case jstNULL:
+        case Undefined:
+        case RegEx:
+            return false;
+        default:
+            return true;
+    }
+}
+
+/**
+ * The {foreignField: {$eq: <local value>}} query of one input document, for confirming
+ * candidate matches.
+ */
+class EqualityProbe {
+public:
+    EqualityProbe(StringData path, const Value& localValue) {
+        BSONObjBuilder bob;
+        localValue.addToBsonObj(&bob, "");
+        _rhs = bob.obj();
+        invariantOK(_expr.init(path, _rhs.firstElement()));
+    }
+
+    bool matches(const BSONObj& foreignDoc) const {
+        return _expr.matchesBSON(foreignDoc);
+    }
+
+private:
+    BSONObj _rhs;
+    EqualityMatchExpression _expr;
+};
+
+}  // namespace
+
 DocumentSourceLookUp::DocumentSourceLookUp(NamespaceString fromNs,
                                            std::string as,
                                            std::string localField,
@@ -60,6 +119,18 @@ const char* DocumentSourceLookUp::getSourceName() const {
     return "$lookup";
 }
 
+const char* DocumentSourceLookUp::joinStrategyName(JoinStrategy strategy) {
+    switch (strategy) {
+        case JoinStrategy::kNestedLoop:
+            return "nestedLoop";
+        case JoinStrategy::kBatchedIn:
+            return "batchedIn";
+        case JoinStrategy::kHashJoin:
+            return "hashJoin";
+    }
+    MONGO_UNREACHABLE;
+}
+
 boost::optional<Document> DocumentSourceLookUp::getNext() {
     pExpCtx->checkForInterrupt();
 
@@ -69,29 +140,276 @@ boost::optional<Document> DocumentSourceLookUp::getNext() {
         return unwindResult();
     }
 
-    boost::optional<Document> input = pSource->getNext();
-    if (!input)
+    if (!nextInput())
         return {};
-    BSONObj query = queryForInput(*input);
-    std::unique_ptr<DBClientCursor> cursor = _mongod->directClient()->query(_fromNs.ns(), query);
 
     std::vector<Value> results;
     int objsize = 0;
-    while (cursor->more()) {
-        BSONObj result = cursor->nextSafe();
+    auto addResult = [&](const BSONObj& result) {
         objsize += result.objsize();
         uassert(4568,
                 str::stream() << "Total size of documents in " << _fromNs.coll() << " matching "
-                              << query << " exceeds maximum document size",
+                              << queryForInput(*_input) << " exceeds maximum document size",
                 objsize <= BSONObjMaxInternalSize);
         results.push_back(Value(result));
+    };
+
+    if (_cursor) {
+        while (_cursor->more()) {
+            addResult(_cursor->nextSafe());
+        }
+        _cursor.reset();
+    } else {
+        for (auto&& result : _matches) {
+            addResult(result);
+        }
+        _matches.clear();
     }
 
-    MutableDocument output(std::move(*input));
+    MutableDocument output(std::move(*_input));
     output.setNestedField(_as, Value(std::move(results)));
     return output.freeze();
 }
 
+DocumentSourceLookUp::JoinStrategy DocumentSourceLookUp::plannedJoinStrategy() const {
+    if (internalDocumentSourceLookupBatchSize.load() <= 1) {
+        return JoinStrategy::kNestedLoop;
+    }
+
+    // A missing collection has no stats, and nothing to scan either.
+    long long foreignBytes = 0;
+    BSONObj collStats;
+    if (_mongod->directClient()->runCommand(
+            _fromNs.db().toString(), BSON("collStats" << _fromNs.coll()), collStats)) {
+        foreignBytes = collStats["size"].safeNumberLong();
+    }
+
+    if (foreignBytes <= internalDocumentSourceLookupHashJoinMaxBytes.load()) {
+        return JoinStrategy::kHashJoin;
+    }
+    return JoinStrategy::kBatchedIn;
+}
+
+void DocumentSourceLookUp::fillBatch() {
+    invariant(_batch.empty());
+
+    const size_t batchSize = std::max(1, internalDocumentSourceLookupBatchSize.load());
+    size_t valueBytes = 0;
+    bool inputExhausted = false;
+    while (_batch.size() < batchSize && valueBytes < kMaxBatchValueBytes) {
+        boost::optional<Document> input = pSource->getNext();
+        if (!input) {
+            inputExhausted = true;
+            break;
+        }
+
+        PendingInput pending;
+        pending.localValue = input->getNestedField(_localField);
+        if (pending.localValue.missing()) {
+            pending.localValue = Value(BSONNULL);
+        }
+        valueBytes += pending.localValue.getApproximateSize();
+        pending.doc = std::move(*input);
+        _batch.push_back(std::move(pending));
+    }
+
+    if (_batch.empty()) {
+        return;
+    }
+
+    if (!_strategy) {
+        _strategy = plannedJoinStrategy();
+        // Scanning the whole foreign collection does not pay off for less than a batch of input.
+        if (*_strategy == JoinStrategy::kHashJoin && inputExhausted) {
+            _strategy = JoinStrategy::kBatchedIn;
+        }
+        if (*_strategy == JoinStrategy::kHashJoin && !buildHashTable()) {
+            _strategy = JoinStrategy::kBatchedIn;
+        }
+        LOG(1) << "$lookup from " << _fromNs << " on " << _foreignFieldFieldName << " uses "
+               << joinStrategyName(*_strategy);
+    }
+
+    switch (*_strategy) {
+        case JoinStrategy::kNestedLoop:
+            // Every input is looked up on its own as it is returned.
+            break;
+        case JoinStrategy::kBatchedIn:
+            resolveWithInQuery();
+            break;
+        case JoinStrategy::kHashJoin:
+            resolveWithHashTable();
+            break;
+    }
+}
+
+void DocumentSourceLookUp::resolveWithInQuery() {
+    // Maps each distinct local value of the batch to the positions in _batch of its inputs.
+    std::unordered_map<Value, std::vector<size_t>, Value::Hash> inputsByValue;
+    std::unordered_map<Value, std::unique_ptr<EqualityProbe>, Value::Hash> probes;
+
+    BSONObjBuilder query;
+    {
+        BSONObjBuilder subObj(query.subobjStart(_foreignFieldFieldName));
+        BSONArrayBuilder values(subObj.subarrayStart("$in"));
+        for (size_t i = 0; i < _batch.size(); ++i) {
+            const Value& localValue = _batch[i].localValue;
+            if (!isBatchableLocalValue(localValue)) {
+                continue;
+            }
+            std::vector<size_t>& inputs = inputsByValue[localValue];
+            if (inputs.empty()) {
+                localValue.addToBsonArray(&values);
+                probes[localValue] =
+                    stdx::make_unique<EqualityProbe>(_foreignFieldFieldName, localValue);
+            }
+            inputs.push_back(i);
+            _batch[i].resolved = true;
+        }
+    }
+
+    if (inputsByValue.empty()) {
+        return;
+    }
+
+    const size_t maxBytes = internalDocumentSourceLookupBatchMaxBytes.load();
+    size_t bytes = 0;
+    std::unique_ptr<DBClientCursor> cursor =
+        _mongod->directClient()->query(_fromNs.ns(), query.obj());
+    while (cursor->more()) {
+        BSONObj foreignDoc = cursor->nextSafe().getOwned();
+        bytes += foreignDoc.objsize();
+        if (bytes > maxBytes) {
+            LOG(1) << "$lookup from " << _fromNs << " matched more than " << maxBytes
+                   << " bytes for a batch of " << _batch.size()
+                   << " documents, looking them up one at a time";
+            for (auto&& pending : _batch) {
+                pending.resolved = false;
+                pending.matches.clear();
+            }
+            return;
+        }
+
+        // A document is a match of every input whose value it contains, but of each input once.
+        for (auto&& candidate : matchCandidates(foreignDoc)) {
+            auto it = inputsByValue.find(candidate);
+            if (it == inputsByValue.end() || !probes[candidate]->matches(foreignDoc)) {
+                continue;
+            }
+            for (size_t i : it->second) {
+                std::vector<BSONObj>& matches = _batch[i].matches;
+                if (matches.empty() || matches.back().objdata() != foreignDoc.objdata()) {
+                    matches.push_back(foreignDoc);
+                }
+            }
+        }
+    }
+}
+
+bool DocumentSourceLookUp::buildHashTable() {
+    const size_t maxBytes = internalDocumentSourceLookupHashJoinMaxBytes.load();
+    size_t bytes = 0;
+    std::unique_ptr<DBClientCursor> cursor = _mongod->directClient()->query(_fromNs.ns(), Query());
+    while (cursor->more()) {
+        pExpCtx->checkForInterrupt();
+
+        BSONObj foreignDoc = cursor->nextSafe().getOwned();
+        bytes += foreignDoc.objsize();
+
+        const size_t pos = _foreignDocs.size();
+        _foreignDocs.push_back(foreignDoc);
+        for (auto&& candidate : matchCandidates(foreignDoc)) {
+            std::vector<size_t>& positions = _hashTable[candidate];
+            if (positions.empty()) {
+                bytes += candidate.getApproximateSize();
+            }
+            positions.push_back(pos);
+            bytes += sizeof(size_t);
+        }
+
+        if (bytes > maxBytes) {
+            LOG(1) << "$lookup hash table for " << _fromNs << " exceeded " << maxBytes
+                   << " bytes, falling back to batched queries";
+            _foreignDocs.clear();
+            _hashTable.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+void DocumentSourceLookUp::resolveWithHashTable() {
+    for (auto&& pending : _batch) {
+        if (pending.localValue.getType() == Undefined) {
+            // Left to the query to reject.
+            continue;
+        }
+        EqualityProbe probe(_foreignFieldFieldName, pending.localValue);
+        if (isBatchableLocalValue(pending.localValue)) {
+            auto it = _hashTable.find(pending.localValue);
+            if (it != _hashTable.end()) {
+                for (size_t pos : it->second) {
+                    if (probe.matches(_foreignDocs[pos])) {
+                        pending.matches.push_back(_foreignDocs[pos]);
+                    }
+                }
+            }
+        } else {
+            // Nulls and regexes are rare enough to simply scan the build side.
+            for (auto&& foreignDoc : _foreignDocs) {
+                if (probe.matches(foreignDoc)) {
+                    pending.matches.push_back(foreignDoc);
+                }
+            }
+        }
+        pending.resolved = true;
+    }
+}
+
+std::vector<Value> DocumentSourceLookUp::matchCandidates(const BSONObj& foreignDoc) const {
+    // An equality on a path matches the values along it, including the elements of arrays
+    // as well as trailing arrays as a whole.
+    BSONElementSet elements;
+    foreignDoc.getFieldsDotted(_foreignFieldFieldName, elements, true);
+    foreignDoc.getFieldsDotted(_foreignFieldFieldName, elements, false);
+
+    std::vector<Value> candidates;
+    candidates.reserve(elements.size());
+    for (auto&& element : elements) {
+        candidates.push_back(Value(element));
+    }
+    return candidates;
+}
+
+bool DocumentSourceLookUp::nextInput() {
+    if (_batch.empty()) {
+        fillBatch();
+        if (_batch.empty()) {
+            return false;
+        }
+    }
+
+    PendingInput& next = _batch.front();
+    if (next.resolved) {
+        _matches = std::move(next.matches);
+        _cursor.reset();
+    } else {
+        _matches.clear();
+        _cursor = _mongod->directClient()->query(_fromNs.ns(), queryForInput(next.doc));
+    }
+    _matchIndex = 0;
+    _input = std::move(next.doc);
+    _batch.pop_front();
+    return true;
+}
+
+bool DocumentSourceLookUp::haveMoreMatches() {
+    if (_cursor) {
+        return _cursor->more();
+    }
+    return _matchIndex < _matches.size();
+}
+
 bool DocumentSourceLookUp::coalesce(const intrusive_ptr<DocumentSource>& pNextSource) {
     if (_handlingUnwind) {
         return false;
@@ -108,6 +426,10 @@ bool DocumentSourceLookUp::coalesce(const intrusive_ptr<DocumentSource>& pNextSo
 
 void DocumentSourceLookUp::dispose() {
     _cursor.reset();
+    _matches.clear();
+    _batch.clear();
+    _foreignDocs.clear();
+    _hashTable.clear();
     pSource->dispose();
 }
 
@@ -131,18 +453,17 @@ boost::optional<Document> DocumentSourceLookUp::unwindResult() {
     // Loop until we get a document that has at least one match.
     // Note we may return early from this loop if our source stage is exhausted or if the unwind
     // source was asked to return empty arrays and we get a document without a match.
-    while (!_cursor || !_cursor->more()) {
-        _input = pSource->getNext();
-        if (!_input)
+    while (!_input || !haveMoreMatches()) {
+        if (!nextInput())
             return {};
 
-        _cursor = _mongod->directClient()->query(_fromNs.ns(), queryForInput(*_input));
         _cursorIndex = 0;
 
-        if (_unwindSrc->preserveNullAndEmptyArrays() && !_cursor->more()) {
+        if (_unwindSrc->preserveNullAndEmptyArrays() && !haveMoreMatches()) {
             // There were no results for this cursor, but the $unwind was asked to preserve empty
             // arrays, so we should return a document without the array.
             MutableDocument output(std::move(*_input));
+            _input = boost::none;
             // Note this will correctly objects in the prefix of '_as', to act as if we had created
             // an empty array and then removed it.
             output.setNestedField(_as, Value());
@@ -152,11 +473,15 @@ boost::optional<Document> DocumentSourceLookUp::unwindResult() {
             return output.freeze();
         }
     }
-    invariant(_cursor->more() && bool(_input));
-    auto nextVal = Value(_cursor->nextSafe());
+    invariant(haveMoreMatches() && bool(_input));
+    auto nextVal = Value(_cursor ? _cursor->nextSafe() : _matches[_matchIndex++]);
 
     // Move input document into output if this is the last or only result, otherwise perform a copy.
-    MutableDocument output(_cursor->more() ? *_input : std::move(*_input));
+    const bool lastMatch = !haveMoreMatches();
+    MutableDocument output(lastMatch ? std::move(*_input) : *_input);
+    if (lastMatch) {
+        _input = boost::none;
+    }
     output.setNestedField(_as, nextVal);
 
     if (indexPath) {
@@ -172,6 +497,10 @@ void DocumentSourceLookUp::serializeToArray(std::vector<Value>& array, bool expl
         DOC(getSourceName() << DOC("from" << _fromNs.coll() << "as" << _as.getPath(false)
                                           << "localField" << _localField.getPath(false)
                                           << "foreignField" << _foreignField.getPath(false))));
+    if (explain && _mongod) {
+        output[getSourceName()]["strategy"] =
+            Value(joinStrategyName(_strategy ? *_strategy : plannedJoinStrategy()));
+    }
     if (_handlingUnwind && explain) {
         const boost::optional<FieldPath> indexPath = _unwindSrc->indexPath();
         output[getSourceName()]["unwinding"] =
@@ -74,6 +74,21 @@ boost::optional<Document> DocumentSourceMatch::getNext() {
     return boost::none;
 }
 
+bool DocumentSourceMatch::canProduceBatches(const ColumnBatch& batch, bool needRows) const {
+    return !_isTextQuery && pSource->canProduceBatches(batch, /*needRows=*/true);
+}
+
+bool DocumentSourceMatch::getNextBatch(ColumnBatch* batch) {
+    pExpCtx->checkForInterrupt();
+
+    while (pSource->getNextBatch(batch)) {
+        batch->filter([this](const BSONObj& row) { return matcher->matches(row); });
+        if (!batch->getSelection().empty())
+            return true;
+    }
+    return false;
+}
+
 bool DocumentSourceMatch::coalesce(const intrusive_ptr<DocumentSource>& nextSource) {
     DocumentSourceMatch* otherMatch = dynamic_cast<DocumentSourceMatch*>(nextSource.get());
     if (!otherMatch)
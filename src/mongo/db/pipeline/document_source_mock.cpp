@@ -87,4 +87,15 @@ boost::optional<Document> DocumentSourceMock::getNext() {
     queue.pop_front();
     return {std::move(doc)};
 }
+
+bool DocumentSourceMock::getNextBatch(ColumnBatch* batch) {
+    invariant(!disposed && produceBatches);
+
+    batch->clear();
+    while (!queue.empty() && !batch->isFull()) {
+        batch->appendRow(queue.front().toBson());
+        queue.pop_front();
+    }
+    return batch->numRows() > 0;
+}
 }
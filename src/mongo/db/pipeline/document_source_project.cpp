@@ -35,6 +35,7 @@
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/stdx/memory.h"
 
 namespace mongo {
 
@@ -77,6 +78,52 @@ boost::optional<Document> DocumentSourceProject::getNext() {
     return out.freeze();
 }
 
+std::unique_ptr<ColumnBatch> DocumentSourceProject::makeInputBatch(
+    const ColumnBatch& batch, vector<int>* inputColumns) const {
+    auto inputBatch = stdx::make_unique<ColumnBatch>();
+    inputColumns->clear();
+    for (size_t i = 0; i < batch.numColumns(); i++) {
+        const ColumnVector& column = batch.getColumn(i);
+        if (column.isConstant()) {
+            inputColumns->push_back(-1);
+            continue;
+        }
+
+        string inputPath;
+        if (!pEO->getInputPath(FieldPath(column.getPath()), &inputPath))
+            return nullptr;
+        inputColumns->push_back(inputPath.empty() ? -1 : inputBatch->addColumn(inputPath));
+    }
+    return inputBatch;
+}
+
+bool DocumentSourceProject::canProduceBatches(const ColumnBatch& batch, bool needRows) const {
+    // The batches only carry the columns of the output, never the projected documents.
+    if (needRows)
+        return false;
+
+    vector<int> inputColumns;
+    std::unique_ptr<ColumnBatch> inputBatch = makeInputBatch(batch, &inputColumns);
+    return inputBatch && pSource->canProduceBatches(*inputBatch, /*needRows=*/false);
+}
+
+bool DocumentSourceProject::getNextBatch(ColumnBatch* batch) {
+    pExpCtx->checkForInterrupt();
+
+    if (!_inputBatch) {
+        _inputBatch = makeInputBatch(*batch, &_inputColumns);
+        invariant(_inputBatch);
+    }
+
+    if (!pSource->getNextBatch(_inputBatch.get())) {
+        batch->clear();
+        return false;
+    }
+
+    batch->assignColumns(*_inputBatch, _inputColumns);
+    return true;
+}
+
 intrusive_ptr<DocumentSource> DocumentSourceProject::optimize() {
     intrusive_ptr<Expression> pE(pEO->optimize());
     pEO = boost::dynamic_pointer_cast<ExpressionObject>(pE);
@@ -33,6 +33,7 @@
 #include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_noop.h"
 #include "mongo/stdx/memory.h"
@@ -299,13 +300,14 @@ public:
     Base() : _tempDir("DocumentSourceGroupTest") {}
 
 protected:
-    void createGroup(const BSONObj& spec, bool inShard = false) {
+    void createGroup(const BSONObj& spec, bool inShard = false, bool extSortAllowed = false) {
         BSONObj namedSpec = BSON("$group" << spec);
         BSONElement specElement = namedSpec.firstElement();
 
         intrusive_ptr<ExpressionContext> expressionContext =
             new ExpressionContext(_opCtx.get(), NamespaceString(ns));
         expressionContext->inShard = inShard;
+        expressionContext->extSortAllowed = extSortAllowed;
         // Won't spill to disk properly if it needs to.
         expressionContext->tempDir = _tempDir.path();
 
@@ -587,10 +589,13 @@ public:
     void run() {
         runSharded(false);
         runSharded(true);
+        runSharded(false, true);
+        runSharded(true, true);
     }
-    void runSharded(bool sharded) {
+    void runSharded(bool sharded, bool batched = false) {
         createGroup(groupSpec());
         auto source = DocumentSourceMock::create(inputData());
+        source->produceBatches = batched;
         group()->setSource(source.get());
 
         intrusive_ptr<DocumentSource> sink = group();
@@ -885,6 +890,145 @@ public:
     }
 };
 
+/**
+ * A $group reading column batches through $match and $project stages has the same results as one
+ * reading documents.
+ */
+class BatchesMatchDocuments : public Base {
+public:
+    void run() {
+        std::deque<Document> input;
+        for (int i = 0; i < 3000; i++) {
+            MutableDocument doc;
+            doc["_id"] = Value(i);
+            doc["k"] = Value(i % 7);
+            if (i % 11) {
+                doc["a"] = i % 3 ? Value(i) : Value(i * 0.25);
+            }
+            doc["b"] = Value(DOC("c" << (i % 2 ? Value(-i) : Value(BSONNULL))));
+            doc["arr"] = Value(DOC_ARRAY(DOC("x" << i) << DOC("x" << 1)));
+            input.push_back(doc.freeze());
+        }
+
+        const BSONObj specs[] = {
+            fromjson("{_id: null, s: {$sum: '$a'}, c: {$sum: 1}, m: {$min: '$a'}}"),
+            fromjson("{_id: '$k', s: {$sum: '$a'}, avg: {$avg: '$b.c'}, max: {$max: '$b.c'}}"),
+            fromjson("{_id: {k: '$k', c: '$b.c'}, f: {$first: '$a'}, l: {$last: '$a'}}"),
+            fromjson("{_id: '$arr.x', n: {$sum: 1}, set: {$addToSet: '$k'}}"),
+        };
+        for (auto&& spec : specs) {
+            for (bool withStages : {false, true}) {
+                ASSERT_EQUALS(results(input, spec, withStages, false),
+                              results(input, spec, withStages, true));
+            }
+        }
+    }
+
+private:
+    /** Runs the group, after a $match and a $project if 'withStages'. */
+    BSONArray results(const std::deque<Document>& input,
+                      const BSONObj& spec,
+                      bool withStages,
+                      bool batched) {
+        auto source = DocumentSourceMock::create(input);
+        source->produceBatches = batched;
+        std::vector<intrusive_ptr<DocumentSource>> stages{source};
+        if (withStages) {
+            BSONObj matchSpec = fromjson("{$match: {k: {$ne: 3}}}");
+            stages.push_back(DocumentSourceMatch::createFromBson(matchSpec.firstElement(), ctx()));
+            stages.back()->setSource(stages[stages.size() - 2].get());
+
+            BSONObj projectSpec = fromjson("{$project: {k: 1, a: 1, b: 1, arr: 1}}");
+            stages.push_back(
+                DocumentSourceProject::createFromBson(projectSpec.firstElement(), ctx()));
+            stages.back()->setSource(stages[stages.size() - 2].get());
+        }
+
+        createGroup(spec);
+        group()->setSource(stages.back().get());
+
+        IdMap resultSet;
+        while (boost::optional<Document> current = group()->getNext()) {
+            resultSet[current->getField("_id")] = *current;
+        }
+        BSONArrayBuilder bsonResultSet;
+        for (auto&& result : resultSet) {
+            bsonResultSet << result.second;
+        }
+        return bsonResultSet.arr();
+    }
+};
+
+/**
+ * A $group whose groups do not fit in memory spills them to files by hash and merges each file on
+ * its own, splitting the files which are still too big. The results are the same as in memory,
+ * including for accumulators which depend on the order of the input.
+ */
+class SpillToPartitions : public Base {
+public:
+    void run() {
+        std::deque<Document> input;
+        for (int i = 0; i < 5000; i++) {
+            input.push_back(DOC("_id" << i << "k" << (i * 7919) % 1500 << "a" << i));
+        }
+        const BSONObj spec = fromjson(
+            "{_id: '$k', n: {$sum: 1}, total: {$sum: '$a'}, first: {$first: '$a'},"
+            " last: {$last: '$a'}, all: {$push: '$a'}}");
+
+        const BSONArray expected = results(input, spec, 100 * 1024 * 1024, 16);
+        ASSERT_EQUALS(1500, expected.nFields());
+
+        // Most partitions of the first level are too big, and are split again.
+        ASSERT_EQUALS(expected, results(input, spec, 64 * 1024, 16));
+        // With two partitions per level, the last level is merged in memory regardless.
+        ASSERT_EQUALS(expected, results(input, spec, 1024, 2));
+        // A distinct has no accumulators to spill.
+        const BSONObj distinct = fromjson("{_id: '$k'}");
+        ASSERT_EQUALS(results(input, distinct, 100 * 1024 * 1024, 16),
+                      results(input, distinct, 1024, 4));
+
+        // Spilling needs allowDiskUse.
+        setKnob("internalDocumentSourceGroupMaxMemoryBytes", 1024);
+        createGroup(spec);
+        auto source = DocumentSourceMock::create(input);
+        group()->setSource(source.get());
+        ASSERT_THROWS_CODE(group()->getNext(), UserException, 16945);
+        setKnob("internalDocumentSourceGroupMaxMemoryBytes", 100 * 1024 * 1024);
+    }
+
+private:
+    static void setKnob(const std::string& name, int value) {
+        ServerParameter* knob = ServerParameterSet::getGlobal()->getMap().find(name)->second;
+        ASSERT_OK(knob->setFromString(std::to_string(value)));
+    }
+
+    BSONArray results(const std::deque<Document>& input,
+                      const BSONObj& spec,
+                      int maxMemoryBytes,
+                      int numPartitions) {
+        setKnob("internalDocumentSourceGroupMaxMemoryBytes", maxMemoryBytes);
+        setKnob("internalDocumentSourceGroupSpillPartitions", numPartitions);
+        createGroup(spec, false, true);
+        setKnob("internalDocumentSourceGroupMaxMemoryBytes", 100 * 1024 * 1024);
+        setKnob("internalDocumentSourceGroupSpillPartitions", 16);
+
+        auto source = DocumentSourceMock::create(input);
+        group()->setSource(source.get());
+
+        IdMap resultSet;
+        while (boost::optional<Document> current = group()->getNext()) {
+            ASSERT(resultSet.emplace(current->getField("_id"), *current).second);
+        }
+        assertExhausted(group());
+
+        BSONArrayBuilder bsonResultSet;
+        for (auto&& result : resultSet) {
+            bsonResultSet << result.second;
+        }
+        return bsonResultSet.arr();
+    }
+};
+
 }  // namespace DocumentSourceGroup
 
 namespace DocumentSourceProject {
@@ -2700,6 +2844,8 @@ public:
         add<DocumentSourceGroup::FourValuesTwoKeys>();
         add<DocumentSourceGroup::FourValuesTwoKeysTwoAccumulators>();
         add<DocumentSourceGroup::GroupNullUndefinedIds>();
+        add<DocumentSourceGroup::BatchesMatchDocuments>();
+        add<DocumentSourceGroup::SpillToPartitions>();
         add<DocumentSourceGroup::ComplexId>();
         add<DocumentSourceGroup::UndefinedAccumulatorValue>();
         add<DocumentSourceGroup::RouterMerger>();
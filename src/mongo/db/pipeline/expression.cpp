@@ -1230,6 +1230,50 @@ void ExpressionObject::addDependencies(DepsTracker* deps, vector<string>* path)
     }
 }
 
+bool ExpressionObject::getInputPath(const FieldPath& outputPath, std::string* inputPath) const {
+    const ExpressionObject* level = this;
+    for (size_t i = 0; i < outputPath.getPathLength(); i++) {
+        const string& fieldName = outputPath.getFieldName(i);
+        FieldMap::const_iterator exprIter = level->_expressions.find(fieldName);
+
+        if (exprIter == level->_expressions.end()) {
+            if (!level->_excludeId && level->_atRoot && fieldName == "_id") {
+                *inputPath = outputPath.getPath(false);
+                return true;
+            }
+            if (level->_atRoot) {
+                inputPath->clear();
+                return true;
+            }
+            // Below the root, the output may be an array of the documents built from an array.
+            return false;
+        }
+
+        Expression* expr = exprIter->second.get();
+        if (!expr) {
+            // Inclusions keep the field where it is.
+            *inputPath = outputPath.getPath(false);
+            return true;
+        }
+
+        if (ExpressionObject* exprObj = dynamic_cast<ExpressionObject*>(expr)) {
+            level = exprObj;
+            continue;
+        }
+
+        ExpressionFieldPath* fieldPath = dynamic_cast<ExpressionFieldPath*>(expr);
+        if (level->_atRoot && i == outputPath.getPathLength() - 1 && fieldPath &&
+            fieldPath->isInputField()) {
+            *inputPath = fieldPath->getFieldPath().tail().getPath(false);
+            return true;
+        }
+        return false;
+    }
+
+    // The output is a document built by this expression.
+    return false;
+}
+
 void ExpressionObject::addToDocument(MutableDocument& out,
                                      const Document& currentDoc,
                                      Variables* vars) const {
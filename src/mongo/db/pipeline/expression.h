@@ -749,6 +749,14 @@ public:
         return _fieldPath;
     }
 
+    /**
+     * Returns whether this reads a field of the current document, rather than the whole document
+     * or a variable. The path of the field is getFieldPath().tail().
+     */
+    bool isInputField() const {
+        return _variable == Variables::ROOT_ID && _fieldPath.getPathLength() > 1;
+    }
+
 private:
     ExpressionFieldPath(const std::string& fieldPath, Variables::Id variable);
 
@@ -1057,6 +1065,14 @@ public:
         _excludeId = b;
     }
 
+    /**
+     * Finds where the value at 'outputPath' of the document built by this expression comes from
+     * when it is taken from the input document as is. Sets '*inputPath' to its path in the input
+     * document, or to an empty string if the output never has the field, and returns true.
+     * Returns false if the value is computed.
+     */
+    bool getInputPath(const FieldPath& outputPath, std::string* inputPath) const;
+
 private:
     explicit ExpressionObject(bool atRoot);
 
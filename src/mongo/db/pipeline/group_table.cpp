@@ -0,0 +1,126 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/group_table.h"
+
+#include <limits>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+const size_t GroupTable::kGroupsPerChunk;
+
+uint64_t GroupTable::hash(const Value& id) {
+    size_t seed = 0xf0afbeef;
+    id.hash_combine(seed);
+
+    // boost::hash_combine leaves the low bits of small integers and doubles poorly distributed,
+    // which linear probing is sensitive to. Finish with the murmur3 mixer.
+    uint64_t h = seed;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+GroupTable::Slot* GroupTable::findSlot(const Value& id, uint64_t hash) {
+    dassert(!_slots.empty());
+    const size_t mask = _slots.size() - 1;
+    const uint32_t hashBits = static_cast<uint32_t>(hash >> 32);
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        Slot& slot = _slots[i];
+        if (slot.group == 0)
+            return &slot;
+        if (slot.hashBits == hashBits) {
+            Group& group = (*this)[slot.group - 1];
+            if (group.hash == hash && Value::compare(group.id, id) == 0)
+                return &slot;
+        }
+    }
+}
+
+GroupTable::Group* GroupTable::find(const Value& id, uint64_t hash) {
+    if (_slots.empty())
+        return nullptr;
+    Slot* slot = findSlot(id, hash);
+    return slot->group ? &(*this)[slot->group - 1] : nullptr;
+}
+
+GroupTable::Group& GroupTable::findOrInsert(const Value& id, uint64_t hash, bool* inserted) {
+    // Keeps the load factor at most 1/2, so that probe sequences stay short.
+    if ((_size + 1) * 2 > _slots.size())
+        grow();
+
+    Slot* slot = findSlot(id, hash);
+    if (slot->group) {
+        *inserted = false;
+        return (*this)[slot->group - 1];
+    }
+
+    uassert(40117,
+            "$group exceeded the maximum number of groups held in memory",
+            _size < std::numeric_limits<uint32_t>::max());
+
+    if (_size == _chunks.size() * kGroupsPerChunk)
+        _chunks.emplace_back(new Group[kGroupsPerChunk]);
+
+    Group& group = (*this)[_size];
+    group.id = id;
+    group.hash = hash;
+    slot->hashBits = static_cast<uint32_t>(hash >> 32);
+    slot->group = ++_size;
+
+    *inserted = true;
+    return group;
+}
+
+void GroupTable::grow() {
+    const size_t capacity = std::max(_slots.size() * 2, size_t(16));
+    _slots.assign(capacity, Slot{0, 0});
+
+    const size_t mask = capacity - 1;
+    for (size_t g = 0; g < _size; g++) {
+        const uint64_t hash = (*this)[g].hash;
+        size_t i = hash & mask;
+        while (_slots[i].group) {
+            i = (i + 1) & mask;
+        }
+        _slots[i].hashBits = static_cast<uint32_t>(hash >> 32);
+        _slots[i].group = g + 1;
+    }
+}
+
+void GroupTable::clear() {
+    for (size_t g = 0; g < _size; g++) {
+        Group& group = (*this)[g];
+        group.id = Value();
+        group.accumulators.clear();
+    }
+    _size = 0;
+    std::fill(_slots.begin(), _slots.end(), Slot{0, 0});
+}
+
+void GroupTable::releaseMemory() {
+    std::vector<Slot>().swap(_slots);
+    std::vector<std::unique_ptr<Group[]>>().swap(_chunks);
+    _size = 0;
+}
+
+}  // namespace mongo
@@ -0,0 +1,112 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+
+/**
+ * The groups of a $group stage: an open-addressing hash table from group keys to the accumulators
+ * of each group.
+ *
+ * The groups are allocated in fixed-size chunks, so a group never moves once inserted and the
+ * chunks are reused after clear(). The slots of the table only hold the index of a group and part
+ * of its hash, which keeps probing within the slot array until the hashes match. The hash of a
+ * key is computed once by the caller with hash() and kept with the group, so growing the table
+ * and partitioning the groups when they are spilled does not hash the keys again.
+ */
+class GroupTable {
+    MONGO_DISALLOW_COPYING(GroupTable);
+
+public:
+    typedef std::vector<boost::intrusive_ptr<Accumulator>> Accumulators;
+
+    struct Group {
+        Value id;
+        Accumulators accumulators;
+        uint64_t hash = 0;
+    };
+
+    GroupTable() = default;
+
+    /**
+     * Returns the hash of the group key 'id', with all its bits well mixed. Keys which compare
+     * equal have the same hash.
+     */
+    static uint64_t hash(const Value& id);
+
+    /**
+     * Returns the group whose key is 'id', which must hash to 'hash'. If there is no such group,
+     * adds one with no accumulators and sets '*inserted' to true.
+     */
+    Group& findOrInsert(const Value& id, uint64_t hash, bool* inserted);
+
+    /**
+     * Returns the group whose key is 'id', or null if there is none.
+     */
+    Group* find(const Value& id, uint64_t hash);
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    /**
+     * Returns a group by its position, in the order they were inserted.
+     */
+    Group& operator[](size_t i) {
+        dassert(i < _size);
+        return _chunks[i / kGroupsPerChunk][i % kGroupsPerChunk];
+    }
+
+    /**
+     * Removes all groups. The memory of the table is kept for the next groups.
+     */
+    void clear();
+
+    /**
+     * Removes all groups and frees the memory of the table.
+     */
+    void releaseMemory();
+
+private:
+    static const size_t kGroupsPerChunk = 1024;
+
+    // An empty slot has a 'group' of 0, otherwise it is the index of the group plus one.
+    struct Slot {
+        uint32_t hashBits;
+        uint32_t group;
+    };
+
+    Slot* findSlot(const Value& id, uint64_t hash);
+    void grow();
+
+    std::vector<Slot> _slots;
+    std::vector<std::unique_ptr<Group[]>> _chunks;
+    size_t _size = 0;
+};
+
+}  // namespace mongo
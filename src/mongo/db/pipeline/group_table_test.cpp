@@ -0,0 +1,125 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/group_table.h"
+
+#include "mongo/db/pipeline/document.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+GroupTable::Group& insert(GroupTable* table, const Value& id, bool* inserted) {
+    return table->findOrInsert(id, GroupTable::hash(id), inserted);
+}
+
+TEST(GroupTableTest, EqualKeysHashTheSame) {
+    ASSERT_EQUALS(GroupTable::hash(Value(1)), GroupTable::hash(Value(1LL)));
+    ASSERT_EQUALS(GroupTable::hash(Value(1)), GroupTable::hash(Value(1.0)));
+    ASSERT_EQUALS(GroupTable::hash(Value(DOC("a" << 2))), GroupTable::hash(Value(DOC("a" << 2.0))));
+    ASSERT_NOT_EQUALS(GroupTable::hash(Value(1)), GroupTable::hash(Value(2)));
+}
+
+TEST(GroupTableTest, FindsInsertedGroups) {
+    GroupTable table;
+    bool inserted;
+    GroupTable::Group& group = insert(&table, Value(5), &inserted);
+    ASSERT(inserted);
+    ASSERT_EQUALS(Value(5), group.id);
+    ASSERT_EQUALS(GroupTable::hash(Value(5)), group.hash);
+    ASSERT(group.accumulators.empty());
+
+    // Numbers which compare equal are the same group.
+    ASSERT_EQUALS(&group, &insert(&table, Value(5.0), &inserted));
+    ASSERT(!inserted);
+    ASSERT_EQUALS(&group, table.find(Value(5LL), GroupTable::hash(Value(5LL))));
+    ASSERT(!table.find(Value(6), GroupTable::hash(Value(6))));
+    ASSERT_EQUALS(1U, table.size());
+}
+
+TEST(GroupTableTest, GroupsDoNotMoveWhenTheTableGrows) {
+    GroupTable table;
+    std::vector<GroupTable::Group*> groups;
+    bool inserted;
+    for (int i = 0; i < 10000; i++) {
+        groups.push_back(&insert(&table, Value(i), &inserted));
+        ASSERT(inserted);
+    }
+    ASSERT_EQUALS(10000U, table.size());
+
+    for (int i = 0; i < 10000; i++) {
+        ASSERT_EQUALS(groups[i], &insert(&table, Value(i), &inserted));
+        ASSERT(!inserted);
+        // Iteration is in the order of insertion.
+        ASSERT_EQUALS(groups[i], &table[i]);
+        ASSERT_EQUALS(Value(i), table[i].id);
+    }
+}
+
+TEST(GroupTableTest, KeysWhichCollide) {
+    // Keys of different types, and keys whose hashes agree in the low bits, still find their own
+    // group.
+    GroupTable table;
+    std::vector<Value> ids{Value(BSONNULL),
+                           Value(StringData("")),
+                           Value(BSONArray()),
+                           Value(Document()),
+                           Value(DOC_ARRAY(1 << 2)),
+                           Value(DOC("x" << DOC_ARRAY(1 << 2)))};
+    for (int i = 0; i < 1000; i++) {
+        ids.push_back(Value(i * 1024.0));
+    }
+
+    bool inserted;
+    for (auto&& id : ids) {
+        insert(&table, id, &inserted);
+        ASSERT(inserted);
+    }
+    for (size_t i = 0; i < ids.size(); i++) {
+        GroupTable::Group* group = table.find(ids[i], GroupTable::hash(ids[i]));
+        ASSERT(group);
+        ASSERT_EQUALS(&table[i], group);
+    }
+}
+
+TEST(GroupTableTest, ClearKeepsWorking) {
+    GroupTable table;
+    bool inserted;
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 3000; i++) {
+            insert(&table, Value(round * 10000 + i), &inserted);
+            ASSERT(inserted);
+        }
+        ASSERT_EQUALS(3000U, table.size());
+        // The groups of the previous round are gone.
+        const Value previous((round - 1) * 10000);
+        ASSERT(!table.find(previous, GroupTable::hash(previous)));
+
+        table.clear();
+        ASSERT(table.empty());
+        ASSERT(!table.find(Value(round * 10000), GroupTable::hash(Value(round * 10000))));
+    }
+
+    table.releaseMemory();
+    ASSERT(table.empty());
+    insert(&table, Value(1), &inserted);
+    ASSERT(inserted);
+    ASSERT_EQUALS(1U, table.size());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -149,6 +149,10 @@ size_t getDocsExamined(StageType type, const SpecificStats* specific) {
     if (STAGE_COLLSCAN == type) {
         const CollectionScanStats* spec = static_cast<const CollectionScanStats*>(specific);
         return spec->docsTested;
+    } else if (STAGE_PARALLEL_COLLSCAN == type) {
+        const ParallelCollectionScanStats* spec =
+            static_cast<const ParallelCollectionScanStats*>(specific);
+        return spec->docsTested;
     } else if (STAGE_FETCH == type) {
         const FetchStats* spec = static_cast<const FetchStats*>(specific);
         return spec->docsExamined;
@@ -267,6 +271,15 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainCommon::EXEC_STATS) {
             bob->appendNumber("docsExamined", spec->docsTested);
         }
+    } else if (STAGE_PARALLEL_COLLSCAN == stats.stageType) {
+        ParallelCollectionScanStats* spec =
+            static_cast<ParallelCollectionScanStats*>(stats.specific.get());
+        bob->appendBool("ordered", spec->ordered);
+        if (verbosity >= ExplainCommon::EXEC_STATS) {
+            bob->appendNumber("workers", spec->workers);
+            bob->appendNumber("ranges", spec->ranges);
+            bob->appendNumber("docsExamined", spec->docsTested);
+        }
     } else if (STAGE_COUNT == stats.stageType) {
         CountStats* spec = static_cast<CountStats*>(stats.specific.get());
 
@@ -377,8 +390,13 @@ void Explain::statsToBSON(const PlanStageStats& stats,
             bob->append("indexBounds", spec->indexBounds);
         }
 
+        if (spec->skipScanPrefixLen > 0) {
+            bob->appendNumber("skipScanPrefixLen", spec->skipScanPrefixLen);
+        }
+
         if (verbosity >= ExplainCommon::EXEC_STATS) {
             bob->appendNumber("keysExamined", spec->keysExamined);
+            bob->appendNumber("seeks", spec->seeks);
             bob->appendNumber("dupsTested", spec->dupsTested);
             bob->appendNumber("dupsDropped", spec->dupsDropped);
             bob->appendNumber("seenInvalidated", spec->seenInvalidated);
@@ -397,6 +415,9 @@ void Explain::statsToBSON(const PlanStageStats& stats,
     } else if (STAGE_PROJECTION == stats.stageType) {
         ProjectionStats* spec = static_cast<ProjectionStats*>(stats.specific.get());
         bob->append("transformBy", spec->projObj);
+        if (spec->covered) {
+            bob->appendBool("covered", true);
+        }
     } else if (STAGE_SHARDING_FILTER == stats.stageType) {
         ShardingFilterStats* spec = static_cast<ShardingFilterStats*>(stats.specific.get());
 
@@ -413,6 +434,11 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainCommon::EXEC_STATS) {
             bob->appendNumber("memUsage", spec->memUsage);
             bob->appendNumber("memLimit", spec->memLimit);
+
+            if (spec->spills > 0) {
+                bob->appendNumber("spills", spec->spills);
+                bob->appendNumber("spilledBytes", static_cast<long long>(spec->spilledBytes));
+            }
         }
 
         if (spec->limit > 0) {
@@ -771,6 +797,11 @@ void Explain::getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsO
         }
         if (STAGE_SORT == stages[i]->stageType()) {
             statsOut->hasSortStage = true;
+
+            const SortStats* sortStats =
+                static_cast<const SortStats*>(stages[i]->getSpecificStats());
+            statsOut->sortSpills += sortStats->spills;
+            statsOut->sortSpilledBytes += sortStats->spilledBytes;
         }
 
         if (STAGE_IXSCAN == stages[i]->stageType()) {
@@ -64,6 +64,10 @@ struct PlanSummaryStats {
     // Did this plan use an in-memory sort stage?
     bool hasSortStage = false;
 
+    // The number of sorted runs, and their total size in bytes, that sort stages spilled to disk.
+    size_t sortSpills = 0U;
+    unsigned long long sortSpilledBytes = 0U;
+
     // The names of each index used by the plan.
     std::set<std::string> indexesUsed;
 
@@ -34,6 +34,7 @@
 
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_info_cache.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/client.h"
 #include "mongo/db/clientcursor.h"
@@ -49,11 +50,13 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_planner_params.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/stats/query_shape_stats.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/stale_exception.h"
@@ -154,6 +157,10 @@ void endQueryOp(OperationContext* txn,
     PlanSummaryStats summaryStats;
     Explain::getSummaryStats(exec, &summaryStats);
     curop->debug().hasSortStage = summaryStats.hasSortStage;
+    if (summaryStats.sortSpills > 0) {
+        curop->debug().sortSpills = summaryStats.sortSpills;
+        curop->debug().sortSpilledBytes = summaryStats.sortSpilledBytes;
+    }
     curop->debug().keysExamined = summaryStats.totalKeysExamined;
     curop->debug().docsExamined = summaryStats.totalDocsExamined;
     curop->debug().idhack = summaryStats.isIdhack;
@@ -163,6 +170,7 @@ void endQueryOp(OperationContext* txn,
     if (collection) {
         collection->infoCache()->notifyOfQuery(txn, summaryStats.indexesUsed);
     }
+    trackQueryShape(txn, collection, exec);
 
     const logger::LogComponent commandLogComponent = logger::LogComponent::kCommand;
     const logger::LogSeverity logLevelOne = logger::LogSeverity::Debug(1);
@@ -243,6 +251,21 @@ void generateBatch(int ntoreturn,
 
 }  // namespace
 
+void trackQueryShape(OperationContext* txn, Collection* collection, const PlanExecutor& exec) {
+    const CanonicalQuery* cq = exec.getCanonicalQuery();
+    if (!collection || !cq || queryShapeStatsMaxShapes.load() <= 0) {
+        return;
+    }
+
+    auto& stats = QueryShapeStats::get(txn->getServiceContext());
+    CurOp::get(txn)->debug().queryShape =
+        stats.getOrCreate(cq->ns(), collection->infoCache()->getPlanCache()->computeKey(*cq), [cq] {
+            const LiteParsedQuery& pq = cq->getParsed();
+            return BSON("filter" << pq.getFilter() << "sort" << pq.getSort() << "projection"
+                                 << pq.getProj());
+        });
+}
+
 /**
  * Called by db/instance.cpp.  This is the getMore entry point.
  */
@@ -434,6 +457,7 @@ QueryResult::View getMore(OperationContext* txn,
             postExecutionStats.totalKeysExamined - preExecutionStats.totalKeysExamined;
         curop.debug().docsExamined =
             postExecutionStats.totalDocsExamined - preExecutionStats.totalDocsExamined;
+        curop.debug().queryShape = cc->getQueryShape();
 
         // We have to do this before re-acquiring locks in the agg case because
         // shouldSaveCursorGetMore() can make a network call for agg cursors.
@@ -696,6 +720,7 @@ std::string runQuery(OperationContext* txn,
         cc->setLeftoverMaxTimeMicros(curop.getRemainingMaxTimeMicros());
 
         endQueryOp(txn, collection, *cc->getExecutor(), dbProfilingLevel, numResults, ccId);
+        cc->setQueryShape(curop.debug().queryShape);
     } else {
         LOG(5) << "Not caching executor but returning " << numResults << " results.\n";
         endQueryOp(txn, collection, *exec, dbProfilingLevel, numResults, ccId);
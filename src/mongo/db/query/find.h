@@ -99,6 +99,16 @@ void endQueryOp(OperationContext* txn,
                 long long numResults,
                 CursorId cursorId);
 
+/**
+ * Looks up the query shape run by 'exec' in the QueryShapeStats and attaches it to the CurOp of
+ * 'txn', which records the operation into it once it has finished. Does nothing if 'collection'
+ * is NULL or 'exec' has no CanonicalQuery, as for aggregation cursors.
+ *
+ * Only finds look the shape up: the cursor they leave behind keeps it for its getMores, which
+ * would otherwise recompute the plan cache key on every batch.
+ */
+void trackQueryShape(OperationContext* txn, Collection* collection, const PlanExecutor& exec);
+
 /**
  * Constructs a PlanExecutor for a query with the oplogReplay option set to true,
  * for the query 'cq' over the collection 'collection'. The PlanExecutor will
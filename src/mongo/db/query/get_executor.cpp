@@ -141,6 +141,7 @@ void fillOutPlannerParams(OperationContext* txn,
                                                     desc->indexName(),
                                                     ice->getFilterExpression(),
                                                     desc->infoObj()));
+        plannerParams->indices.back().multikeyPaths = ice->getMultikeyPaths(txn);
     }
 
     // If query supports index filters, filter params.indices by indices in query settings.
@@ -187,6 +188,10 @@ void fillOutPlannerParams(OperationContext* txn,
         plannerParams->options |= QueryPlannerParams::INDEX_INTERSECTION;
     }
 
+    if (internalQueryPlannerEnableSkipScan) {
+        plannerParams->options |= QueryPlannerParams::SKIP_SCAN;
+    }
+
     plannerParams->options |= QueryPlannerParams::SPLIT_LIMITED_SORT;
 
     // Doc-level locking storage engines cannot answer predicates implicitly via exact index
@@ -578,6 +583,9 @@ StatusWith<unique_ptr<PlanExecutor>> getExecutorFind(OperationContext* txn,
     if (ShardingState::get(txn)->needCollectionMetadata(txn, nss.ns())) {
         options |= QueryPlannerParams::INCLUDE_SHARD_FILTER;
     }
+    if (!canonicalQuery->getParsed().showRecordId()) {
+        options |= QueryPlannerParams::PARALLEL_COLLSCAN;
+    }
     return getExecutor(
         txn, collection, std::move(canonicalQuery), PlanExecutor::YIELD_AUTO, options);
 }
@@ -1027,10 +1035,29 @@ bool turnIxscanIntoCount(QuerySolution* soln) {
     return true;
 }
 
+/**
+ * Returns the position of 'field' in 'keyPattern', or the number of fields in 'keyPattern' if it is
+ * not there.
+ */
+size_t getDistinctFieldNo(const BSONObj& keyPattern, const std::string& field) {
+    size_t fieldNo = 0;
+    BSONObjIterator it(keyPattern);
+    while (it.more()) {
+        if (field == it.next().fieldName()) {
+            break;
+        }
+        fieldNo++;
+    }
+    return fieldNo;
+}
+
 /**
  * Returns true if indices contains an index that can be used with DistinctNode (the "fast distinct
  * hack" node, which can be used only if there is an empty query predicate).  Sets indexOut to the
- * array index of PlannerParams::indices.  Look for the index for the fewest fields.  Criteria for
+ * array index of PlannerParams::indices.  Look for the index which is prefixed by 'field', or else
+ * the one which has it in the earliest position, so that the distinct scan skips across the
+ * distinct values of as few leading fields as possible. Ties go to the index with the fewest
+ * fields.  Criteria for
  * suitable index is that the index cannot be special (geo, hashed, text, ...), and the index cannot
  * be a partial index.
  *
@@ -1047,6 +1074,7 @@ bool getDistinctNodeIndex(const std::vector<IndexEntry>& indices,
                           size_t* indexOut) {
     invariant(indexOut);
     bool isDottedField = str::contains(field, '.');
+    size_t minFieldNo = std::numeric_limits<size_t>::max();
     int minFields = std::numeric_limits<int>::max();
     for (size_t i = 0; i < indices.size(); ++i) {
         // Skip special indices.
@@ -1061,9 +1089,11 @@ bool getDistinctNodeIndex(const std::vector<IndexEntry>& indices,
         if (indices[i].multikey && isDottedField) {
             continue;
         }
+        size_t fieldNo = getDistinctFieldNo(indices[i].keyPattern, field);
         int nFields = indices[i].keyPattern.nFields();
-        // Pick the index with the lowest number of fields.
-        if (nFields < minFields) {
+        // Pick the index with the earliest position of 'field' and the lowest number of fields.
+        if (fieldNo < minFieldNo || (fieldNo == minFieldNo && nFields < minFields)) {
+            minFieldNo = fieldNo;
             minFields = nFields;
             *indexOut = i;
         }
@@ -1254,17 +1284,9 @@ bool turnIxscanIntoDistinctIxscan(QuerySolution* soln, const string& field) {
         dn->direction = isn->direction;
         dn->bounds = isn->bounds;
 
-        // Figure out which field we're skipping to the next value of.  TODO: We currently only
-        // try to distinct-hack when there is an index prefixed by the field we're distinct-ing
-        // over.  Consider removing this code if we stick with that policy.
-        dn->fieldNo = 0;
-        BSONObjIterator it(isn->indexKeyPattern);
-        while (it.more()) {
-            if (field == it.next().fieldName()) {
-                break;
-            }
-            dn->fieldNo++;
-        }
+        // Figure out which field we're skipping to the next value of. If it is not the first
+        // field of the index we skip to the next value of all of the fields up to it.
+        dn->fieldNo = getDistinctFieldNo(isn->indexKeyPattern, field);
 
         // Delete the old index scan, set the child of project to the fast distinct scan.
         delete root->children[0];
@@ -1293,7 +1315,8 @@ StatusWith<unique_ptr<PlanExecutor>> getExecutorDistinct(OperationContext* txn,
     // When can we do a fast distinct hack?
     // 1. There is a plan with just one leaf and that leaf is an ixscan.
     // 2. The ixscan indexes the field we're interested in.
-    // 2a: We are correct if the index contains the field but for now we look for prefix.
+    // 2a: We are correct if the index contains the field but unless skip scans are enabled we
+    //     look for prefix.
     // 3. The query is covered/no fetch.
     //
     // We go through normal planning (with limited parameters) to see if we can produce
@@ -1302,13 +1325,24 @@ StatusWith<unique_ptr<PlanExecutor>> getExecutorDistinct(OperationContext* txn,
     QueryPlannerParams plannerParams;
     plannerParams.options = QueryPlannerParams::NO_TABLE_SCAN;
 
+    const bool canSkipScan = internalQueryPlannerEnableSkipScan;
+    if (canSkipScan) {
+        plannerParams.options |= QueryPlannerParams::SKIP_SCAN;
+    }
+
     IndexCatalog::IndexIterator ii = collection->getIndexCatalog()->getIndexIterator(txn, false);
     while (ii.more()) {
         const IndexDescriptor* desc = ii.next();
         IndexCatalogEntry* ice = ii.catalogEntry(desc);
-        // The distinct hack can work if any field is in the index but it's not always clear
-        // if it's a win unless it's the first field.
-        if (desc->keyPattern().firstElement().fieldName() == field) {
+        // The distinct hack can work if any field is in the index. When it is not the first
+        // field the distinct scan skips to the next value of the fields before it, which is
+        // only a win over scanning every key when they have few distinct values, so we only
+        // do so if skip scans are enabled.
+        const bool isPrefix = desc->keyPattern().firstElement().fieldName() == field;
+        const bool canSkip = canSkipScan &&
+            IndexNames::findPluginName(desc->keyPattern()).empty() &&
+            desc->keyPattern().hasField(field);
+        if (isPrefix || canSkip) {
             plannerParams.indices.push_back(IndexEntry(desc->keyPattern(),
                                                        desc->getAccessMethodName(),
                                                        desc->isMultikey(txn),
@@ -1317,6 +1351,7 @@ StatusWith<unique_ptr<PlanExecutor>> getExecutorDistinct(OperationContext* txn,
                                                        desc->indexName(),
                                                        ice->getFilterExpression(),
                                                        desc->infoObj()));
+            plannerParams.indices.back().multikeyPaths = ice->getMultikeyPaths(txn);
         }
     }
 
@@ -1335,7 +1370,7 @@ StatusWith<unique_ptr<PlanExecutor>> getExecutorDistinct(OperationContext* txn,
     }
 
     //
-    // If we're here, we have an index prefixed by the field we're distinct-ing over.
+    // If we're here, we have an index over the field we're distinct-ing over.
     //
 
     // Applying a projection allows the planner to try to give us covered plans that we can turn
@@ -1371,7 +1406,7 @@ StatusWith<unique_ptr<PlanExecutor>> getExecutorDistinct(OperationContext* txn,
         dn->indexKeyPattern = plannerParams.indices[distinctNodeIndex].keyPattern;
         dn->direction = 1;
         IndexBoundsBuilder::allValuesBounds(dn->indexKeyPattern, &dn->bounds);
-        dn->fieldNo = 0;
+        dn->fieldNo = getDistinctFieldNo(dn->indexKeyPattern, field);
 
         QueryPlannerParams params;
 
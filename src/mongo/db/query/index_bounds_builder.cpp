@@ -1002,4 +1002,25 @@ bool IndexBoundsBuilder::isSingleInterval(const IndexBounds& bounds,
     }
 }
 
+// static
+size_t IndexBoundsBuilder::getSkipScanPrefixLen(const IndexBounds& bounds) {
+    if (bounds.isSimpleRange) {
+        return 0;
+    }
+
+    Interval minMax = IndexBoundsBuilder::allValues();
+    Interval maxMin = minMax;
+    maxMin.reverse();
+
+    for (size_t fieldNo = 0; fieldNo < bounds.fields.size(); ++fieldNo) {
+        const OrderedIntervalList& oil = bounds.fields[fieldNo];
+        if (1 != oil.intervals.size() ||
+            (!oil.intervals[0].equals(minMax) && !oil.intervals[0].equals(maxMin))) {
+            return fieldNo;
+        }
+    }
+
+    return 0;
+}
+
 }  // namespace mongo
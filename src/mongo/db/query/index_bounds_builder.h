@@ -188,6 +188,13 @@ public:
                                  bool* startKeyInclusive,
                                  BSONObj* endKey,
                                  bool* endKeyInclusive);
+
+    /**
+     * Returns the number of leading fields of 'bounds' which take all values and are followed
+     * by a field which does not, which is how many leading fields a scan over 'bounds' skips
+     * across. Returns 0 if the first field is constrained or no field is.
+     */
+    static size_t getSkipScanPrefixLen(const IndexBounds& bounds);
 };
 
 }  // namespace mongo
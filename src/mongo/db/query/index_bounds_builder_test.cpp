@@ -1331,6 +1331,34 @@ TEST(IndexBoundsBuilderTest, EqualitySingleMissingSingleInterval) {
     ASSERT(!testSingleInterval(bounds));
 }
 
+//
+// getSkipScanPrefixLen
+//
+
+TEST(IndexBoundsBuilderTest, SkipScanPrefixLen) {
+    OrderedIntervalList oil_a("a");
+    OrderedIntervalList oil_b("b");
+    OrderedIntervalList oil_c("c");
+    IndexBounds bounds;
+    oil_a.intervals.push_back(IndexBoundsBuilder::allValues());
+    oil_b.intervals.push_back(IndexBoundsBuilder::allValues());
+    oil_b.intervals.back().reverse();
+    oil_c.intervals.push_back(Interval(BSON("" << 5 << "" << 5), true, true));
+    bounds.fields.push_back(oil_a);
+    bounds.fields.push_back(oil_b);
+    bounds.fields.push_back(oil_c);
+    ASSERT_EQUALS(2U, IndexBoundsBuilder::getSkipScanPrefixLen(bounds));
+
+    // A constrained first field is not skipped across.
+    bounds.fields[0] = oil_c;
+    ASSERT_EQUALS(0U, IndexBoundsBuilder::getSkipScanPrefixLen(bounds));
+
+    // Nor are bounds which take all values.
+    bounds.fields[0] = oil_a;
+    bounds.fields[2] = oil_a;
+    ASSERT_EQUALS(0U, IndexBoundsBuilder::getSkipScanPrefixLen(bounds));
+}
+
 //
 // Complementing bounds for negations
 //
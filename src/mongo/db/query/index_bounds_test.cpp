@@ -748,6 +748,44 @@ TEST(IndexBoundsCheckerTest, SecondIntervalMustRewind) {
     ASSERT_EQUALS(state, IndexBoundsChecker::VALID);
 }
 
+// With no bounds on the leading field, a key outside the bounds of the second field is skipped by
+// seeking within the current leading value or past it.
+TEST(IndexBoundsCheckerTest, SkipAcrossUnconstrainedLeadingField) {
+    OrderedIntervalList fooList("foo");
+    fooList.intervals.push_back(Interval(BSON("" << MINKEY << "" << MAXKEY), true, true));
+
+    OrderedIntervalList barList("bar");
+    barList.intervals.push_back(Interval(BSON("" << 5 << "" << 5), true, true));
+
+    IndexBounds bounds;
+    bounds.fields.push_back(fooList);
+    bounds.fields.push_back(barList);
+    IndexBoundsChecker it(&bounds, BSON("foo" << 1 << "bar" << 1), 1);
+
+    IndexSeekPoint seekPoint;
+    IndexBoundsChecker::KeyState state;
+
+    // Behind the interval on 'bar': seek to it under the same value of 'foo'.
+    state = it.checkKey(BSON("" << 1 << "" << 3), &seekPoint);
+    ASSERT_EQUALS(state, IndexBoundsChecker::MUST_ADVANCE);
+    ASSERT_EQUALS(seekPoint.prefixLen, 1);
+    ASSERT_EQUALS(seekPoint.prefixExclusive, false);
+    ASSERT_EQUALS(seekPoint.keySuffix[1]->numberInt(), 5);
+    ASSERT_EQUALS(seekPoint.suffixInclusive[1], true);
+
+    state = it.checkKey(BSON("" << 1 << "" << 5), &seekPoint);
+    ASSERT_EQUALS(state, IndexBoundsChecker::VALID);
+
+    // Past the interval on 'bar': seek past the current value of 'foo'.
+    state = it.checkKey(BSON("" << 1 << "" << 6), &seekPoint);
+    ASSERT_EQUALS(state, IndexBoundsChecker::MUST_ADVANCE);
+    ASSERT_EQUALS(seekPoint.prefixLen, 1);
+    ASSERT_EQUALS(seekPoint.prefixExclusive, true);
+
+    state = it.checkKey(BSON("" << 2 << "" << 5), &seekPoint);
+    ASSERT_EQUALS(state, IndexBoundsChecker::VALID);
+}
+
 TEST(IndexBoundsCheckerTest, SimpleCheckKeyBackwards) {
     OrderedIntervalList fooList("foo");
     fooList.intervals.push_back(Interval(BSON("" << 20 << "" << 7), true, true));
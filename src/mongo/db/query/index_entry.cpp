@@ -60,6 +60,10 @@ std::string IndexEntry::toString() const {
         sb << " io: " << infoObj;
     }
 
+    if (skipScanPrefixLen) {
+        sb << " skipScanPrefixLen: " << skipScanPrefixLen;
+    }
+
     return sb.str();
 }
 
@@ -30,6 +30,7 @@
 
 #include <string>
 
+#include "mongo/db/index/multikey_paths.h"
 #include "mongo/db/index_names.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/util/mongoutils/str.h"
@@ -59,7 +60,8 @@ struct IndexEntry {
           unique(unq),
           name(n),
           filterExpr(fe),
-          infoObj(io) {
+          infoObj(io),
+          skipScanPrefixLen(0) {
         type = IndexNames::nameToType(accessMethod);
     }
 
@@ -79,7 +81,8 @@ struct IndexEntry {
           unique(unq),
           name(n),
           filterExpr(fe),
-          infoObj(io) {
+          infoObj(io),
+          skipScanPrefixLen(0) {
         type = IndexNames::nameToType(IndexNames::findPluginName(keyPattern));
     }
 
@@ -93,7 +96,8 @@ struct IndexEntry {
           unique(false),
           name("test_foo"),
           filterExpr(nullptr),
-          infoObj(BSONObj()) {
+          infoObj(BSONObj()),
+          skipScanPrefixLen(0) {
         type = IndexNames::nameToType(IndexNames::findPluginName(keyPattern));
     }
 
@@ -101,6 +105,10 @@ struct IndexEntry {
 
     bool multikey;
 
+    // Which components of each key pattern field traverse an array, if the index tracks it. Lets
+    // the planner cover the fields of a multikey index which are never arrays.
+    MultikeyPaths multikeyPaths;
+
     bool sparse;
 
     bool unique;
@@ -116,6 +124,12 @@ struct IndexEntry {
     // by the keyPattern?)
     IndexType type;
 
+    // Set by the planner when the query has no predicate over the leading fields of this
+    // index, to the number of those fields. The scan then seeks across their distinct values,
+    // and predicates over the field at this position play the part of predicates over the
+    // first field.
+    size_t skipScanPrefixLen;
+
     std::string toString() const;
 };
 
@@ -94,6 +94,7 @@ const char kOplogReplayField[] = "oplogReplay";
 const char kNoCursorTimeoutField[] = "noCursorTimeout";
 const char kAwaitDataField[] = "awaitData";
 const char kPartialResultsField[] = "allowPartialResults";
+const char kAllowDiskUseField[] = "allowDiskUse";
 const char kTermField[] = "term";
 const char kOptionsField[] = "options";
 
@@ -335,6 +336,13 @@ StatusWith<unique_ptr<LiteParsedQuery>> LiteParsedQuery::makeFromFindCommand(Nam
             }
 
             pq->_allowPartialResults = el.boolean();
+        } else if (str::equals(fieldName, kAllowDiskUseField)) {
+            Status status = checkFieldType(el, Bool);
+            if (!status.isOK()) {
+                return status;
+            }
+
+            pq->_allowDiskUse = el.boolean();
         } else if (str::equals(fieldName, kOptionsField)) {
             // 3.0.x versions of the shell may generate an explain of a find command with an
             // 'options' field. We accept this only if the 'options' field is empty so that
@@ -440,7 +448,8 @@ std::unique_ptr<LiteParsedQuery> LiteParsedQuery::makeAsFindCmd(
     bool isOplogReplay,
     bool isNoCursorTimeout,
     bool isAwaitData,
-    bool allowPartialResults) {
+    bool allowPartialResults,
+    bool allowDiskUse) {
     unique_ptr<LiteParsedQuery> pq(new LiteParsedQuery(std::move(nss)));
     // ntoreturn and batchSize or limit are mutually exclusive.
     if (batchSize || limit) {
@@ -477,6 +486,7 @@ std::unique_ptr<LiteParsedQuery> LiteParsedQuery::makeAsFindCmd(
     pq->_noCursorTimeout = isNoCursorTimeout;
     pq->_awaitData = isAwaitData;
     pq->_allowPartialResults = allowPartialResults;
+    pq->_allowDiskUse = allowDiskUse;
 
     return pq;
 }
@@ -582,6 +592,10 @@ void LiteParsedQuery::asFindCommand(BSONObjBuilder* cmdBuilder) const {
         cmdBuilder->append(kPartialResultsField, true);
     }
 
+    if (_allowDiskUse) {
+        cmdBuilder->append(kAllowDiskUseField, true);
+    }
+
     if (_replicationTerm) {
         cmdBuilder->append(kTermField, *_replicationTerm);
     }
@@ -921,6 +935,8 @@ Status LiteParsedQuery::initFullQuery(const BSONObj& top) {
                     return maxTimeMS.getStatus();
                 }
                 _maxTimeMS = maxTimeMS.getValue();
+            } else if (str::equals("allowDiskUse", name)) {
+                _allowDiskUse = e.trueValue();
             }
         }
     }
@@ -110,7 +110,8 @@ public:
         bool isOplogReplay = false,
         bool isNoCursorTimeout = false,
         bool isAwaitData = false,
-        bool allowPartialResults = false);
+        bool allowPartialResults = false,
+        bool allowDiskUse = false);
 
     /**
      * Converts this LPQ into a find command.
@@ -248,6 +249,9 @@ public:
     bool hasReadPref() const {
         return _hasReadPref;
     }
+    bool allowDiskUse() const {
+        return _allowDiskUse;
+    }
 
     bool isTailable() const {
         return _tailable;
@@ -382,6 +386,10 @@ private:
     bool _snapshot = false;
     bool _hasReadPref = false;
 
+    // Lets a blocking SORT stage spill sorted runs to disk rather than fail once it exceeds
+    // internalQueryExecMaxBlockingSortBytes.
+    bool _allowDiskUse = false;
+
     // Options that can be specified in the OP_QUERY 'flags' header.
     bool _tailable = false;
     bool _slaveOk = false;
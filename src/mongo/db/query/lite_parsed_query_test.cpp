@@ -599,6 +599,18 @@ TEST(LiteParsedQueryTest, ParseFromCommandAllFlagsTrue) {
     ASSERT(lpq->isAllowPartialResults());
 }
 
+TEST(LiteParsedQueryTest, ParseFromCommandAllowDiskUse) {
+    BSONObj cmdObj = fromjson("{find: 'testns', sort: {a: 1}, allowDiskUse: true}");
+    const NamespaceString nss("test.testns");
+    bool isExplain = false;
+    unique_ptr<LiteParsedQuery> lpq(
+        assertGet(LiteParsedQuery::makeFromFindCommand(nss, cmdObj, isExplain)));
+    ASSERT(lpq->allowDiskUse());
+
+    // The option survives the round trip through asFindCommand() so mongos forwards it.
+    ASSERT(lpq->asFindCommand()["allowDiskUse"].trueValue());
+}
+
 TEST(LiteParsedQueryTest, ParseFromCommandCommentWithValidMinMax) {
     BSONObj cmdObj = fromjson(
         "{find: 'testns',"
@@ -930,6 +942,17 @@ TEST(LiteParsedQueryTest, ParseFromCommandPartialWrongType) {
     ASSERT_NOT_OK(result.getStatus());
 }
 
+TEST(LiteParsedQueryTest, ParseFromCommandAllowDiskUseWrongType) {
+    BSONObj cmdObj = fromjson(
+        "{find: 'testns',"
+        "sort:  {a: 1},"
+        "allowDiskUse: 1}");
+    const NamespaceString nss("test.testns");
+    bool isExplain = false;
+    auto result = LiteParsedQuery::makeFromFindCommand(nss, cmdObj, isExplain);
+    ASSERT_NOT_OK(result.getStatus());
+}
+
 TEST(LiteParsedQueryTest, ParseFromCommandReadConcernWrongType) {
     BSONObj cmdObj = fromjson(
         "{find: 'testns',"
@@ -1188,6 +1211,7 @@ TEST(LiteParsedQueryTest, DefaultQueryParametersCorrect) {
     ASSERT_EQUALS(false, lpq->isAwaitData());
     ASSERT_EQUALS(false, lpq->isExhaust());
     ASSERT_EQUALS(false, lpq->isAllowPartialResults());
+    ASSERT_EQUALS(false, lpq->allowDiskUse());
 }
 
 //
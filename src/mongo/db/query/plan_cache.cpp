@@ -42,9 +42,11 @@
 #include "mongo/db/query/plan_ranker.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/db/query/query_knobs.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace {
@@ -58,6 +60,10 @@ const char kEncodeChildrenSeparator = ',';
 const char kEncodeSortSection = '~';
 const char kEncodeProjectionSection = '|';
 
+// Upper bound on the number of shards of a PlanCache. Caches smaller than this get one shard per
+// entry so that the total capacity stays internalQueryCacheSize.
+const size_t kMaxPlanCacheShards = 16;
+
 /**
  * Encode user-provided string. Cache key delimiters seen in the
  * user string are escaped with a backslash.
@@ -330,13 +336,34 @@ CachedSolution::~CachedSolution() {
     }
 }
 
+//
+// PlanCacheShapeStats
+//
+
+void PlanCacheShapeStats::appendTo(BSONObjBuilder* bob) const {
+    const long long numRuns = static_cast<long long>(runs.load());
+    const long long numWorks = static_cast<long long>(works.load());
+    bob->append("hits", static_cast<long long>(hits.load()));
+    bob->append("replans", static_cast<long long>(replans.load()));
+    bob->append("runs", numRuns);
+    bob->append("avgWorks", numRuns ? static_cast<double>(numWorks) / numRuns : 0.0);
+    const long long lastUsed = lastUsedMillis.load();
+    if (lastUsed) {
+        bob->appendDate("lastUsed", Date_t::fromMillisSinceEpoch(lastUsed));
+    } else {
+        bob->appendNull("lastUsed");
+    }
+}
+
 //
 // PlanCacheEntry
 //
 
 PlanCacheEntry::PlanCacheEntry(const std::vector<QuerySolution*>& solutions,
                                PlanRankingDecision* why)
-    : plannerData(solutions.size()), decision(why) {
+    : plannerData(solutions.size()),
+      decision(why),
+      shapeStats(std::make_shared<PlanCacheShapeStats>()) {
     invariant(why);
 
     // The caller of this constructor is responsible for ensuring
@@ -380,6 +407,7 @@ PlanCacheEntry* PlanCacheEntry::clone() const {
         fb->score = feedback[i]->score;
         entry->feedback.push_back(fb);
     }
+    entry->shapeStats = shapeStats;
     return entry;
 }
 
@@ -476,9 +504,17 @@ std::string SolutionCacheData::toString() const {
 // PlanCache
 //
 
-PlanCache::PlanCache() : _cache(internalQueryCacheSize) {}
+PlanCache::PlanCache() : PlanCache(std::string()) {}
 
-PlanCache::PlanCache(const std::string& ns) : _cache(internalQueryCacheSize), _ns(ns) {}
+PlanCache::PlanCache(const std::string& ns) : _ns(ns) {
+    const size_t maxSize = std::max(1, internalQueryCacheSize.load());
+    const size_t numShards = std::min(kMaxPlanCacheShards, maxSize);
+    // Round up, so the cache holds at least internalQueryCacheSize entries in total.
+    _shardCapacity = (maxSize + numShards - 1) / numShards;
+    for (size_t i = 0; i < numShards; ++i) {
+        _shards.push_back(stdx::make_unique<Shard>(_shardCapacity));
+    }
+}
 
 PlanCache::~PlanCache() {}
 
@@ -652,31 +688,66 @@ Status PlanCache::add(const CanonicalQuery& query,
     }
     entry->projection = projBuilder.obj();
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(computeKey(query), entry);
+    const PlanCacheKey key = computeKey(query);
+    EntryRef ref(entry);
+    std::unique_ptr<EntryRef> evictedEntry;
+    {
+        Shard& shard = shardFor(key);
+        stdx::lock_guard<stdx::mutex> shardLock(shard.mutex);
+
+        // A replanned shape keeps its counters.
+        if (EntryRef existing = lookupInLock(shard, key)) {
+            ref->shapeStats = existing->shapeStats;
+        }
+        evictedEntry = shard.cache.add(key, new EntryRef(std::move(ref)));
+    }
 
     if (NULL != evictedEntry.get()) {
         LOG(1) << _ns << ": plan cache maximum size exceeded - "
-               << "removed least recently used entry " << evictedEntry->toString();
+               << "removed least recently used entry " << (*evictedEntry)->toString();
     }
 
     return Status::OK();
 }
 
+// static
+PlanCache::EntryRef PlanCache::lookupInLock(const Shard& shard, const PlanCacheKey& key) {
+    EntryRef* entry;
+    if (!shard.cache.get(key, &entry).isOK()) {
+        return EntryRef();
+    }
+    invariant(entry && *entry);
+    return *entry;
+}
+
+size_t PlanCache::shardIndexFor(const PlanCacheKey& key) const {
+    return std::hash<PlanCacheKey>()(key) % _shards.size();
+}
+
+PlanCache::Shard& PlanCache::shardFor(const PlanCacheKey& key) const {
+    return *_shards[shardIndexFor(key)];
+}
+
 Status PlanCache::get(const CanonicalQuery& query, CachedSolution** crOut) const {
     PlanCacheKey key = computeKey(query);
     verify(crOut);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(key, &entry);
-    if (!cacheStatus.isOK()) {
-        return cacheStatus;
+    EntryRef entry;
+    {
+        Shard& shard = shardFor(key);
+        stdx::lock_guard<stdx::mutex> shardLock(shard.mutex);
+        entry = lookupInLock(shard, key);
+    }
+    if (!entry) {
+        return Status(ErrorCodes::NoSuchKey, "no such key in LRU key-value store");
     }
-    invariant(entry);
 
+    // The planner data of a published entry is immutable, so it can be copied without the lock.
     *crOut = new CachedSolution(key, *entry);
 
+    entry->shapeStats->hits.fetchAndAdd(1);
+    entry->shapeStats->lastUsedMillis.store(Date_t::now().toMillisSinceEpoch());
+
     return Status::OK();
 }
 
@@ -687,13 +758,15 @@ Status PlanCache::feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* fee
     std::unique_ptr<PlanCacheEntryFeedback> autoFeedback(feedback);
     PlanCacheKey ck = computeKey(cq);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(ck, &entry);
-    if (!cacheStatus.isOK()) {
-        return cacheStatus;
+    Shard& shard = shardFor(ck);
+    stdx::lock_guard<stdx::mutex> shardLock(shard.mutex);
+    EntryRef entry = lookupInLock(shard, ck);
+    if (!entry) {
+        return Status(ErrorCodes::NoSuchKey, "no such key in LRU key-value store");
     }
-    invariant(entry);
+
+    entry->shapeStats->runs.fetchAndAdd(1);
+    entry->shapeStats->works.fetchAndAdd(autoFeedback->stats->common.works);
 
     // We store up to a constant number of feedback entries.
     if (entry->feedback.size() < size_t(internalQueryCacheFeedbacksStored)) {
@@ -703,14 +776,35 @@ Status PlanCache::feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* fee
     return Status::OK();
 }
 
+Status PlanCache::noteReplan(const CanonicalQuery& cq) {
+    PlanCacheKey ck = computeKey(cq);
+
+    EntryRef entry;
+    {
+        Shard& shard = shardFor(ck);
+        stdx::lock_guard<stdx::mutex> shardLock(shard.mutex);
+        entry = lookupInLock(shard, ck);
+    }
+    if (!entry) {
+        return Status(ErrorCodes::NoSuchKey, "no such key in LRU key-value store");
+    }
+
+    entry->shapeStats->replans.fetchAndAdd(1);
+    return Status::OK();
+}
+
 Status PlanCache::remove(const CanonicalQuery& canonicalQuery) {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.remove(computeKey(canonicalQuery));
+    PlanCacheKey key = computeKey(canonicalQuery);
+    Shard& shard = shardFor(key);
+    stdx::lock_guard<stdx::mutex> shardLock(shard.mutex);
+    return shard.cache.remove(key);
 }
 
 void PlanCache::clear() {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    _cache.clear();
+    for (auto& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> shardLock(shard->mutex);
+        shard->cache.clear();
+    }
     _writeOperations.store(0);
 }
 
@@ -726,13 +820,13 @@ Status PlanCache::getEntry(const CanonicalQuery& query, PlanCacheEntry** entryOu
     PlanCacheKey key = computeKey(query);
     verify(entryOut);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(key, &entry);
-    if (!cacheStatus.isOK()) {
-        return cacheStatus;
+    // Cloning reads the feedback, which is only stable under the shard lock.
+    Shard& shard = shardFor(key);
+    stdx::lock_guard<stdx::mutex> shardLock(shard.mutex);
+    EntryRef entry = lookupInLock(shard, key);
+    if (!entry) {
+        return Status(ErrorCodes::NoSuchKey, "no such key in LRU key-value store");
     }
-    invariant(entry);
 
     *entryOut = entry->clone();
 
@@ -740,25 +834,31 @@ Status PlanCache::getEntry(const CanonicalQuery& query, PlanCacheEntry** entryOu
 }
 
 std::vector<PlanCacheEntry*> PlanCache::getAllEntries() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
     std::vector<PlanCacheEntry*> entries;
-    typedef std::list<std::pair<PlanCacheKey, PlanCacheEntry*>>::const_iterator ConstIterator;
-    for (ConstIterator i = _cache.begin(); i != _cache.end(); i++) {
-        PlanCacheEntry* entry = i->second;
-        entries.push_back(entry->clone());
+    for (auto& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> shardLock(shard->mutex);
+        for (auto i = shard->cache.begin(); i != shard->cache.end(); i++) {
+            entries.push_back((*i->second)->clone());
+        }
     }
 
     return entries;
 }
 
 bool PlanCache::contains(const CanonicalQuery& cq) const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.hasKey(computeKey(cq));
+    PlanCacheKey key = computeKey(cq);
+    Shard& shard = shardFor(key);
+    stdx::lock_guard<stdx::mutex> shardLock(shard.mutex);
+    return shard.cache.hasKey(key);
 }
 
 size_t PlanCache::size() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.size();
+    size_t total = 0;
+    for (auto& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> shardLock(shard->mutex);
+        total += shard->cache.size();
+    }
+    return total;
 }
 
 void PlanCache::notifyOfIndexEntries(const std::vector<IndexEntry>& indexEntries) {
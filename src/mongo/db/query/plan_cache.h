@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <memory>
 #include <set>
 #include <boost/optional/optional.hpp>
 
@@ -62,6 +63,32 @@ struct PlanCacheEntryFeedback {
     double score;
 };
 
+/**
+ * Counters describing how a query shape has used the plan cache. They are shared by every
+ * PlanCacheEntry cached for the shape, so they survive the entry being replaced when the shape is
+ * replanned, and are updated without holding any plan cache lock.
+ */
+struct PlanCacheShapeStats {
+    // Number of times a cached plan for the shape was handed out by PlanCache::get().
+    AtomicUInt64 hits;
+
+    // Number of times the CachedPlanStage gave up on the cached plan and replanned the shape.
+    AtomicUInt64 replans;
+
+    // Number of trial periods the cached plan completed without replanning, and the total number
+    // of works they took.
+    AtomicUInt64 runs;
+    AtomicUInt64 works;
+
+    // Wall clock time of the last hit, in milliseconds since the epoch. 0 if never used.
+    AtomicInt64 lastUsedMillis;
+
+    /**
+     * Appends the counters, with the average works per run and the last used time, to 'bob'.
+     */
+    void appendTo(BSONObjBuilder* bob) const;
+};
+
 // TODO: Replace with opaque type.
 typedef std::string PlanID;
 
@@ -255,8 +282,12 @@ public:
     std::unique_ptr<PlanRankingDecision> decision;
 
     // Annotations from cached runs.  The CachedPlanStage provides these stats about its
-    // runs when they complete.
+    // runs when they complete.  Guarded by the lock of the cache shard holding the entry.
     std::vector<PlanCacheEntryFeedback*> feedback;
+
+    // Usage counters of the query shape. Shared with clones and with the entries which replace
+    // this one in the cache.
+    std::shared_ptr<PlanCacheShapeStats> shapeStats;
 };
 
 /**
@@ -264,6 +295,11 @@ public:
  * mapping, the cache contains information on why that mapping was made and statistics on the
  * cache entry's actual performance on subsequent runs.
  *
+ * The cache is split into shards chosen by a hash of the cache key, each with its own mutex and
+ * LRU list, so lookups of different query shapes do not contend. Entries are published fully
+ * built and their planner data is never modified afterwards: get() only takes the shard mutex to
+ * find the entry and take a reference to it, and copies the cached solution out after releasing
+ * it. An entry which is replaced or evicted meanwhile stays alive until its last reader is done.
  */
 class PlanCache {
 private:
@@ -327,6 +363,14 @@ public:
      */
     Status feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* feedback);
 
+    /**
+     * Records that the CachedPlanStage abandoned the cached plan for 'cq' and replanned it. The
+     * count is carried over to the entry cached by the replan, if any.
+     *
+     * Returns an error Status if there is no entry for 'cq' in the cache.
+     */
+    Status noteReplan(const CanonicalQuery& cq);
+
     /**
      * Remove the entry corresponding to 'ck' from the cache.  Returns Status::OK() if the plan
      * was present and removed and an error status otherwise.
@@ -380,6 +424,28 @@ public:
      */
     size_t size() const;
 
+    /**
+     * Returns the number of shards the cache is split into.
+     * Used for testing.
+     */
+    size_t numShards() const {
+        return _shards.size();
+    }
+
+    /**
+     * Returns the number of entries each shard holds before it evicts.
+     * Used for testing.
+     */
+    size_t shardCapacity() const {
+        return _shardCapacity;
+    }
+
+    /**
+     * Returns the index of the shard which holds the entry for 'key'.
+     * Used for testing.
+     */
+    size_t shardIndexFor(const PlanCacheKey& key) const;
+
     /**
      * Updates internal state kept about the collection's indexes.  Must be called when the set
      * of indexes on the associated collection have changed.
@@ -393,10 +459,32 @@ private:
     void encodeKeyForSort(const BSONObj& sortObj, StringBuilder* keyBuilder) const;
     void encodeKeyForProj(const BSONObj& projObj, StringBuilder* keyBuilder) const;
 
-    LRUKeyValue<PlanCacheKey, PlanCacheEntry> _cache;
+    // Entries are reference counted so that readers can use them after releasing the shard
+    // mutex.
+    typedef std::shared_ptr<PlanCacheEntry> EntryRef;
+
+    struct Shard {
+        Shard(size_t maxSize) : cache(maxSize) {}
+
+        // Protects 'cache' and the feedback of the entries in it.
+        stdx::mutex mutex;
+
+        LRUKeyValue<PlanCacheKey, EntryRef> cache;
+    };
+
+    Shard& shardFor(const PlanCacheKey& key) const;
+
+    /**
+     * Returns a reference to the entry for 'key', or an empty reference if there is none. The
+     * caller must hold the mutex of 'shard'.
+     */
+    static EntryRef lookupInLock(const Shard& shard, const PlanCacheKey& key);
+
+    // Never resized after construction, so it can be read without a lock.
+    std::vector<std::unique_ptr<Shard>> _shards;
 
-    // Protects _cache.
-    mutable stdx::mutex _cacheMutex;
+    // Maximum number of entries in each shard.
+    size_t _shardCapacity;
 
     // Counter for write notifications since initialization or last clear() invocation.  Starts
     // at 0.
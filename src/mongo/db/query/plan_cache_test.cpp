@@ -45,6 +45,7 @@
 #include "mongo/db/query/query_solution.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/scopeguard.h"
 
 using namespace mongo;
 
@@ -388,6 +389,113 @@ TEST(PlanCacheTest, AddValidSolution) {
     ASSERT_EQUALS(planCache.size(), 1U);
 }
 
+/**
+ * Adds a single collection scan solution for 'cq' to 'planCache'.
+ */
+void addCollScan(PlanCache* planCache, const CanonicalQuery& cq) {
+    GenerateQuerySolution generator;
+    unique_ptr<QuerySolution> qs(generator());
+    std::vector<QuerySolution*> solns;
+    solns.push_back(qs.get());
+    ASSERT_OK(planCache->add(cq, solns, createDecision(1U)));
+}
+
+// Shards split the configured capacity between them, without going below it.
+TEST(PlanCacheTest, ShardsShareCapacity) {
+    const int oldCacheSize = internalQueryCacheSize.load();
+    ON_BLOCK_EXIT([oldCacheSize] { internalQueryCacheSize.store(oldCacheSize); });
+
+    internalQueryCacheSize.store(3);
+    PlanCache smallCache;
+    ASSERT_EQUALS(smallCache.numShards(), 3U);
+    ASSERT_EQUALS(smallCache.shardCapacity(), 1U);
+
+    internalQueryCacheSize.store(100);
+    PlanCache planCache;
+    ASSERT_GREATER_THAN(planCache.numShards(), 1U);
+    ASSERT_GREATER_THAN_OR_EQUALS(planCache.numShards() * planCache.shardCapacity(), 100U);
+
+    // Each shard evicts on its own, so the caches hold as many entries as fit in the shards the
+    // keys hash to.
+    std::vector<size_t> smallShardKeys(smallCache.numShards());
+    std::vector<size_t> shardKeys(planCache.numShards());
+    for (int i = 0; i < 200; ++i) {
+        unique_ptr<CanonicalQuery> cq(
+            canonicalize(BSON(std::string(str::stream() << "f" << i) << 1)));
+        addCollScan(&smallCache, *cq);
+        addCollScan(&planCache, *cq);
+        ++smallShardKeys[smallCache.shardIndexFor(smallCache.computeKey(*cq))];
+        ++shardKeys[planCache.shardIndexFor(planCache.computeKey(*cq))];
+    }
+
+    size_t expectedSmallSize = 0;
+    for (size_t numKeys : smallShardKeys) {
+        expectedSmallSize += std::min(numKeys, smallCache.shardCapacity());
+    }
+    size_t expectedSize = 0;
+    for (size_t numKeys : shardKeys) {
+        expectedSize += std::min(numKeys, planCache.shardCapacity());
+    }
+    ASSERT_EQUALS(smallCache.size(), expectedSmallSize);
+    ASSERT_EQUALS(planCache.size(), expectedSize);
+
+    // Every shard is visited when listing and clearing.
+    std::vector<PlanCacheEntry*> entries = planCache.getAllEntries();
+    ASSERT_EQUALS(entries.size(), planCache.size());
+    for (auto entry : entries) {
+        delete entry;
+    }
+    planCache.clear();
+    ASSERT_EQUALS(planCache.size(), 0U);
+}
+
+// The usage counters of a shape are updated by lookups, feedback and replans, and are carried
+// over when the shape is cached again.
+TEST(PlanCacheTest, ShapeStats) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    ASSERT_NOT_OK(planCache.noteReplan(*cq));
+    addCollScan(&planCache, *cq);
+
+    CachedSolution* rawCS;
+    ASSERT_OK(planCache.get(*cq, &rawCS));
+    delete rawCS;
+    ASSERT_OK(planCache.get(*cq, &rawCS));
+    delete rawCS;
+
+    CommonStats common("CACHED_PLAN");
+    common.works = 10;
+    PlanCacheEntryFeedback* feedback = new PlanCacheEntryFeedback();
+    feedback->stats.reset(new PlanStageStats(common, STAGE_CACHED_PLAN));
+    feedback->score = 0;
+    ASSERT_OK(planCache.feedback(*cq, feedback));
+    ASSERT_OK(planCache.noteReplan(*cq));
+
+    // Replanning caches a new entry for the shape.
+    addCollScan(&planCache, *cq);
+
+    PlanCacheEntry* rawEntry;
+    ASSERT_OK(planCache.getEntry(*cq, &rawEntry));
+    unique_ptr<PlanCacheEntry> entry(rawEntry);
+    ASSERT_TRUE(entry->feedback.empty());
+
+    BSONObjBuilder bob;
+    entry->shapeStats->appendTo(&bob);
+    BSONObj stats = bob.obj();
+    ASSERT_EQUALS(stats["hits"].numberLong(), 2);
+    ASSERT_EQUALS(stats["replans"].numberLong(), 1);
+    ASSERT_EQUALS(stats["runs"].numberLong(), 1);
+    ASSERT_EQUALS(stats["avgWorks"].numberDouble(), 10.0);
+    ASSERT_EQUALS(stats["lastUsed"].type(), Date);
+
+    // A shape which is removed and cached again starts over.
+    ASSERT_OK(planCache.remove(*cq));
+    addCollScan(&planCache, *cq);
+    ASSERT_OK(planCache.getEntry(*cq, &rawEntry));
+    entry.reset(rawEntry);
+    ASSERT_EQUALS(entry->shapeStats->hits.load(), 0U);
+}
+
 /**
  * Each test in the CachePlanSelectionTest suite goes through
  * the following flow:
@@ -603,7 +603,7 @@ void PlanEnumerator::enumerateOneIndex(const IndexToPredMap& idxToFirst,
                 indexAssign.index = it->first;
 
                 indexAssign.preds.push_back(pred);
-                indexAssign.positions.push_back(0);
+                indexAssign.positions.push_back(thisIndex.skipScanPrefixLen);
 
                 // If there are any preds that could possibly be compounded with this
                 // index...
@@ -637,8 +637,8 @@ void PlanEnumerator::enumerateOneIndex(const IndexToPredMap& idxToFirst,
             indexAssign.preds = it->second;
 
             // Since everything in assign.preds prefixes the index, they all go
-            // at position '0' in the index, the first position.
-            indexAssign.positions.resize(indexAssign.preds.size(), 0);
+            // at the first position, which is past the skipped fields for a skip scan.
+            indexAssign.positions.resize(indexAssign.preds.size(), thisIndex.skipScanPrefixLen);
 
             // Find everything that could use assign.index but isn't a pred over
             // the first field of that index.
@@ -704,8 +704,8 @@ void PlanEnumerator::enumerateAndIntersect(const IndexToPredMap& idxToFirst,
         oneAssign.index = firstIt->first;
         oneAssign.preds = firstIt->second;
         // Since everything in assign.preds prefixes the index, they all go
-        // at position '0' in the index, the first position.
-        oneAssign.positions.resize(oneAssign.preds.size(), 0);
+        // at the first position, which is past the skipped fields for a skip scan.
+        oneAssign.positions.resize(oneAssign.preds.size(), oneIndex.skipScanPrefixLen);
 
         // We create a scan per predicate so if we have >1 predicate we'll already
         // have at least 2 scans (one predicate per scan as the planner can't
@@ -777,8 +777,8 @@ void PlanEnumerator::enumerateAndIntersect(const IndexToPredMap& idxToFirst,
             firstAssign.index = it1->first;
             firstAssign.preds = it1->second;
             // Since everything in assign.preds prefixes the index, they all go
-            // at position '0' in the index, the first position.
-            firstAssign.positions.resize(firstAssign.preds.size(), 0);
+            // at the first position, which is past the skipped fields for a skip scan.
+            firstAssign.positions.resize(firstAssign.preds.size(), ie1.skipScanPrefixLen);
 
             // We keep track of what preds are assigned to indices either because they
             // prefix the index or have been assigned through compounding. We make sure
@@ -808,7 +808,7 @@ void PlanEnumerator::enumerateAndIntersect(const IndexToPredMap& idxToFirst,
             for (size_t i = 0; i < preds.size(); ++i) {
                 if (predsAssigned.end() == predsAssigned.find(preds[i])) {
                     secondAssign.preds.push_back(preds[i]);
-                    secondAssign.positions.push_back(0);
+                    secondAssign.positions.push_back(ie2.skipScanPrefixLen);
                     predsAssigned.insert(preds[i]);
                 }
             }
@@ -1102,13 +1102,17 @@ void PlanEnumerator::compound(const vector<MatchExpression*>& tryCompound,
     // fields in the index key pattern.
     BSONObjIterator kpIt(thisIndex.keyPattern);
 
-    // Skip the first elt as it's already assigned.
+    // Skip the first elt as it's already assigned, along with the elts a skip scan seeks
+    // across.
     kpIt.next();
 
     // When we compound we store the field number that the predicate
     // goes over in order to avoid having to iterate again and compare
     // field names.
     size_t posInIdx = 0;
+    for (; posInIdx < thisIndex.skipScanPrefixLen; ++posInIdx) {
+        kpIt.next();
+    }
 
     while (kpIt.more()) {
         BSONElement keyElt = kpIt.next();
@@ -1146,7 +1150,8 @@ void PlanEnumerator::tagMemo(size_t id) {
         PredicateAssignment* pa = assign->pred.get();
         verify(NULL == pa->expr->getTag());
         verify(pa->indexToAssign < pa->first.size());
-        pa->expr->setTag(new IndexTag(pa->first[pa->indexToAssign]));
+        const size_t index = pa->first[pa->indexToAssign];
+        pa->expr->setTag(new IndexTag(index, (*_indices)[index].skipScanPrefixLen));
     } else if (NULL != assign->orAssignment) {
         OrAssignment* oa = assign->orAssignment.get();
         for (size_t i = 0; i < oa->subnodes.size(); ++i) {
@@ -134,13 +134,23 @@ QuerySolutionNode* QueryPlannerAccess::makeCollectionScan(const CanonicalQuery&
     // The sort can specify $natural as well. The sort direction should override the hint
     // direction if both are specified.
     const BSONObj& sortObj = query.getParsed().getSort();
+    bool naturalSort = false;
     if (!sortObj.isEmpty()) {
         BSONElement natural = sortObj.getFieldDotted("$natural");
         if (!natural.eoo()) {
             csn->direction = natural.numberInt() >= 0 ? 1 : -1;
+            naturalSort = true;
         }
     }
 
+    // A parallel scan returns its ranges one after the other when the caller asked for RecordId
+    // order.
+    if ((params.options & QueryPlannerParams::PARALLEL_COLLSCAN) && !tailable &&
+        0 == csn->maxScan && csn->direction > 0) {
+        csn->parallel = true;
+        csn->parallelOrdered = naturalSort;
+    }
+
     return csn;
 }
 
@@ -205,6 +215,7 @@ QuerySolutionNode* QueryPlannerAccess::makeLeafNode(
         IndexScanNode* isn = new IndexScanNode();
         isn->indexKeyPattern = index.keyPattern;
         isn->indexIsMultiKey = index.multikey;
+        isn->multikeyPaths = index.multikeyPaths;
         isn->bounds.fields.resize(index.keyPattern.nFields());
         isn->maxScan = query.getParsed().getMaxScan();
         isn->addKeyMetadata = query.getParsed().returnKey();
@@ -1236,6 +1247,7 @@ QuerySolutionNode* QueryPlannerAccess::scanWholeIndex(const IndexEntry& index,
     unique_ptr<IndexScanNode> isn = make_unique<IndexScanNode>();
     isn->indexKeyPattern = index.keyPattern;
     isn->indexIsMultiKey = index.multikey;
+    isn->multikeyPaths = index.multikeyPaths;
     isn->maxScan = query.getParsed().getMaxScan();
     isn->addKeyMetadata = query.getParsed().returnKey();
 
@@ -1372,6 +1384,7 @@ QuerySolutionNode* QueryPlannerAccess::makeIndexScan(const IndexEntry& index,
     IndexScanNode* isn = new IndexScanNode();
     isn->indexKeyPattern = index.keyPattern;
     isn->indexIsMultiKey = index.multikey;
+    isn->multikeyPaths = index.multikeyPaths;
     isn->direction = 1;
     isn->maxScan = query.getParsed().getMaxScan();
     isn->addKeyMetadata = query.getParsed().returnKey();
@@ -210,6 +210,7 @@ void explodeScan(IndexScanNode* isn,
         child->maxScan = isn->maxScan;
         child->addKeyMetadata = isn->addKeyMetadata;
         child->indexIsMultiKey = isn->indexIsMultiKey;
+        child->multikeyPaths = isn->multikeyPaths;
 
         // Copy the filter, if there is one.
         if (isn->filter.get()) {
@@ -521,6 +522,7 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
 
     SortNode* sort = new SortNode();
     sort->pattern = sortObj;
+    sort->allowDiskUse = lpq.allowDiskUse();
     sort->children.push_back(solnRoot);
     solnRoot = sort;
     // When setting the limit on the sort, we need to consider both
@@ -120,6 +120,54 @@ void QueryPlannerIXSelect::findRelevantIndices(const unordered_set<string>& fiel
     }
 }
 
+// static
+size_t QueryPlannerIXSelect::getSkipScanPrefixLen(const unordered_set<string>& fields,
+                                                  const IndexEntry& index) {
+    if (INDEX_BTREE != index.type) {
+        return 0;
+    }
+
+    size_t pos = 0;
+    BSONObjIterator it(index.keyPattern);
+    while (it.more()) {
+        if (fields.end() != fields.find(it.next().fieldName())) {
+            return pos;
+        }
+        ++pos;
+    }
+    return 0;
+}
+
+// static
+void QueryPlannerIXSelect::findSkipScanIndices(const unordered_set<string>& fields,
+                                               const vector<IndexEntry>& allIndices,
+                                               vector<IndexEntry>* out) {
+    // Fields which an index we already use is prefixed by. Seeking across the leading fields of
+    // another index is unlikely to beat a scan of an index prefixed by the field.
+    unordered_set<string> leadingFields;
+    for (size_t i = 0; i < out->size(); ++i) {
+        leadingFields.insert((*out)[i].keyPattern.firstElement().fieldName());
+    }
+
+    for (size_t i = 0; i < allIndices.size(); ++i) {
+        size_t prefixLen = getSkipScanPrefixLen(fields, allIndices[i]);
+        if (0 == prefixLen) {
+            continue;
+        }
+
+        BSONObjIterator it(allIndices[i].keyPattern);
+        for (size_t pos = 0; pos < prefixLen; ++pos) {
+            it.next();
+        }
+        if (leadingFields.end() != leadingFields.find(it.next().fieldName())) {
+            continue;
+        }
+
+        out->push_back(allIndices[i]);
+        out->back().skipScanPrefixLen = prefixLen;
+    }
+}
+
 // static
 bool QueryPlannerIXSelect::compatible(const BSONElement& elt,
                                       const IndexEntry& index,
@@ -330,16 +378,20 @@ void QueryPlannerIXSelect::rateIndices(MatchExpression* node,
 
         // TODO: This is slow, with all the string compares.
         for (size_t i = 0; i < indices.size(); ++i) {
+            // A skip scan seeks across the leading fields we have no predicates over, so for
+            // it the first field is the one following them.
+            size_t pos = 0;
             BSONObjIterator it(indices[i].keyPattern);
-            BSONElement elt = it.next();
-            if (elt.fieldName() == fullPath && compatible(elt, indices[i], node)) {
-                rt->first.push_back(i);
-            }
             while (it.more()) {
-                elt = it.next();
+                BSONElement elt = it.next();
                 if (elt.fieldName() == fullPath && compatible(elt, indices[i], node)) {
-                    rt->notFirst.push_back(i);
+                    if (pos == indices[i].skipScanPrefixLen) {
+                        rt->first.push_back(i);
+                    } else {
+                        rt->notFirst.push_back(i);
+                    }
                 }
+                ++pos;
             }
         }
 
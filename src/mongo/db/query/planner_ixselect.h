@@ -59,6 +59,23 @@ public:
                                     const std::vector<IndexEntry>& indices,
                                     std::vector<IndexEntry>* out);
 
+    /**
+     * Returns the number of leading fields of the btree index 'index' which come before the
+     * first field we have predicates over, or 0 if it is not a btree index or has no field we
+     * have predicates over.
+     */
+    static size_t getSkipScanPrefixLen(const unordered_set<std::string>& fields,
+                                       const IndexEntry& index);
+
+    /**
+     * Adds to 'out' the btree indices which are not prefixed by fields we have predicates
+     * over but which contain such a field, as long as no index already in 'out' is prefixed by
+     * it. Each is given the skipScanPrefixLen computed by getSkipScanPrefixLen().
+     */
+    static void findSkipScanIndices(const unordered_set<std::string>& fields,
+                                    const std::vector<IndexEntry>& allIndices,
+                                    std::vector<IndexEntry>* out);
+
     /**
      * Return true if the index key pattern field 'elt' (which belongs to 'index') can be used
      * to answer the predicate 'node'.
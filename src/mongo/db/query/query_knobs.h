@@ -58,6 +58,12 @@ extern std::atomic<bool> internalQueryPlannerEnableIndexIntersection;  // NOLINT
 // Do we use hash-based intersection for rooted $and queries?
 extern std::atomic<bool> internalQueryPlannerEnableHashIntersection;  // NOLINT
 
+// Do we plan skip scans over compound indices whose leading fields the query leaves
+// unconstrained, and distinct scans over indices not prefixed by the distinct field? Off by
+// default: both only pay off when the skipped fields have few distinct values, and distinct
+// scans do not compete with a collection scan.
+extern std::atomic<bool> internalQueryPlannerEnableSkipScan;  // NOLINT
+
 //
 // plan cache
 //
@@ -105,6 +111,16 @@ extern std::atomic<int> internalQueryExecYieldIterations;  // NOLINT
 // Yield if it's been at least this many milliseconds since we last yielded.
 extern std::atomic<int> internalQueryExecYieldPeriodMS;  // NOLINT
 
+// Up to how many worker threads may a single collection scan use? 1 or less turns parallel
+// collection scans off.
+extern std::atomic<int> internalQueryExecParallelCollScanMaxDOP;  // NOLINT
+
+// How many parallel collection scan workers may run at once, over all queries?
+extern std::atomic<int> internalQueryExecParallelCollScanMaxWorkers;  // NOLINT
+
+// Collections with fewer records than this are always scanned by a single thread.
+extern std::atomic<int> internalQueryExecParallelCollScanMinRecords;  // NOLINT
+
 // Limit the size that we write without yielding to 16MB / 64 (max expected number of indexes)
 const int64_t insertVectorMaxBytes = 256 * 1024;
 
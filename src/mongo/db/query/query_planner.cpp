@@ -39,6 +39,7 @@
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/matcher/expression_text.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/planner_access.h"
 #include "mongo/db/query/planner_analysis.h"
@@ -232,6 +233,24 @@ bool providesSort(const CanonicalQuery& query, const BSONObj& kp) {
     return query.getParsed().getSort().isPrefixOf(kp);
 }
 
+/**
+ * Returns true if some index scan under 'node' seeks across the leading fields of its index.
+ */
+static bool hasSkipScan(const QuerySolutionNode* node) {
+    if (STAGE_IXSCAN == node->getType()) {
+        const IndexScanNode* isn = static_cast<const IndexScanNode*>(node);
+        if (IndexBoundsBuilder::getSkipScanPrefixLen(isn->bounds) > 0) {
+            return true;
+        }
+    }
+    for (size_t i = 0; i < node->children.size(); ++i) {
+        if (hasSkipScan(node->children[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
 // static
 const int QueryPlanner::kPlannerVersion = 1;
 
@@ -528,8 +547,13 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
 
     size_t hintIndexNumber = numeric_limits<size_t>::max();
 
+    const bool canSkipScan = params.options & QueryPlannerParams::SKIP_SCAN;
+
     if (hintIndex.isEmpty()) {
         QueryPlannerIXSelect::findRelevantIndices(fields, params.indices, &relevantIndices);
+        if (canSkipScan) {
+            QueryPlannerIXSelect::findSkipScanIndices(fields, params.indices, &relevantIndices);
+        }
     } else {
         // Sigh.  If the hint is specified it might be using the index name.
         BSONElement firstHintElt = hintIndex.firstElement();
@@ -562,6 +586,13 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
         if (hintIndexNumber == numeric_limits<size_t>::max()) {
             return Status(ErrorCodes::BadValue, "bad hint");
         }
+
+        // A hinted index which is not prefixed by a field we have predicates over would be
+        // scanned in full. Seek across its leading fields instead.
+        if (canSkipScan) {
+            relevantIndices[0].skipScanPrefixLen =
+                QueryPlannerIXSelect::getSkipScanPrefixLen(fields, relevantIndices[0]);
+        }
     }
 
     // Deal with the .min() and .max() query options.  If either exist we can only use an index
@@ -906,8 +937,16 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
     // The caller can explicitly ask for a collscan.
     bool collscanRequested = (params.options & QueryPlannerParams::INCLUDE_COLLSCAN);
 
+    // A skip scan costs a seek per distinct value of the leading fields it skips across, which
+    // we have no estimate of. If those are all the indexed plans we have, let them compete with
+    // a collscan.
+    bool onlySkipScans = !out->empty();
+    for (size_t i = 0; i < out->size() && onlySkipScans; ++i) {
+        onlySkipScans = hasSkipScan((*out)[i]->root.get());
+    }
+
     // No indexed plans?  We must provide a collscan if possible or else we can't run the query.
-    bool collscanNeeded = (0 == out->size() && canTableScan);
+    bool collscanNeeded = ((0 == out->size() || onlySkipScans) && canTableScan);
 
     if (possibleToCollscan && (collscanRequested || collscanNeeded)) {
         QuerySolution* collscan = buildCollscanSoln(query, isTailable, params);
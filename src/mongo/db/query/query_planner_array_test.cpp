@@ -1137,4 +1137,85 @@ TEST_F(QueryPlannerTest, MultikeyElemMatchAllCompound3) {
         "bounds: {'arr.k': [[3,3,true,true]], 'arr.v': [[3,3,true,true]]}}}}}");
 }
 
+
+//
+// Covering with path-level multikey information
+//
+
+TEST_F(QueryPlannerTest, MultikeyIndexWithoutPathsIsNotCovered) {
+    addIndex(BSON("a" << 1 << "b" << 1), true);
+    runQuerySortProj(fromjson("{a: 1}"), BSONObj(), fromjson("{_id: 0, a: 1}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{proj: {spec: {_id: 0, a: 1}, node: {cscan: {dir: 1}}}}");
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1}, type: 'simple', node: "
+        "{fetch: {filter: null, node: {ixscan: {pattern: {a: 1, b: 1}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, MultikeyPathsCoverNonArrayField) {
+    MultikeyPaths multikeyPaths{std::set<size_t>{}, {0U}};
+    addIndex(BSON("a" << 1 << "b" << 1), multikeyPaths);
+    runQuerySortProj(fromjson("{a: 1, b: 2}"), BSONObj(), fromjson("{_id: 0, a: 1}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{proj: {spec: {_id: 0, a: 1}, node: {cscan: {dir: 1}}}}");
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1}, type: 'coveredIndex', node: "
+        "{ixscan: {filter: null, pattern: {a: 1, b: 1}, "
+        "bounds: {a: [[1, 1, true, true]], b: [[2, 2, true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, MultikeyPathsDoNotCoverArrayField) {
+    MultikeyPaths multikeyPaths{std::set<size_t>{}, {0U}};
+    addIndex(BSON("a" << 1 << "b" << 1), multikeyPaths);
+    runQuerySortProj(fromjson("{a: 1}"), BSONObj(), fromjson("{_id: 0, a: 1, b: 1}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{proj: {spec: {_id: 0, a: 1, b: 1}, node: {cscan: {dir: 1}}}}");
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1, b: 1}, type: 'simple', node: "
+        "{fetch: {filter: null, node: {ixscan: {pattern: {a: 1, b: 1}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, MultikeyPathsCoverFieldAfterArrayField) {
+    MultikeyPaths multikeyPaths{{0U}, std::set<size_t>{}};
+    addIndex(BSON("tags" << 1 << "date" << 1), multikeyPaths);
+    runQuerySortProj(fromjson("{tags: 'x'}"), BSONObj(), fromjson("{_id: 0, date: 1}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{proj: {spec: {_id: 0, date: 1}, node: {cscan: {dir: 1}}}}");
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, date: 1}, type: 'coveredIndex', node: "
+        "{ixscan: {filter: null, pattern: {tags: 1, date: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, MultikeyPathsDoNotCoverDottedField) {
+    MultikeyPaths multikeyPaths{{0U}, std::set<size_t>{}};
+    addIndex(BSON("tags" << 1 << "d.e" << 1), multikeyPaths);
+    runQuerySortProj(fromjson("{tags: 'x'}"), BSONObj(), fromjson("{_id: 0, 'd.e': 1}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{proj: {spec: {_id: 0, 'd.e': 1}, node: {cscan: {dir: 1}}}}");
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, 'd.e': 1}, node: "
+        "{fetch: {filter: null, node: {ixscan: {pattern: {tags: 1, 'd.e': 1}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, MultikeyPathsCoverPartialIndex) {
+    params.options = QueryPlannerParams::NO_TABLE_SCAN;
+    BSONObj filterObj(fromjson("{date: {$gt: 0}}"));
+    std::unique_ptr<MatchExpression> filterExpr = parseMatchExpression(filterObj);
+    MultikeyPaths multikeyPaths{{0U}, std::set<size_t>{}};
+    addIndex(BSON("tags" << 1 << "date" << 1), multikeyPaths, filterExpr.get());
+
+    runQuerySortProj(
+        fromjson("{tags: 'x', date: {$gt: 5}}"), BSONObj(), fromjson("{_id: 0, date: 1}"));
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, date: 1}, type: 'coveredIndex', node: "
+        "{ixscan: {filter: null, pattern: {tags: 1, date: 1}, "
+        "bounds: {tags: [['x', 'x', true, true]], date: [[5, Infinity, false, true]]}}}}}");
+}
+
 }  // namespace
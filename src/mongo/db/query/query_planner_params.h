@@ -95,6 +95,16 @@ struct QueryPlannerParams {
         // Set this if you don't want any plans with a non-covered projection stage. All projections
         // must be provided/covered by an index.
         NO_UNCOVERED_PROJECTIONS = 1 << 10,
+
+        // Set this to let a forward collection scan be split across worker threads. The results
+        // then carry no RecordIds and do not all come from the snapshot of the operation, so only
+        // read-only callers which need neither may set it.
+        PARALLEL_COLLSCAN = 1 << 11,
+
+        // Set this to let the planner use a compound index for predicates which do not cover
+        // its leading fields, when no index is prefixed by them. The scan seeks across the
+        // distinct values of the unconstrained leading fields.
+        SKIP_SCAN = 1 << 12,
     };
 
     // See Options enum above.
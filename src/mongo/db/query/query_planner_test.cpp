@@ -2257,6 +2257,32 @@ TEST_F(QueryPlannerTest, HintOverridesNaturalSort) {
         "{ixscan: {filter: null, pattern: {x: 1}}}}}");
 }
 
+// Forward collection scans may be split across worker threads when the caller allows it, and a
+// $natural sort asks for the ranges to be returned in order.
+TEST_F(QueryPlannerTest, ParallelCollScan) {
+    auto collScan = [this]() {
+        ASSERT_EQUALS(1U, solns.size());
+        ASSERT_EQUALS(STAGE_COLLSCAN, solns[0]->root->getType());
+        return static_cast<const CollectionScanNode*>(solns[0]->root.get());
+    };
+
+    runQuery(fromjson("{a: 1}"));
+    ASSERT_FALSE(collScan()->parallel);
+
+    params.options = QueryPlannerParams::PARALLEL_COLLSCAN;
+    runQuery(fromjson("{a: 1}"));
+    ASSERT_TRUE(collScan()->parallel);
+    ASSERT_FALSE(collScan()->parallelOrdered);
+
+    runQuerySortHint(fromjson("{a: 1}"), BSON("$natural" << 1), BSONObj());
+    ASSERT_TRUE(collScan()->parallel);
+    ASSERT_TRUE(collScan()->parallelOrdered);
+
+    // Backward scans stay in a single thread.
+    runQuerySortHint(fromjson("{a: 1}"), BSON("$natural" << -1), BSONObj());
+    ASSERT_FALSE(collScan()->parallel);
+}
+
 TEST_F(QueryPlannerTest, HintValid) {
     addIndex(BSON("a" << 1));
     runQueryHint(BSONObj(), fromjson("{a: 1}"));
@@ -4176,4 +4202,134 @@ TEST_F(QueryPlannerTest, NToReturnHackWithSingleBatch) {
         "{cscan: {dir:1, filter: {}}}}}}}");
 }
 
+//
+// Skip scans
+//
+
+TEST_F(QueryPlannerTest, SkipScanOverUnconstrainedLeadingField) {
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    runQuery(fromjson("{b: 5}"));
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+
+    params.options |= QueryPlannerParams::SKIP_SCAN;
+    runQuery(fromjson("{b: 5}"));
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: null, pattern: {a: 1, b: 1}, "
+        "bounds: {a: [['MinKey','MaxKey',true,true]], b: [[5,5,true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanCompetesWithCollscan) {
+    params.options = QueryPlannerParams::SKIP_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    addIndex(BSON("c" << 1));
+
+    // The collscan is a candidate when all the indexed plans are skip scans...
+    runQuery(fromjson("{b: 5}"));
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: null, pattern: {a: 1, b: 1}, "
+        "bounds: {a: [['MinKey','MaxKey',true,true]], b: [[5,5,true,true]]}}}}}");
+
+    // ...but not when some other index can be used.
+    runQuery(fromjson("{b: 5, c: 6}"));
+    assertNumSolutions(2U);
+    assertSolutionExists(
+        "{fetch: {filter: {c: 6}, node: {ixscan: {filter: null, pattern: {a: 1, b: 1}}}}}");
+    assertSolutionExists(
+        "{fetch: {filter: {b: 5}, node: {ixscan: {filter: null, pattern: {c: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanCompoundsTrailingFields) {
+    params.options |= QueryPlannerParams::SKIP_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1 << "c" << 1 << "d" << 1));
+
+    runQuery(fromjson("{b: {$gt: 1}, d: 3}"));
+    assertNumSolutions(2U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: null, "
+        "pattern: {a: 1, b: 1, c: 1, d: 1}, bounds: {a: [['MinKey','MaxKey',true,true]], "
+        "b: [[1,Infinity,false,true]], c: [['MinKey','MaxKey',true,true]], "
+        "d: [[3,3,true,true]]}}}}}");
+
+    // Both unconstrained leading fields are skipped across.
+    runQuery(fromjson("{c: {$in: [1, 2]}}"));
+    assertNumSolutions(2U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: null, "
+        "pattern: {a: 1, b: 1, c: 1, d: 1}, bounds: {a: [['MinKey','MaxKey',true,true]], "
+        "b: [['MinKey','MaxKey',true,true]], c: [[1,1,true,true],[2,2,true,true]], "
+        "d: [['MinKey','MaxKey',true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanCoveredAndSorted) {
+    params.options |= QueryPlannerParams::SKIP_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    runQuerySortProj(fromjson("{b: {$lt: 4}}"), BSON("a" << 1), fromjson("{_id: 0, a: 1, b: 1}"));
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1, b: 1}, node: {ixscan: {filter: null, "
+        "pattern: {a: 1, b: 1}, bounds: {a: [['MinKey','MaxKey',true,true]], "
+        "b: [[-Infinity,4,true,false]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedWhenAnIndexIsPrefixedByTheField) {
+    params.options |= QueryPlannerParams::SKIP_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    addIndex(BSON("b" << 1));
+
+    runQuery(fromjson("{b: 5}"));
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: null, pattern: {b: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedForSpecialIndexes) {
+    params.options |= QueryPlannerParams::SKIP_SCAN;
+    addIndex(BSON("a"
+                  << "2dsphere"
+                  << "b" << 1));
+
+    runQuery(fromjson("{b: 5}"));
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanBelowOr) {
+    params.options = QueryPlannerParams::NO_TABLE_SCAN | QueryPlannerParams::SKIP_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    addIndex(BSON("c" << 1));
+
+    runQuery(fromjson("{$or: [{b: 1}, {c: 2}]}"));
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {or: {nodes: ["
+        "{ixscan: {filter: null, pattern: {a: 1, b: 1}, "
+        "bounds: {a: [['MinKey','MaxKey',true,true]], b: [[1,1,true,true]]}}},"
+        "{ixscan: {filter: null, pattern: {c: 1}}}]}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanHintedIndex) {
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    // Without skip scans the hinted index is scanned in full.
+    runQueryHint(fromjson("{b: 5}"), BSON("a" << 1 << "b" << 1));
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: {b: 5}, node: {ixscan: {filter: null, pattern: {a: 1, b: 1}, "
+        "bounds: {a: [['MinKey','MaxKey',true,true]], b: [['MinKey','MaxKey',true,true]]}}}}}");
+
+    params.options |= QueryPlannerParams::SKIP_SCAN;
+    runQueryHint(fromjson("{b: 5}"), BSON("a" << 1 << "b" << 1));
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: null, pattern: {a: 1, b: 1}, "
+        "bounds: {a: [['MinKey','MaxKey',true,true]], b: [[5,5,true,true]]}}}}}");
+}
+
 }  // namespace
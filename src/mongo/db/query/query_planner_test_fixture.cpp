@@ -102,6 +102,20 @@ void QueryPlannerTest::addIndex(BSONObj keyPattern, MatchExpression* filterExpr)
                                         BSONObj()));
 }
 
+void QueryPlannerTest::addIndex(BSONObj keyPattern,
+                                const MultikeyPaths& multikeyPaths,
+                                MatchExpression* filterExpr) {
+    IndexEntry entry(keyPattern,
+                     true,   // multikey
+                     false,  // sparse
+                     false,  // unique
+                     "tags_are_arrays_but_dates_are_not",
+                     filterExpr,
+                     BSONObj());
+    entry.multikeyPaths = multikeyPaths;
+    params.indices.push_back(entry);
+}
+
 void QueryPlannerTest::runQuery(BSONObj query) {
     runQuerySortProjSkipLimit(query, BSONObj(), BSONObj(), 0, 0);
 }
@@ -59,6 +59,11 @@ protected:
 
     void addIndex(BSONObj keyPattern, MatchExpression* filterExpr);
 
+    // Adds a multikey index which knows which components of each of its fields are arrays.
+    void addIndex(BSONObj keyPattern,
+                  const MultikeyPaths& multikeyPaths,
+                  MatchExpression* filterExpr = NULL);
+
     //
     // Execute planner.
     //
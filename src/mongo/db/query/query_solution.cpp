@@ -105,7 +105,8 @@ QuerySolutionNode* TextNode::clone() const {
 // CollectionScanNode
 //
 
-CollectionScanNode::CollectionScanNode() : tailable(false), direction(1), maxScan(0) {}
+CollectionScanNode::CollectionScanNode()
+    : tailable(false), direction(1), maxScan(0), parallel(false), parallelOrdered(false) {}
 
 void CollectionScanNode::appendToString(mongoutils::str::stream* ss, int indent) const {
     addIndent(ss, indent);
@@ -116,6 +117,10 @@ void CollectionScanNode::appendToString(mongoutils::str::stream* ss, int indent)
         addIndent(ss, indent + 1);
         *ss << "filter = " << filter->toString();
     }
+    if (parallel) {
+        addIndent(ss, indent + 1);
+        *ss << "parallel = " << (parallelOrdered ? "ordered" : "unordered") << '\n';
+    }
     addCommon(ss, indent);
 }
 
@@ -128,6 +133,8 @@ QuerySolutionNode* CollectionScanNode::clone() const {
     copy->tailable = this->tailable;
     copy->direction = this->direction;
     copy->maxScan = this->maxScan;
+    copy->parallel = this->parallel;
+    copy->parallelOrdered = this->parallelOrdered;
 
     return copy;
 }
@@ -412,23 +419,26 @@ void IndexScanNode::appendToString(mongoutils::str::stream* ss, int indent) cons
 }
 
 bool IndexScanNode::hasField(const string& field) const {
-    // There is no covering in a multikey index because you don't know whether or not the field
-    // in the key was extracted from an array in the original document.
-    if (indexIsMultiKey) {
-        return false;
-    }
-
     // Custom index access methods may return non-exact key data - this function is currently
     // used for covering exact key data only.
     if (IndexNames::BTREE != IndexNames::findPluginName(indexKeyPattern)) {
         return false;
     }
 
+    // In a multikey index a field can only be covered if the index knows that none of its path
+    // components were arrays in any document. Otherwise you don't know whether or not the field in
+    // the key was extracted from an array in the original document.
+    if (indexIsMultiKey && multikeyPaths.empty()) {
+        return false;
+    }
+
+    size_t keyPatternIndex = 0;
     BSONObjIterator it(indexKeyPattern);
     while (it.more()) {
         if (field == it.next().fieldName()) {
-            return true;
+            return !indexIsMultiKey || multikeyPaths[keyPatternIndex].empty();
         }
+        ++keyPatternIndex;
     }
     return false;
 }
@@ -580,6 +590,7 @@ QuerySolutionNode* IndexScanNode::clone() const {
     copy->_sorts = this->_sorts;
     copy->indexKeyPattern = this->indexKeyPattern;
     copy->indexIsMultiKey = this->indexIsMultiKey;
+    copy->multikeyPaths = this->multikeyPaths;
     copy->direction = this->direction;
     copy->maxScan = this->maxScan;
     copy->addKeyMetadata = this->addKeyMetadata;
@@ -605,8 +616,9 @@ bool filtersAreEquivalent(const MatchExpression* lhs, const MatchExpression* rhs
 bool IndexScanNode::operator==(const IndexScanNode& other) const {
     return filtersAreEquivalent(filter.get(), other.filter.get()) &&
         indexKeyPattern == other.indexKeyPattern && indexIsMultiKey == other.indexIsMultiKey &&
-        direction == other.direction && maxScan == other.maxScan &&
-        addKeyMetadata == other.addKeyMetadata && bounds == other.bounds;
+        multikeyPaths == other.multikeyPaths && direction == other.direction &&
+        maxScan == other.maxScan && addKeyMetadata == other.addKeyMetadata &&
+        bounds == other.bounds;
 }
 
 //
@@ -696,6 +708,7 @@ QuerySolutionNode* SortNode::clone() const {
     copy->_sorts = this->_sorts;
     copy->pattern = this->pattern;
     copy->limit = this->limit;
+    copy->allowDiskUse = this->allowDiskUse;
 
     return copy;
 }
@@ -33,6 +33,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/fts/fts_query.h"
+#include "mongo/db/index/multikey_paths.h"
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/stage_types.h"
@@ -290,6 +291,12 @@ struct CollectionScanNode : public QuerySolutionNode {
 
     // maxScan option to .find() limits how many docs we look at.
     int maxScan;
+
+    // May the scan be split across worker threads? See QueryPlannerParams::PARALLEL_COLLSCAN.
+    bool parallel;
+
+    // Must a parallel scan return its results in RecordId order, for a {$natural: 1} sort?
+    bool parallelOrdered;
 };
 
 struct AndHashNode : public QuerySolutionNode {
@@ -462,6 +469,10 @@ struct IndexScanNode : public QuerySolutionNode {
     BSONObj indexKeyPattern;
     bool indexIsMultiKey;
 
+    // Which components of each key pattern field are arrays. Empty if the index does not track
+    // path-level multikey information.
+    MultikeyPaths multikeyPaths;
+
     int direction;
 
     // maxScan option to .find() limits how many docs we look at.
@@ -592,7 +603,7 @@ struct SortKeyGeneratorNode : public QuerySolutionNode {
 };
 
 struct SortNode : public QuerySolutionNode {
-    SortNode() : limit(0) {}
+    SortNode() : limit(0), allowDiskUse(false) {}
     virtual ~SortNode() {}
 
     virtual StageType getType() const {
@@ -631,6 +642,9 @@ struct SortNode : public QuerySolutionNode {
 
     // Sum of both limit and skip count in the parsed query.
     size_t limit;
+
+    // May the sort spill to disk once it exceeds its memory limit?
+    bool allowDiskUse;
 };
 
 struct LimitNode : public QuerySolutionNode {
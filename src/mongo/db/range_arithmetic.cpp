@@ -32,8 +32,6 @@
 
 namespace mongo {
 
-using std::make_pair;
-using std::pair;
 using std::string;
 using std::stringstream;
 
@@ -61,64 +59,6 @@ int compareRanges(const BSONObj& rangeMin1,
     return rangeMax1.woCompare(rangeMax2);
 }
 
-// Represents the start and end of an overlap of a tested range
-typedef pair<RangeMap::const_iterator, RangeMap::const_iterator> OverlapBounds;
-
-// Internal-only, shared functionality
-OverlapBounds rangeMapOverlapBounds(const RangeMap& ranges,
-                                    const BSONObj& inclusiveLower,
-                                    const BSONObj& exclusiveUpper) {
-    // Returns the first chunk with a min key that is >= lower bound - the previous chunk
-    // might overlap.
-    RangeMap::const_iterator low = ranges.lower_bound(inclusiveLower);
-
-    // See if the previous chunk overlaps our range, not clear from just min key
-    if (low != ranges.begin()) {
-        RangeMap::const_iterator next = low;
-        --low;
-
-        // If the previous range's max value is lte our min value
-        if (low->second.woCompare(inclusiveLower) < 1) {
-            low = next;
-        }
-    }
-
-    // Returns the first chunk with a max key that is >= upper bound - implies the
-    // chunk does not overlap upper bound
-    RangeMap::const_iterator high = ranges.lower_bound(exclusiveUpper);
-
-    return OverlapBounds(low, high);
-}
-
-void getRangeMapOverlap(const RangeMap& ranges,
-                        const BSONObj& inclusiveLower,
-                        const BSONObj& exclusiveUpper,
-                        RangeVector* overlap) {
-    overlap->clear();
-    OverlapBounds bounds = rangeMapOverlapBounds(ranges, inclusiveLower, exclusiveUpper);
-    for (RangeMap::const_iterator it = bounds.first; it != bounds.second; ++it) {
-        overlap->push_back(make_pair(it->first, it->second));
-    }
-}
-
-bool rangeMapOverlaps(const RangeMap& ranges,
-                      const BSONObj& inclusiveLower,
-                      const BSONObj& exclusiveUpper) {
-    OverlapBounds bounds = rangeMapOverlapBounds(ranges, inclusiveLower, exclusiveUpper);
-    return bounds.first != bounds.second;
-}
-
-bool rangeMapContains(const RangeMap& ranges,
-                      const BSONObj& inclusiveLower,
-                      const BSONObj& exclusiveUpper) {
-    OverlapBounds bounds = rangeMapOverlapBounds(ranges, inclusiveLower, exclusiveUpper);
-    if (bounds.first == ranges.end())
-        return false;
-
-    return bounds.first->first.woCompare(inclusiveLower) == 0 &&
-        bounds.first->second.woCompare(exclusiveUpper) == 0;
-}
-
 string rangeToString(const BSONObj& inclusiveLower, const BSONObj& exclusiveUpper) {
     stringstream ss;
     ss << "[" << inclusiveLower.toString() << ", " << exclusiveUpper.toString() << ")";
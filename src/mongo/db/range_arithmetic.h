@@ -118,8 +118,12 @@ typedef std::vector<std::pair<BSONObj, BSONObj>> RangeVector;
 /**
  * Returns the overlap of a range [inclusiveLower, exclusiveUpper) with the provided range map
  * as a vector of ranges from the map.
+ *
+ * The range map may be a RangeMap or any other map of ranges sorted by their lower bound which
+ * offers the same lower_bound() and bidirectional const_iterator interface.
  */
-void getRangeMapOverlap(const RangeMap& ranges,
+template <typename RangeMapType>
+void getRangeMapOverlap(const RangeMapType& ranges,
                         const BSONObj& inclusiveLower,
                         const BSONObj& exclusiveUpper,
                         RangeVector* vector);
@@ -128,7 +132,8 @@ void getRangeMapOverlap(const RangeMap& ranges,
  * Returns true if the provided range map has ranges which overlap the provided range
  * [inclusiveLower, exclusiveUpper).
  */
-bool rangeMapOverlaps(const RangeMap& ranges,
+template <typename RangeMapType>
+bool rangeMapOverlaps(const RangeMapType& ranges,
                       const BSONObj& inclusiveLower,
                       const BSONObj& exclusiveUpper);
 
@@ -136,7 +141,8 @@ bool rangeMapOverlaps(const RangeMap& ranges,
  * Returns true if the provided range map exactly contains the provided range
  * [inclusiveLower, exclusiveUpper).
  */
-bool rangeMapContains(const RangeMap& ranges,
+template <typename RangeMapType>
+bool rangeMapContains(const RangeMapType& ranges,
                       const BSONObj& inclusiveLower,
                       const BSONObj& exclusiveUpper);
 
@@ -149,4 +155,72 @@ std::string rangeToString(const BSONObj& inclusiveLower, const BSONObj& exclusiv
  * std::string representation of overlapping ranges as a list "[range1),[range2),..."
  */
 std::string overlapToString(RangeVector overlap);
+
+namespace range_arithmetic_detail {
+
+// Internal-only, shared functionality. Returns the start and end of the overlap of the tested
+// range with the range map.
+template <typename RangeMapType>
+std::pair<typename RangeMapType::const_iterator, typename RangeMapType::const_iterator>
+rangeMapOverlapBounds(const RangeMapType& ranges,
+                      const BSONObj& inclusiveLower,
+                      const BSONObj& exclusiveUpper) {
+    // Returns the first chunk with a min key that is >= lower bound - the previous chunk
+    // might overlap.
+    typename RangeMapType::const_iterator low = ranges.lower_bound(inclusiveLower);
+
+    // See if the previous chunk overlaps our range, not clear from just min key
+    if (low != ranges.begin()) {
+        typename RangeMapType::const_iterator next = low;
+        --low;
+
+        // If the previous range's max value is lte our min value
+        if (low->second.woCompare(inclusiveLower) < 1) {
+            low = next;
+        }
+    }
+
+    // Returns the first chunk with a max key that is >= upper bound - implies the
+    // chunk does not overlap upper bound
+    typename RangeMapType::const_iterator high = ranges.lower_bound(exclusiveUpper);
+
+    return std::make_pair(low, high);
+}
+
+}  // namespace range_arithmetic_detail
+
+template <typename RangeMapType>
+void getRangeMapOverlap(const RangeMapType& ranges,
+                        const BSONObj& inclusiveLower,
+                        const BSONObj& exclusiveUpper,
+                        RangeVector* overlap) {
+    overlap->clear();
+    auto bounds =
+        range_arithmetic_detail::rangeMapOverlapBounds(ranges, inclusiveLower, exclusiveUpper);
+    for (auto it = bounds.first; it != bounds.second; ++it) {
+        overlap->push_back(std::make_pair(it->first, it->second));
+    }
+}
+
+template <typename RangeMapType>
+bool rangeMapOverlaps(const RangeMapType& ranges,
+                      const BSONObj& inclusiveLower,
+                      const BSONObj& exclusiveUpper) {
+    auto bounds =
+        range_arithmetic_detail::rangeMapOverlapBounds(ranges, inclusiveLower, exclusiveUpper);
+    return bounds.first != bounds.second;
+}
+
+template <typename RangeMapType>
+bool rangeMapContains(const RangeMapType& ranges,
+                      const BSONObj& inclusiveLower,
+                      const BSONObj& exclusiveUpper) {
+    auto bounds =
+        range_arithmetic_detail::rangeMapOverlapBounds(ranges, inclusiveLower, exclusiveUpper);
+    if (bounds.first == ranges.end())
+        return false;
+
+    return bounds.first->first.woCompare(inclusiveLower) == 0 &&
+        bounds.first->second.woCompare(exclusiveUpper) == 0;
+}
 }
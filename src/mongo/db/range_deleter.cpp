@@ -32,6 +32,7 @@
 
 #include "mongo/db/range_deleter.h"
 
+#include <algorithm>
 #include <boost/date_time/posix_time/posix_time_duration.hpp>
 #include <memory>
 
@@ -179,9 +180,9 @@ RangeDeleter::~RangeDeleter() {
     }
 }
 
-void RangeDeleter::startWorkers() {
-    if (!_worker) {
-        _worker.reset(new stdx::thread(stdx::bind(&RangeDeleter::doWork, this)));
+void RangeDeleter::startWorkers(size_t numWorkers) {
+    while (_workers.size() < numWorkers) {
+        _workers.emplace_back(stdx::bind(&RangeDeleter::doWork, this));
     }
 }
 
@@ -191,8 +192,8 @@ void RangeDeleter::stopWorkers() {
         _stopRequested = true;
     }
 
-    if (_worker) {
-        _worker->join();
+    for (auto& worker : _workers) {
+        worker.join();
     }
 
     stdx::unique_lock<stdx::mutex> sl(_queueMutex);
@@ -353,9 +354,15 @@ bool RangeDeleter::deleteNow(OperationContext* txn,
     taskDetails.stats.queueEndTS = jsTime();
 
     taskDetails.stats.deleteStartTS = jsTime();
+    {
+        stdx::lock_guard<stdx::mutex> sl(_queueMutex);
+        _inProgressTasks.insert(&taskDetails);
+    }
+
     bool result = _env->deleteRange(txn, taskDetails, &taskDetails.stats.deletedDocCount, errMsg);
 
     taskDetails.stats.deleteEndTS = jsTime();
+    taskDetails.stats.deletedBytes = taskDetails.progress.deletedBytes.load();
 
     if (result) {
         taskDetails.stats.waitForReplStartTS = jsTime();
@@ -366,12 +373,16 @@ bool RangeDeleter::deleteNow(OperationContext* txn,
     {
         stdx::lock_guard<stdx::mutex> sl(_queueMutex);
         _deleteSet.erase(&deleteRange);
+        _inProgressTasks.erase(&taskDetails);
 
         _deletesInProgress--;
 
         if (_deletesInProgress == 0) {
             _nothingInProgressCV.notify_one();
         }
+
+        // The workers may be skipping tasks on the namespace that was deleted from.
+        _taskQueueNotEmptyCV.notify_all();
     }
 
     recordDelStats(new DeleteJobStats(taskDetails.stats));
@@ -390,6 +401,23 @@ void RangeDeleter::getStatsHistory(std::vector<DeleteJobStats*>* stats) const {
     }
 }
 
+void RangeDeleter::getInProgressDeletes(std::vector<BSONObj>* deletes) const {
+    deletes->clear();
+
+    stdx::lock_guard<stdx::mutex> sl(_queueMutex);
+    deletes->reserve(_inProgressTasks.size());
+    for (const RangeDeleteEntry* entry : _inProgressTasks) {
+        BSONObjBuilder builder;
+        builder.append("ns", entry->options.range.ns);
+        builder.append("min", entry->options.range.minKey);
+        builder.append("max", entry->options.range.maxKey);
+        builder.append("deleteStart", entry->stats.deleteStartTS);
+        builder.append("deletedDocs", entry->progress.deletedDocs.load());
+        builder.append("deletedBytes", entry->progress.deletedBytes.load());
+        deletes->push_back(builder.obj());
+    }
+}
+
 BSONObj RangeDeleter::toBSON() const {
     stdx::lock_guard<stdx::mutex> sl(_queueMutex);
 
@@ -422,7 +450,8 @@ void RangeDeleter::doWork() {
 
         {
             stdx::unique_lock<stdx::mutex> sl(_queueMutex);
-            while (_taskQueue.empty()) {
+            TaskList::iterator readyTask;
+            while ((readyTask = findReadyTask_inlock()) == _taskQueue.end()) {
                 _taskQueueNotEmptyCV.wait_for(sl,
                                               stdx::chrono::milliseconds(kNotEmptyTimeoutMillis));
 
@@ -431,7 +460,7 @@ void RangeDeleter::doWork() {
                     return;
                 }
 
-                if (_taskQueue.empty()) {
+                if (findReadyTask_inlock() == _taskQueue.end()) {
                     // Try to check if some deletes are ready and move them to the
                     // ready queue.
 
@@ -472,18 +501,20 @@ void RangeDeleter::doWork() {
                 return;
             }
 
-            nextTask = _taskQueue.front();
-            _taskQueue.pop_front();
+            nextTask = *readyTask;
+            _taskQueue.erase(readyTask);
 
+            nextTask->stats.deleteStartTS = jsTime();
+            _inProgressTasks.insert(nextTask);
             _deletesInProgress++;
         }
 
         {
             auto txn = client->makeOperationContext();
-            nextTask->stats.deleteStartTS = jsTime();
             bool delResult =
                 _env->deleteRange(txn.get(), *nextTask, &nextTask->stats.deletedDocCount, &errMsg);
             nextTask->stats.deleteEndTS = jsTime();
+            nextTask->stats.deletedBytes = nextTask->progress.deletedBytes.load();
 
             if (delResult) {
                 nextTask->stats.waitForReplStartTS = jsTime();
@@ -505,11 +536,15 @@ void RangeDeleter::doWork() {
                               nextTask->options.range.minKey,
                               nextTask->options.range.maxKey);
             deletePtrElement(&_deleteSet, &setEntry);
+            _inProgressTasks.erase(nextTask);
             _deletesInProgress--;
 
             if (nextTask->notifyDone) {
                 nextTask->notifyDone->notifyOne();
             }
+
+            // The other workers may be skipping tasks on the namespace that was deleted from.
+            _taskQueueNotEmptyCV.notify_all();
         }
 
         recordDelStats(new DeleteJobStats(nextTask->stats));
@@ -532,6 +567,21 @@ bool RangeDeleter::canEnqueue_inlock(StringData ns,
     return true;
 }
 
+RangeDeleter::TaskList::iterator RangeDeleter::findReadyTask_inlock() {
+    for (TaskList::iterator it = _taskQueue.begin(); it != _taskQueue.end(); ++it) {
+        const string& ns = (*it)->options.range.ns;
+        const bool nsInProgress = std::any_of(
+            _inProgressTasks.begin(), _inProgressTasks.end(), [&ns](const RangeDeleteEntry* entry) {
+                return entry->options.range.ns == ns;
+            });
+        if (!nsInProgress) {
+            return it;
+        }
+    }
+
+    return _taskQueue.end();
+}
+
 bool RangeDeleter::stopRequested() const {
     stdx::lock_guard<stdx::mutex> sl(_stopMutex);
     return _stopRequested;
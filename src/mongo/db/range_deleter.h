@@ -39,6 +39,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/range_arithmetic.h"
 #include "mongo/db/write_concern_options.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/concurrency/mutex.h"
@@ -61,9 +62,11 @@ struct RangeDeleterOptions;
  *
  * Threading assumptions:
  *
- *   This class has (currently) one worker thread attacking the queue, one
- *   job at a time. If we want an immediate deletion, that job is going to
- *   be performed on the thread that is requesting it.
+ *   This class has one or more worker threads attacking the queue, each
+ *   one job at a time. No two workers delete from the same namespace at
+ *   the same time, so a worker skips the queued jobs of a namespace that
+ *   is already being worked on. If we want an immediate deletion, that
+ *   job is going to be performed on the thread that is requesting it.
  *
  *   All calls regarding deletion are synchronized.
  *
@@ -96,15 +99,15 @@ public:
     //
 
     /**
-     * Starts the background thread to work on this queue. Does nothing if the worker
-     * thread is already active.
+     * Starts 'numWorkers' background threads to work on this queue. Does nothing if that
+     * many worker threads are already active.
      *
      * This call is _not_ thread safe and must be issued before any other call.
      */
-    void startWorkers();
+    void startWorkers(size_t numWorkers = 1);
 
     /**
-     * Stops the background thread working on this queue. This will block if there are
+     * Stops the background threads working on this queue. This will block if there are
      * tasks that are being deleted, but will leave the pending tasks in the queue.
      *
      * Steps:
@@ -161,6 +164,12 @@ public:
     size_t getPendingDeletes() const;
     size_t getDeletesInProgress() const;
 
+    /**
+     * Fills 'deletes' with the namespace, range, start time and number of documents and bytes
+     * deleted so far of every delete which is in progress, including the immediate ones.
+     */
+    void getInProgressDeletes(std::vector<BSONObj>* deletes) const;
+
     //
     // Methods meant to be only used for testing. Should be treated like private
     // methods.
@@ -193,13 +202,19 @@ private:
                            const BSONObj& max,
                            std::string* errMsg) const;
 
+    /**
+     * Returns the first task of _taskQueue whose namespace is not being deleted from, or
+     * _taskQueue.end() if there is none.
+     */
+    TaskList::iterator findReadyTask_inlock();
+
     /** Returns true if stopWorkers() was called. This call is synchronized. */
     bool stopRequested() const;
 
     std::unique_ptr<RangeDeleterEnv> _env;
 
-    // Initially not active. Must be started explicitly.
-    std::unique_ptr<stdx::thread> _worker;
+    // Initially empty. Must be started explicitly.
+    std::vector<stdx::thread> _workers;
 
     // Protects _stopRequested.
     mutable stdx::mutex _stopMutex;
@@ -238,6 +253,9 @@ private:
     // Keeps track of number of tasks that are in progress, including the inline deletes.
     size_t _deletesInProgress;
 
+    // The tasks which are being deleted from, including the inline deletes. Not owned here.
+    std::set<const RangeDeleteEntry*> _inProgressTasks;
+
     // Protects _statsHistory
     mutable stdx::mutex _statsHistoryMutex;
     std::deque<DeleteJobStats*> _statsHistory;
@@ -256,8 +274,17 @@ struct DeleteJobStats {
     Date_t waitForReplEndTS;
 
     long long int deletedDocCount;
+    long long int deletedBytes;
+
+    DeleteJobStats() : deletedDocCount(0), deletedBytes(0) {}
+};
 
-    DeleteJobStats() : deletedDocCount(0) {}
+/**
+ * Progress of a delete which is running, updated by the environment as it deletes documents.
+ */
+struct RangeDeleteProgress {
+    AtomicInt64 deletedDocs;
+    AtomicInt64 deletedBytes;
 };
 
 struct RangeDeleterOptions {
@@ -293,6 +320,9 @@ struct RangeDeleteEntry {
 
     DeleteJobStats stats;
 
+    // Can be updated through a const reference by the environment, while deleteRange runs.
+    mutable RangeDeleteProgress progress;
+
     // For debugging only
     BSONObj toBSON() const;
 };
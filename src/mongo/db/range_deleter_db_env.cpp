@@ -41,14 +41,69 @@
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/operation_shard_version.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/s/d_state.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
 using std::string;
 
+namespace {
+
+/**
+ * Number of documents deleted from a range under one acquisition of the write lock.
+ */
+std::atomic<int> rangeDeleterBatchSize(128);  // NOLINT
+
+class RangeDeleterBatchSizeParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
+public:
+    RangeDeleterBatchSizeParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(), "rangeDeleterBatchSize", &rangeDeleterBatchSize) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 1 || potentialNewValue > 10000) {
+            return Status(ErrorCodes::BadValue,
+                          "rangeDeleterBatchSize has to be >= 1 and <= 10000");
+        }
+        return Status::OK();
+    }
+} rangeDeleterBatchSizeParameter;
+
+/**
+ * Ceilings on the rate at which a range deleter worker deletes documents and bytes, 0 means
+ * unlimited. Each range is throttled on its own, so the rate of a node is up to the number of
+ * worker threads times these.
+ */
+std::atomic<long long> rangeDeleterMaxDocsPerSec(0);   // NOLINT
+std::atomic<long long> rangeDeleterMaxBytesPerSec(0);  // NOLINT
+
+class RangeDeleterRateParameter
+    : public ExportedServerParameter<long long, ServerParameterType::kStartupAndRuntime> {
+public:
+    RangeDeleterRateParameter(const std::string& name, std::atomic<long long>* value)
+        : ExportedServerParameter<long long, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(), name, value) {}
+
+    virtual Status validate(const long long& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue, str::stream() << name() << " has to be >= 0");
+        }
+        return Status::OK();
+    }
+};
+
+RangeDeleterRateParameter rangeDeleterMaxDocsPerSecParameter("rangeDeleterMaxDocsPerSec",
+                                                             &rangeDeleterMaxDocsPerSec);
+RangeDeleterRateParameter rangeDeleterMaxBytesPerSecParameter("rangeDeleterMaxBytesPerSec",
+                                                              &rangeDeleterMaxBytesPerSec);
+
+}  // namespace
+
 /**
  * Outline of the delete process:
  * 1. Initialize the client for this thread if there is no client. This is for the worker
@@ -56,7 +111,7 @@ using std::string;
  * 2. Grant this thread authorization to perform deletes.
  * 3. Temporarily enable mode to bypass shard version checks. TODO: Replace this hack.
  * 4. Setup callback to save deletes to moveChunk directory (only if moveParanoia is true).
- * 5. Delete range.
+ * 5. Delete range, in batches and at the rate allowed by the server parameters.
  * 6. Wait until the majority of the secondaries catch up.
  */
 bool RangeDeleterDBEnv::deleteRange(OperationContext* txn,
@@ -87,6 +142,13 @@ bool RangeDeleterDBEnv::deleteRange(OperationContext* txn,
     log() << "Deleter starting delete for: " << ns << " from " << inclusiveLower << " -> "
           << exclusiveUpper << ", with opId: " << opId;
 
+    Helpers::RemoveRangeOptions removeOptions;
+    removeOptions.batchSize = rangeDeleterBatchSize.load();
+    removeOptions.maxDocsPerSec = rangeDeleterMaxDocsPerSec.load();
+    removeOptions.maxBytesPerSec = rangeDeleterMaxBytesPerSec.load();
+    removeOptions.deletedDocs = &taskDetails.progress.deletedDocs;
+    removeOptions.deletedBytes = &taskDetails.progress.deletedBytes;
+
     try {
         *deletedDocs =
             Helpers::removeRange(txn,
@@ -95,7 +157,8 @@ bool RangeDeleterDBEnv::deleteRange(OperationContext* txn,
                                  writeConcern,
                                  removeSaverPtr,
                                  fromMigrate,
-                                 onlyRemoveOrphans);
+                                 onlyRemoveOrphans,
+                                 &removeOptions);
 
         if (*deletedDocs < 0) {
             *errMsg = "collection or index dropped before data could be cleaned";
@@ -30,6 +30,7 @@
 
 #include "mongo/base/init.h"
 #include "mongo/db/range_deleter_db_env.h"
+#include "mongo/db/server_parameters.h"
 
 namespace {
 
@@ -38,6 +39,30 @@ mongo::RangeDeleter* _deleter = NULL;
 
 namespace mongo {
 
+namespace {
+
+int rangeDeleterWorkerThreads = 1;
+
+class RangeDeleterWorkerThreadsParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupOnly> {
+public:
+    RangeDeleterWorkerThreadsParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(),
+              "rangeDeleterWorkerThreads",
+              &rangeDeleterWorkerThreads) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 1 || potentialNewValue > 16) {
+            return Status(ErrorCodes::BadValue,
+                          "rangeDeleterWorkerThreads has to be >= 1 and <= 16");
+        }
+        return Status::OK();
+    }
+} rangeDeleterWorkerThreadsParameter;
+
+}  // namespace
+
 MONGO_INITIALIZER(RangeDeleterInit)(InitializerContext* context) {
     _deleter = new RangeDeleter(new RangeDeleterDBEnv);
     return Status::OK();
@@ -46,4 +71,8 @@ MONGO_INITIALIZER(RangeDeleterInit)(InitializerContext* context) {
 RangeDeleter* getDeleter() {
     return _deleter;
 }
+
+size_t getDeleterNumWorkers() {
+    return rangeDeleterWorkerThreads;
+}
 }
@@ -36,4 +36,10 @@ namespace mongo {
  * Gets the global instance of the deleter and starts it.
  */
 RangeDeleter* getDeleter();
+
+/**
+ * Number of worker threads of the global deleter, set at startup with the server parameter
+ * "rangeDeleterWorkerThreads".
+ */
+size_t getDeleterNumWorkers();
 }
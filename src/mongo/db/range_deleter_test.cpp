@@ -26,7 +26,9 @@
  *    it in the license file.
  */
 
+#include <set>
 #include <string>
+#include <vector>
 
 #include "mongo/db/field_parser.h"
 #include "mongo/db/range_deleter.h"
@@ -40,6 +42,7 @@
 #include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace {
@@ -357,5 +360,84 @@ TEST(MixedDeletes, MultipleDeletes) {
     deleter.stopWorkers();
 }
 
+// Tests that with several workers, deletes on different namespaces run at the same time while
+// the deletes on a namespace which is already being deleted from wait for it.
+TEST(MultipleWorkers, DistinctNamespaces) {
+    const string ns1("test.user");
+    const string ns2("test.other");
+
+    RangeDeleterMockEnv* env = new RangeDeleterMockEnv();
+    RangeDeleter deleter(env);
+
+    std::unique_ptr<mongo::repl::ReplicationCoordinatorMock> mock(
+        new mongo::repl::ReplicationCoordinatorMock(replSettings));
+
+    mongo::repl::ReplicationCoordinator::set(mongo::getGlobalServiceContext(), std::move(mock));
+
+    deleter.startWorkers(2);
+
+    env->pauseDeletes();
+
+    Notification notifyDone1;
+    ASSERT_TRUE(deleter.queueDelete(
+        noTxn,
+        RangeDeleterOptions(KeyRange(ns1, BSON("x" << 10), BSON("x" << 20), BSON("x" << 1))),
+        &notifyDone1,
+        NULL /* don't care errMsg */));
+
+    env->waitForNthPausedDelete(1u);
+
+    Notification notifyDone2;
+    ASSERT_TRUE(deleter.queueDelete(
+        noTxn,
+        RangeDeleterOptions(KeyRange(ns1, BSON("x" << 20), BSON("x" << 30), BSON("x" << 1))),
+        &notifyDone2,
+        NULL /* don't care errMsg */));
+
+    Notification notifyDone3;
+    ASSERT_TRUE(deleter.queueDelete(
+        noTxn,
+        RangeDeleterOptions(KeyRange(ns2, BSON("x" << 10), BSON("x" << 20), BSON("x" << 1))),
+        &notifyDone3,
+        NULL /* don't care errMsg */));
+
+    // The idle worker skips the second delete on ns1 and picks up the one on ns2.
+    env->waitForNthPausedDelete(2u);
+
+    ASSERT_EQUALS(3U, deleter.getTotalDeletes());
+    ASSERT_EQUALS(1U, deleter.getPendingDeletes());
+    ASSERT_EQUALS(2U, deleter.getDeletesInProgress());
+
+    std::vector<BSONObj> inProgress;
+    deleter.getInProgressDeletes(&inProgress);
+    ASSERT_EQUALS(2U, inProgress.size());
+
+    std::set<string> inProgressNss;
+    for (const BSONObj& entry : inProgress) {
+        inProgressNss.insert(entry["ns"].str());
+        ASSERT_TRUE(entry["min"].Obj().equal(BSON("x" << 10)));
+        ASSERT_EQUALS(0LL, entry["deletedDocs"].numberLong());
+    }
+    ASSERT_EQUALS(1U, inProgressNss.count(ns1));
+    ASSERT_EQUALS(1U, inProgressNss.count(ns2));
+
+    // Let the deletes proceed one at a time.
+    for (size_t remaining = 3; remaining > 0; remaining--) {
+        env->resumeOneDelete();
+        while (deleter.getTotalDeletes() >= remaining) {
+            sleepmillis(1);
+        }
+    }
+
+    notifyDone1.waitToBeNotified();
+    notifyDone2.waitToBeNotified();
+    notifyDone3.waitToBeNotified();
+
+    deleter.getInProgressDeletes(&inProgress);
+    ASSERT_TRUE(inProgress.empty());
+
+    deleter.stopWorkers();
+}
+
 }  // unnamed namespace
 }  // namespace mongo
@@ -52,6 +52,7 @@
 #include "mongo/db/repl/rollback_source_impl.h"
 #include "mongo/db/repl/rs_rollback.h"
 #include "mongo/db/repl/rs_sync.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/executor/network_interface_factory.h"
 #include "mongo/rpc/metadata/repl_set_metadata.h"
@@ -144,6 +145,31 @@ static int bufferMaxSizeGauge = 256 * 1024 * 1024;
 static ServerStatusMetricField<int> displayBufferMaxSize("repl.buffer.maxSizeBytes",
                                                          &bufferMaxSizeGauge);
 
+class ExportedBufferMaxSizeParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupOnly> {
+public:
+    ExportedBufferMaxSizeParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(), "replBufferMaxSizeBytes", &bufferMaxSizeGauge) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        // The buffer must always be able to hold at least one maximum sized oplog entry.
+        if (potentialNewValue < BSONObjMaxInternalSize) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "replBufferMaxSizeBytes must be at least "
+                                        << BSONObjMaxInternalSize);
+        }
+
+        return Status::OK();
+    }
+
+} exportedBufferMaxSizeParam;
+
+// The number and time of waits for the applier to free space in a full buffer
+static TimerStats bufferFullStats;
+static ServerStatusMetricField<TimerStats> displayBufferFull("repl.buffer.fullWaits",
+                                                             &bufferFullStats);
+
 
 BackgroundSyncInterface::~BackgroundSyncInterface() {}
 
@@ -576,7 +602,10 @@ void BackgroundSync::_fetcherCallback(const StatusWith<Fetcher::QueryResponse>&
 
     if (toApplyDocumentBytes > 0) {
         // Wait for enough space.
-        _buffer.waitForSpace(toApplyDocumentBytes);
+        if (_buffer.size() + toApplyDocumentBytes > _buffer.maxSize()) {
+            TimerHolder timer(&bufferFullStats);
+            _buffer.waitForSpace(toApplyDocumentBytes);
+        }
 
         OCCASIONALLY {
             LOG(2) << "bgsync buffer has " << _buffer.size() << " bytes";
@@ -32,6 +32,7 @@
 #include <vector>
 
 #include "mongo/client/connpool.h"
+#include "mongo/db/client.h"
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbhelpers.h"
@@ -47,6 +48,7 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/wire_version.h"
 #include "mongo/s/write_ops/batched_command_request.h"
+#include "mongo/util/net/abstract_message_port.h"
 
 namespace mongo {
 
@@ -239,6 +241,10 @@ public:
         result.appendDate("localTime", jsTime());
         result.append("maxWireVersion", WireSpec::instance().maxWireVersionIncoming);
         result.append("minWireVersion", WireSpec::instance().minWireVersionIncoming);
+        if (auto port = txn->getClient()->port()) {
+            port->compressorManager().serverNegotiate(cmdObj, &result);
+        }
+
         return true;
     }
 } cmdismaster;
@@ -114,6 +114,64 @@ MONGO_FP_DECLARE(rsSyncApplyStop);
 static TimerStats applyBatchStats;
 static ServerStatusMetricField<TimerStats> displayOpBatchesApplied("repl.apply.batches",
                                                                    &applyBatchStats);
+
+// Number and time of each writer thread's share of a batch
+static TimerStats applyWriterStats;
+static ServerStatusMetricField<TimerStats> displayWriterBatchesApplied("repl.apply.writers",
+                                                                       &applyWriterStats);
+
+// Time the applier spent waiting for the batcher to have a batch ready
+static TimerStats applyWaitStats;
+static ServerStatusMetricField<TimerStats> displayApplyWaits("repl.apply.batchWaits",
+                                                             &applyWaitStats);
+
+// The ops and bytes of the batch currently being applied
+static Counter64 applyOpsGauge;
+static ServerStatusMetricField<Counter64> displayApplyOps("repl.apply.inProgress.count",
+                                                          &applyOpsGauge);
+static Counter64 applyBytesGauge;
+static ServerStatusMetricField<Counter64> displayApplyBytes("repl.apply.inProgress.sizeBytes",
+                                                            &applyBytesGauge);
+
+// Time the batcher spent waiting for ops to arrive in the bgsync buffer, and for the applier to
+// take the previous batch
+static TimerStats batcherOpWaitStats;
+static ServerStatusMetricField<TimerStats> displayBatcherOpWaits("repl.batcher.bufferWaits",
+                                                                 &batcherOpWaitStats);
+static TimerStats batcherApplierWaitStats;
+static ServerStatusMetricField<TimerStats> displayBatcherApplierWaits("repl.batcher.applierWaits",
+                                                                      &batcherApplierWaitStats);
+
+// The ops and bytes of the batch that is formed and waiting for the applier to take it
+static Counter64 batcherReadyOpsGauge;
+static ServerStatusMetricField<Counter64> displayBatcherReadyOps("repl.batcher.ready.count",
+                                                                 &batcherReadyOpsGauge);
+static Counter64 batcherReadyBytesGauge;
+static ServerStatusMetricField<Counter64> displayBatcherReadyBytes("repl.batcher.ready.sizeBytes",
+                                                                   &batcherReadyBytesGauge);
+
+// Oplog entries handed to the writers by (namespace, _id) hash and by namespace hash only
+static Counter64 opsPartitionedByIdStats;
+static ServerStatusMetricField<Counter64> displayOpsPartitionedById(
+    "repl.apply.partitioning.byId", &opsPartitionedByIdStats);
+static Counter64 opsPartitionedByNamespaceStats;
+static ServerStatusMetricField<Counter64> displayOpsPartitionedByNamespace(
+    "repl.apply.partitioning.byNamespace", &opsPartitionedByNamespaceStats);
+
+// Sum over batches of the number of writers given work and of the size of the largest writer
+// vector. Together with repl.apply.ops these describe how evenly batches are spread, e.g. a
+// batch applied entirely by one writer adds its full size to maxWriterOps.
+static Counter64 writersUsedStats;
+static ServerStatusMetricField<Counter64> displayWritersUsed("repl.apply.partitioning.writersUsed",
+                                                             &writersUsedStats);
+static Counter64 maxWriterOpsStats;
+static ServerStatusMetricField<Counter64> displayMaxWriterOps(
+    "repl.apply.partitioning.maxWriterOps", &maxWriterOpsStats);
+
+// When true, CRUD ops on non-capped collections are spread across the writers by the _id of the
+// document they touch, instead of by namespace only, on storage engines with document locking.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(replWriterPartitionById, bool, true);
+
 void initializePrefetchThread() {
     if (!ClientBasic::getCurrent()) {
         Client::initThreadIfNotAlready();
@@ -438,19 +496,27 @@ void prefetchOps(const std::deque<SyncTail::OplogEntry>& ops, OldThreadPool* pre
     prefetcherPool->join();
 }
 
-// Doles out all the work to the writer pool threads and waits for them to complete
+// Doles out all the work to the writer pool threads. The caller must join the pool.
 void applyOps(const std::vector<std::vector<BSONObj>>& writerVectors,
               OldThreadPool* writerPool,
               SyncTail::MultiSyncApplyFunc func,
               SyncTail* sync) {
-    TimerHolder timer(&applyBatchStats);
+    size_t maxWriterOps = 0;
     for (std::vector<std::vector<BSONObj>>::const_iterator it = writerVectors.begin();
          it != writerVectors.end();
          ++it) {
         if (!it->empty()) {
-            writerPool->schedule(func, stdx::cref(*it), sync);
+            writersUsedStats.increment();
+            maxWriterOps = std::max(maxWriterOps, it->size());
+
+            const std::vector<BSONObj>* ops = &(*it);
+            writerPool->schedule([func, ops, sync] {
+                TimerHolder timer(&applyWriterStats);
+                func(*ops, sync);
+            });
         }
     }
+    maxWriterOpsStats.increment(maxWriterOps);
 }
 
 /**
@@ -483,48 +549,52 @@ private:
     StringMap<bool> _cache;
 };
 
+}  // namespace
+
 void fillWriterVectors(OperationContext* txn,
                        const std::deque<SyncTail::OplogEntry>& ops,
+                       bool partitionById,
                        std::vector<std::vector<BSONObj>>* writerVectors) {
-    const bool supportsDocLocking =
-        getGlobalServiceContext()->getGlobalStorageEngine()->supportsDocLocking();
     const uint32_t numWriters = writerVectors->size();
 
     Lock::GlobalRead globalReadLock(txn->lockState());
 
     CachingCappedChecker isCapped;
 
+    // An op without an _id can't be ordered against the other ops on its collection by
+    // looking at the _id alone, so every op on that collection in this batch is applied by a
+    // single writer, in oplog order.
+    StringMap<bool> serializedNamespaces;
+    if (partitionById) {
+        for (auto&& op : ops) {
+            if (isCrudOpType(op.opType.rawData()) && op.id.eoo()) {
+                serializedNamespaces[op.ns] = true;
+            }
+        }
+    }
+
+    long long partitionedById = 0;
     for (auto&& op : ops) {
         StringMapTraits::HashedKey hashedNs(op.ns);
         uint32_t hash = hashedNs.hash();
 
-        const char* opType = op.opType.rawData();
-
         // For doc locking engines, include the _id of the document in the hash so we get
         // parallelism even if all writes are to a single collection. We can't do this for capped
         // collections because the order of inserts is a guaranteed property, unlike for normal
         // collections.
-        if (supportsDocLocking && isCrudOpType(opType) && !isCapped(txn, hashedNs)) {
-            BSONElement id;
-            switch (opType[0]) {
-                case 'u':
-                    id = op.o2.Obj()["_id"];
-                    break;
-                case 'd':
-                case 'i':
-                    id = op.o.Obj()["_id"];
-                    break;
-            }
-
-            const size_t idHash = BSONElement::Hasher()(id);
-            MurmurHash3_x86_32(&idHash, sizeof(idHash), hash, &hash);
+        if (partitionById && isCrudOpType(op.opType.rawData()) &&
+            serializedNamespaces.find(hashedNs) == serializedNamespaces.end() &&
+            !isCapped(txn, hashedNs)) {
+            MurmurHash3_x86_32(&op.idHash, sizeof(op.idHash), hash, &hash);
+            partitionedById++;
         }
 
         (*writerVectors)[hash % numWriters].push_back(op.raw);
     }
-}
 
-}  // namespace
+    opsPartitionedByIdStats.increment(partitionedById);
+    opsPartitionedByNamespaceStats.increment(ops.size() - partitionedById);
+}
 
 // Applies a batch of oplog entries, by using a set of threads to apply the operations and then
 // writes the oplog entries to the local oplog.
@@ -540,7 +610,9 @@ OpTime SyncTail::multiApply(OperationContext* txn,
 
     std::vector<std::vector<BSONObj>> writerVectors(replWriterThreadCount);
 
-    fillWriterVectors(txn, ops.getDeque(), &writerVectors);
+    const bool partitionById = replWriterPartitionById &&
+        getGlobalServiceContext()->getGlobalStorageEngine()->supportsDocLocking();
+    fillWriterVectors(txn, ops.getDeque(), partitionById, &writerVectors);
     LOG(2) << "replication batch size is " << ops.getDeque().size() << endl;
     // We must grab this because we're going to grab write locks later.
     // We hold this mutex the entire time we're writing; it doesn't matter
@@ -565,11 +637,15 @@ OpTime SyncTail::multiApply(OperationContext* txn,
         setMinValid(txn, *boundaries);  // Mark us as in the middle of a batch.
     }
 
+    TimerHolder timer(&applyBatchStats);
     applyOps(writerVectors, &_writerPool, _applyFunc, this);
 
     OpTime lastOpTime;
     {
-        ON_BLOCK_EXIT([&] { _writerPool.join(); });
+        ON_BLOCK_EXIT([&] {
+            _writerPool.join();
+            timer.recordMillis();
+        });
         std::vector<BSONObj> raws;
         raws.reserve(ops.getDeque().size());
         for (auto&& op : ops.getDeque()) {
@@ -640,11 +716,16 @@ public:
         _inShutdown.store(true);
         _cv.notify_all();
         _thread.join();
+
+        // Drop a batch the applier never took from the occupancy gauges.
+        batcherReadyOpsGauge.decrement(_ops.getDeque().size());
+        batcherReadyBytesGauge.decrement(_ops.getSize());
     }
 
     OpQueue getNextBatch(Seconds maxWaitTime) {
         stdx::unique_lock<stdx::mutex> lk(_mutex);
         if (_ops.empty()) {
+            TimerHolder timer(&applyWaitStats);
             // We intentionally don't care about whether this returns due to signaling or timeout
             // since we do the same thing either way: return whatever is in _ops.
             (void)_cv.wait_for(lk, maxWaitTime);
@@ -654,6 +735,9 @@ public:
         _ops = {};
         _cv.notify_all();
 
+        batcherReadyOpsGauge.decrement(ops.getDeque().size());
+        batcherReadyBytesGauge.decrement(ops.getSize());
+
         return ops;
     }
 
@@ -707,12 +791,17 @@ private:
             }
 
             stdx::unique_lock<stdx::mutex> lk(_mutex);
-            while (!_ops.empty()) {
+            if (!_ops.empty()) {
                 // Block until the previous batch has been taken.
-                if (_inShutdown.load())
-                    return;
-                _cv.wait(lk);
+                TimerHolder timer(&batcherApplierWaitStats);
+                while (!_ops.empty()) {
+                    if (_inShutdown.load())
+                        return;
+                    _cv.wait(lk);
+                }
             }
+            batcherReadyOpsGauge.increment(ops.getDeque().size());
+            batcherReadyBytesGauge.increment(ops.getSize());
             _ops = std::move(ops);
             _cv.notify_all();
         }
@@ -818,7 +907,11 @@ void SyncTail::oplogApplication() {
         minValidBoundaries.end = std::max(originalEndOpTime, lastOpTime);
 
 
+        applyOpsGauge.increment(ops.getDeque().size());
+        applyBytesGauge.increment(ops.getSize());
         lastWriteOpTime = multiApply(&txn, ops, minValidBoundaries);
+        applyOpsGauge.decrement(ops.getDeque().size());
+        applyBytesGauge.decrement(ops.getSize());
         if (lastWriteOpTime.isNull()) {
             // fassert if oplog application failed for any reasons other than shutdown.
             error() << "Failed to apply " << ops.getDeque().size()
@@ -850,6 +943,20 @@ SyncTail::OplogEntry::OplogEntry(const BSONObj& rawInput) : raw(rawInput.getOwne
             o = elem;
         }
     }
+
+    switch (opType[0]) {
+        case 'u':
+            if (o2.type() == Object)
+                id = o2.Obj()["_id"];
+            break;
+        case 'd':
+        case 'i':
+            if (o.type() == Object)
+                id = o.Obj()["_id"];
+            break;
+    }
+    if (!id.eoo())
+        idHash = BSONElement::Hasher()(id);
 }
 
 // Copies ops out of the bgsync queue into the deque passed in as a parameter.
@@ -868,6 +975,7 @@ bool SyncTail::tryPopAndWaitForMore(OperationContext* txn, SyncTail::OpQueue* op
         // if we don't have anything in the queue, wait a bit for something to appear
         if (ops->empty()) {
             // block up to 1 second
+            TimerHolder timer(&batcherOpWaitStats);
             _networkQueue->waitForMore();
             return false;
         }
@@ -30,6 +30,7 @@
 
 #include <boost/optional.hpp>
 #include <deque>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/bson/bsonobj.h"
@@ -117,6 +118,12 @@ public:
         BSONElement version;
         BSONElement o;
         BSONElement o2;
+
+        // The _id of the document an insert, update or delete applies to (EOO for other ops or
+        // when the op has no _id) and its hash. Both are computed when the entry is parsed, on
+        // the batching thread, so partitioning the batch among the writers doesn't have to.
+        BSONElement id;
+        size_t idHash = 0;
     };
 
     class OpQueue {
@@ -198,6 +205,17 @@ private:
     OldThreadPool _prefetcherPool;
 };
 
+/**
+ * Distributes the ops of a batch among the writer vectors so that ops which must be applied in
+ * order land in the same vector, in oplog order. Ops are hashed by namespace; if "partitionById"
+ * is true, CRUD ops on non-capped collections are further hashed by the _id of the document they
+ * touch, unless some CRUD op on the same namespace in this batch has no _id.
+ */
+void fillWriterVectors(OperationContext* txn,
+                       const std::deque<SyncTail::OplogEntry>& ops,
+                       bool partitionById,
+                       std::vector<std::vector<BSONObj>>* writerVectors);
+
 // These free functions are used by the thread pool workers to write ops to the db.
 void multiSyncApply(const std::vector<BSONObj>& ops, SyncTail* st);
 void multiInitialSyncApply(const std::vector<BSONObj>& ops, SyncTail* st);
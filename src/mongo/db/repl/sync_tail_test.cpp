@@ -357,4 +357,126 @@ TEST_F(SyncTailTest, SyncApplyCommandThrowsException) {
     ASSERT_EQUALS(1U, _opsApplied);
 }
 
+
+std::deque<SyncTail::OplogEntry> makeOplogEntries(const std::vector<BSONObj>& raws) {
+    std::deque<SyncTail::OplogEntry> ops;
+    for (auto&& raw : raws) {
+        ops.emplace_back(raw);
+    }
+    return ops;
+}
+
+// Returns the index of the writer vector holding "op", or -1.
+int findWriter(const std::vector<std::vector<BSONObj>>& writerVectors, const BSONObj& op) {
+    for (size_t i = 0; i < writerVectors.size(); ++i) {
+        for (auto&& applied : writerVectors[i]) {
+            if (applied.objdata() == op.objdata() || applied == op) {
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
+TEST_F(SyncTailTest, FillWriterVectorsPartitionsSingleCollectionById) {
+    std::vector<BSONObj> raws;
+    for (int i = 0; i < 64; ++i) {
+        raws.push_back(BSON("op"
+                            << "i"
+                            << "ns"
+                            << "test.t"
+                            << "o" << BSON("_id" << i)));
+    }
+    // A later update of the first document must be applied after its insert.
+    raws.push_back(BSON("op"
+                        << "u"
+                        << "ns"
+                        << "test.t"
+                        << "o2" << BSON("_id" << 0) << "o" << BSON("$set" << BSON("x" << 1))));
+
+    std::vector<std::vector<BSONObj>> writerVectors(8);
+    fillWriterVectors(_txn.get(), makeOplogEntries(raws), true, &writerVectors);
+
+    size_t writersUsed = 0;
+    for (auto&& writer : writerVectors) {
+        writersUsed += !writer.empty();
+    }
+    ASSERT_GREATER_THAN(writersUsed, 1U);
+
+    const int writer = findWriter(writerVectors, raws.front());
+    ASSERT_NOT_EQUALS(-1, writer);
+    ASSERT_EQUALS(writer, findWriter(writerVectors, raws.back()));
+    ASSERT_EQUALS(raws.back(), writerVectors[writer].back());
+}
+
+TEST_F(SyncTailTest, FillWriterVectorsSerializesNamespaceWithOpMissingId) {
+    std::vector<BSONObj> raws;
+    for (int i = 0; i < 16; ++i) {
+        raws.push_back(BSON("op"
+                            << "i"
+                            << "ns"
+                            << "test.t"
+                            << "o" << BSON("_id" << i)));
+    }
+    raws.push_back(BSON("op"
+                        << "u"
+                        << "ns"
+                        << "test.t"
+                        << "o2" << BSON("x" << 1) << "o" << BSON("$set" << BSON("y" << 1))));
+
+    std::vector<std::vector<BSONObj>> writerVectors(8);
+    fillWriterVectors(_txn.get(), makeOplogEntries(raws), true, &writerVectors);
+
+    const int writer = findWriter(writerVectors, raws.front());
+    ASSERT_NOT_EQUALS(-1, writer);
+    ASSERT_EQUALS(raws.size(), writerVectors[writer].size());
+    for (size_t i = 0; i < raws.size(); ++i) {
+        ASSERT_EQUALS(raws[i], writerVectors[writer][i]);
+    }
+}
+
+TEST_F(SyncTailTest, FillWriterVectorsByNamespaceOnly) {
+    std::vector<BSONObj> raws;
+    for (int i = 0; i < 16; ++i) {
+        raws.push_back(BSON("op"
+                            << "i"
+                            << "ns"
+                            << "test.t"
+                            << "o" << BSON("_id" << i)));
+    }
+
+    std::vector<std::vector<BSONObj>> writerVectors(8);
+    fillWriterVectors(_txn.get(), makeOplogEntries(raws), false, &writerVectors);
+
+    const int writer = findWriter(writerVectors, raws.front());
+    ASSERT_NOT_EQUALS(-1, writer);
+    ASSERT_EQUALS(raws.size(), writerVectors[writer].size());
+}
+
+TEST_F(SyncTailTest, OplogEntryParsesIdOfCrudOps) {
+    SyncTail::OplogEntry insert(BSON("op"
+                                     << "i"
+                                     << "ns"
+                                     << "test.t"
+                                     << "o" << BSON("_id" << 1 << "x" << 2)));
+    ASSERT_EQUALS(1, insert.id.numberInt());
+    ASSERT_EQUALS(BSONElement::Hasher()(insert.id), insert.idHash);
+
+    SyncTail::OplogEntry update(BSON("op"
+                                     << "u"
+                                     << "ns"
+                                     << "test.t"
+                                     << "o" << BSON("$set" << BSON("x" << 3)) << "o2"
+                                     << BSON("_id" << 1)));
+    ASSERT_EQUALS(1, update.id.numberInt());
+    ASSERT_EQUALS(insert.idHash, update.idHash);
+
+    SyncTail::OplogEntry command(BSON("op"
+                                      << "c"
+                                      << "ns"
+                                      << "test.$cmd"
+                                      << "o" << BSON("_id" << 1)));
+    ASSERT_TRUE(command.id.eoo());
+}
+
 }  // namespace
@@ -108,7 +108,6 @@ CollectionMetadata* CollectionMetadata::cloneMigrate(const ChunkType& chunk,
     metadata->_chunksMap.erase(chunk.getMin());
     metadata->_shardVersion = newShardVersion;
     metadata->_collVersion = newShardVersion > _collVersion ? newShardVersion : this->_collVersion;
-    metadata->fillRanges();
 
     invariant(metadata->isValid());
     return metadata.release();
@@ -156,7 +155,6 @@ CollectionMetadata* CollectionMetadata::clonePlusChunk(const ChunkType& chunk,
     metadata->_chunksMap.insert(make_pair(chunk.getMin().getOwned(), chunk.getMax().getOwned()));
     metadata->_shardVersion = newShardVersion;
     metadata->_collVersion = newShardVersion > _collVersion ? newShardVersion : this->_collVersion;
-    metadata->fillRanges();
 
     invariant(metadata->isValid());
     return metadata.release();
@@ -194,7 +192,6 @@ CollectionMetadata* CollectionMetadata::cloneMinusPending(const ChunkType& pendi
     metadata->_pendingMap = this->_pendingMap;
     metadata->_pendingMap.erase(pending.getMin());
     metadata->_chunksMap = this->_chunksMap;
-    metadata->_rangesMap = this->_rangesMap;
     metadata->_shardVersion = _shardVersion;
     metadata->_collVersion = _collVersion;
 
@@ -228,7 +225,6 @@ CollectionMetadata* CollectionMetadata::clonePlusPending(const ChunkType& pendin
     metadata->fillKeyPatternFields();
     metadata->_pendingMap = this->_pendingMap;
     metadata->_chunksMap = this->_chunksMap;
-    metadata->_rangesMap = this->_rangesMap;
     metadata->_shardVersion = _shardVersion;
     metadata->_collVersion = _collVersion;
 
@@ -338,7 +334,8 @@ CollectionMetadata* CollectionMetadata::cloneSplit(const ChunkType& chunk,
             ss << "]";
             uasserted(28821, ss.str());
         }
-        metadata->_chunksMap[startKey] = split.getOwned();
+        metadata->_chunksMap.erase(startKey);
+        metadata->_chunksMap.insert(make_pair(startKey, split.getOwned()));
         metadata->_chunksMap.insert(make_pair(split.getOwned(), chunk.getMax().getOwned()));
         metadata->_shardVersion.incMinor();
         startKey = split;
@@ -346,7 +343,6 @@ CollectionMetadata* CollectionMetadata::cloneSplit(const ChunkType& chunk,
 
     metadata->_collVersion =
         metadata->_shardVersion > _collVersion ? metadata->_shardVersion : _collVersion;
-    metadata->fillRanges();
 
     invariant(metadata->isValid());
     return metadata.release();
@@ -413,7 +409,6 @@ CollectionMetadata* CollectionMetadata::cloneMerge(const BSONObj& minKey,
     metadata->fillKeyPatternFields();
     metadata->_pendingMap = this->_pendingMap;
     metadata->_chunksMap = this->_chunksMap;
-    metadata->_rangesMap = this->_rangesMap;
     metadata->_shardVersion = newShardVersion;
     metadata->_collVersion = newShardVersion > _collVersion ? newShardVersion : this->_collVersion;
 
@@ -434,12 +429,12 @@ bool CollectionMetadata::keyBelongsToMe(const BSONObj& key) const {
         return true;
     }
 
-    if (_rangesMap.size() <= 0) {
+    if (_chunksMap.size() <= 0) {
         return false;
     }
 
-    RangeMap::const_iterator it = _rangesMap.upper_bound(key);
-    if (it != _rangesMap.begin())
+    SharedRangeMap::const_iterator it = _chunksMap.upper_bound(key);
+    if (it != _chunksMap.begin())
         it--;
 
     bool good = rangeContains(it->first, it->second, key);
@@ -451,7 +446,7 @@ bool CollectionMetadata::keyBelongsToMe(const BSONObj& key) const {
             log() << "bad: " << key << " " << it->first << " " << key.woCompare( it->first ) << " "
                   << key.woCompare( it->second );
 
-            for ( RangeMap::const_iterator i = _rangesMap.begin(); i != _rangesMap.end(); ++i ) {
+            for ( auto i = _chunksMap.begin(); i != _chunksMap.end(); ++i ) {
                 log() << "\t" << i->first << "\t" << i->second << "\t";
             }
         }
@@ -479,8 +474,8 @@ bool CollectionMetadata::keyIsPending(const BSONObj& key) const {
 }
 
 bool CollectionMetadata::getNextChunk(const BSONObj& lookupKey, ChunkType* chunk) const {
-    RangeMap::const_iterator upperChunkIt = _chunksMap.upper_bound(lookupKey);
-    RangeMap::const_iterator lowerChunkIt = upperChunkIt;
+    SharedRangeMap::const_iterator upperChunkIt = _chunksMap.upper_bound(lookupKey);
+    SharedRangeMap::const_iterator lowerChunkIt = upperChunkIt;
 
     if (upperChunkIt != _chunksMap.begin()) {
         --lowerChunkIt;
@@ -513,7 +508,7 @@ void CollectionMetadata::toBSONChunks(BSONArrayBuilder& bb) const {
     if (_chunksMap.empty())
         return;
 
-    for (RangeMap::const_iterator it = _chunksMap.begin(); it != _chunksMap.end(); ++it) {
+    for (SharedRangeMap::const_iterator it = _chunksMap.begin(); it != _chunksMap.end(); ++it) {
         BSONArrayBuilder chunkBB(bb.subarrayStart());
         chunkBB.append(it->first);
         chunkBB.append(it->second);
@@ -554,8 +549,8 @@ bool CollectionMetadata::getNextOrphanRange(const BSONObj& origLookupKey, KeyRan
     BSONObj lookupKey = origLookupKey;
     BSONObj maxKey = getMaxKey();  // so we don't keep rebuilding
     while (lookupKey.woCompare(maxKey) < 0) {
-        RangeMap::const_iterator lowerChunkIt = _chunksMap.end();
-        RangeMap::const_iterator upperChunkIt = _chunksMap.end();
+        SharedRangeMap::const_iterator lowerChunkIt = _chunksMap.end();
+        SharedRangeMap::const_iterator upperChunkIt = _chunksMap.end();
 
         if (!_chunksMap.empty()) {
             upperChunkIt = _chunksMap.upper_bound(lookupKey);
@@ -630,13 +625,13 @@ bool CollectionMetadata::getNextOrphanRange(const BSONObj& origLookupKey, KeyRan
 string CollectionMetadata::toString() const {
     StringBuilder ss;
     ss << " CollectionManager version: " << _shardVersion.toString() << " key: " << _keyPattern;
-    if (_rangesMap.empty()) {
+    if (_chunksMap.empty()) {
         return ss.str();
     }
 
-    RangeMap::const_iterator it = _rangesMap.begin();
+    SharedRangeMap::const_iterator it = _chunksMap.begin();
     ss << it->first << " -> " << it->second;
-    while (it != _rangesMap.end()) {
+    while (++it != _chunksMap.end()) {
         ss << ", " << it->first << " -> " << it->second;
     }
     return ss.str();
@@ -668,13 +663,13 @@ bool CollectionMetadata::isValid() const {
 
     if (_shardVersion.majorVersion() > 0) {
         // Must be chunks
-        if (_rangesMap.size() == 0 || _chunksMap.size() == 0)
+        if (_chunksMap.size() == 0)
             return false;
     } else {
         // No chunks
         if (_shardVersion.minorVersion() > 0)
             return false;
-        if (_rangesMap.size() > 0 || _chunksMap.size() > 0)
+        if (_chunksMap.size() > 0)
             return false;
     }
 
@@ -691,40 +686,6 @@ bool CollectionMetadata::isValidKey(const BSONObj& key) const {
     return key.nFields() == _keyPattern.nFields();
 }
 
-void CollectionMetadata::fillRanges() {
-    if (_chunksMap.empty())
-        return;
-
-    // Load the chunk information, coallesceing their ranges.  The version for this shard
-    // would be the highest version for any of the chunks.
-    RangeMap::const_iterator it = _chunksMap.begin();
-    BSONObj min, max;
-    while (it != _chunksMap.end()) {
-        BSONObj currMin = it->first;
-        BSONObj currMax = it->second;
-        ++it;
-
-        // coalesce the chunk's bounds in ranges if they are adjacent chunks
-        if (min.isEmpty()) {
-            min = currMin;
-            max = currMax;
-            continue;
-        }
-        if (max == currMin) {
-            max = currMax;
-            continue;
-        }
-
-        _rangesMap.insert(make_pair(min, max));
-
-        min = currMin;
-        max = currMax;
-    }
-    dassert(!min.isEmpty());
-
-    _rangesMap.insert(make_pair(min, max));
-}
-
 void CollectionMetadata::fillKeyPatternFields() {
     // Parse the shard keys into the states 'keys' and 'keySet' members.
     BSONObjIterator patternIter = _keyPattern.begin();
@@ -34,6 +34,7 @@
 #include "mongo/db/field_ref_set.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/range_arithmetic.h"
+#include "mongo/db/s/shared_range_map.h"
 #include "mongo/s/chunk_version.h"
 
 namespace mongo {
@@ -206,6 +207,18 @@ public:
         return _chunksMap.size();
     }
 
+    /**
+     * Returns the number of segments the chunks are stored in, and how many of them are shared
+     * with the chunks of 'other'. Exposed for testing.
+     */
+    std::size_t getNumChunkSegments() const {
+        return _chunksMap.getNumSegments();
+    }
+
+    std::size_t getNumSharedChunkSegments(const CollectionMetadata& other) const {
+        return _chunksMap.getNumSharedSegments(other._chunksMap);
+    }
+
     std::size_t getNumPending() const {
         return _pendingMap.size();
     }
@@ -291,24 +304,15 @@ private:
     // Map of ranges of chunks that are migrating but have not been confirmed added yet
     RangeMap _pendingMap;
 
-    // Map of chunks tracked by this shard
-    RangeMap _chunksMap;
-
-    // A second map from a min key into a range or contiguous chunks. The map is redundant
-    // w.r.t. _chunkMap but we expect high chunk contiguity, especially in small
-    // installations.
-    RangeMap _rangesMap;
+    // Map of chunks tracked by this shard. It is shared with the metadata this one was cloned
+    // or reloaded from, so that building a new version only copies the changed chunks.
+    SharedRangeMap _chunksMap;
 
     /**
      * Returns true if this metadata was loaded with all necessary information.
      */
     bool isValid() const;
 
-    /**
-     * Try to find chunks that are adjacent and record these intervals in the _rangesMap
-     */
-    void fillRanges();
-
     /**
      * Creates the _keyField* local data
      */
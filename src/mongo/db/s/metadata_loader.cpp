@@ -154,8 +154,8 @@ Status MetadataLoader::initChunks(OperationContext* txn,
             versionMap[shard] = oldMetadata->_shardVersion;
             metadata->_collVersion = oldMetadata->_collVersion;
 
-            // TODO: This could be made more efficient if copying not required, but
-            // not as frequently reloaded as in mongos.
+            // The chunks are shared with the old metadata, only the ones which changed since
+            // are copied below.
             metadata->_chunksMap = oldMetadata->_chunksMap;
 
             LOG(2) << "loading new chunks for collection " << ns
@@ -169,10 +169,12 @@ Status MetadataLoader::initChunks(OperationContext* txn,
     }
 
 
-    // Exposes the new metadata's range map and version to the "differ," who
-    // would ultimately be responsible of filling them up.
+    // Exposes the new metadata's version and a scratch range map to the "differ," who would
+    // ultimately be responsible of filling them up. The scratch map only holds the chunks
+    // affected by the changes, which are then applied to the new metadata's chunks.
+    RangeMap changedChunks;
     SCMConfigDiffTracker differ(shard);
-    differ.attach(ns, metadata->_chunksMap, metadata->_collVersion, versionMap);
+    differ.attach(ns, changedChunks, metadata->_collVersion, versionMap);
 
     try {
         std::vector<ChunkType> chunks;
@@ -188,6 +190,19 @@ Status MetadataLoader::initChunks(OperationContext* txn,
             return status;
         }
 
+        // The differ only removes the chunks whose min key falls within the range of a changed
+        // chunk, so those are the only ones it needs to see.
+        std::vector<BSONObj> replacedChunkMins;
+        for (const ChunkType& chunk : chunks) {
+            for (auto it = metadata->_chunksMap.lower_bound(chunk.getMin());
+                 it != metadata->_chunksMap.end() && it->first.woCompare(chunk.getMax()) < 0;
+                 ++it) {
+                if (changedChunks.insert(*it).second) {
+                    replacedChunkMins.push_back(it->first);
+                }
+            }
+        }
+
         //
         // The diff tracker should always find at least one chunk (the highest chunk we saw
         // last time).  If not, something has changed on the config server (potentially between
@@ -199,8 +214,14 @@ Status MetadataLoader::initChunks(OperationContext* txn,
             LOG(2) << "loaded " << diffsApplied << " chunks into new metadata for " << ns
                    << " with version " << metadata->_collVersion;
 
+            for (const BSONObj& min : replacedChunkMins) {
+                metadata->_chunksMap.erase(min);
+            }
+            for (const auto& range : changedChunks) {
+                metadata->_chunksMap.insert(range);
+            }
+
             metadata->_shardVersion = versionMap[shard];
-            metadata->fillRanges();
 
             invariant(metadata->isValid());
             return Status::OK();
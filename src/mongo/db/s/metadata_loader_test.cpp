@@ -26,6 +26,8 @@
  *    then also delete it in the license file.
  */
 
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kSharding
+
 #include "mongo/platform/basic.h"
 
 #include <vector>
@@ -34,6 +36,7 @@
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/client/connpool.h"
 #include "mongo/client/dbclientinterface.h"
+#include "mongo/config.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/s/collection_metadata.h"
@@ -44,7 +47,9 @@
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/catalog/type_collection.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/log.h"
 #include "mongo/util/net/hostandport.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -465,6 +470,37 @@ protected:
         return *_loader;
     }
 
+    MockRemoteDBServer* getConfigServer() const {
+        return _dummyConfig.get();
+    }
+
+    /**
+     * Replaces the chunks on the config server with the two halves of 'chunk' split at
+     * 'splitKey', which is what a refresh reads after the split of 'chunk'.
+     */
+    void setSplitChunks(const ChunkType& chunk,
+                        const BSONObj& splitKey,
+                        const ChunkVersion& newVersion) {
+        _dummyConfig->remove(ChunkType::ConfigNS, BSONObj());
+
+        ChunkType lower(chunk);
+        lower.setName(OID::gen().toString());
+        lower.setMax(splitKey);
+        lower.setVersion(newVersion);
+        ASSERT_OK(lower.validate());
+        _dummyConfig->insert(ChunkType::ConfigNS, lower.toBSON());
+
+        ChunkVersion upperVersion(newVersion);
+        upperVersion.incMinor();
+
+        ChunkType upper(chunk);
+        upper.setName(OID::gen().toString());
+        upper.setMin(splitKey);
+        upper.setVersion(upperVersion);
+        ASSERT_OK(upper.validate());
+        _dummyConfig->insert(ChunkType::ConfigNS, upper.toBSON());
+    }
+
     void getMetadataFor(OperationContext* txn,
                         const OwnedPointerVector<ChunkType>& chunks,
                         CollectionMetadata* metadata) {
@@ -739,6 +775,145 @@ TEST_F(MultipleMetadataFixture, PromotePendingBadOverlap) {
     ASSERT_EQUALS(status.code(), ErrorCodes::RemoteChangeDetected);
 }
 
+TEST_F(MultipleMetadataFixture, RefreshAppliesChangedChunks) {
+    OperationContextNoop txn;
+    OID epoch = OID::gen();
+
+    OwnedPointerVector<ChunkType> chunks;
+    for (int i = 0; i < 3; i++) {
+        unique_ptr<ChunkType> chunk(new ChunkType());
+        chunk->setNS("foo.bar");
+        chunk->setShard("shard0000");
+        chunk->setMin(BSON("x" << i * 10));
+        chunk->setMax(BSON("x" << (i + 1) * 10));
+        chunk->setVersion(ChunkVersion(1, i, epoch));
+        chunks.mutableVector().push_back(chunk.release());
+    }
+
+    CollectionMetadata oldMetadata;
+    getMetadataFor(&txn, chunks, &oldMetadata);
+    ASSERT_EQUALS(3u, oldMetadata.getNumChunks());
+
+    // The refresh only reads the two halves of the split chunk
+    setSplitChunks(*chunks.vector()[1], BSON("x" << 15), ChunkVersion(1, 3, epoch));
+
+    CollectionMetadata newMetadata;
+    Status status = loader().makeCollectionMetadata(
+        &txn, catalogManager(), "foo.bar", "shard0000", &oldMetadata, &newMetadata);
+    ASSERT_OK(status);
+
+    ASSERT_EQUALS(4u, newMetadata.getNumChunks());
+    ASSERT_EQUALS(ChunkVersion(1, 4, epoch).toLong(), newMetadata.getShardVersion().toLong());
+
+    ChunkType nextChunk;
+    ASSERT(newMetadata.getNextChunk(BSON("x" << 15), &nextChunk));
+    ASSERT_EQUALS(BSON("x" << 15), nextChunk.getMin());
+    ASSERT_EQUALS(BSON("x" << 20), nextChunk.getMax());
+    ASSERT(newMetadata.keyBelongsToMe(BSON("x" << 29)));
+    ASSERT(!newMetadata.keyBelongsToMe(BSON("x" << 30)));
+
+    // The old metadata is not changed by the refresh
+    ASSERT_EQUALS(3u, oldMetadata.getNumChunks());
+    ASSERT(oldMetadata.getNextChunk(BSON("x" << 15), &nextChunk));
+    ASSERT_EQUALS(BSON("x" << 10), nextChunk.getMin());
+    ASSERT_EQUALS(BSON("x" << 20), nextChunk.getMax());
+}
+
+// A refresh after a split should only copy the storage segment holding the split chunk, so that
+// its cost depends on the number of changed chunks rather than on the number of chunks.
+TEST_F(MultipleMetadataFixture, RefreshAfterSplitSharesUnchangedChunks) {
+    const int kNumChunks = 2000;
+    const int kNumRefreshes = 5;
+
+    OperationContextNoop txn;
+    OID epoch = OID::gen();
+
+    OwnedPointerVector<ChunkType> chunks;
+    for (int i = 0; i < kNumChunks; i++) {
+        unique_ptr<ChunkType> chunk(new ChunkType());
+        chunk->setNS("foo.bar");
+        chunk->setShard("shard0000");
+        chunk->setMin(BSON("x" << i * 10));
+        chunk->setMax(BSON("x" << (i + 1) * 10));
+        chunk->setVersion(ChunkVersion(1, i, epoch));
+        chunks.mutableVector().push_back(chunk.release());
+    }
+
+    unique_ptr<CollectionMetadata> metadata(new CollectionMetadata());
+    getMetadataFor(&txn, chunks, metadata.get());
+    ASSERT_EQUALS(static_cast<size_t>(kNumChunks), metadata->getNumChunks());
+    ASSERT_GREATER_THAN(metadata->getNumChunkSegments(), 1U);
+
+    for (int i = 0; i < kNumRefreshes; i++) {
+        const ChunkType& chunk = *chunks.vector()[(i * 397) % kNumChunks];
+        ChunkVersion newVersion(metadata->getCollVersion());
+        newVersion.incMinor();
+        setSplitChunks(chunk, BSON("x" << chunk.getMin()["x"].numberInt() + 5), newVersion);
+
+        unique_ptr<CollectionMetadata> newMetadata(new CollectionMetadata());
+        ASSERT_OK(loader().makeCollectionMetadata(
+            &txn, catalogManager(), "foo.bar", "shard0000", metadata.get(), newMetadata.get()));
+
+        ASSERT_EQUALS(metadata->getNumChunks() + 1, newMetadata->getNumChunks());
+        ASSERT_GREATER_THAN_OR_EQUALS(newMetadata->getNumSharedChunkSegments(*metadata),
+                                      metadata->getNumChunkSegments() - 1);
+
+        metadata = std::move(newMetadata);
+    }
+
+    ASSERT_EQUALS(static_cast<size_t>(kNumChunks + kNumRefreshes), metadata->getNumChunks());
+}
+
+#ifndef MONGO_CONFIG_DEBUG_BUILD
+
+// Measures how long a shard takes to refresh its metadata after a split, which should depend on
+// the number of changed chunks rather than on the number of chunks on the shard.
+TEST_F(MultipleMetadataFixture, PerformanceRefreshAfterSplit) {
+    const int kNumRefreshes = 200;
+
+    for (int numChunks : {1000, 10 * 1000, 100 * 1000}) {
+        OperationContextNoop txn;
+        OID epoch = OID::gen();
+
+        OwnedPointerVector<ChunkType> chunks;
+        for (int i = 0; i < numChunks; i++) {
+            unique_ptr<ChunkType> chunk(new ChunkType());
+            chunk->setNS("foo.bar");
+            chunk->setShard("shard0000");
+            chunk->setMin(BSON("x" << i * 10));
+            chunk->setMax(BSON("x" << (i + 1) * 10));
+            chunk->setVersion(ChunkVersion(1, i, epoch));
+            chunks.mutableVector().push_back(chunk.release());
+        }
+
+        unique_ptr<CollectionMetadata> metadata(new CollectionMetadata());
+        getMetadataFor(&txn, chunks, metadata.get());
+        ASSERT_EQUALS(static_cast<size_t>(numChunks), metadata->getNumChunks());
+
+        long long refreshMicros = 0;
+        for (int i = 0; i < kNumRefreshes; i++) {
+            const ChunkType& chunk = *chunks.vector()[(i * 7919) % numChunks];
+            ChunkVersion newVersion(metadata->getCollVersion());
+            newVersion.incMinor();
+            setSplitChunks(chunk, BSON("x" << chunk.getMin()["x"].numberInt() + 5), newVersion);
+
+            unique_ptr<CollectionMetadata> newMetadata(new CollectionMetadata());
+            Timer timer;
+            ASSERT_OK(loader().makeCollectionMetadata(
+                &txn, catalogManager(), "foo.bar", "shard0000", metadata.get(), newMetadata.get()));
+            refreshMicros += timer.micros();
+
+            metadata = std::move(newMetadata);
+        }
+
+        ASSERT_EQUALS(static_cast<size_t>(numChunks + kNumRefreshes), metadata->getNumChunks());
+        log() << numChunks << " chunks: " << refreshMicros / kNumRefreshes
+              << " micros per refresh";
+    }
+}
+
+#endif  // MONGO_CONFIG_DEBUG_BUILD
+
 #if 0
     // TODO: MockServer functionality does not support selective query - consider
     // inserting nothing at all to chunk/collections collection
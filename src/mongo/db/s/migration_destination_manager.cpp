@@ -43,6 +43,7 @@
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/catalog/index_create.h"
 #include "mongo/db/client.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbhelpers.h"
@@ -50,6 +51,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/ops/delete.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/range_deleter_service.h"
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
@@ -62,9 +64,11 @@
 #include "mongo/s/grid.h"
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/stdx/chrono.h"
+#include "mongo/stdx/future.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -75,6 +79,10 @@ namespace {
 
 Tee* migrateLog = RamLog::get("migrate");
 
+// Maximum number of cloned documents inserted in one write unit of work. The batches are also
+// limited to insertVectorMaxBytes.
+const long long kMaxCloneBatchDocs = 64;
+
 /**
  * Returns a human-readabale name of the migration manager's state.
  */
@@ -607,11 +615,60 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
 
         const BSONObj migrateCloneRequest = createMigrateCloneRequest(sessionId);
 
+        // Each batch is inserted by a separate thread while the next one is fetched from the
+        // donor. The thread has its own client, so the last optime of its inserts is handed back
+        // in order to wait for them to replicate along with the rest of the migration.
+        const Timer cloneTimer;
+        stdx::future<Status> insertResult;
+        repl::OpTime lastInsertedOp;
+
+        const auto insertBatch = [&](BSONObj arr) -> Status {
+            Client::initThread("migrateCloneInserter");
+            ON_BLOCK_EXIT([] { Client::destroy(); });
+
+            OperationContextImpl inserterTxn;
+            if (getGlobalAuthorizationManager()->isAuthEnabled()) {
+                AuthorizationSession::get(inserterTxn.getClient())->grantInternalAuthorization();
+            }
+
+            DisableDocumentValidation validationDisabler(&inserterTxn);
+
+            Status status =
+                _insertCloneBatch(&inserterTxn, ns, min, max, shardKeyPattern, writeConcern, arr);
+            lastInsertedOp = repl::ReplClientInfo::forClient(inserterTxn.getClient()).getLastOp();
+            return status;
+        };
+
+        // Waits for the batch being inserted, if any, and returns false if it could not be.
+        const auto waitForInsert = [&]() -> bool {
+            if (!insertResult.valid()) {
+                return true;
+            }
+
+            const Status status = insertResult.get();
+
+            auto& clientInfo = repl::ReplClientInfo::forClient(txn->getClient());
+            if (clientInfo.getLastOp() < lastInsertedOp) {
+                clientInfo.setLastOp(lastInsertedOp);
+            }
+
+            if (!status.isOK()) {
+                errmsg = status.reason();
+                error() << errmsg << migrateLog;
+                return false;
+            }
+
+            return true;
+        };
+
         while (true) {
             BSONObj res;
             if (!conn->runCommand("admin",
                                   migrateCloneRequest,
                                   res)) {  // gets array of objects to copy, in disk order
+                // The inserter may still be using the state of this migration.
+                waitForInsert();
+
                 setState(FAIL);
                 errmsg = "_migrateClone failed: ";
                 errmsg += res.toString();
@@ -620,66 +677,22 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
                 return;
             }
 
-            BSONObj arr = res["objects"].Obj();
-            int thisTime = 0;
-
-            BSONObjIterator i(arr);
-            while (i.more()) {
-                txn->checkForInterrupt();
-
-                if (getState() == ABORT) {
-                    errmsg = str::stream() << "Migration abort requested while "
-                                           << "copying documents";
-                    error() << errmsg << migrateLog;
-                    return;
-                }
-
-                BSONObj docToClone = i.next().Obj();
-                {
-                    OldClientWriteContext cx(txn, ns);
-
-                    BSONObj localDoc;
-                    if (willOverrideLocalId(
-                            txn, ns, min, max, shardKeyPattern, cx.db(), docToClone, &localDoc)) {
-                        string errMsg = str::stream() << "cannot migrate chunk, local document "
-                                                      << localDoc << " has same _id as cloned "
-                                                      << "remote document " << docToClone;
-
-                        warning() << errMsg;
-
-                        // Exception will abort migration cleanly
-                        uasserted(16976, errMsg);
-                    }
-
-                    Helpers::upsert(txn, ns, docToClone, true);
-                }
-                thisTime++;
+            if (!waitForInsert()) {
+                return;
+            }
 
-                {
-                    stdx::lock_guard<stdx::mutex> statsLock(_mutex);
-                    _numCloned++;
-                    _clonedBytes += docToClone.objsize();
-                }
+            txn->checkForInterrupt();
 
-                if (writeConcern.shouldWaitForOtherNodes()) {
-                    repl::ReplicationCoordinator::StatusAndDuration replStatus =
-                        repl::getGlobalReplicationCoordinator()->awaitReplication(
-                            txn,
-                            repl::ReplClientInfo::forClient(txn->getClient()).getLastOp(),
-                            writeConcern);
-                    if (replStatus.status.code() == ErrorCodes::WriteConcernFailed) {
-                        warning() << "secondaryThrottle on, but doc insert timed out; "
-                                     "continuing";
-                    } else {
-                        massertStatusOK(replStatus.status);
-                    }
-                }
+            BSONObj arr = res["objects"].Obj();
+            if (arr.isEmpty()) {
+                break;
             }
 
-            if (thisTime == 0)
-                break;
+            insertResult = stdx::async(stdx::launch::async, insertBatch, arr);
         }
 
+        timing.setCloneStats(_getNumCloned(), _getClonedBytes(), cloneTimer.millis());
+
         timing.done(3);
 
         MONGO_FAIL_POINT_PAUSE_WHILE_SET(migrateThreadHangAtStep3);
@@ -961,6 +974,124 @@ bool MigrationDestinationManager::_flushPendingWrites(OperationContext* txn,
     return true;
 }
 
+Status MigrationDestinationManager::_insertCloneBatch(OperationContext* txn,
+                                                     const string& ns,
+                                                     const BSONObj& min,
+                                                     const BSONObj& max,
+                                                     const BSONObj& shardKeyPattern,
+                                                     const WriteConcernOptions& writeConcern,
+                                                     const BSONObj& arr) {
+    std::vector<BSONObj> docs;
+    for (const BSONElement& elem : arr) {
+        docs.push_back(elem.Obj());
+    }
+
+    auto batchBegin = docs.begin();
+    while (batchBegin != docs.end()) {
+        txn->checkForInterrupt();
+
+        if (getState() == ABORT) {
+            return Status(ErrorCodes::OperationFailed,
+                          "Migration abort requested while copying documents");
+        }
+
+        // Limit the batch size, larger batches are more efficient but smaller ones yield the
+        // collection lock more often and are less likely to conflict with other writes.
+        // A batch always takes at least one document.
+        auto batchEnd = batchBegin;
+        long long batchBytes = 0;
+        do {
+            batchBytes += batchEnd->objsize();
+            ++batchEnd;
+        } while (batchEnd != docs.end() && batchEnd - batchBegin < kMaxCloneBatchDocs &&
+                 batchBytes < insertVectorMaxBytes);
+
+        {
+            OldClientWriteContext cx(txn, ns);
+
+            Collection* const collection = cx.db()->getCollection(ns);
+            uassert(ErrorCodes::NamespaceNotFound,
+                    str::stream() << "collection dropped during migration: " << ns,
+                    collection);
+
+            for (auto it = batchBegin; it != batchEnd; ++it) {
+                BSONObj localDoc;
+                if (willOverrideLocalId(
+                        txn, ns, min, max, shardKeyPattern, cx.db(), *it, &localDoc)) {
+                    string errMsg = str::stream() << "cannot migrate chunk, local document "
+                                                  << localDoc << " has same _id as cloned "
+                                                  << "remote document " << *it;
+
+                    warning() << errMsg;
+
+                    // Exception will abort migration cleanly
+                    uasserted(16976, errMsg);
+                }
+            }
+
+            bool inserted = false;
+            try {
+                WriteUnitOfWork wunit(txn);
+                uassertStatusOK(collection->insertDocuments(
+                    txn, batchBegin, batchEnd, true /* enforceQuota */, true /* fromMigrate */));
+                wunit.commit();
+                inserted = true;
+            } catch (const UserException& ex) {
+                // A killed or timed out migration must stop, not go on one document at a time.
+                if (ErrorCodes::isInterruption(ErrorCodes::fromInt(ex.getCode()))) {
+                    throw;
+                }
+                txn->recoveryUnit()->abandonSnapshot();
+            } catch (const WriteConflictException&) {
+                txn->recoveryUnit()->abandonSnapshot();
+                WriteConflictException::logAndBackoff(0, "migrate clone", ns);
+            }
+
+            if (!inserted) {
+                // A document may already be there, or a write conflicted with the batch, so fall
+                // back to upserting the documents one at a time.
+                for (auto it = batchBegin; it != batchEnd; ++it) {
+                    Helpers::upsert(txn, ns, *it, true);
+                }
+            }
+        }
+
+        {
+            stdx::lock_guard<stdx::mutex> statsLock(_mutex);
+            _numCloned += batchEnd - batchBegin;
+            _clonedBytes += batchBytes;
+        }
+
+        if (writeConcern.shouldWaitForOtherNodes()) {
+            repl::ReplicationCoordinator::StatusAndDuration replStatus =
+                repl::getGlobalReplicationCoordinator()->awaitReplication(
+                    txn,
+                    repl::ReplClientInfo::forClient(txn->getClient()).getLastOp(),
+                    writeConcern);
+            if (replStatus.status.code() == ErrorCodes::WriteConcernFailed) {
+                warning() << "secondaryThrottle on, but doc insert timed out; "
+                             "continuing";
+            } else {
+                massertStatusOK(replStatus.status);
+            }
+        }
+
+        batchBegin = batchEnd;
+    }
+
+    return Status::OK();
+}
+
+long long MigrationDestinationManager::_getNumCloned() const {
+    stdx::lock_guard<stdx::mutex> sl(_mutex);
+    return _numCloned;
+}
+
+long long MigrationDestinationManager::_getClonedBytes() const {
+    stdx::lock_guard<stdx::mutex> sl(_mutex);
+    return _clonedBytes;
+}
+
 MoveTimingHelper::MoveTimingHelper(OperationContext* txn,
                                    const string& where,
                                    const string& ns,
@@ -1011,6 +1142,13 @@ MoveTimingHelper::~MoveTimingHelper() {
     }
 }
 
+void MoveTimingHelper::setCloneStats(long long numDocs, long long numBytes, long long millis) {
+    _b.append("clonedDocs", numDocs);
+    _b.append("clonedBytes", numBytes);
+    _b.append("cloneMillis", millis);
+    _b.append("cloneBytesPerSec", millis > 0 ? numBytes * 1000 / millis : numBytes);
+}
+
 void MoveTimingHelper::done(int step) {
     invariant(step == ++_nextStep);
     invariant(step <= _totalNumSteps);
@@ -119,6 +119,22 @@ private:
                          const BSONObj& xfer,
                          repl::OpTime* lastOpApplied);
 
+    /**
+     * Inserts the documents of a batch returned by _migrateClone, several at a time, and waits
+     * for them to replicate if the write concern asks for it. Returns an error if the migration
+     * was aborted in the meantime.
+     */
+    Status _insertCloneBatch(OperationContext* txn,
+                             const std::string& ns,
+                             const BSONObj& min,
+                             const BSONObj& max,
+                             const BSONObj& shardKeyPattern,
+                             const WriteConcernOptions& writeConcern,
+                             const BSONObj& arr);
+
+    long long _getNumCloned() const;
+    long long _getClonedBytes() const;
+
     bool _flushPendingWrites(OperationContext* txn,
                              const std::string& ns,
                              BSONObj min,
@@ -168,6 +184,12 @@ public:
 
     void done(int step);
 
+    /**
+     * Records the number of documents and bytes copied by the initial clone, and its throughput
+     * given that it took 'millis'.
+     */
+    void setCloneStats(long long numDocs, long long numBytes, long long millis);
+
 private:
     // Measures how long the receiving of a chunk takes
     Timer _t;
@@ -330,6 +330,8 @@ public:
         // Track last result from TO shard for sanity check
         BSONObj res;
 
+        const Timer transferTimer;
+
         // Don't want a single chunk move to take more than a day
         for (int i = 0; i < 86400; i++) {
             invariant(!txn->lockState()->isLocked());
@@ -428,6 +430,15 @@ public:
             }
         }
 
+        // The recipient reports how much it cloned, which took at most as long as it took to get
+        // to the steady state.
+        if (res["counts"].isABSONObj()) {
+            const BSONObj counts = res["counts"].Obj();
+            timing.setCloneStats(counts["cloned"].numberLong(),
+                                 counts["clonedBytes"].numberLong(),
+                                 transferTimer.millis());
+        }
+
         timing.done(4);
 
         distLockStatus = distLock->checkForPendingCatalogChange();
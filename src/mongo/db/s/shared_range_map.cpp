@@ -0,0 +1,175 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/shared_range_map.h"
+
+#include <algorithm>
+
+namespace mongo {
+
+namespace {
+
+bool rangeMinLess(const SharedRangeMap::value_type& range, const BSONObj& min) {
+    return range.first.woCompare(min) < 0;
+}
+
+bool rangeMinGreater(const BSONObj& min, const SharedRangeMap::value_type& range) {
+    return min.woCompare(range.first) < 0;
+}
+
+}  // namespace
+
+const size_t SharedRangeMap::kMaxSegmentSize;
+
+SharedRangeMap::const_iterator& SharedRangeMap::const_iterator::operator++() {
+    if (++_offset == _map->_segments[_segment]->size()) {
+        ++_segment;
+        _offset = 0;
+    }
+    return *this;
+}
+
+SharedRangeMap::const_iterator& SharedRangeMap::const_iterator::operator--() {
+    if (_offset == 0) {
+        --_segment;
+        _offset = _map->_segments[_segment]->size();
+    }
+    --_offset;
+    return *this;
+}
+
+void SharedRangeMap::clear() {
+    _segments.clear();
+    _size = 0;
+}
+
+SharedRangeMap::const_iterator SharedRangeMap::find(const BSONObj& min) const {
+    const_iterator it = lower_bound(min);
+    if (it == end() || it->first.woCompare(min) != 0) {
+        return end();
+    }
+    return it;
+}
+
+SharedRangeMap::const_iterator SharedRangeMap::lower_bound(const BSONObj& min) const {
+    const size_t index = _findSegment(min, false);
+    if (index == _segments.size()) {
+        return end();
+    }
+
+    const Segment& segment = *_segments[index];
+    auto it = std::lower_bound(segment.begin(), segment.end(), min, rangeMinLess);
+    return const_iterator(this, index, it - segment.begin());
+}
+
+SharedRangeMap::const_iterator SharedRangeMap::upper_bound(const BSONObj& min) const {
+    const size_t index = _findSegment(min, true);
+    if (index == _segments.size()) {
+        return end();
+    }
+
+    const Segment& segment = *_segments[index];
+    auto it = std::upper_bound(segment.begin(), segment.end(), min, rangeMinGreater);
+    return const_iterator(this, index, it - segment.begin());
+}
+
+bool SharedRangeMap::insert(const value_type& range) {
+    if (_segments.empty()) {
+        _segments.push_back(std::make_shared<Segment>(1, range));
+        _size = 1;
+        return true;
+    }
+
+    // Ranges past the end of the map are appended to the last segment
+    const size_t index = std::min(_findSegment(range.first, false), _segments.size() - 1);
+
+    const Segment& current = *_segments[index];
+    auto it = std::lower_bound(current.begin(), current.end(), range.first, rangeMinLess);
+    if (it != current.end() && it->first.woCompare(range.first) == 0) {
+        return false;
+    }
+
+    const size_t offset = it - current.begin();
+    Segment* segment = _getMutableSegment(index);
+    segment->insert(segment->begin() + offset, range);
+    ++_size;
+
+    if (segment->size() > kMaxSegmentSize) {
+        const auto middle = segment->begin() + segment->size() / 2;
+        auto upperHalf = std::make_shared<Segment>(middle, segment->end());
+        segment->erase(middle, segment->end());
+        _segments.insert(_segments.begin() + index + 1, std::move(upperHalf));
+    }
+
+    return true;
+}
+
+size_t SharedRangeMap::erase(const BSONObj& min) {
+    const size_t index = _findSegment(min, false);
+    if (index == _segments.size()) {
+        return 0;
+    }
+
+    const Segment& current = *_segments[index];
+    auto it = std::lower_bound(current.begin(), current.end(), min, rangeMinLess);
+    if (it == current.end() || it->first.woCompare(min) != 0) {
+        return 0;
+    }
+
+    if (current.size() == 1) {
+        _segments.erase(_segments.begin() + index);
+    } else {
+        const size_t offset = it - current.begin();
+        Segment* segment = _getMutableSegment(index);
+        segment->erase(segment->begin() + offset);
+    }
+
+    --_size;
+    return 1;
+}
+
+size_t SharedRangeMap::getNumSharedSegments(const SharedRangeMap& other) const {
+    size_t numShared = 0;
+    for (const auto& segment : _segments) {
+        if (std::find(other._segments.begin(), other._segments.end(), segment) !=
+            other._segments.end()) {
+            ++numShared;
+        }
+    }
+    return numShared;
+}
+
+size_t SharedRangeMap::_findSegment(const BSONObj& min, bool strict) const {
+    // Segments are ordered and never empty, so they can be searched by their last range
+    auto it = std::partition_point(_segments.begin(),
+                                   _segments.end(),
+                                   [&](const std::shared_ptr<Segment>& segment) {
+                                       const int cmp = segment->back().first.woCompare(min);
+                                       return strict ? cmp <= 0 : cmp < 0;
+                                   });
+    return it - _segments.begin();
+}
+
+SharedRangeMap::Segment* SharedRangeMap::_getMutableSegment(size_t index) {
+    std::shared_ptr<Segment>& segment = _segments[index];
+    if (segment.use_count() > 1) {
+        segment = std::make_shared<Segment>(*segment);
+    }
+    return segment.get();
+}
+
+}  // namespace mongo
@@ -0,0 +1,160 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+
+/**
+ * A map of [min, max) ranges keyed by their min, with the subset of the std::map interface used by
+ * the range arithmetic functions (see range_arithmetic.h). Unlike a RangeMap, copies of the map are
+ * structurally shared: the ranges are stored in sorted segments of bounded size which are only
+ * copied when a map that shares them is modified. Copying the map is therefore proportional to the
+ * number of segments, and every insertion or removal only copies the segment it touches.
+ *
+ * This lets shards build the metadata of a new collection version from the previous one at a cost
+ * proportional to the number of changed chunks, rather than the total number of chunks.
+ *
+ * Like the standard containers, concurrent reads are safe, but the map must not be modified while
+ * it is read or copied. Iterators are invalidated by any modification.
+ */
+class SharedRangeMap {
+public:
+    typedef std::pair<BSONObj, BSONObj> value_type;
+
+    class const_iterator : public std::iterator<std::bidirectional_iterator_tag, value_type> {
+    public:
+        const_iterator() = default;
+
+        const value_type& operator*() const {
+            return (*_map->_segments[_segment])[_offset];
+        }
+
+        const value_type* operator->() const {
+            return &**this;
+        }
+
+        const_iterator& operator++();
+        const_iterator& operator--();
+
+        const_iterator operator++(int) {
+            const_iterator it = *this;
+            ++*this;
+            return it;
+        }
+
+        const_iterator operator--(int) {
+            const_iterator it = *this;
+            --*this;
+            return it;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return _segment == other._segment && _offset == other._offset;
+        }
+
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class SharedRangeMap;
+
+        const_iterator(const SharedRangeMap* map, size_t segment, size_t offset)
+            : _map(map), _segment(segment), _offset(offset) {}
+
+        const SharedRangeMap* _map = nullptr;
+        size_t _segment = 0;
+        size_t _offset = 0;
+    };
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    void clear();
+
+    const_iterator begin() const {
+        return const_iterator(this, 0, 0);
+    }
+
+    const_iterator end() const {
+        return const_iterator(this, _segments.size(), 0);
+    }
+
+    /**
+     * Same semantics as the std::map methods of the same name.
+     */
+    const_iterator find(const BSONObj& min) const;
+    const_iterator lower_bound(const BSONObj& min) const;
+    const_iterator upper_bound(const BSONObj& min) const;
+
+    /**
+     * Adds the range, unless a range with the same min is already present. Returns whether the
+     * range was added.
+     */
+    bool insert(const value_type& range);
+
+    /**
+     * Removes the range starting at 'min', if any. Returns the number of ranges removed.
+     */
+    size_t erase(const BSONObj& min);
+
+    /**
+     * Returns the number of segments in which the ranges are stored. Exposed for testing.
+     */
+    size_t getNumSegments() const {
+        return _segments.size();
+    }
+
+    /**
+     * Returns the number of segments this map shares with 'other'. Exposed for testing.
+     */
+    size_t getNumSharedSegments(const SharedRangeMap& other) const;
+
+private:
+    typedef std::vector<value_type> Segment;
+
+    // Segments are split once they grow beyond this many ranges
+    static const size_t kMaxSegmentSize = 128;
+
+    /**
+     * Returns the index of the first segment whose last range starts at or after 'min' (or after
+     * 'min' if 'strict' is set), or the number of segments if there is none.
+     */
+    size_t _findSegment(const BSONObj& min, bool strict) const;
+
+    /**
+     * Returns the segment at 'index', copying it first if it is shared with another map.
+     */
+    Segment* _getMutableSegment(size_t index);
+
+    std::vector<std::shared_ptr<Segment>> _segments;
+    size_t _size = 0;
+};
+
+}  // namespace mongo
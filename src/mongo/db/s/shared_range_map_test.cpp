@@ -0,0 +1,165 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/shared_range_map.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/range_arithmetic.h"
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using std::make_pair;
+
+BSONObj key(int x) {
+    return BSON("x" << x);
+}
+
+void assertSameRanges(const RangeMap& expected, const SharedRangeMap& actual) {
+    ASSERT_EQUALS(expected.size(), actual.size());
+    ASSERT_EQUALS(expected.empty(), actual.empty());
+
+    auto actualIt = actual.begin();
+    for (auto it = expected.begin(); it != expected.end(); ++it, ++actualIt) {
+        ASSERT(actualIt != actual.end());
+        ASSERT_EQUALS(it->first, actualIt->first);
+        ASSERT_EQUALS(it->second, actualIt->second);
+    }
+    ASSERT(actualIt == actual.end());
+
+    // Iterate backwards as well
+    for (auto it = expected.rbegin(); it != expected.rend(); ++it) {
+        --actualIt;
+        ASSERT_EQUALS(it->first, actualIt->first);
+    }
+    ASSERT(actualIt == actual.begin());
+}
+
+TEST(SharedRangeMap, Empty) {
+    SharedRangeMap ranges;
+    ASSERT(ranges.empty());
+    ASSERT_EQUALS(0U, ranges.size());
+    ASSERT(ranges.begin() == ranges.end());
+    ASSERT(ranges.lower_bound(key(0)) == ranges.end());
+    ASSERT(ranges.upper_bound(key(0)) == ranges.end());
+    ASSERT(ranges.find(key(0)) == ranges.end());
+    ASSERT_EQUALS(0U, ranges.erase(key(0)));
+}
+
+TEST(SharedRangeMap, InsertFindErase) {
+    SharedRangeMap ranges;
+    ASSERT(ranges.insert(make_pair(key(10), key(20))));
+    ASSERT(ranges.insert(make_pair(key(0), key(10))));
+    ASSERT(!ranges.insert(make_pair(key(0), key(5))));
+    ASSERT_EQUALS(2U, ranges.size());
+
+    ASSERT_EQUALS(key(10), ranges.find(key(0))->second);
+    ASSERT(ranges.find(key(5)) == ranges.end());
+    ASSERT_EQUALS(key(10), ranges.lower_bound(key(5))->first);
+    ASSERT_EQUALS(key(10), ranges.upper_bound(key(0))->first);
+    ASSERT(ranges.upper_bound(key(10)) == ranges.end());
+
+    ASSERT_EQUALS(0U, ranges.erase(key(5)));
+    ASSERT_EQUALS(1U, ranges.erase(key(0)));
+    ASSERT_EQUALS(1U, ranges.size());
+    ASSERT_EQUALS(key(10), ranges.begin()->first);
+
+    ranges.clear();
+    ASSERT(ranges.empty());
+}
+
+TEST(SharedRangeMap, MatchesRangeMap) {
+    PseudoRandom random(12345);
+    RangeMap expected;
+    SharedRangeMap actual;
+
+    for (int i = 0; i < 20000; i++) {
+        const int x = random.nextInt32(2000);
+        if (random.nextInt32(3) == 0) {
+            ASSERT_EQUALS(expected.erase(key(x)), actual.erase(key(x)));
+        } else {
+            ASSERT_EQUALS(expected.insert(make_pair(key(x), key(x + 1))).second,
+                          actual.insert(make_pair(key(x), key(x + 1))));
+        }
+
+        const int lookup = random.nextInt32(2002) - 1;
+        auto lower = expected.lower_bound(key(lookup));
+        auto upper = expected.upper_bound(key(lookup));
+        if (lower == expected.end()) {
+            ASSERT(actual.lower_bound(key(lookup)) == actual.end());
+        } else {
+            ASSERT_EQUALS(lower->first, actual.lower_bound(key(lookup))->first);
+        }
+        if (upper == expected.end()) {
+            ASSERT(actual.upper_bound(key(lookup)) == actual.end());
+        } else {
+            ASSERT_EQUALS(upper->first, actual.upper_bound(key(lookup))->first);
+        }
+    }
+
+    assertSameRanges(expected, actual);
+    ASSERT_GREATER_THAN(actual.getNumSegments(), 1U);
+}
+
+TEST(SharedRangeMap, CopiesShareUnchangedSegments) {
+    SharedRangeMap original;
+    RangeMap expected;
+    for (int i = 0; i < 10000; i++) {
+        original.insert(make_pair(key(i * 10), key(i * 10 + 10)));
+        expected.insert(make_pair(key(i * 10), key(i * 10 + 10)));
+    }
+
+    SharedRangeMap copy = original;
+    ASSERT_EQUALS(original.getNumSegments(), copy.getNumSharedSegments(original));
+
+    // Split a chunk in the copy, which only copies the segment it belongs to
+    ASSERT_EQUALS(1U, copy.erase(key(5000)));
+    ASSERT(copy.insert(make_pair(key(5000), key(5005))));
+    ASSERT(copy.insert(make_pair(key(5005), key(5010))));
+    ASSERT_EQUALS(copy.getNumSegments() - 1, copy.getNumSharedSegments(original));
+
+    // The original is not affected
+    assertSameRanges(expected, original);
+
+    expected.erase(key(5000));
+    expected.insert(make_pair(key(5000), key(5005)));
+    expected.insert(make_pair(key(5005), key(5010)));
+    assertSameRanges(expected, copy);
+}
+
+TEST(SharedRangeMap, RangeArithmetic) {
+    SharedRangeMap ranges;
+    ranges.insert(make_pair(key(0), key(10)));
+    ranges.insert(make_pair(key(10), key(20)));
+    ranges.insert(make_pair(key(30), key(40)));
+
+    ASSERT(rangeMapContains(ranges, key(10), key(20)));
+    ASSERT(!rangeMapContains(ranges, key(10), key(15)));
+    ASSERT(rangeMapOverlaps(ranges, key(15), key(35)));
+    ASSERT(!rangeMapOverlaps(ranges, key(20), key(30)));
+
+    RangeVector overlap;
+    getRangeMapOverlap(ranges, key(5), key(35), &overlap);
+    ASSERT_EQUALS(3U, overlap.size());
+    ASSERT_EQUALS(key(0), overlap.front().first);
+    ASSERT_EQUALS(key(40), overlap.back().second);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -55,6 +55,9 @@ struct ServerGlobalParams {
           doFork(0),
           socket("/tmp"),
           maxConns(DEFAULT_MAX_CONN),
+          serviceExecutor("synchronous"),
+          reactorIOThreads(DEFAULT_REACTOR_IO_THREADS),
+          reactorWorkerThreads(DEFAULT_REACTOR_WORKER_THREADS),
           unixSocketPermissions(DEFAULT_UNIX_PERMS),
           logAppend(false),
           logRenameOnRotate(true),
@@ -98,6 +101,13 @@ struct ServerGlobalParams {
 
     int maxConns;  // Maximum number of simultaneous open connections.
 
+    // How incoming connections are serviced: "synchronous" dedicates a thread to every
+    // connection, "reactor" multiplexes connections on a few asio event loops and hands
+    // complete requests to a bounded pool of worker threads.
+    std::string serviceExecutor;  // --serviceExecutor
+    int reactorIOThreads;         // --reactorIOThreads
+    int reactorWorkerThreads;     // --reactorWorkerThreads
+
     int unixSocketPermissions;  // permissions for the UNIX domain socket
 
     std::string keyFile;  // Path to keyfile, or empty if none.
@@ -53,8 +53,10 @@
 #include "mongo/util/map_util.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/listen.h"  // For DEFAULT_MAX_CONN
+#include "mongo/util/net/message_compressor_registry.h"
 #include "mongo/util/net/ssl_options.h"
 #include "mongo/util/options_parser/startup_options.h"
+#include "mongo/util/stringutils.h"
 
 using std::endl;
 using std::string;
@@ -112,12 +114,19 @@ CODE facilitynames[] = {{"auth", LOG_AUTH},
 Status addGeneralServerOptions(moe::OptionSection* options) {
     StringBuilder portInfoBuilder;
     StringBuilder maxConnInfoBuilder;
+    StringBuilder reactorIOThreadsInfoBuilder;
+    StringBuilder reactorWorkerThreadsInfoBuilder;
     std::stringstream unixSockPermsBuilder;
 
     portInfoBuilder << "specify port number - " << ServerGlobalParams::DefaultDBPort
                     << " by default";
     maxConnInfoBuilder << "max number of simultaneous connections - " << DEFAULT_MAX_CONN
                        << " by default";
+    reactorIOThreadsInfoBuilder << "number of event loop threads for serviceExecutor=reactor - "
+                                << DEFAULT_REACTOR_IO_THREADS << " by default";
+    reactorWorkerThreadsInfoBuilder << "number of request worker threads for "
+                                    << "serviceExecutor=reactor - "
+                                    << DEFAULT_REACTOR_WORKER_THREADS << " by default";
     unixSockPermsBuilder << "permissions to set on UNIX domain socket file - "
                          << "0" << std::oct << DEFAULT_UNIX_PERMS << " by default";
 
@@ -206,6 +215,37 @@ Status addGeneralServerOptions(moe::OptionSection* options) {
     options->addOptionChaining(
         "net.maxIncomingConnections", "maxConns", moe::Int, maxConnInfoBuilder.str().c_str());
 
+    options->addOptionChaining("net.serviceExecutor",
+                               "serviceExecutor",
+                               moe::String,
+                               "how connections are serviced: one thread per connection "
+                               "(synchronous, the default) or asio event loops dispatching to a "
+                               "worker pool (reactor)")
+        .format("(:?synchronous)|(:?reactor)", "(synchronous/reactor)");
+
+    options->addOptionChaining("net.reactor.ioThreads",
+                               "reactorIOThreads",
+                               moe::Int,
+                               reactorIOThreadsInfoBuilder.str().c_str());
+
+    options->addOptionChaining("net.reactor.workerThreads",
+                               "reactorWorkerThreads",
+                               moe::Int,
+                               reactorWorkerThreadsInfoBuilder.str().c_str());
+
+    options->addOptionChaining("net.compression.compressors",
+                               "networkMessageCompressors",
+                               moe::String,
+                               "comma separated list of compressors to offer for network messages, "
+                               "most preferred first (snappy, zlib), or 'disabled' - defaults to "
+                               "snappy");
+
+    options->addOptionChaining("net.compression.thresholdBytes",
+                               "networkMessageCompressionThresholdBytes",
+                               moe::Int,
+                               "network messages with a smaller body are sent uncompressed - "
+                               "defaults to 1024");
+
     options->addOptionChaining(
                  "logpath",
                  "logpath",
@@ -823,6 +863,54 @@ Status storeServerOptions(const moe::Environment& params, const std::vector<std:
         }
     }
 
+    if (params.count("net.serviceExecutor")) {
+        serverGlobalParams.serviceExecutor = params["net.serviceExecutor"].as<std::string>();
+#ifdef _WIN32
+        if (serverGlobalParams.serviceExecutor == "reactor") {
+            return Status(ErrorCodes::BadValue,
+                          "serviceExecutor=reactor is not supported on Windows");
+        }
+#endif
+    }
+
+    if (params.count("net.reactor.ioThreads")) {
+        serverGlobalParams.reactorIOThreads = params["net.reactor.ioThreads"].as<int>();
+
+        if (serverGlobalParams.reactorIOThreads < 1) {
+            return Status(ErrorCodes::BadValue, "reactorIOThreads has to be at least 1");
+        }
+    }
+
+    if (params.count("net.reactor.workerThreads")) {
+        serverGlobalParams.reactorWorkerThreads = params["net.reactor.workerThreads"].as<int>();
+
+        if (serverGlobalParams.reactorWorkerThreads < 1) {
+            return Status(ErrorCodes::BadValue, "reactorWorkerThreads has to be at least 1");
+        }
+    }
+
+    if (params.count("net.compression.compressors")) {
+        const auto compressors = params["net.compression.compressors"].as<std::string>();
+        std::vector<std::string> names;
+        if (compressors != "disabled") {
+            splitStringDelim(compressors, &names, ',');
+        }
+
+        Status status = MessageCompressorRegistry::get().setEnabledCompressors(names);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    if (params.count("net.compression.thresholdBytes")) {
+        const int threshold = params["net.compression.thresholdBytes"].as<int>();
+        if (threshold < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "networkMessageCompressionThresholdBytes can't be negative");
+        }
+        MessageCompressorRegistry::get().setThresholdBytes(threshold);
+    }
+
     if (params.count("net.wireObjectCheck")) {
         serverGlobalParams.objcheck = params["net.wireObjectCheck"].as<bool>();
     }
@@ -424,7 +424,7 @@ public:
     NoLimitSorter(const SortOptions& opts,
                   const Comparator& comp,
                   const Settings& settings = Settings())
-        : _comp(comp), _settings(settings), _opts(opts), _memUsed(0) {
+        : _comp(comp), _settings(settings), _opts(opts), _memUsed(0), _bytesSpilled(0) {
         verify(_opts.limit == 0);
     }
 
@@ -455,6 +455,9 @@ public:
     size_t memUsed() const {
         return _memUsed;
     }
+    unsigned long long bytesSpilled() const {
+        return _bytesSpilled;
+    }
 
 private:
     class STLComparator {
@@ -502,6 +505,7 @@ private:
         }
 
         _iters.push_back(std::shared_ptr<Iterator>(writer.done()));
+        _bytesSpilled += writer.bytesWritten();
 
         _memUsed = 0;
     }
@@ -510,6 +514,7 @@ private:
     const Settings _settings;
     SortOptions _opts;
     size_t _memUsed;
+    unsigned long long _bytesSpilled;
     std::deque<Data> _data;                         // the "current" data
     std::vector<std::shared_ptr<Iterator>> _iters;  // data that has already been spilled
 };
@@ -556,6 +561,9 @@ public:
     size_t memUsed() const {
         return _best.first.memUsageForSorter() + _best.second.memUsageForSorter();
     }
+    unsigned long long bytesSpilled() const {
+        return 0;
+    }
 
 private:
     const Comparator _comp;
@@ -578,6 +586,7 @@ public:
           _settings(settings),
           _opts(opts),
           _memUsed(0),
+          _bytesSpilled(0),
           _haveCutoff(false),
           _worstCount(0),
           _medianCount(0) {
@@ -652,6 +661,9 @@ public:
     size_t memUsed() const {
         return _memUsed;
     }
+    unsigned long long bytesSpilled() const {
+        return _bytesSpilled;
+    }
 
 private:
     class STLComparator {
@@ -782,6 +794,7 @@ private:
         std::vector<Data>().swap(_data);
 
         _iters.push_back(std::shared_ptr<Iterator>(writer.done()));
+        _bytesSpilled += writer.bytesWritten();
 
         _memUsed = 0;
     }
@@ -790,6 +803,7 @@ private:
     const Settings _settings;
     SortOptions _opts;
     size_t _memUsed;
+    unsigned long long _bytesSpilled;
     std::vector<Data> _data;  // the "current" data. Organized as max-heap if size == limit.
     std::vector<std::shared_ptr<Iterator>> _iters;  // data that has already been spilled
 
@@ -816,7 +830,7 @@ inline unsigned nextFileNumber() {
 
 template <typename Key, typename Value>
 SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts, const Settings& settings)
-    : _settings(settings) {
+    : _settings(settings), _bytesWritten(0) {
     namespace str = mongoutils::str;
 
     // This should be checked by consumers, but if we get here don't allow writes.
@@ -899,6 +913,7 @@ void SortedFileWriter<Key, Value>::spill() {
     try {
         _file.write(reinterpret_cast<const char*>(&size), sizeof(size));
         _file.write(outBuffer, std::abs(size));
+        _bytesWritten += sizeof(size) + std::abs(size);
 
     } catch (const std::exception&) {
         msgasserted(16821,
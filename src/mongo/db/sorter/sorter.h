@@ -173,6 +173,7 @@ public:
     // TEMP these are here for compatibility. Will be replaced with a general stats API
     virtual int numFiles() const = 0;
     virtual size_t memUsed() const = 0;
+    virtual unsigned long long bytesSpilled() const = 0;
 
 protected:
     Sorter() {}  // can only be constructed as a base
@@ -193,10 +194,16 @@ public:
     void addAlreadySorted(const Key&, const Value&);
     Iterator* done();  /// Can't add more data after calling done()
 
+    /// Bytes written to the file so far, after compression.
+    unsigned long long bytesWritten() const {
+        return _bytesWritten;
+    }
+
 private:
     void spill();
 
     const Settings _settings;
+    unsigned long long _bytesWritten;
     std::string _fileName;
     std::shared_ptr<sorter::FileDeleter> _fileDeleter;  // Must outlive _file
     std::ofstream _file;
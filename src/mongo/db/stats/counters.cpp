@@ -158,8 +158,61 @@ void NetworkCounter::append(BSONObjBuilder& b) {
     b.append("numRequests", static_cast<long long>(_requests.loadRelaxed()));
 }
 
+void ServiceExecutorCounter::gotConnection() {
+    _connections.fetchAndAdd(1);
+}
+
+void ServiceExecutorCounter::closedConnection() {
+    _connections.fetchAndSubtract(1);
+}
+
+void ServiceExecutorCounter::enqueued() {
+    _queueDepth.fetchAndAdd(1);
+    _tasksEnqueued.fetchAndAdd(1);
+}
+
+void ServiceExecutorCounter::dequeued(long long waitMicros) {
+    _queueDepth.fetchAndSubtract(1);
+    _totalWaitMicros.fetchAndAdd(waitMicros);
+
+    // don't care about the race as its just a high water mark
+    if (waitMicros > _maxWaitMicros.loadRelaxed()) {
+        _maxWaitMicros.store(waitMicros);
+    }
+}
+
+void ServiceExecutorCounter::ran(long long requests, long long runMicros) {
+    _tasksRun.fetchAndAdd(1);
+    _requests.fetchAndAdd(requests);
+    _totalRunMicros.fetchAndAdd(runMicros);
+}
+
+void ServiceExecutorCounter::setWorkerStatsAppender(
+    stdx::function<void(BSONObjBuilder&)> appender) {
+    stdx::lock_guard<stdx::mutex> lk(_workerStatsMutex);
+    _workerStatsAppender = std::move(appender);
+}
+
+void ServiceExecutorCounter::append(BSONObjBuilder& b) {
+    b.append("connections", static_cast<long long>(_connections.loadRelaxed()));
+    b.append("queueDepth", static_cast<long long>(_queueDepth.loadRelaxed()));
+    b.append("tasksEnqueued", static_cast<long long>(_tasksEnqueued.loadRelaxed()));
+    b.append("tasksRun", static_cast<long long>(_tasksRun.loadRelaxed()));
+    b.append("requests", static_cast<long long>(_requests.loadRelaxed()));
+    b.append("totalQueueWaitMicros", static_cast<long long>(_totalWaitMicros.loadRelaxed()));
+    b.append("maxQueueWaitMicros", static_cast<long long>(_maxWaitMicros.loadRelaxed()));
+    b.append("totalRunMicros", static_cast<long long>(_totalRunMicros.loadRelaxed()));
+
+    stdx::lock_guard<stdx::mutex> lk(_workerStatsMutex);
+    if (_workerStatsAppender) {
+        BSONObjBuilder workers(b.subobjStart("workers"));
+        _workerStatsAppender(workers);
+    }
+}
+
 
 OpCounters globalOpCounters;
 OpCounters replOpCounters;
 NetworkCounter networkCounter;
+ServiceExecutorCounter serviceExecutorCounter;
 }
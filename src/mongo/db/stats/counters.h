@@ -32,6 +32,8 @@
 #include "mongo/platform/basic.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/concurrency/spin_lock.h"
@@ -106,4 +108,44 @@ private:
 };
 
 extern NetworkCounter networkCounter;
+
+/**
+ * Counters for the reactor service executor (--serviceExecutor=reactor), which multiplexes
+ * client connections on a few event loops and hands requests to a bounded worker pool.
+ */
+class ServiceExecutorCounter {
+public:
+    void gotConnection();
+    void closedConnection();
+
+    // A connection became readable and was queued for a worker.
+    void enqueued();
+
+    // A worker picked up a queued connection after it waited "waitMicros" in the queue.
+    void dequeued(long long waitMicros);
+
+    // A worker finished servicing "requests" messages on a connection in "runMicros".
+    void ran(long long requests, long long runMicros);
+
+    // Registers the function which appends the state of the worker pool, as a "workers"
+    // subobject, to the counters.
+    void setWorkerStatsAppender(stdx::function<void(BSONObjBuilder&)> appender);
+
+    void append(BSONObjBuilder& b);
+
+private:
+    stdx::mutex _workerStatsMutex;
+    stdx::function<void(BSONObjBuilder&)> _workerStatsAppender;
+
+    AtomicInt64 _connections;
+    AtomicInt64 _queueDepth;
+    AtomicInt64 _tasksEnqueued;
+    AtomicInt64 _tasksRun;
+    AtomicInt64 _requests;
+    AtomicInt64 _totalWaitMicros;
+    AtomicInt64 _maxWaitMicros;
+    AtomicInt64 _totalRunMicros;
+};
+
+extern ServiceExecutorCounter serviceExecutorCounter;
 }
@@ -0,0 +1,308 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_shape_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(queryShapeStatsMaxShapes, int, 1000);
+
+MONGO_EXPORT_SERVER_PARAMETER(queryShapeStatsFTDCTopN, int, 10);
+
+namespace {
+
+const auto getQueryShapeStats = ServiceContext::declareDecoration<QueryShapeStats>();
+
+long long nonNegative(long long value) {
+    return value < 0 ? 0 : value;
+}
+
+}  // namespace
+
+//
+// LatencyHistogram
+//
+
+// static
+int LatencyHistogram::bucketFor(long long micros) {
+    if (micros < kSubBuckets) {
+        return micros < 0 ? 0 : static_cast<int>(micros);
+    }
+    const int msb = 63 - countLeadingZeros64(static_cast<unsigned long long>(micros));
+    if (msb >= kMaxBits) {
+        return kNumBuckets - 1;
+    }
+    const int sub = static_cast<int>(micros >> (msb - kSubBucketBits)) & (kSubBuckets - 1);
+    return (msb - kSubBucketBits + 1) * kSubBuckets + sub;
+}
+
+// static
+long long LatencyHistogram::lowerBound(int bucket) {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    const int msb = bucket / kSubBuckets + kSubBucketBits - 1;
+    const long long sub = bucket % kSubBuckets;
+    return (kSubBuckets + sub) << (msb - kSubBucketBits);
+}
+
+void LatencyHistogram::record(long long micros) {
+    _buckets[bucketFor(micros)].fetchAndAdd(1);
+}
+
+long long LatencyHistogram::count() const {
+    unsigned long long total = 0;
+    for (int i = 0; i < kNumBuckets; ++i) {
+        total += _buckets[i].load();
+    }
+    return static_cast<long long>(total);
+}
+
+long long LatencyHistogram::percentile(double percentile) const {
+    unsigned long long counts[kNumBuckets];
+    unsigned long long total = 0;
+    for (int i = 0; i < kNumBuckets; ++i) {
+        counts[i] = _buckets[i].load();
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    // The rank of the value at 'percentile', counting from 1.
+    const unsigned long long rank =
+        std::max(1ULL,
+                 static_cast<unsigned long long>(
+                     std::ceil(total * std::min(percentile, 100.0) / 100)));
+    unsigned long long seen = 0;
+    for (int i = 0; i < kNumBuckets; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return i == kNumBuckets - 1 ? lowerBound(i) : lowerBound(i + 1) - 1;
+        }
+    }
+    MONGO_UNREACHABLE;
+}
+
+void LatencyHistogram::appendBuckets(BSONArrayBuilder* arr) const {
+    for (int i = 0; i < kNumBuckets; ++i) {
+        const unsigned long long n = _buckets[i].load();
+        if (n) {
+            arr->append(BSON("micros" << lowerBound(i) << "count" << static_cast<long long>(n)));
+        }
+    }
+}
+
+//
+// QueryShapeMetrics
+//
+
+void QueryShapeMetrics::record(bool isGetMore,
+                               long long micros,
+                               long long keys,
+                               long long docs,
+                               long long returned) {
+    (isGetMore ? getMores : queries).fetchAndAdd(1);
+    keysExamined.fetchAndAdd(nonNegative(keys));
+    docsExamined.fetchAndAdd(nonNegative(docs));
+    nreturned.fetchAndAdd(nonNegative(returned));
+    totalMicros.fetchAndAdd(nonNegative(micros));
+    lastSeenMillis.store(Date_t::now().toMillisSinceEpoch());
+    latency.record(micros);
+}
+
+void QueryShapeMetrics::appendTo(BSONObjBuilder* bob, bool includeHistogram) const {
+    bob->append("ns", ns);
+    bob->append("shape", shape);
+    bob->append("planCacheKey", key);
+    bob->append("queries", static_cast<long long>(queries.load()));
+    bob->append("getMores", static_cast<long long>(getMores.load()));
+    bob->append("keysExamined", static_cast<long long>(keysExamined.load()));
+    bob->append("docsExamined", static_cast<long long>(docsExamined.load()));
+    bob->append("nreturned", static_cast<long long>(nreturned.load()));
+    bob->append("totalMicros", static_cast<long long>(totalMicros.load()));
+    bob->appendDate("lastSeen", Date_t::fromMillisSinceEpoch(lastSeenMillis.load()));
+
+    BSONObjBuilder latencyBuilder(bob->subobjStart("latencyMicros"));
+    latencyBuilder.append("p50", latency.percentile(50));
+    latencyBuilder.append("p90", latency.percentile(90));
+    latencyBuilder.append("p99", latency.percentile(99));
+    latencyBuilder.append("max", latency.percentile(100));
+    if (includeHistogram) {
+        BSONArrayBuilder arr(latencyBuilder.subarrayStart("histogram"));
+        latency.appendBuckets(&arr);
+        arr.doneFast();
+    }
+    latencyBuilder.doneFast();
+}
+
+//
+// QueryShapeStats
+//
+
+// static
+QueryShapeStats& QueryShapeStats::get(ServiceContext* service) {
+    return getQueryShapeStats(service);
+}
+
+QueryShapeStats::QueryShapeStats() = default;
+
+// static
+std::string QueryShapeStats::makeMapKey(StringData ns, StringData key) {
+    std::string mapKey;
+    mapKey.reserve(ns.size() + 1 + key.size());
+    mapKey.append(ns.rawData(), ns.size());
+    mapKey.push_back('\0');
+    mapKey.append(key.rawData(), key.size());
+    return mapKey;
+}
+
+std::shared_ptr<QueryShapeMetrics> QueryShapeStats::getOrCreate(
+    StringData ns, StringData key, const stdx::function<BSONObj()>& makeShape) {
+    const int maxShapes = queryShapeStatsMaxShapes.load();
+    if (maxShapes <= 0) {
+        return {};
+    }
+    const size_t partitionSize = (maxShapes + kNumPartitions - 1) / kNumPartitions;
+
+    std::string mapKey = makeMapKey(ns, key);
+    Partition& partition = _partitions[std::hash<std::string>()(mapKey) % kNumPartitions];
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    auto it = partition.index.find(mapKey);
+    if (it != partition.index.end()) {
+        partition.shapes.splice(partition.shapes.begin(), partition.shapes, it->second);
+        return partition.shapes.front();
+    }
+
+    // The limit may have been lowered at runtime, so more than one shape can have to go.
+    while (!partition.shapes.empty() && partition.shapes.size() >= partitionSize) {
+        const QueryShapeMetrics& victim = *partition.shapes.back();
+        partition.index.erase(makeMapKey(victim.ns, victim.key));
+        partition.shapes.pop_back();
+        _evicted.fetchAndAdd(1);
+    }
+
+    partition.shapes.push_front(
+        std::make_shared<QueryShapeMetrics>(ns.toString(), key.toString(), makeShape()));
+    partition.index.emplace(std::move(mapKey), partition.shapes.begin());
+    return partition.shapes.front();
+}
+
+std::vector<std::shared_ptr<QueryShapeMetrics>> QueryShapeStats::_sortedByLatency(
+    StringData ns) const {
+    std::vector<std::shared_ptr<QueryShapeMetrics>> shapes;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        for (const auto& metrics : partition.shapes) {
+            if (ns.empty() || ns == metrics->ns) {
+                shapes.push_back(metrics);
+            }
+        }
+    }
+
+    // Snapshot the totals, which keep moving while sorting.
+    std::vector<std::pair<unsigned long long, size_t>> order;
+    order.reserve(shapes.size());
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        order.emplace_back(shapes[i]->totalMicros.load(), i);
+    }
+    std::sort(order.begin(), order.end(), [](const std::pair<unsigned long long, size_t>& a,
+                                             const std::pair<unsigned long long, size_t>& b) {
+        return a.first > b.first;
+    });
+
+    std::vector<std::shared_ptr<QueryShapeMetrics>> sorted;
+    sorted.reserve(shapes.size());
+    for (const auto& entry : order) {
+        sorted.push_back(std::move(shapes[entry.second]));
+    }
+    return sorted;
+}
+
+void QueryShapeStats::append(BSONObjBuilder* bob,
+                             StringData ns,
+                             long long limit,
+                             bool includeHistogram) const {
+    auto shapes = _sortedByLatency(ns);
+    BSONArrayBuilder arr(bob->subarrayStart("shapes"));
+    long long appended = 0;
+    for (const auto& metrics : shapes) {
+        if (limit > 0 && appended == limit) {
+            break;
+        }
+        BSONObjBuilder shapeBuilder(arr.subobjStart());
+        metrics->appendTo(&shapeBuilder, includeHistogram);
+        shapeBuilder.doneFast();
+        ++appended;
+    }
+    arr.doneFast();
+    bob->append("numShapes", static_cast<long long>(shapes.size()));
+    bob->append("shapesEvicted", static_cast<long long>(_evicted.load()));
+}
+
+void QueryShapeStats::appendForFTDC(BSONObjBuilder* bob) const {
+    const int topN = queryShapeStatsFTDCTopN.load();
+    auto shapes = _sortedByLatency(StringData());
+    bob->append("numShapes", static_cast<long long>(shapes.size()));
+    bob->append("shapesEvicted", static_cast<long long>(_evicted.load()));
+    if (topN <= 0) {
+        return;
+    }
+
+    BSONObjBuilder topBuilder(bob->subobjStart("top"));
+    for (size_t i = 0; i < shapes.size() && i < static_cast<size_t>(topN); ++i) {
+        const QueryShapeMetrics& metrics = *shapes[i];
+        BSONObjBuilder shapeBuilder(topBuilder.subobjStart(std::to_string(i)));
+        shapeBuilder.append("queries", static_cast<long long>(metrics.queries.load()));
+        shapeBuilder.append("getMores", static_cast<long long>(metrics.getMores.load()));
+        shapeBuilder.append("keysExamined", static_cast<long long>(metrics.keysExamined.load()));
+        shapeBuilder.append("docsExamined", static_cast<long long>(metrics.docsExamined.load()));
+        shapeBuilder.append("nreturned", static_cast<long long>(metrics.nreturned.load()));
+        shapeBuilder.append("totalMicros", static_cast<long long>(metrics.totalMicros.load()));
+        shapeBuilder.append("p50Micros", metrics.latency.percentile(50));
+        shapeBuilder.append("p99Micros", metrics.latency.percentile(99));
+        shapeBuilder.doneFast();
+    }
+    topBuilder.doneFast();
+}
+
+void QueryShapeStats::clear() {
+    for (auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        partition.index.clear();
+        partition.shapes.clear();
+    }
+}
+
+size_t QueryShapeStats::size() const {
+    size_t total = 0;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        total += partition.shapes.size();
+    }
+    return total;
+}
+
+}  // namespace mongo
@@ -0,0 +1,193 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+// Maximum number of query shapes tracked by the server. 0 disables the statistics.
+extern std::atomic<int> queryShapeStatsMaxShapes;  // NOLINT
+
+// Number of shapes, by total latency, included in each full-time diagnostic data capture sample.
+// 0 leaves the shapes out of FTDC.
+extern std::atomic<int> queryShapeStatsFTDCTopN;  // NOLINT
+
+/**
+ * A latency histogram with log-linear buckets, in the spirit of HdrHistogram: each power of two
+ * is split into kSubBuckets buckets, so any value is off by at most 25% from the bounds of its
+ * bucket, for a fixed 1.3KB whatever the range. Recording is a single atomic increment.
+ */
+class LatencyHistogram {
+    MONGO_DISALLOW_COPYING(LatencyHistogram);
+
+public:
+    static const int kSubBucketBits = 2;
+    static const int kSubBuckets = 1 << kSubBucketBits;
+
+    // Values of 2^kMaxBits micros (about 12 days) and above go into the last bucket.
+    static const int kMaxBits = 40;
+    static const int kNumBuckets = (kMaxBits - kSubBucketBits + 1) * kSubBuckets;
+
+    LatencyHistogram() = default;
+
+    void record(long long micros);
+
+    long long count() const;
+
+    /**
+     * Returns the upper bound of the bucket holding the value at 'percentile' (between 0 and
+     * 100), or 0 if nothing was recorded.
+     */
+    long long percentile(double percentile) const;
+
+    /**
+     * Appends the non-empty buckets as an array of {micros: <lower bound>, count: <n>}.
+     */
+    void appendBuckets(BSONArrayBuilder* arr) const;
+
+    static int bucketFor(long long micros);
+    static long long lowerBound(int bucket);
+
+private:
+    AtomicUInt64 _buckets[kNumBuckets];
+};
+
+/**
+ * Execution counters of one query shape. Updated without locks by the operations of the shape,
+ * and kept alive by them even if the shape is evicted from QueryShapeStats meanwhile.
+ */
+class QueryShapeMetrics {
+    MONGO_DISALLOW_COPYING(QueryShapeMetrics);
+
+public:
+    QueryShapeMetrics(std::string ns, std::string key, BSONObj shape)
+        : ns(std::move(ns)), key(std::move(key)), shape(std::move(shape)) {}
+
+    /**
+     * Records one find or getMore of the shape. Negative counts, which OpDebug uses for unset
+     * values, are recorded as 0.
+     */
+    void record(bool isGetMore,
+                long long micros,
+                long long keysExamined,
+                long long docsExamined,
+                long long nreturned);
+
+    void appendTo(BSONObjBuilder* bob, bool includeHistogram) const;
+
+    const std::string ns;
+
+    // The plan cache key of the shape.
+    const std::string key;
+
+    // The filter, sort and projection of the first query seen with the shape.
+    const BSONObj shape;
+
+    AtomicUInt64 queries;
+    AtomicUInt64 getMores;
+    AtomicUInt64 keysExamined;
+    AtomicUInt64 docsExamined;
+    AtomicUInt64 nreturned;
+    AtomicUInt64 totalMicros;
+    AtomicInt64 lastSeenMillis;
+    LatencyHistogram latency;
+};
+
+/**
+ * Bounded in-memory store of per query shape execution statistics, keyed by namespace and plan
+ * cache key. Finds and getMores look their shape up once, when they finish executing, and the
+ * returned QueryShapeMetrics are recorded into with the final latency of the operation.
+ *
+ * The store is split into partitions by a hash of the shape, each with its own mutex and an equal
+ * share of queryShapeStatsMaxShapes. When a partition is full, a new shape replaces its least
+ * recently looked up one.
+ */
+class QueryShapeStats {
+    MONGO_DISALLOW_COPYING(QueryShapeStats);
+
+public:
+    static QueryShapeStats& get(ServiceContext* service);
+
+    QueryShapeStats();
+
+    /**
+     * Returns the metrics for the shape 'key' of 'ns', creating them if needed with the example
+     * shape produced by 'makeShape'. Returns an empty pointer if the statistics are disabled.
+     */
+    std::shared_ptr<QueryShapeMetrics> getOrCreate(StringData ns,
+                                                   StringData key,
+                                                   const stdx::function<BSONObj()>& makeShape);
+
+    /**
+     * Appends the shapes of 'ns', or of all namespaces if 'ns' is empty, as a "shapes" array
+     * sorted by decreasing total latency. At most 'limit' shapes are appended if it is positive.
+     */
+    void append(BSONObjBuilder* bob, StringData ns, long long limit, bool includeHistogram) const;
+
+    /**
+     * Appends the numeric statistics of the queryShapeStatsFTDCTopN shapes with the highest total
+     * latency, keyed by rank so that the sample layout only changes when the number of shapes does.
+     * FTDC only keeps strings in its reference samples, so the shapes themselves are left out and
+     * have to be matched up with the output of append().
+     */
+    void appendForFTDC(BSONObjBuilder* bob) const;
+
+    /**
+     * Forgets all shapes.
+     */
+    void clear();
+
+    size_t size() const;
+
+private:
+    typedef std::list<std::shared_ptr<QueryShapeMetrics>> ShapeList;
+
+    struct Partition {
+        mutable stdx::mutex mutex;
+
+        // From the most to the least recently looked up shape.
+        ShapeList shapes;
+
+        // Position of each shape in 'shapes', by makeMapKey().
+        std::unordered_map<std::string, ShapeList::iterator> index;
+    };
+
+    static const size_t kNumPartitions = 16;
+
+    static std::string makeMapKey(StringData ns, StringData key);
+
+    std::vector<std::shared_ptr<QueryShapeMetrics>> _sortedByLatency(StringData ns) const;
+
+    Partition _partitions[kNumPartitions];
+
+    AtomicUInt64 _evicted;
+};
+
+}  // namespace mongo
@@ -0,0 +1,174 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_shape_stats.h"
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace {
+
+using namespace mongo;
+
+std::shared_ptr<QueryShapeMetrics> getShape(QueryShapeStats* stats,
+                                            StringData ns,
+                                            StringData key) {
+    return stats->getOrCreate(ns, key, [key] { return BSON("filter" << BSON(key << 1)); });
+}
+
+TEST(LatencyHistogramTest, Buckets) {
+    // Small values get a bucket each, then every power of two is split in four.
+    for (long long micros = 0; micros < 4; ++micros) {
+        ASSERT_EQUALS(LatencyHistogram::bucketFor(micros), micros);
+    }
+    ASSERT_EQUALS(LatencyHistogram::bucketFor(4), 4);
+    ASSERT_EQUALS(LatencyHistogram::bucketFor(7), 7);
+    ASSERT_EQUALS(LatencyHistogram::bucketFor(8), 8);
+    ASSERT_EQUALS(LatencyHistogram::bucketFor(9), 8);
+    ASSERT_EQUALS(LatencyHistogram::bucketFor(10), 9);
+    ASSERT_EQUALS(LatencyHistogram::bucketFor(-1), 0);
+    ASSERT_EQUALS(LatencyHistogram::bucketFor(1LL << 50), LatencyHistogram::kNumBuckets - 1);
+
+    // Every value falls between the lower bounds of its bucket and of the next one.
+    for (long long micros = 1; micros < (1LL << 40); micros = micros * 3 / 2 + 1) {
+        int bucket = LatencyHistogram::bucketFor(micros);
+        ASSERT_LESS_THAN_OR_EQUALS(LatencyHistogram::lowerBound(bucket), micros);
+        ASSERT_GREATER_THAN(LatencyHistogram::lowerBound(bucket + 1), micros);
+    }
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+    LatencyHistogram histogram;
+    ASSERT_EQUALS(histogram.percentile(50), 0);
+
+    for (int i = 0; i < 90; ++i) {
+        histogram.record(100);
+    }
+    for (int i = 0; i < 10; ++i) {
+        histogram.record(10000);
+    }
+    ASSERT_EQUALS(histogram.count(), 100);
+
+    // 100 is in [96, 111] and 10000 in [8192, 10239].
+    ASSERT_EQUALS(histogram.percentile(50), 111);
+    ASSERT_EQUALS(histogram.percentile(90), 111);
+    ASSERT_EQUALS(histogram.percentile(91), 10239);
+    ASSERT_EQUALS(histogram.percentile(100), 10239);
+
+    BSONArrayBuilder arr;
+    histogram.appendBuckets(&arr);
+    ASSERT_EQUALS(arr.arr(), BSON_ARRAY(BSON("micros" << 96LL << "count" << 90LL)
+                                        << BSON("micros" << 8192LL << "count" << 10LL)));
+}
+
+TEST(QueryShapeStatsTest, RecordAndList) {
+    QueryShapeStats stats;
+    auto fast = getShape(&stats, "test.a", "fast");
+    auto slow = getShape(&stats, "test.a", "slow");
+    auto other = getShape(&stats, "test.b", "fast");
+    ASSERT_EQUALS(stats.size(), 3U);
+    ASSERT_EQUALS(fast.get(), getShape(&stats, "test.a", "fast").get());
+    ASSERT_NOT_EQUALS(fast.get(), other.get());
+
+    fast->record(false, 10, 1, 1, 1);
+    fast->record(true, 20, -1, 2, 2);
+    slow->record(false, 5000, 100, 200, 0);
+    other->record(false, 1, 0, 0, 0);
+
+    BSONObjBuilder bob;
+    stats.append(&bob, "test.a", 0, false);
+    BSONObj result = bob.obj();
+    ASSERT_EQUALS(result["numShapes"].numberLong(), 2);
+    std::vector<BSONElement> shapes = result["shapes"].Array();
+    ASSERT_EQUALS(shapes.size(), 2U);
+
+    // Sorted by total latency.
+    BSONObj first = shapes[0].Obj();
+    ASSERT_EQUALS(first["planCacheKey"].String(), "slow");
+    ASSERT_EQUALS(first["shape"].Obj(), BSON("filter" << BSON("slow" << 1)));
+
+    BSONObj second = shapes[1].Obj();
+    ASSERT_EQUALS(second["ns"].String(), "test.a");
+    ASSERT_EQUALS(second["queries"].numberLong(), 1);
+    ASSERT_EQUALS(second["getMores"].numberLong(), 1);
+    ASSERT_EQUALS(second["keysExamined"].numberLong(), 1);
+    ASSERT_EQUALS(second["docsExamined"].numberLong(), 3);
+    ASSERT_EQUALS(second["nreturned"].numberLong(), 3);
+    ASSERT_EQUALS(second["totalMicros"].numberLong(), 30);
+    ASSERT_EQUALS(second["latencyMicros"]["max"].numberLong(), 23);
+    ASSERT_FALSE(second["latencyMicros"].Obj().hasField("histogram"));
+
+    BSONObjBuilder limited;
+    stats.append(&limited, "", 1, true);
+    BSONObj limitedResult = limited.obj();
+    ASSERT_EQUALS(limitedResult["numShapes"].numberLong(), 3);
+    shapes = limitedResult["shapes"].Array();
+    ASSERT_EQUALS(shapes.size(), 1U);
+    ASSERT_EQUALS(shapes[0]["latencyMicros"]["histogram"].Array().size(), 1U);
+
+    BSONObjBuilder ftdc;
+    stats.appendForFTDC(&ftdc);
+    BSONObj ftdcResult = ftdc.obj();
+    ASSERT_EQUALS(ftdcResult["top"]["0"]["totalMicros"].numberLong(), 5000);
+    ASSERT_EQUALS(ftdcResult["top"]["2"]["totalMicros"].numberLong(), 1);
+
+    stats.clear();
+    ASSERT_EQUALS(stats.size(), 0U);
+
+    // Metrics held by a running operation stay usable after the shape is gone.
+    fast->record(false, 10, 1, 1, 1);
+    ASSERT_EQUALS(fast->queries.load(), 2U);
+}
+
+TEST(QueryShapeStatsTest, Bounded) {
+    const int oldMaxShapes = queryShapeStatsMaxShapes.load();
+    ON_BLOCK_EXIT([oldMaxShapes] { queryShapeStatsMaxShapes.store(oldMaxShapes); });
+
+    QueryShapeStats stats;
+    queryShapeStatsMaxShapes.store(0);
+    ASSERT_FALSE(getShape(&stats, "test.a", "x"));
+
+    queryShapeStatsMaxShapes.store(32);
+    auto busy = getShape(&stats, "test.a", "busy");
+    std::shared_ptr<QueryShapeMetrics> last;
+    for (int i = 0; i < 1000; ++i) {
+        last = getShape(&stats, "test.a", std::to_string(i));
+
+        // A shape still in use is never the one evicted, however few operations it has.
+        ASSERT_EQUALS(busy.get(), getShape(&stats, "test.a", "busy").get());
+    }
+    ASSERT_LESS_THAN_OR_EQUALS(stats.size(), 32U);
+
+    // Neither is the newest shape.
+    ASSERT_EQUALS(last.get(), getShape(&stats, "test.a", "999").get());
+
+    // Old shapes go first, whatever their number of operations.
+    auto old = getShape(&stats, "test.b", "old");
+    for (int i = 0; i < 10; ++i) {
+        old->record(false, 1, 0, 0, 0);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        getShape(&stats, "test.b", std::to_string(i));
+    }
+    ASSERT_NOT_EQUALS(old.get(), getShape(&stats, "test.b", "old").get());
+
+    BSONObjBuilder bob;
+    stats.append(&bob, "", 0, false);
+    ASSERT_GREATER_THAN_OR_EQUALS(bob.obj()["shapesEvicted"].numberLong(), 2000 + 2 - 32);
+}
+
+}  // namespace
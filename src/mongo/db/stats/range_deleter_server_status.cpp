@@ -38,9 +38,20 @@ namespace mongo {
  * Sample format:
  *
  * rangeDeleter: {
+ *   inProgress: [
+ *     {
+ *       ns: "test.user",
+ *       min: { x: 0 },
+ *       max: { x: 10 },
+ *       deleteStart: ISODate("2014-06-11T22:45:30.221Z"),
+ *       deletedDocs: NumberLong(2000),
+ *       deletedBytes: NumberLong(128000)
+ *     }
+ *   ],
  *   lastDeleteStats: [
  *     {
  *       deleteDocs: NumberLong(5);
+ *       deletedBytes: NumberLong(320);
  *       queueStart: ISODate("2014-06-11T22:45:30.221Z"),
  *       queueEnd: ISODate("2014-06-11T22:45:30.221Z"),
  *       deleteStart: ISODate("2014-06-11T22:45:30.221Z"),
@@ -66,6 +77,14 @@ public:
 
         BSONObjBuilder result;
 
+        std::vector<BSONObj> inProgress;
+        deleter->getInProgressDeletes(&inProgress);
+        BSONArrayBuilder inProgressBuilder(result.subarrayStart("inProgress"));
+        for (const BSONObj& entry : inProgress) {
+            inProgressBuilder.append(entry);
+        }
+        inProgressBuilder.doneFast();
+
         OwnedPointerVector<DeleteJobStats> statsList;
         deleter->getStatsHistory(&statsList.mutableVector());
         BSONArrayBuilder oldStatsBuilder;
@@ -74,6 +93,7 @@ public:
              ++it) {
             BSONObjBuilder entryBuilder;
             entryBuilder.append("deletedDocs", (*it)->deletedDocCount);
+            entryBuilder.append("deletedBytes", (*it)->deletedBytes);
 
             if ((*it)->queueEndTS > Date_t()) {
                 entryBuilder.append("queueStart", (*it)->queueStartTS);
@@ -30,8 +30,54 @@
 
 #include "mongo/db/storage/bson_collection_catalog_entry.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace mongo {
 
+namespace {
+
+/**
+ * Encodes 'multikeyPaths' as a subdocument with one BinData field per field of 'keyPattern',
+ * holding one byte per path component which is 1 if the component traverses an array.
+ */
+void appendMultikeyPathsAsBytes(const BSONObj& keyPattern,
+                                const MultikeyPaths& multikeyPaths,
+                                BSONObjBuilder* subobjBuilder) {
+    size_t i = 0;
+    for (auto&& keyElem : keyPattern) {
+        StringData keyName = keyElem.fieldNameStringData();
+        size_t numParts = std::count(keyName.begin(), keyName.end(), '.') + 1;
+        std::vector<char> multikeyPathsEncodedAsBytes(numParts, 0);
+        for (size_t component : multikeyPaths[i]) {
+            invariant(component < numParts);
+            multikeyPathsEncodedAsBytes[component] = 1;
+        }
+        subobjBuilder->appendBinData(
+            keyName, numParts, BinDataGeneral, multikeyPathsEncodedAsBytes.data());
+        ++i;
+    }
+}
+
+/**
+ * Decodes the subdocument written by appendMultikeyPathsAsBytes() into 'multikeyPaths'.
+ */
+void parseMultikeyPathsFromBytes(const BSONObj& multikeyPathsObj, MultikeyPaths* multikeyPaths) {
+    for (auto&& elem : multikeyPathsObj) {
+        std::set<size_t> multikeyComponents;
+        int len;
+        const char* data = elem.binData(len);
+        for (int i = 0; i < len; ++i) {
+            if (data[i]) {
+                multikeyComponents.insert(i);
+            }
+        }
+        multikeyPaths->push_back(multikeyComponents);
+    }
+}
+
+}  // namespace
+
 BSONCollectionCatalogEntry::BSONCollectionCatalogEntry(StringData ns)
     : CollectionCatalogEntry(ns) {}
 
@@ -77,11 +123,17 @@ void BSONCollectionCatalogEntry::getAllIndexes(OperationContext* txn,
 }
 
 bool BSONCollectionCatalogEntry::isIndexMultikey(OperationContext* txn,
-                                                 StringData indexName) const {
+                                                 StringData indexName,
+                                                 MultikeyPaths* multikeyPaths) const {
     MetaData md = _getMetaData(txn);
 
     int offset = md.findIndexOffset(indexName);
     invariant(offset >= 0);
+
+    if (multikeyPaths) {
+        *multikeyPaths = md.indexes[offset].multikeyPaths;
+    }
+
     return md.indexes[offset].multikey;
 }
 
@@ -160,6 +212,15 @@ BSONObj BSONCollectionCatalogEntry::MetaData::toBSON() const {
             sub.append("spec", indexes[i].spec);
             sub.appendBool("ready", indexes[i].ready);
             sub.appendBool("multikey", indexes[i].multikey);
+
+            if (!indexes[i].multikeyPaths.empty()) {
+                BSONObjBuilder subMultikeyPaths(sub.subobjStart("multikeyPaths"));
+                appendMultikeyPathsAsBytes(indexes[i].spec.getObjectField("key"),
+                                           indexes[i].multikeyPaths,
+                                           &subMultikeyPaths);
+                subMultikeyPaths.doneFast();
+            }
+
             sub.append("head", static_cast<long long>(indexes[i].head.repr()));
             sub.done();
         }
@@ -190,8 +251,8 @@ void BSONCollectionCatalogEntry::MetaData::parse(const BSONObj& obj) {
             }
             imd.multikey = idx["multikey"].trueValue();
 
-            if (idx["multikeyPaths"]) {
-                imd.hasMultikeyPaths = true;
+            if (idx["multikeyPaths"].isABSONObj()) {
+                parseMultikeyPathsFromBytes(idx["multikeyPaths"].Obj(), &imd.multikeyPaths);
             }
 
             indexes.push_back(imd);
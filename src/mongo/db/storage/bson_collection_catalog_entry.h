@@ -57,7 +57,9 @@ public:
 
     virtual void getAllIndexes(OperationContext* txn, std::vector<std::string>* names) const;
 
-    virtual bool isIndexMultikey(OperationContext* txn, StringData indexName) const;
+    virtual bool isIndexMultikey(OperationContext* txn,
+                                 StringData indexName,
+                                 MultikeyPaths* multikeyPaths) const;
 
     virtual RecordId getIndexHead(OperationContext* txn, StringData indexName) const;
 
@@ -81,8 +83,9 @@ public:
         RecordId head;
         bool multikey;
 
-        // Set to true if the index metadata has path-level multikey information.
-        bool hasMultikeyPaths = false;
+        // The path components of each key pattern field which traverse an array. Empty if the
+        // index metadata has no path-level multikey information.
+        MultikeyPaths multikeyPaths;
     };
 
     struct MetaData {
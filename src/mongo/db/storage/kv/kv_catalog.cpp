@@ -156,7 +156,8 @@ Status KVCatalog::FeatureTracker::isCompatibleWithCurrentCode(OperationContext*
     return Status::OK();
 }
 
-Status KVCatalog::FeatureTracker::hasNoFeaturesMarkedAsInUse(OperationContext* opCtx) const {
+Status KVCatalog::FeatureTracker::hasNoFeaturesMarkedAsInUse(
+    OperationContext* opCtx, RepairableFeatureMask ignoredRepairableFeatures) const {
     std::unique_ptr<Lock::ResourceLock> rLk;
     if (!_catalog->_isRsThreadSafe && opCtx->lockState()) {
         rLk = stdx::make_unique<Lock::ResourceLock>(
@@ -164,6 +165,7 @@ Status KVCatalog::FeatureTracker::hasNoFeaturesMarkedAsInUse(OperationContext* o
     }
 
     FeatureBits versionInfo = getInfo(opCtx);
+    versionInfo.repairableFeatures &= ~ignoredRepairableFeatures;
 
     if (versionInfo.nonRepairableFeatures) {
         StringBuilder sb;
@@ -133,8 +133,12 @@ public:
      *
      *   - ErrorCodes::MustUpgrade if a feature is still enabled on some collection or index in the
      *     data files and a newer version is required to start up and downgrade successfully.
+     *
+     * The repairable features in 'ignoredRepairableFeatures' are not considered, which lets the
+     * caller check for features other than the ones the current code maintains itself.
      */
-    Status hasNoFeaturesMarkedAsInUse(OperationContext* opCtx) const;
+    Status hasNoFeaturesMarkedAsInUse(OperationContext* opCtx,
+                                      RepairableFeatureMask ignoredRepairableFeatures = 0) const;
 
     /**
      * Deletes the feature document managed by this FeatureTracker instance from the KVCatalog.
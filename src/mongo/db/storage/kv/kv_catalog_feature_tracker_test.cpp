@@ -541,6 +541,31 @@ TEST_F(KVCatalogFeatureTrackerTest, FeatureDocumentStillHasRepairableFeaturesMar
     }
 }
 
+TEST_F(KVCatalogFeatureTrackerTest, IgnoredRepairableFeaturesAreNotConsideredInUse) {
+    auto opCtx = newOperationContext();
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        getFeatureTracker()->markRepairableFeatureAsInUse(opCtx.get(), kRepairableFeature1);
+        wuow.commit();
+    }
+
+    const auto ignored = static_cast<RepairableFeatureMask>(kRepairableFeature1);
+    ASSERT_OK(getFeatureTracker()->hasNoFeaturesMarkedAsInUse(opCtx.get(), ignored));
+
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        getFeatureTracker()->markRepairableFeatureAsInUse(opCtx.get(), kRepairableFeature2);
+        wuow.commit();
+    }
+
+    auto status = getFeatureTracker()->hasNoFeaturesMarkedAsInUse(opCtx.get(), ignored);
+    ASSERT_EQ(ErrorCodes::MustUpgrade, status.code());
+    ASSERT_EQ(
+        "The data files use features not supported by this version of mongod; the R feature"
+        " bits in positions [ 1 ] are still enabled",
+        status.reason());
+}
+
 TEST_F(KVCatalogFeatureTrackerTest, FeatureDocumentCanBeDeleted) {
     {
         auto opCtx = newOperationContext();
@@ -33,8 +33,10 @@
 #include "mongo/db/storage/kv/kv_collection_catalog_entry.h"
 
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index_names.h"
 #include "mongo/db/storage/kv/kv_catalog.h"
 #include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -87,14 +89,29 @@ KVCollectionCatalogEntry::~KVCollectionCatalogEntry() {}
 
 bool KVCollectionCatalogEntry::setIndexIsMultikey(OperationContext* txn,
                                                   StringData indexName,
-                                                  bool multikey) {
+                                                  const MultikeyPaths& multikeyPaths) {
     MetaData md = _getMetaData(txn);
 
     int offset = md.findIndexOffset(indexName);
     invariant(offset >= 0);
-    if (md.indexes[offset].multikey == multikey)
+
+    bool changed = !md.indexes[offset].multikey;
+    md.indexes[offset].multikey = true;
+
+    MultikeyPaths& indexMultikeyPaths = md.indexes[offset].multikeyPaths;
+    if (!indexMultikeyPaths.empty() && !multikeyPaths.empty()) {
+        invariant(indexMultikeyPaths.size() == multikeyPaths.size());
+        for (size_t i = 0; i < multikeyPaths.size(); ++i) {
+            for (size_t component : multikeyPaths[i]) {
+                changed = indexMultikeyPaths[i].insert(component).second || changed;
+            }
+        }
+    }
+
+    if (!changed) {
         return false;
-    md.indexes[offset].multikey = multikey;
+    }
+
     _catalog->putMetaData(txn, ns().toString(), md);
     return true;
 }
@@ -102,12 +119,15 @@ bool KVCollectionCatalogEntry::setIndexIsMultikey(OperationContext* txn,
 void KVCollectionCatalogEntry::removePathLevelMultikeyInfoFromAllIndexes(OperationContext* txn) {
     MetaData md = _getMetaData(txn);
     for (auto&& imd : md.indexes) {
-        if (imd.hasMultikeyPaths) {
+        if (!imd.multikeyPaths.empty()) {
             log() << "Removing path-level multikey information from index " << imd.spec
                   << " and any other indexes on collection '" << md.ns << "'";
             // At least one index on this collection has path-level multikey information. We
             // reserialize the collection metadata to remove the "multikeyPaths" elements from all
             // the index metadata subdocuments.
+            for (auto&& index : md.indexes) {
+                index.multikeyPaths.clear();
+            }
             _catalog->putMetaData(txn, ns().toString(), md);
             return;
         }
@@ -161,7 +181,16 @@ Status KVCollectionCatalogEntry::removeIndex(OperationContext* txn, StringData i
 Status KVCollectionCatalogEntry::prepareForIndexBuild(OperationContext* txn,
                                                       const IndexDescriptor* spec) {
     MetaData md = _getMetaData(txn);
-    md.indexes.push_back(IndexMetaData(spec->infoObj(), false, RecordId(), false));
+    IndexMetaData imd(spec->infoObj(), false, RecordId(), false);
+
+    // Only v1 btree keys record which of their paths traverse arrays. Indexes built before path
+    // tracking was turned on keep an empty 'multikeyPaths', since their paths are unknown.
+    if (storageGlobalParams.trackPathLevelMultikeyInfo &&
+        spec->getAccessMethodName() == IndexNames::BTREE && spec->version() >= 1) {
+        imd.multikeyPaths.resize(spec->keyPattern().nFields());
+    }
+
+    md.indexes.push_back(imd);
     _catalog->putMetaData(txn, ns().toString(), md);
 
     string ident = _catalog->getIndexIdent(txn, ns().ns(), spec->indexName());
@@ -169,7 +169,8 @@ public:
     virtual void setJournalListener(JournalListener* jl) = 0;
     
     //hotBackup interface
-    virtual StatusWith<BSONObj> beginHotBackup(OperationContext* opCtx) {
+    virtual StatusWith<BSONObj> beginHotBackup(OperationContext* opCtx,
+                                               const BSONObj& incrementalFrom) {
        return Status(ErrorCodes::CommandNotSupported,
                       "The current storage engine doesn't support hotbackup mode");
     }
@@ -36,6 +36,7 @@
 #include "mongo/db/storage/kv/kv_catalog_feature_tracker.h"
 #include "mongo/db/storage/kv/kv_database_catalog_entry.h"
 #include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -47,6 +48,7 @@ using std::vector;
 
 using NonRepairableFeature = KVCatalog::FeatureTracker::NonRepairableFeature;
 using RepairableFeature = KVCatalog::FeatureTracker::RepairableFeature;
+using RepairableFeatureMask = KVCatalog::FeatureTracker::RepairableFeatureMask;
 
 namespace {
 const std::string catalogInfo = "_mdb_catalog";
@@ -177,7 +179,10 @@ KVStorageEngine::~KVStorageEngine() {}
 void KVStorageEngine::finishInit() {}
 
 Status KVStorageEngine::requireDataFileCompatibilityWithPriorRelease(OperationContext* opCtx) {
-    if (_catalog->getFeatureTracker()->isRepairableFeatureInUse(
+    const bool trackPathLevelMultikeyInfo = storageGlobalParams.trackPathLevelMultikeyInfo;
+
+    if (!trackPathLevelMultikeyInfo &&
+        _catalog->getFeatureTracker()->isRepairableFeatureInUse(
             opCtx, RepairableFeature::kPathLevelMultikeyTracking)) {
         {
             stdx::lock_guard<stdx::mutex> lk(_dbsLock);
@@ -217,6 +222,24 @@ Status KVStorageEngine::requireDataFileCompatibilityWithPriorRelease(OperationCo
         }
     }
 
+    if (trackPathLevelMultikeyInfo) {
+        // Indexes built from now on record which of their paths are multikey, and prior releases
+        // would not keep that information up to date. The feature document is kept so that they
+        // refuse to start on these data files until this version is restarted with
+        // trackPathLevelMultikeyInfo=false, which removes the information again.
+        if (!_catalog->getFeatureTracker()->isRepairableFeatureInUse(
+                opCtx, RepairableFeature::kPathLevelMultikeyTracking)) {
+            WriteUnitOfWork wuow(opCtx);
+            _catalog->getFeatureTracker()->markRepairableFeatureAsInUse(
+                opCtx, RepairableFeature::kPathLevelMultikeyTracking);
+            wuow.commit();
+        }
+
+        return _catalog->getFeatureTracker()->hasNoFeaturesMarkedAsInUse(
+            opCtx,
+            static_cast<RepairableFeatureMask>(RepairableFeature::kPathLevelMultikeyTracking));
+    }
+
     auto status = _catalog->getFeatureTracker()->hasNoFeaturesMarkedAsInUse(opCtx);
     if (!status.isOK()) {
         return status;
@@ -350,11 +373,12 @@ void KVStorageEngine::setJournalListener(JournalListener* jl) {
     _engine->setJournalListener(jl);
 }
 
-StatusWith<BSONObj> KVStorageEngine::beginHotBackup(OperationContext* txn) {
+StatusWith<BSONObj> KVStorageEngine::beginHotBackup(OperationContext* txn,
+                                                    const BSONObj& incrementalFrom) {
     if(_engine->getHotBackupToken() != 0){
        return Status(ErrorCodes::BadValue, "Already in HotBackup Mode");
     }
-    auto status = _engine->beginHotBackup(txn);
+    auto status = _engine->beginHotBackup(txn, incrementalFrom);
     return status;
 }
 
@@ -370,7 +394,9 @@ Status KVStorageEngine::continueHotBackup(OperationContext* txn, const int64_t&
 }
 
 Status KVStorageEngine::endHotBackup(OperationContext* txn, const int64_t& token, bool isBackground) {
-   invariant(_engine->getHotBackupToken() != 0);
+   if(_engine->getHotBackupToken() == 0) {
+     return Status(ErrorCodes::BadValue, "Not begin in HotBackup Mode");
+   }
    if(_engine->getHotBackupToken() != token) {
      return Status(ErrorCodes::BadValue, "Not match hotBackup token");
    }
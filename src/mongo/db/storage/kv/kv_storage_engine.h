@@ -100,7 +100,8 @@ public:
 
     void setJournalListener(JournalListener* jl) final;
 
-    virtual StatusWith<BSONObj> beginHotBackup(OperationContext* txn);
+    virtual StatusWith<BSONObj> beginHotBackup(OperationContext* txn,
+                                               const BSONObj& incrementalFrom = BSONObj());
     virtual Status continueHotBackup(OperationContext* txn, const int64_t& token);
     virtual Status endHotBackup(OperationContext* txn, const int64_t& token, bool isBackground = false);
 
@@ -104,7 +104,13 @@ void NamespaceDetailsCollectionCatalogEntry::getAllIndexes(OperationContext* txn
 }
 
 bool NamespaceDetailsCollectionCatalogEntry::isIndexMultikey(OperationContext* txn,
-                                                             StringData idxName) const {
+                                                             StringData idxName,
+                                                             MultikeyPaths* multikeyPaths) const {
+    // MMAPv1 only records whether the whole index is multikey.
+    if (multikeyPaths) {
+        multikeyPaths->clear();
+    }
+
     int idxNo = _findIndexNumber(txn, idxName);
     invariant(idxNo >= 0);
     return isIndexMultikey(idxNo);
@@ -114,12 +120,11 @@ bool NamespaceDetailsCollectionCatalogEntry::isIndexMultikey(int idxNo) const {
     return (_details->multiKeyIndexBits & (((unsigned long long)1) << idxNo)) != 0;
 }
 
-bool NamespaceDetailsCollectionCatalogEntry::setIndexIsMultikey(OperationContext* txn,
-                                                                StringData indexName,
-                                                                bool multikey) {
+bool NamespaceDetailsCollectionCatalogEntry::setIndexIsMultikey(
+    OperationContext* txn, StringData indexName, const MultikeyPaths& multikeyPaths) {
     int idxNo = _findIndexNumber(txn, indexName);
     invariant(idxNo >= 0);
-    return setIndexIsMultikey(txn, idxNo, multikey);
+    return setIndexIsMultikey(txn, idxNo);
 }
 
 bool NamespaceDetailsCollectionCatalogEntry::setIndexIsMultikey(OperationContext* txn,
@@ -461,6 +461,20 @@ public:
         return {};
     }
 
+    /**
+     * Returns a cursor over the Records whose ids are in [start, end), in ascending order, or {}
+     * if this store cannot position a cursor on a RecordId range. A null 'end' means the range
+     * extends to the end of the store.
+     *
+     * Cursors over disjoint ranges can be iterated concurrently by different operations, which is
+     * how a collection scan is split across worker threads.
+     */
+    virtual std::unique_ptr<RecordCursor> getCursorForRange(OperationContext* txn,
+                                                            const RecordId& start,
+                                                            const RecordId& end) const {
+        return {};
+    }
+
     /**
      * Returns many RecordCursors that partition the RecordStore into many disjoint sets.
      * Iterating all returned RecordCursors is equivalent to iterating the full store.
@@ -287,7 +287,12 @@ public:
      */
     virtual void setJournalListener(JournalListener* jl) = 0;
 
-    virtual StatusWith<BSONObj> beginHotBackup(OperationContext* txn){
+    /**
+     * Starts a hot backup and returns the files to copy. If 'incrementalFrom' holds the backupId
+     * returned by a previous backup, only the journal files written since then are listed.
+     */
+    virtual StatusWith<BSONObj> beginHotBackup(OperationContext* txn,
+                                               const BSONObj& incrementalFrom = BSONObj()) {
         return Status(ErrorCodes::CommandNotSupported,
                       "The current storage engine doesn't support hotbackup mode");
     }
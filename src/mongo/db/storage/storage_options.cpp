@@ -66,6 +66,15 @@ ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime> NoTableSc
 ExportedServerParameter<double, ServerParameterType::kStartupAndRuntime> SyncdelaySetting(
     ServerParameterSet::getGlobal(), "syncdelay", &storageGlobalParams.syncdelay);
 
+/**
+ * Specify whether indexes built by this mongod record which of their paths are multikey. Set to
+ * false at startup to remove that information from all indexes before a downgrade.
+ */
+ExportedServerParameter<bool, ServerParameterType::kStartupOnly> TrackPathLevelMultikeyInfoSetting(
+    ServerParameterSet::getGlobal(),
+    "trackPathLevelMultikeyInfo",
+    &storageGlobalParams.trackPathLevelMultikeyInfo);
+
 /**
  * Specify an integer between 1 and kMaxJournalCommitInterval signifying the number of milliseconds
  * (ms) between journal commits.
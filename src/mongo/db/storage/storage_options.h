@@ -58,7 +58,8 @@ struct StorageGlobalParams {
           repair(false),
           noTableScan(false),
           directoryperdb(false),
-          syncdelay(60.0) {
+          syncdelay(60.0),
+          trackPathLevelMultikeyInfo(true) {
         dur = false;
         if (sizeof(void*) == 8)
             dur = true;
@@ -112,6 +113,11 @@ struct StorageGlobalParams {
     // Do not set this value on production systems.
     // In almost every situation, you should use the default setting.
     AtomicDouble syncdelay;  // seconds between fsyncs
+
+    // Whether indexes record which of their paths are multikey. Releases which don't maintain this
+    // information refuse to start on data files which may contain it, so it has to be turned off
+    // for one restart before downgrading, which removes it from every index.
+    bool trackPathLevelMultikeyInfo;
 };
 
 extern StorageGlobalParams storageGlobalParams;
@@ -67,6 +67,11 @@ Status WiredTigerGlobalOptions::add(moe::OptionSection* options) {
                                         "wiredTigerDirectoryForIndexes",
                                         moe::Switch,
                                         "Put indexes and data in different directories");
+    wiredTigerOptions.addOptionChaining("storage.wiredTiger.engineConfig.incrementalBackup",
+                                        "wiredTigerIncrementalBackup",
+                                        moe::Switch,
+                                        "keep journal files until hotBackup has copied them so "
+                                        "that later backups can be taken incrementally");
     wiredTigerOptions.addOptionChaining("storage.wiredTiger.engineConfig.configString",
                                         "wiredTigerEngineConfigString",
                                         moe::String,
@@ -125,6 +130,10 @@ Status WiredTigerGlobalOptions::store(const moe::Environment& params,
         wiredTigerGlobalOptions.directoryForIndexes =
             params["storage.wiredTiger.engineConfig.directoryForIndexes"].as<bool>();
     }
+    if (params.count("storage.wiredTiger.engineConfig.incrementalBackup")) {
+        wiredTigerGlobalOptions.incrementalBackup =
+            params["storage.wiredTiger.engineConfig.incrementalBackup"].as<bool>();
+    }
     if (params.count("storage.wiredTiger.engineConfig.configString")) {
         wiredTigerGlobalOptions.engineConfig =
             params["storage.wiredTiger.engineConfig.configString"].as<std::string>();
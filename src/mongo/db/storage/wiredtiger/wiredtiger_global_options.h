@@ -44,6 +44,7 @@ public:
           checkpointDelaySecs(0),
           statisticsLogDelaySecs(0),
           directoryForIndexes(false),
+          incrementalBackup(false),
           useCollectionPrefixCompression(false),
           useIndexPrefixCompression(false){};
 
@@ -55,6 +56,7 @@ public:
     size_t statisticsLogDelaySecs;
     std::string journalCompressor;
     bool directoryForIndexes;
+    bool incrementalBackup;
     std::string engineConfig;
 
     std::string collectionBlockCompressor;
@@ -496,12 +496,17 @@ protected:
         WT_CURSOR* cursor;
         // We use our own session to ensure we aren't in a transaction.
         WT_SESSION* session = _session->getSession();
-        int err = session->open_cursor(session, idx->uri().c_str(), NULL, "bulk", &cursor);
-        if (!err)
-            return cursor;
 
-        warning() << "failed to create WiredTiger bulk cursor: " << wiredtiger_strerror(err);
-        warning() << "falling back to non-bulk cursor for index " << idx->uri();
+        // Bulk loads are not written to the journal, so they could not be rolled forward from
+        // the journal files copied by an incremental hot backup.
+        if (!wiredTigerGlobalOptions.incrementalBackup) {
+            int err = session->open_cursor(session, idx->uri().c_str(), NULL, "bulk", &cursor);
+            if (!err)
+                return cursor;
+
+            warning() << "failed to create WiredTiger bulk cursor: " << wiredtiger_strerror(err);
+            warning() << "falling back to non-bulk cursor for index " << idx->uri();
+        }
 
         invariantWTOK(session->open_cursor(session, idx->uri().c_str(), NULL, NULL, &cursor));
         return cursor;
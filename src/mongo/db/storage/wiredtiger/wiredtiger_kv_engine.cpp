@@ -42,6 +42,7 @@
 #include <valgrind/valgrind.h>
 
 #include "mongo/base/error_codes.h"
+#include "mongo/base/parse_number.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/locker.h"
@@ -66,6 +67,7 @@
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/ticketholder.h"
 #include "mongo/util/exit.h"
+#include "mongo/util/mongoutils/str.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
 
@@ -122,7 +124,7 @@ private:
 class WiredTigerKVEngine::WiredTigerHotBackupThread : public BackgroundJob {
 public:
     WiredTigerHotBackupThread(WiredTigerKVEngine* engine, const int& expire_interval, const int64_t& token)
-        : BackgroundJob(false /* deleteSelf */), _engine(engine), _expire_interval(expire_interval), _token(token) {
+        : BackgroundJob(true /* deleteSelf */), _engine(engine), _expire_interval(expire_interval), _token(token) {
     }
 
     virtual std::string name() const {
@@ -138,9 +140,6 @@ public:
         auto epoch = now_ms.time_since_epoch();
         int64_t now_t = epoch.count();
 
-        if(_token != _engine->getHotBackupToken()) {
-           return true;
-        }
         auto duration = now_t - _engine->getHotBackupHeartBeat();
         if(duration > _expire_interval ) {
           return true;
@@ -151,16 +150,16 @@ public:
     virtual void run() {
         Client::initThread(name().c_str());
 
-        while (!inShutdown()) {
-            if (!_check_expire()) {
-                LOG(0) << "session keep live";
-                sleepmillis(10000);  // Back off in case there were problems deleting.
-            }else {
-               if(_token == _engine->getHotBackupToken()) {
-                  _engine->endHotBackup(NULL, true);
-               }
+        // The backup is ended by the client, or by us once its heartbeats stop. Either way the
+        // token changes and the thread exits; the engine never waits for it.
+        while (!inShutdown() && _token == _engine->getHotBackupToken()) {
+            if (_check_expire()) {
+               LOG(0) << "hot backup " << _token << " expired, no heartbeat for "
+                      << _expire_interval << "ms";
+               _engine->_expireHotBackup(_token);
                break;
             }
+            sleepmillis(1000);
         }
     }
 private:
@@ -256,8 +255,9 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     // The setting may have a later setting override it if not using the journal.  We make it
     // unconditional here because even nojournal may need this setting if it is a transition
     // from using the journal.
-    ss << "log=(enabled=true,archive=true,path=journal,compressor=";
-    ss << wiredTigerGlobalOptions.journalCompressor << "),";
+    ss << "log=(enabled=true,path=journal,compressor=";
+    ss << wiredTigerGlobalOptions.journalCompressor << ",archive=";
+    ss << (wiredTigerGlobalOptions.incrementalBackup ? "false" : "true") << "),";
     ss << "file_manager=(close_idle_time=100000),";  //~28 hours, will put better fix in 3.1.x
     ss << "checkpoint=(wait=" << wiredTigerGlobalOptions.checkpointDelaySecs;
     ss << ",log_size=2GB),";
@@ -349,6 +349,13 @@ void WiredTigerKVEngine::cleanShutdown() {
     log() << "WiredTigerKVEngine shutting down";
     syncSizeInfo(true);
     if (_conn) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_hotBackupMutex);
+            if (_hotBackupSession) {
+                _endHotBackup_inlock(false);
+            }
+        }
+
         // these must be the last things we do before _conn->close();
         if (_journalFlusher)
             _journalFlusher->shutdown();
@@ -381,22 +388,59 @@ const int64_t WiredTigerKVEngine::getHotBackupHeartBeat() {
    return _hotBackupHB.load();
 }
 
-StatusWith<BSONObj> WiredTigerKVEngine::beginHotBackup(OperationContext* opCtx) {
-    invariant(!_hotBackupSession);
+StatusWith<BSONObj> WiredTigerKVEngine::beginHotBackup(OperationContext* opCtx,
+                                                      const BSONObj& incrementalFrom) {
+    stdx::lock_guard<stdx::mutex> lk(_hotBackupMutex);
+    if (_hotBackupSession) {
+        return Status(ErrorCodes::BadValue, "Already in HotBackup Mode");
+    }
+
+    // With archiving disabled every journal file written since the last backup is still on disk,
+    // so a backup which ships the journal can be rolled forward by the next one.
+    const bool keepLogs = wiredTigerGlobalOptions.incrementalBackup;
+    const bool incremental = !incrementalFrom.isEmpty();
+    const uint64_t identsCreated = _identsCreated.load();
+    long long prevLogFile = 0;
+    if (incremental) {
+        if (!keepLogs) {
+            return Status(ErrorCodes::IllegalOperation,
+                          "incremental hot backup requires --wiredTigerIncrementalBackup");
+        }
+        BSONElement instanceId = incrementalFrom["instanceId"];
+        if (instanceId.type() != jstOID || instanceId.OID() != _hotBackupInstanceId) {
+            return Status(ErrorCodes::BadValue,
+                          "incremental hot backup must follow a backup taken since the server "
+                          "last started, take a full backup");
+        }
+        if (incrementalFrom["identsCreated"].numberLong() != (long long)identsCreated) {
+            return Status(ErrorCodes::BadValue,
+                          "collections or indexes were created since the previous backup, "
+                          "take a full backup");
+        }
+        prevLogFile = incrementalFrom["lastLogFile"].numberLong();
+        if (prevLogFile <= 0) {
+            return Status(ErrorCodes::BadValue, "incremental backupId has no lastLogFile");
+        }
+    }
+
     auto session = stdx::make_unique<WiredTigerSession>(_conn);
     WT_SESSION* s = session->getSession();
     WT_CURSOR* c = NULL;
     const char* filename;
 
-    int ret = WT_OP_CHECK(s->open_cursor(s, "backup:", NULL, NULL, &c));
+    // An incremental backup only needs the journal: replaying it over the previous backup
+    // brings every table file forward.
+    int ret = WT_OP_CHECK(
+        s->open_cursor(s, "backup:", NULL, incremental ? "target=(\"log:\")" : NULL, &c));
     if (ret != 0) {
         return StatusWith<BSONObj>(wtRCToStatus(ret));
     }
     invariant(c);
-    //ON_BLOCK_EXIT(c->close, c);
     
     BSONObjBuilder resBuilder;
     BSONArrayBuilder arrBuilder;
+    long long firstLogFile = 0;
+    long long lastLogFile = 0;
 
     while ((ret = c->next(c)) == 0 &&
            (ret = c->get_key(c, &filename)) == 0 ) {
@@ -413,13 +457,34 @@ StatusWith<BSONObj> WiredTigerKVEngine::beginHotBackup(OperationContext* opCtx)
              }
           }
           if (fullFilePath.find("WiredTigerLog") != std::string::npos) {
-              continue;
+              // WiredTigerLog.<number>
+              long long logFile = 0;
+              Status parsed = parseNumberFromStringWithBase(
+                  StringData(filename).substr(StringData(filename).rfind('.') + 1), 10, &logFile);
+              if (parsed.isOK()) {
+                  firstLogFile = firstLogFile ? std::min(firstLogFile, logFile) : logFile;
+                  lastLogFile = std::max(lastLogFile, logFile);
+              }
+              if (!keepLogs) {
+                  continue;
+              }
           }
           LOG(0) << "fullFilePath: " << fullFilePath;
           arrBuilder.append(fullFilePath);
    }
+   if (ret != WT_NOTFOUND) {
+       return StatusWith<BSONObj>(wtRCToStatus(ret));
+   }
+
+   if (incremental && (firstLogFile == 0 || firstLogFile > prevLogFile)) {
+       return Status(ErrorCodes::BadValue,
+                     str::stream() << "journal file " << prevLogFile
+                                   << " of the previous backup has been removed, take a full "
+                                      "backup");
+   }
 
    _hotBackupSession = std::move(session);
+   _hotBackupCursor = c;
    
      //init _hotBackupHB && _hotBackupToken
      auto now = std::chrono::system_clock::now();
@@ -431,16 +496,28 @@ StatusWith<BSONObj> WiredTigerKVEngine::beginHotBackup(OperationContext* opCtx)
      _hotBackupHB.store(hotBackupHB);
    
    LOG(0) << "begin record session life: " << hotBackupHB;
-   _hotBackupThr = stdx::make_unique<WiredTigerHotBackupThread>(this, 10000, hotBackupHB);
-   _hotBackupThr->go();
+   (new WiredTigerHotBackupThread(this, 10000, hotBackupHB))->go();
    resBuilder.append("fileList", arrBuilder.arr());
    resBuilder.append("token", (long long)(hotBackupHB));
+   resBuilder.append("dbpath", _path);
+   if (keepLogs) {
+       // Pass this back as 'incremental' to the next begin, after this backup has ended.
+       resBuilder.appendBool("incremental", incremental);
+       BSONObjBuilder backupId(resBuilder.subobjStart("backupId"));
+       backupId.append("instanceId", _hotBackupInstanceId);
+       backupId.append("identsCreated", (long long)identsCreated);
+       backupId.append("lastLogFile", lastLogFile);
+       backupId.done();
+   }
    
    return StatusWith<BSONObj>(resBuilder.obj());
 }
 
 Status WiredTigerKVEngine::continueHotBackup(OperationContext* opCtx) {
-   invariant(_hotBackupSession);
+   stdx::lock_guard<stdx::mutex> lk(_hotBackupMutex);
+   if (!_hotBackupSession) {
+       return Status(ErrorCodes::BadValue, "Not begin in HotBackup Mode");
+   }
    //update heart beat
    
    auto now = std::chrono::system_clock::now();
@@ -455,16 +532,39 @@ Status WiredTigerKVEngine::continueHotBackup(OperationContext* opCtx) {
 }
 
 Status WiredTigerKVEngine::endHotBackup(OperationContext* opCtx, bool isBackground) {
-    if(isBackground == false) {
-      _hotBackupThr->wait();
+    stdx::lock_guard<stdx::mutex> lk(_hotBackupMutex);
+    if (!_hotBackupSession) {
+        return Status(ErrorCodes::BadValue, "Not begin in HotBackup Mode");
+    }
+    // Only a client which ends the backup itself has copied all of the files.
+    _endHotBackup_inlock(!isBackground);
+    return Status::OK();
+}
+
+void WiredTigerKVEngine::_expireHotBackup(int64_t token) {
+    stdx::lock_guard<stdx::mutex> lk(_hotBackupMutex);
+    if (_hotBackupSession && getHotBackupToken() == token) {
+        _endHotBackup_inlock(false);
     }
+}
+
+void WiredTigerKVEngine::_endHotBackup_inlock(bool archiveLogs) {
+    if (archiveLogs && wiredTigerGlobalOptions.incrementalBackup) {
+        WT_SESSION* s = _hotBackupSession->getSession();
+        int ret = s->truncate(s, "log:", _hotBackupCursor, NULL, NULL);
+        if (ret != 0) {
+            // Not fatal for the backup, the files are archived by the next one instead.
+            warning() << "failed to archive journal files after hot backup: "
+                      << wtRCToStatus(ret);
+        }
+    }
+    _hotBackupCursor = nullptr;
     _hotBackupSession.reset();
 
     int64_t token_init = 0;
     setHotBackupToken(token_init);
      
     LOG(0) << "reset _hotBackupSession done";
-    return Status::OK();
 }
 
 int64_t WiredTigerKVEngine::getHotBackupToken() {
@@ -593,6 +693,7 @@ Status WiredTigerKVEngine::createRecordStore(OperationContext* opCtx,
     string uri = _uri(ident);
     WT_SESSION* s = session.getSession();
     LOG(2) << "WiredTigerKVEngine::createRecordStore uri: " << uri << " config: " << config;
+    _identsCreated.fetchAndAdd(1);
     return wtRCToStatus(s->create(s, uri.c_str(), config.c_str()));
 }
 
@@ -660,6 +761,7 @@ Status WiredTigerKVEngine::createSortedDataInterface(OperationContext* opCtx,
 
     LOG(2) << "WiredTigerKVEngine::createSortedDataInterface ident: " << ident
            << " config: " << config;
+    _identsCreated.fetchAndAdd(1);
     return wtRCToStatus(WiredTigerIndex::Create(opCtx, _uri(ident), config));
 }
 
@@ -35,9 +35,11 @@
 #include <string>
 #include <wiredtiger.h>
 
+#include "mongo/bson/oid.h"
 #include "mongo/bson/ordering.h"
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/elapsed_tracker.h"
 
@@ -117,7 +119,8 @@ public:
 
     virtual void cleanShutdown();
 
-    virtual StatusWith<BSONObj> beginHotBackup(OperationContext* opCtx);
+    virtual StatusWith<BSONObj> beginHotBackup(OperationContext* opCtx,
+                                               const BSONObj& incrementalFrom);
     virtual Status continueHotBackup(OperationContext* opCtx);
     virtual Status endHotBackup(OperationContext* opCtx, bool isBackground = false);
     virtual int64_t getHotBackupToken();
@@ -137,6 +140,10 @@ public:
     WT_CONNECTION* getConnection() {
         return _conn;
     }
+
+    WiredTigerSessionCache* getSessionCache() {
+        return _sessionCache.get();
+    }
     void dropSomeQueuedIdents();
     bool haveDropsQueued() const;
 
@@ -160,6 +167,18 @@ private:
     class WiredTigerJournalFlusher;
     class WiredTigerHotBackupThread;
 
+    /**
+     * Ends the hot backup identified by 'token' if its client stopped sending heartbeats.
+     */
+    void _expireHotBackup(int64_t token);
+
+    /**
+     * Closes the hot backup cursor. When 'archiveLogs' is set and the journal is kept for
+     * incremental backups, first removes the journal files which the backup has copied and
+     * which are no longer needed for recovery.
+     */
+    void _endHotBackup_inlock(bool archiveLogs);
+
     Status _salvageIfNeeded(const char* uri);
     void _checkIdentPath(StringData ident);
 
@@ -192,10 +211,16 @@ private:
     mutable Date_t _previousCheckedDropsQueued;
     std::unique_ptr<WiredTigerSession> _backupSession;
     //for hot backup
+    stdx::mutex _hotBackupMutex;  // serializes begin/end of a hot backup
     std::unique_ptr<WiredTigerSession> _hotBackupSession;
+    WT_CURSOR* _hotBackupCursor = nullptr;  // owned by _hotBackupSession
     std::atomic<int64_t> _hotBackupHB;
     std::atomic<int64_t> _hotBackupToken;    
-    std::unique_ptr<WiredTigerHotBackupThread> _hotBackupThr;
+
+    // An incremental backup can only follow a backup taken by this process, and only if no
+    // collection or index has been created since, because creating a table is not journaled.
+    const OID _hotBackupInstanceId = OID::gen();
+    AtomicUInt64 _identsCreated;
 
 };
 }
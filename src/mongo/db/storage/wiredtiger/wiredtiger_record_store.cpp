@@ -39,6 +39,7 @@
 
 #include "mongo/base/checked_cast.h"
 #include "mongo/bson/util/builder.h"
+#include "mongo/db/client.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/namespace_string.h"
@@ -58,8 +59,10 @@
 #include "mongo/util/fail_point.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/progress_meter.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 //#define RS_ITERATOR_TRACE(x) log() << "WTRS::Iterator " << x
 #define RS_ITERATOR_TRACE(x)
@@ -88,6 +91,32 @@ bool shouldUseOplogHack(OperationContext* opCtx, const std::string& uri) {
     return (appMetadata.getValue().getIntField("oplogKeyExtractionVersion") == 1);
 }
 
+int64_t cappedMaxSizeSlackFor(int64_t cappedMaxSize) {
+    return std::min(cappedMaxSize / 10, int64_t(16 * 1024 * 1024));
+}
+
+// Number of stones an oplog of 'maxSize' bytes is divided into.
+size_t numStonesToKeepFor(int64_t maxSize) {
+    const unsigned long long kMinStonesToKeep = 10ULL;
+    const unsigned long long kMaxStonesToKeep = 100ULL;
+
+    unsigned long long numStones = maxSize / BSONObjMaxInternalSize;
+    return std::min(kMaxStonesToKeep, std::max(kMinStonesToKeep, numStones));
+}
+
+// Counters of the oplog reclaim thread, reported in the "oplogTruncation" section of
+// serverStatus. A node has a single active oplog, so they are process-wide.
+AtomicInt64 oplogTruncateCount;
+AtomicInt64 oplogTruncateMicros;
+AtomicInt64 oplogRecordsTruncated;
+AtomicInt64 oplogBytesTruncated;
+AtomicInt64 oplogTruncateWriteConflicts;
+
+// The stones of the active oplog, for reporting the truncation backlog. Set and cleared by the
+// record store owning them, so the stones never outlive their record store here.
+stdx::mutex activeOplogStonesMutex;
+WiredTigerRecordStore::OplogStones* activeOplogStones = nullptr;
+
 }  // namespace
 
 MONGO_FP_DECLARE(WTWriteConflictException);
@@ -152,11 +181,7 @@ WiredTigerRecordStore::OplogStones::OplogStones(OperationContext* txn, WiredTige
     invariant(rs->cappedMaxSize() > 0);
     unsigned long long maxSize = rs->cappedMaxSize();
 
-    const unsigned long long kMinStonesToKeep = 10ULL;
-    const unsigned long long kMaxStonesToKeep = 100ULL;
-
-    unsigned long long numStones = maxSize / BSONObjMaxInternalSize;
-	size_t numStonesToKeep = std::min(kMaxStonesToKeep, std::max(kMinStonesToKeep, numStones));
+    size_t numStonesToKeep = numStonesToKeepFor(maxSize);
     _minBytesPerStone = maxSize / numStonesToKeep;
     invariant(_minBytesPerStone > 0);
 
@@ -202,6 +227,11 @@ WiredTigerRecordStore::OplogStones::peekOldestStoneIfNeeded() const {
     return _stones.front();
 }
 
+int64_t WiredTigerRecordStore::OplogStones::bytesToReclaim() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return std::max(int64_t(0), _bytesInStones_inlock() - _rs->cappedMaxSize());
+}
+
 void WiredTigerRecordStore::OplogStones::popOldestStone() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     _stones.pop_front();
@@ -437,24 +467,43 @@ void WiredTigerRecordStore::OplogStones::_pokeReclaimThreadIfNeeded() {
 }
 
 void WiredTigerRecordStore::OplogStones::adjust(int64_t maxSize) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-    const unsigned long long kMinStonesToKeep = 10ULL;
-    const unsigned long long kMaxStonesToKeep = 100ULL;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
 
-    unsigned long long numStones = maxSize / BSONObjMaxInternalSize;
-    size_t numStonesToKeep = std::min(kMaxStonesToKeep, std::max(kMinStonesToKeep, numStones));
-    _minBytesPerStone = maxSize / numStonesToKeep;
-    invariant(_minBytesPerStone > 0);
-    _pokeReclaimThreadIfNeeded();
+        // Stones created before the resize keep their size. After a shrink the reclaim thread
+        // drops them whole until the remaining ones fit, new stones use the new size.
+        _minBytesPerStone = maxSize / numStonesToKeepFor(maxSize);
+        invariant(_minBytesPerStone > 0);
+
+        if (!hasExcessStones_inlock()) {
+            return;
+        }
+    }
+
+    // The reclaim thread checks for excess stones while holding '_oplogReclaimMutex'. Notify
+    // under it so that the wakeup is not lost when no insert comes along to poke the thread again.
+    stdx::lock_guard<stdx::mutex> lk(_oplogReclaimMutex);
+    _oplogReclaimCv.notify_one();
 }
 
 class WiredTigerRecordStore::Cursor final : public SeekableRecordCursor {
 public:
-    Cursor(OperationContext* txn, const WiredTigerRecordStore& rs, bool forward = true)
+    /**
+     * A forward cursor can be limited to the ids in [rangeStart, rangeEnd). A null bound leaves
+     * that side of the range open.
+     */
+    Cursor(OperationContext* txn,
+           const WiredTigerRecordStore& rs,
+           bool forward = true,
+           const RecordId& rangeStart = RecordId(),
+           const RecordId& rangeEnd = RecordId())
         : _rs(rs),
           _txn(txn),
           _forward(forward),
-          _readUntilForOplog(WiredTigerRecoveryUnit::get(txn)->getOplogReadTill()) {
+          _readUntilForOplog(WiredTigerRecoveryUnit::get(txn)->getOplogReadTill()),
+          _rangeStart(rangeStart),
+          _rangeEnd(rangeEnd) {
+        invariant(_forward || (_rangeStart.isNull() && _rangeEnd.isNull()));
         _cursor.emplace(rs.getURI(), rs.tableId(), true, txn);
     }
 
@@ -486,6 +535,18 @@ public:
                     ? (cmp >= 0)
                     : (cmp > 0);  // No longer hidden.
             }
+        } else if (_lastReturnedId.isNull() && !_rangeStart.isNull()) {
+            c->set_key(c, _makeKey(_rangeStart));
+            int cmp;
+            int seekRet = WT_OP_CHECK(c->search_near(c, &cmp));
+            if (seekRet == WT_NOTFOUND) {
+                _eof = true;
+                return {};
+            }
+            invariantWTOK(seekRet);
+
+            // search_near may land on the record just before the start of the range.
+            mustAdvance = cmp < 0;
         }
 
         if (mustAdvance) {
@@ -521,7 +582,7 @@ public:
             throw WriteConflictException();
         }
 
-        if (!isVisible(id)) {
+        if (!isVisible(id) || (!_rangeEnd.isNull() && id >= _rangeEnd)) {
             _eof = true;
             return {};
         }
@@ -653,6 +714,8 @@ private:
     bool _eof = false;
     RecordId _lastReturnedId;  // If null, need to seek to first/last record.
     const RecordId _readUntilForOplog;
+    const RecordId _rangeStart;
+    const RecordId _rangeEnd;
 };
 
 StatusWith<std::string> WiredTigerRecordStore::parseOptionsField(const BSONObj options) {
@@ -820,7 +883,7 @@ WiredTigerRecordStore::WiredTigerRecordStore(OperationContext* ctx,
       _isEphemeral(isEphemeral),
       _isOplog(NamespaceString::oplog(ns)),
       _cappedMaxSize(cappedMaxSize),
-      _cappedMaxSizeSlack(std::min(cappedMaxSize / 10, int64_t(16 * 1024 * 1024))),
+      _cappedMaxSizeSlack(cappedMaxSizeSlackFor(cappedMaxSize)),
       _cappedMaxDocs(cappedMaxDocs),
       _cappedSleep(0),
       _cappedSleepMS(0),
@@ -841,10 +904,10 @@ WiredTigerRecordStore::WiredTigerRecordStore(OperationContext* ctx,
     }
 
     if (_isCapped) {
-        invariant(_cappedMaxSize > 0);
+        invariant(_cappedMaxSize.load() > 0);
         invariant(_cappedMaxDocs == -1 || _cappedMaxDocs > 0);
     } else {
-        invariant(_cappedMaxSize == -1);
+        invariant(_cappedMaxSize.load() == -1);
         invariant(_cappedMaxDocs == -1);
     }
 
@@ -884,6 +947,9 @@ WiredTigerRecordStore::WiredTigerRecordStore(OperationContext* ctx,
 
     if (WiredTigerKVEngine::initRsOplogBackgroundThread(ns)) {
         _oplogStones = std::make_shared<OplogStones>(ctx, this);
+
+        stdx::lock_guard<stdx::mutex> activeLk(activeOplogStonesMutex);
+        activeOplogStones = _oplogStones.get();
     }
 }
 
@@ -899,6 +965,12 @@ WiredTigerRecordStore::~WiredTigerRecordStore() {
     }
 
     if (_oplogStones) {
+        {
+            stdx::lock_guard<stdx::mutex> activeLk(activeOplogStonesMutex);
+            if (activeOplogStones == _oplogStones.get()) {
+                activeOplogStones = nullptr;
+            }
+        }
         _oplogStones->kill();
     }
 }
@@ -931,7 +1003,7 @@ int64_t WiredTigerRecordStore::cappedMaxDocs() const {
 
 int64_t WiredTigerRecordStore::cappedMaxSize() const {
     invariant(_isCapped);
-    return _cappedMaxSize;
+    return _cappedMaxSize.load();
 }
 
 int64_t WiredTigerRecordStore::storageSize(OperationContext* txn,
@@ -1025,7 +1097,7 @@ bool WiredTigerRecordStore::cappedAndNeedDelete() const {
     if (!_isCapped)
         return false;
 
-    if (_dataSize.load() >= _cappedMaxSize)
+    if (_dataSize.load() >= _cappedMaxSize.load())
         return true;
 
     if ((_cappedMaxDocs != -1) && (_numRecords.load() > _cappedMaxDocs))
@@ -1054,7 +1126,7 @@ int64_t WiredTigerRecordStore::cappedDeleteAsNeeded(OperationContext* txn,
         if (!lock.try_lock()) {
             // Someone else is deleting old records. Apply back-pressure if too far behind,
             // otherwise continue.
-            if ((_dataSize.load() - _cappedMaxSize) < _cappedMaxSizeSlack)
+            if ((_dataSize.load() - _cappedMaxSize.load()) < _cappedMaxSizeSlack.load())
                 return 0;
 
             // Don't wait forever: we're in a transaction, we could block eviction.
@@ -1069,7 +1141,7 @@ int64_t WiredTigerRecordStore::cappedDeleteAsNeeded(OperationContext* txn,
 
             // If we already waited, let someone else do cleanup unless we are significantly
             // over the limit.
-            if ((_dataSize.load() - _cappedMaxSize) < (2 * _cappedMaxSizeSlack))
+            if ((_dataSize.load() - _cappedMaxSize.load()) < (2 * _cappedMaxSizeSlack.load()))
                 return 0;
         }
     }
@@ -1092,7 +1164,8 @@ int64_t WiredTigerRecordStore::cappedDeleteAsNeeded_inlock(OperationContext* txn
     int64_t dataSize = _dataSize.load();
     int64_t numRecords = _numRecords.load();
 
-    int64_t sizeOverCap = (dataSize > _cappedMaxSize) ? dataSize - _cappedMaxSize : 0;
+    int64_t cappedMaxSize = _cappedMaxSize.load();
+    int64_t sizeOverCap = (dataSize > cappedMaxSize) ? dataSize - cappedMaxSize : 0;
     int64_t sizeSaved = 0;
     int64_t docsOverCap = 0, docsRemoved = 0;
     if (_cappedMaxDocs != -1 && numRecords > _cappedMaxDocs)
@@ -1236,6 +1309,16 @@ bool WiredTigerRecordStore::yieldAndAwaitOplogDeletionRequest(OperationContext*
 }
 
 void WiredTigerRecordStore::reclaimOplog(OperationContext* txn) {
+    // Shrinking a large oplog can leave many stones to drop, so report the truncation in
+    // currentOp of the reclaim thread.
+    std::unique_ptr<ProgressMeterHolder> progress;
+    const int64_t bytesToReclaim = _oplogStones->bytesToReclaim();
+    if (bytesToReclaim > 0 && txn->getClient()) {
+        stdx::lock_guard<Client> lk(*txn->getClient());
+        progress = stdx::make_unique<ProgressMeterHolder>(*txn->setMessage_inlock(
+            "Oplog Truncation", "Oplog Truncation Progress (bytes)", bytesToReclaim));
+    }
+
     while (auto stone = _oplogStones->peekOldestStoneIfNeeded()) {
         invariant(stone->lastRecord.isNormal());
 
@@ -1247,6 +1330,7 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* txn) {
         WT_SESSION* session = ru->getSession(txn)->getSession();
 
         try {
+            Timer timer;
             WriteUnitOfWork wuow(txn);
 
             WiredTigerCursor startwrap(_uri, _tableId, true, txn);
@@ -1268,7 +1352,17 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* txn) {
 
             // Stash the truncate point for next time to cleanly skip over tombstones, etc.
             _oplogStones->firstRecord = stone->lastRecord;
+
+            oplogTruncateCount.fetchAndAdd(1);
+            oplogTruncateMicros.fetchAndAdd(timer.micros());
+            oplogRecordsTruncated.fetchAndAdd(stone->records);
+            oplogBytesTruncated.fetchAndAdd(stone->bytes);
+
+            if (progress) {
+                progress->hit(stone->bytes);
+            }
         } catch (const WriteConflictException& wce) {
+            oplogTruncateWriteConflicts.fetchAndAdd(1);
             LOG(1) << "Caught WriteConflictException while truncating oplog entries, retrying";
         }
     }
@@ -1277,6 +1371,24 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* txn) {
            << " records totaling to " << _dataSize.load() << " bytes";
 }
 
+// static
+bool WiredTigerRecordStore::appendOplogTruncationStats(BSONObjBuilder* builder) {
+    stdx::lock_guard<stdx::mutex> activeLk(activeOplogStonesMutex);
+    if (!activeOplogStones) {
+        return false;
+    }
+
+    builder->appendNumber("truncateCount", oplogTruncateCount.load());
+    builder->appendNumber("totalTimeTruncatingMicros", oplogTruncateMicros.load());
+    builder->appendNumber("recordsTruncated", oplogRecordsTruncated.load());
+    builder->appendNumber("bytesTruncated", oplogBytesTruncated.load());
+    builder->appendNumber("writeConflicts", oplogTruncateWriteConflicts.load());
+    builder->appendNumber("stones", static_cast<long long>(activeOplogStones->numStones()));
+    builder->appendNumber("bytesToReclaim",
+                          static_cast<long long>(activeOplogStones->bytesToReclaim()));
+    return true;
+}
+
 Status WiredTigerRecordStore::insertRecords(OperationContext* txn,
                                             std::vector<Record>* records,
                                             bool enforceQuota) {
@@ -1287,7 +1399,7 @@ Status WiredTigerRecordStore::insertRecords(OperationContext* txn,
         totalLength += record.data.size();
 
     // caller will retry one element at a time
-    if (_isCapped && totalLength > _cappedMaxSize)
+    if (_isCapped && totalLength > _cappedMaxSize.load())
         return Status(ErrorCodes::BadValue, "object to insert exceeds cappedMaxSize");
 
     WiredTigerCursor curwrap(_uri, _tableId, true, txn);
@@ -1469,6 +1581,16 @@ std::unique_ptr<RecordCursor> WiredTigerRecordStore::getRandomCursorWithOptions(
     return stdx::make_unique<RandomCursor>(txn, *this, extraConfig);
 }
 
+std::unique_ptr<RecordCursor> WiredTigerRecordStore::getCursorForRange(
+    OperationContext* txn, const RecordId& start, const RecordId& end) const {
+    // Capped collections hide uncommitted records at their end, which only a cursor that starts at
+    // the beginning of the collection knows how to do.
+    if (_isCapped) {
+        return {};
+    }
+    return stdx::make_unique<Cursor>(txn, *this, /*forward=*/true, start, end);
+}
+
 std::vector<std::unique_ptr<RecordCursor>> WiredTigerRecordStore::getManyCursors(
     OperationContext* txn) const {
     std::vector<std::unique_ptr<RecordCursor>> cursors(1);
@@ -1581,7 +1703,7 @@ void WiredTigerRecordStore::appendCustomStats(OperationContext* txn,
     result->appendBool("capped", _isCapped);
     if (_isCapped) {
         result->appendIntOrLL("max", _cappedMaxDocs);
-        result->appendIntOrLL("maxSize", static_cast<long long>(_cappedMaxSize / scale));
+        result->appendIntOrLL("maxSize", static_cast<long long>(_cappedMaxSize.load() / scale));
         result->appendIntOrLL("sleepCount", _cappedSleep.load());
         result->appendIntOrLL("sleepMS", _cappedSleepMS.load());
     }
@@ -1839,13 +1961,23 @@ void WiredTigerRecordStore::temp_cappedTruncateAfter(OperationContext* txn,
 }
 
 Status WiredTigerRecordStore::updateCappedSize(OperationContext* txn, long long cappedSize) {
-        if (_cappedMaxSize == cappedSize) {
-                return Status::OK();
-        }
-        _cappedMaxSize = cappedSize;
-        if (_oplogStones) {
-                _oplogStones->adjust(cappedSize);
-        }
+    invariant(_isCapped);
+    if (cappedSize <= 0) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "capped size must be positive, got " << cappedSize);
+    }
+    if (_cappedMaxSize.load() == cappedSize) {
         return Status::OK();
+    }
+
+    // Writers read the size without any locks. A shrink is not applied by deleting inline: for
+    // the oplog the reclaim thread truncates whole stones, otherwise cappedDeleteAsNeeded()
+    // catches up on the next inserts.
+    _cappedMaxSize.store(cappedSize);
+    _cappedMaxSizeSlack.store(cappedMaxSizeSlackFor(cappedSize));
+    if (_oplogStones) {
+        _oplogStones->adjust(cappedSize);
+    }
+    return Status::OK();
 }
 }  // namespace mongo
@@ -153,6 +153,9 @@ public:
     std::unique_ptr<RecordCursor> getRandomCursorWithOptions(OperationContext* txn,
                                                              StringData extraConfig) const;
 
+    std::unique_ptr<RecordCursor> getCursorForRange(OperationContext* txn,
+                                                    const RecordId& start,
+                                                    const RecordId& end) const final;
     std::vector<std::unique_ptr<RecordCursor>> getManyCursors(OperationContext* txn) const final;
 
     virtual Status truncate(OperationContext* txn);
@@ -237,6 +240,10 @@ public:
     // Returns false if the oplog was dropped while waiting for a deletion request.
     bool yieldAndAwaitOplogDeletionRequest(OperationContext* txn);
 
+    // Appends the counters of the oplog reclaim thread and the backlog of the active oplog.
+    // Returns false, without appending anything, when there is no active oplog.
+    static bool appendOplogTruncationStats(BSONObjBuilder* builder);
+
     class OplogStones;
 
     // Exposed only for testing.
@@ -279,8 +286,9 @@ private:
     const bool _isEphemeral;
     // True if the namespace of this record store starts with "local.oplog.", and false otherwise.
     const bool _isOplog;
-    int64_t _cappedMaxSize;
-    const int64_t _cappedMaxSizeSlack;  // when to start applying backpressure
+    // Both can be changed by updateCappedSize() while operations are running.
+    AtomicInt64 _cappedMaxSize;
+    AtomicInt64 _cappedMaxSizeSlack;  // when to start applying backpressure
     const int64_t _cappedMaxDocs;
     RecordId _cappedFirstRecord;
     AtomicInt64 _cappedSleep;
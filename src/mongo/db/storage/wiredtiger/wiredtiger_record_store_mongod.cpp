@@ -37,6 +37,7 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/namespace_string.h"
@@ -128,6 +129,27 @@ private:
     std::string _name;
 };
 
+/**
+ * Adds "oplogTruncation" to db.serverStatus(): how much the reclaim thread truncated and how long
+ * it took, and how many bytes of whole stones the oplog holds beyond its maximum size.
+ */
+class OplogTruncationServerStatusSection : public ServerStatusSection {
+public:
+    OplogTruncationServerStatusSection() : ServerStatusSection("oplogTruncation") {}
+
+    bool includeByDefault() const final {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* txn, const BSONElement& configElement) const final {
+        BSONObjBuilder builder;
+        if (!WiredTigerRecordStore::appendOplogTruncationStats(&builder)) {
+            return BSONObj();
+        }
+        return builder.obj();
+    }
+} oplogTruncationServerStatusSection;
+
 }  // namespace
 
 // static
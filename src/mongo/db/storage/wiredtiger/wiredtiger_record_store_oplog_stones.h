@@ -58,12 +58,12 @@ public:
     void kill();
 
     bool hasExcessStones_inlock() const {
-		int64_t total_bytes = 0;
-		for (std::deque<OplogStones::Stone>::const_iterator it = _stones.begin(); it != _stones.end(); ++it) {
-			total_bytes += it->bytes;
-		}
-		return total_bytes > _rs->cappedMaxSize();
-	}
+        return _bytesInStones_inlock() > _rs->cappedMaxSize();
+    }
+
+    // Number of bytes by which the whole stones exceed the maximum size of the oplog, i.e. what
+    // the reclaim thread still has to truncate.
+    int64_t bytesToReclaim() const;
 
     void awaitHasExcessStonesOrDead();
 
@@ -85,8 +85,9 @@ public:
                                               int64_t bytesRemoved,
                                               RecordId firstRemovedId);
 
-	// Resize oplog size
-	void adjust(int64_t maxSize);
+    // Resizes the stones for an oplog of 'maxSize' bytes and wakes up the reclaim thread if the
+    // oplog now holds too many of them.
+    void adjust(int64_t maxSize);
 
     // The start point of where to truncate next. Used by the background reclaim thread to
     // efficiently truncate records with WiredTiger by skipping over tombstones, etc.
@@ -123,6 +124,14 @@ private:
                                     int64_t estRecordsPerStone,
                                     int64_t estBytesPerStone);
 
+    int64_t _bytesInStones_inlock() const {
+        int64_t bytes = 0;
+        for (const auto& stone : _stones) {
+            bytes += stone.bytes;
+        }
+        return bytes;
+    }
+
     void _pokeReclaimThreadIfNeeded();
 
     static const uint64_t kRandomSamplesPerStone = 10;
@@ -956,6 +956,61 @@ TEST(WiredTigerRecordStoreTest, CappedCursorYieldFirst) {
     ASSERT(!cursor->next());
 }
 
+// Cursors over adjacent RecordId ranges together return every record exactly once, in order,
+// including when the bounds fall between records or the cursor yields before it is positioned.
+TEST(WiredTigerRecordStoreTest, CursorForRange) {
+    WiredTigerHarnessHelper harnessHelper;
+    unique_ptr<RecordStore> rs(harnessHelper.newNonCappedRecordStore("a.b"));
+
+    std::vector<RecordId> ids;
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+        for (int i = 0; i < 100; i++) {
+            WriteUnitOfWork uow(opCtx.get());
+            StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "a", 2, false);
+            ASSERT_OK(res.getStatus());
+            ids.push_back(res.getValue());
+            uow.commit();
+        }
+        // Leave a hole so that one of the bounds below does not name an existing record.
+        WriteUnitOfWork uow(opCtx.get());
+        rs->deleteRecord(opCtx.get(), ids[50]);
+        ids.erase(ids.begin() + 50);
+        uow.commit();
+    }
+
+    unique_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+    const std::vector<RecordId> bounds = {
+        RecordId(), ids[10], RecordId(ids[49].repr() + 1), ids[80], RecordId()};
+
+    std::vector<RecordId> seen;
+    for (size_t i = 0; i + 1 < bounds.size(); i++) {
+        auto cursor = rs->getCursorForRange(opCtx.get(), bounds[i], bounds[i + 1]);
+        ASSERT(cursor);
+        cursor->save();
+        opCtx->recoveryUnit()->abandonSnapshot();
+        ASSERT_TRUE(cursor->restore());
+        while (auto record = cursor->next()) {
+            if (!bounds[i + 1].isNull()) {
+                ASSERT_LT(record->id, bounds[i + 1]);
+            }
+            seen.push_back(record->id);
+        }
+    }
+    ASSERT(ids == seen);
+
+    // A range past the last record is empty.
+    auto cursor = rs->getCursorForRange(opCtx.get(), RecordId(ids.back().repr() + 1), RecordId());
+    ASSERT(!cursor->next());
+}
+
+TEST(WiredTigerRecordStoreTest, CursorForRangeOnCapped) {
+    WiredTigerHarnessHelper harnessHelper;
+    unique_ptr<RecordStore> rs(harnessHelper.newCappedRecordStore("a.b", 10000, 50));
+    unique_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+    ASSERT(!rs->getCursorForRange(opCtx.get(), RecordId(1), RecordId()));
+}
+
 BSONObj makeBSONObjWithSize(const Timestamp& opTime, int size, char fill = 'x') {
     BSONObj objTemplate = BSON("ts" << opTime << "str"
                                     << "");
@@ -1356,6 +1411,136 @@ TEST(WiredTigerRecordStoreTest, OplogStones_ReclaimStones) {
     }
 }
 
+// Verify that shrinking the oplog leaves the excess stones to the reclaim thread and that growing
+// it does not drop anything.
+TEST(WiredTigerRecordStoreTest, OplogStones_Resize) {
+    WiredTigerHarnessHelper harnessHelper;
+
+    const int64_t cappedMaxSize = 10 * 1024;  // 10KB
+    unique_ptr<RecordStore> rs(
+        harnessHelper.newCappedRecordStore("local.oplog.stones", cappedMaxSize, -1));
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+
+    oplogStones->setMinBytesPerStone(100);
+
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 1), 100), RecordId(1, 1));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 2), 100), RecordId(1, 2));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 3), 100), RecordId(1, 3));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 4), 100), RecordId(1, 4));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 5), 100), RecordId(1, 5));
+
+        ASSERT_EQ(5U, oplogStones->numStones());
+        ASSERT_EQ(0, oplogStones->bytesToReclaim());
+    }
+
+    // Invalid sizes are rejected and leave the oplog alone.
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+
+        ASSERT_EQUALS(ErrorCodes::BadValue, wtrs->updateCappedSize(opCtx.get(), 0));
+        ASSERT_EQUALS(ErrorCodes::BadValue, wtrs->updateCappedSize(opCtx.get(), -1));
+        ASSERT_EQ(cappedMaxSize, wtrs->cappedMaxSize());
+    }
+
+    // Shrinking does not delete anything by itself.
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+
+        ASSERT_OK(wtrs->updateCappedSize(opCtx.get(), 250));
+
+        ASSERT_EQ(250, wtrs->cappedMaxSize());
+        ASSERT_EQ(5, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(5U, oplogStones->numStones());
+        ASSERT_EQ(250, oplogStones->bytesToReclaim());
+    }
+
+    // The reclaim thread drops whole stones until the rest fits.
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get());
+
+        ASSERT_EQ(2, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(200, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(2U, oplogStones->numStones());
+        ASSERT_EQ(0, oplogStones->bytesToReclaim());
+    }
+
+    // Growing keeps all the records.
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+
+        ASSERT_OK(wtrs->updateCappedSize(opCtx.get(), cappedMaxSize));
+        wtrs->reclaimOplog(opCtx.get());
+
+        ASSERT_EQ(cappedMaxSize, wtrs->cappedMaxSize());
+        ASSERT_EQ(2, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(2U, oplogStones->numStones());
+        ASSERT_EQ(0, oplogStones->bytesToReclaim());
+    }
+}
+
+// Verify that truncations by the reclaim thread and the remaining backlog are reported.
+TEST(WiredTigerRecordStoreTest, OplogStones_TruncationStats) {
+    WiredTigerHarnessHelper harnessHelper;
+
+    const int64_t cappedMaxSize = 10 * 1024;  // 10KB
+    unique_ptr<RecordStore> rs(
+        harnessHelper.newCappedRecordStore("local.oplog.stones", cappedMaxSize, -1));
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+
+    oplogStones->setMinBytesPerStone(100);
+
+    auto getStats = []() {
+        BSONObjBuilder builder;
+        ASSERT_TRUE(WiredTigerRecordStore::appendOplogTruncationStats(&builder));
+        return builder.obj();
+    };
+    BSONObj before = getStats();
+
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 1), 100), RecordId(1, 1));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 2), 100), RecordId(1, 2));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 3), 100), RecordId(1, 3));
+        ASSERT_OK(wtrs->updateCappedSize(opCtx.get(), 150));
+
+        BSONObj stats = getStats();
+        ASSERT_EQ(3, stats["stones"].numberLong());
+        ASSERT_EQ(150, stats["bytesToReclaim"].numberLong());
+    }
+
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper.newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get());
+
+        BSONObj stats = getStats();
+        ASSERT_EQ(1, stats["stones"].numberLong());
+        ASSERT_EQ(0, stats["bytesToReclaim"].numberLong());
+        ASSERT_EQ(2, stats["truncateCount"].numberLong() - before["truncateCount"].numberLong());
+        ASSERT_EQ(2,
+                  stats["recordsTruncated"].numberLong() -
+                      before["recordsTruncated"].numberLong());
+        ASSERT_EQ(200,
+                  stats["bytesTruncated"].numberLong() - before["bytesTruncated"].numberLong());
+    }
+
+    // Nothing is reported once the oplog is gone.
+    rs.reset();
+    BSONObjBuilder builder;
+    ASSERT_FALSE(WiredTigerRecordStore::appendOplogTruncationStats(&builder));
+    ASSERT_TRUE(builder.obj().isEmpty());
+}
+
 // Verify that an oplog stone isn't created if it would cause the logical representation of the
 // records to not be in increasing order.
 TEST(WiredTigerRecordStoreTest, OplogStones_AscendingOrder) {
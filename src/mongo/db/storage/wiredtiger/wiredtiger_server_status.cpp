@@ -76,6 +76,11 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* txn,
 
     WiredTigerKVEngine::appendGlobalStats(bob);
 
+    {
+        BSONObjBuilder sessionCache(bob.subobjStart("sessionCache"));
+        _engine->getSessionCache()->appendStats(&sessionCache);
+    }
+
     return bob.obj();
 }
 
@@ -33,13 +33,24 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <new>
+
 #include "mongo/base/error_codes.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -120,6 +131,14 @@ void WiredTigerSession::closeAllCursors(uint64_t cursorEpoch) {
 
 namespace {
 AtomicUInt64 nextTableId(1);
+
+// Upper bound for the number of session cache shards, regardless of the number of CPUs
+const unsigned kMaxSessionCacheShards = 64;
+
+unsigned numSessionCacheShards() {
+    ProcessInfo pi;
+    return std::max(1U, std::min(pi.getNumCores(), kMaxSessionCacheShards));
+}
 }
 // static
 uint64_t WiredTigerSession::genTableId() {
@@ -129,13 +148,41 @@ uint64_t WiredTigerSession::genTableId() {
 // -----------------------
 
 WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
-    : _engine(engine), _conn(engine->getConnection()), _snapshotManager(_conn), _shuttingDown(0) {}
+    : _engine(engine),
+      _conn(engine->getConnection()),
+      _snapshotManager(_conn),
+      _shuttingDown(0),
+      _numShards(numSessionCacheShards()),
+      _shardStorage(new char[_numShards * sizeof(Shard) + kCacheLineSize]),
+      _shards(_constructShards(_shardStorage.get(), _numShards)) {}
 
 WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn)
-    : _engine(NULL), _conn(conn), _snapshotManager(_conn), _shuttingDown(0) {}
+    : _engine(NULL),
+      _conn(conn),
+      _snapshotManager(_conn),
+      _shuttingDown(0),
+      _numShards(numSessionCacheShards()),
+      _shardStorage(new char[_numShards * sizeof(Shard) + kCacheLineSize]),
+      _shards(_constructShards(_shardStorage.get(), _numShards)) {}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
     shuttingDown();
+
+    for (unsigned i = 0; i < _numShards; i++) {
+        _shards[i].~Shard();
+    }
+}
+
+// static
+WiredTigerSessionCache::Shard* WiredTigerSessionCache::_constructShards(char* storage,
+                                                                        unsigned numShards) {
+    const uintptr_t address = reinterpret_cast<uintptr_t>(storage);
+    Shard* const shards =
+        reinterpret_cast<Shard*>((address + kCacheLineSize - 1) & ~(kCacheLineSize - 1));
+    for (unsigned i = 0; i < numShards; i++) {
+        new (&shards[i]) Shard();
+    }
+    return shards;
 }
 
 void WiredTigerSessionCache::shuttingDown() {
@@ -219,9 +266,13 @@ void WiredTigerSessionCache::closeAllCursors() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     uint64_t cursorEpoch = _cursorEpoch.addAndFetch(1);
 
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(cursorEpoch);
+    for (unsigned i = 0; i < _numShards; i++) {
+        Shard& shard = _shards[i];
+        stdx::lock_guard<stdx::mutex> lock(shard.lock);
+        for (SessionCache::iterator it = shard.sessions.begin(); it != shard.sessions.end();
+             it++) {
+            (*it)->closeAllCursors(cursorEpoch);
+        }
     }
 }
 
@@ -230,9 +281,21 @@ void WiredTigerSessionCache::closeAll() {
     SessionCache swap;
 
     {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        // Lock every shard, in order, so that no session of the old epoch can be handed out or
+        // returned to the cache once the epoch has been incremented.
+        std::vector<stdx::unique_lock<stdx::mutex>> locks;
+        for (unsigned i = 0; i < _numShards; i++) {
+            locks.emplace_back(_shards[i].lock);
+        }
+
         _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
+
+        for (unsigned i = 0; i < _numShards; i++) {
+            Shard& shard = _shards[i];
+            swap.insert(swap.end(), shard.sessions.begin(), shard.sessions.end());
+            shard.sessions.clear();
+            shard.numSessions.store(0);
+        }
     }
 
     for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
@@ -249,17 +312,34 @@ WiredTigerSession* WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) {
+    const unsigned home = _getShardIndex();
+
+    // Start with the shard of the current CPU and steal from the others if it is empty
+    for (unsigned i = 0; i < _numShards; i++) {
+        Shard& shard = _shards[(home + i) % _numShards];
+        if (i > 0 && !shard.numSessions.loadRelaxed()) {
+            continue;
+        }
+
+        stdx::lock_guard<stdx::mutex> lock(shard.lock);
+        if (!shard.sessions.empty()) {
             // Get the most recently used session so that if we discard sessions, we're
             // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
+            WiredTigerSession* cachedSession = shard.sessions.back();
+            shard.sessions.pop_back();
+            shard.numSessions.store(shard.sessions.size());
+
+            if (i == 0) {
+                shard.hits.fetchAndAdd(1);
+            } else {
+                _shards[home].steals.fetchAndAdd(1);
+            }
             return cachedSession;
         }
     }
 
+    _shards[home].misses.fetchAndAdd(1);
+
     // Outside of the cache partition lock, but on release will be put back on the cache
     return new WiredTigerSession(_conn, _epoch.load(), _cursorEpoch.load());
 }
@@ -297,10 +377,12 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     uint64_t currentEpoch = _epoch.load();
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        Shard& shard = _shards[_getShardIndex()];
+        stdx::lock_guard<stdx::mutex> lock(shard.lock);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            shard.sessions.push_back(session);
+            shard.numSessions.store(shard.sessions.size());
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -316,4 +398,35 @@ void WiredTigerSessionCache::setJournalListener(JournalListener* jl) {
     stdx::unique_lock<stdx::mutex> lk(_journalListenerMutex);
     _journalListener = jl;
 }
+
+void WiredTigerSessionCache::appendStats(BSONObjBuilder* builder) const {
+    long long sessionsCached = 0;
+    long long hits = 0;
+    long long steals = 0;
+    long long misses = 0;
+
+    for (unsigned i = 0; i < _numShards; i++) {
+        const Shard& shard = _shards[i];
+        sessionsCached += shard.numSessions.load();
+        hits += shard.hits.load();
+        steals += shard.steals.load();
+        misses += shard.misses.load();
+    }
+
+    builder->append("shards", static_cast<int>(_numShards));
+    builder->append("sessionsCached", sessionsCached);
+    builder->append("hits", hits);
+    builder->append("steals", steals);
+    builder->append("misses", misses);
+}
+
+unsigned WiredTigerSessionCache::_getShardIndex() const {
+#if defined(__linux__)
+    const int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        return cpu % _numShards;
+    }
+#endif
+    return std::hash<stdx::thread::id>()(stdx::this_thread::get_id()) % _numShards;
+}
 }
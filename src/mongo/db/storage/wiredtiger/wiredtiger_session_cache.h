@@ -32,7 +32,9 @@
 #pragma once
 
 #include <list>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <boost/thread/shared_mutex.hpp>
 #include <wiredtiger.h>
@@ -40,11 +42,13 @@
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/platform/compiler.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/spin_lock.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerKVEngine;
 
 class WiredTigerCachedCursor {
@@ -123,6 +127,10 @@ private:
 /**
  *  This cache implements a shared pool of WiredTiger sessions with the goal to amortize the
  *  cost of session creation and destruction over multiple uses.
+ *
+ *  The pool is split into one shard per CPU, so that getting and releasing a session normally
+ *  only touches the shard of the CPU the thread runs on. A thread which finds its shard empty
+ *  steals a session from another shard before opening a new one.
  */
 class WiredTigerSessionCache {
 public:
@@ -183,7 +191,46 @@ public:
 
     void setJournalListener(JournalListener* jl);
 
+    /**
+     * Appends the number of cached sessions and how often getSession was served from the
+     * current CPU's shard, from another shard or by opening a new session.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
 private:
+    typedef std::vector<WiredTigerSession*> SessionCache;
+
+    // Each shard starts on a cache line of its own, so that the lock and counters of neighbouring
+    // shards never share one
+    static const size_t kCacheLineSize = 64;
+
+    struct MONGO_COMPILER_ALIGN_TYPE(64) Shard {
+        stdx::mutex lock;
+        SessionCache sessions;  // protected by 'lock'
+
+        // Size of 'sessions', so that empty shards can be skipped without locking them
+        AtomicUInt32 numSessions;
+
+        // Outcomes of the getSession calls which started at this shard
+        AtomicUInt64 hits;
+        AtomicUInt64 steals;
+        AtomicUInt64 misses;
+    };
+
+    static_assert(alignof(Shard) == kCacheLineSize, "shards must start on a cache line");
+    static_assert(sizeof(Shard) % kCacheLineSize == 0, "shards must fill whole cache lines");
+
+    /**
+     * Constructs 'numShards' shards at the first cache line boundary of 'storage', which must
+     * have room for them and for a cache line more.
+     */
+    static Shard* _constructShards(char* storage, unsigned numShards);
+
+    /**
+     * Returns the index of the shard for the CPU the calling thread runs on.
+     */
+    unsigned _getShardIndex() const;
+
     WiredTigerKVEngine* _engine;  // not owned, might be NULL
     WT_CONNECTION* _conn;         // not owned
     WiredTigerSnapshotManager _snapshotManager;
@@ -194,11 +241,14 @@ private:
     AtomicUInt32 _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
-    typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
+    const unsigned _numShards;
+
+    // Before C++17 new[] does not honour the alignment of Shard, so the shards are constructed
+    // in storage with a spare cache line to align them in
+    std::unique_ptr<char[]> _shardStorage;
+    Shard* const _shards;
 
-    // Bumped when all open sessions need to be closed
+    // Bumped when all open sessions need to be closed. Only changes while all shards are locked.
     AtomicUInt64 _epoch;  // atomic so we can check it outside of the lock
 
     // Bumped when all open cursors need to be closed
@@ -0,0 +1,147 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class WiredTigerConnection {
+public:
+    WiredTigerConnection(StringData dbpath) : _conn(NULL) {
+        int ret = wiredtiger_open(dbpath.toString().c_str(), NULL, "create", &_conn);
+        ASSERT_OK(wtRCToStatus(ret));
+        ASSERT(_conn);
+    }
+    ~WiredTigerConnection() {
+        _conn->close(_conn, NULL);
+    }
+    WT_CONNECTION* getConnection() const {
+        return _conn;
+    }
+
+private:
+    WT_CONNECTION* _conn;
+};
+
+class WiredTigerSessionCacheHarness {
+public:
+    WiredTigerSessionCacheHarness()
+        : _dbpath("wt_session_cache_test"),
+          _connection(_dbpath.path()),
+          _sessionCache(_connection.getConnection()) {}
+
+    WiredTigerSessionCache* getSessionCache() {
+        return &_sessionCache;
+    }
+
+    BSONObj stats() {
+        BSONObjBuilder builder;
+        _sessionCache.appendStats(&builder);
+        return builder.obj();
+    }
+
+private:
+    unittest::TempDir _dbpath;
+    WiredTigerConnection _connection;
+    WiredTigerSessionCache _sessionCache;
+};
+
+TEST(WiredTigerSessionCacheTest, ReleasedSessionIsReused) {
+    WiredTigerSessionCacheHarness harness;
+    WiredTigerSessionCache* cache = harness.getSessionCache();
+
+    WiredTigerSession* session = cache->getSession();
+    ASSERT_EQUALS(1, harness.stats()["misses"].numberLong());
+
+    cache->releaseSession(session);
+    ASSERT_EQUALS(1, harness.stats()["sessionsCached"].numberLong());
+
+    // The thread may have moved to another CPU in between, in which case the session is stolen
+    // from the shard it was released to.
+    ASSERT_EQUALS(session, cache->getSession());
+    BSONObj stats = harness.stats();
+    ASSERT_EQUALS(1, stats["hits"].numberLong() + stats["steals"].numberLong());
+    ASSERT_EQUALS(1, stats["misses"].numberLong());
+    ASSERT_EQUALS(0, stats["sessionsCached"].numberLong());
+
+    cache->releaseSession(session);
+}
+
+TEST(WiredTigerSessionCacheTest, CloseAllDropsSessionsOfOlderEpochs) {
+    WiredTigerSessionCacheHarness harness;
+    WiredTigerSessionCache* cache = harness.getSessionCache();
+
+    WiredTigerSession* cached = cache->getSession();
+    WiredTigerSession* outstanding = cache->getSession();
+    cache->releaseSession(cached);
+    ASSERT_EQUALS(1, harness.stats()["sessionsCached"].numberLong());
+
+    cache->closeAll();
+    ASSERT_EQUALS(0, harness.stats()["sessionsCached"].numberLong());
+
+    // A session handed out before closeAll is closed on release instead of being cached
+    cache->releaseSession(outstanding);
+    ASSERT_EQUALS(0, harness.stats()["sessionsCached"].numberLong());
+
+    WiredTigerSession* session = cache->getSession();
+    ASSERT_EQUALS(3, harness.stats()["misses"].numberLong());
+    cache->releaseSession(session);
+    ASSERT_EQUALS(1, harness.stats()["sessionsCached"].numberLong());
+}
+
+TEST(WiredTigerSessionCacheTest, ConcurrentGetAndRelease) {
+    WiredTigerSessionCacheHarness harness;
+    WiredTigerSessionCache* cache = harness.getSessionCache();
+
+    const int kThreads = 8;
+    const int kIterations = 1000;
+
+    std::vector<stdx::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([cache] {
+            for (int i = 0; i < kIterations; i++) {
+                WiredTigerSession* session = cache->getSession();
+                cache->releaseSession(session);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Every call is accounted for exactly once and every session which was opened is cached
+    BSONObj stats = harness.stats();
+    ASSERT_EQUALS(kThreads * kIterations,
+                  stats["hits"].numberLong() + stats["steals"].numberLong() +
+                      stats["misses"].numberLong());
+    ASSERT_EQUALS(stats["misses"].numberLong(), stats["sessionsCached"].numberLong());
+}
+
+}  // namespace
+}  // namespace mongo
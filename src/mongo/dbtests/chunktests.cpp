@@ -61,7 +61,7 @@ public:
             _chunkMap[mySplitPoints[i]] = chunk;
         }
 
-        _chunkRanges.reloadAll(_chunkMap);
+        _routingTable = ChunkRoutingTable(_chunkMap);
     }
 };
 
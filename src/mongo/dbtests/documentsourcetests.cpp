@@ -37,7 +37,9 @@
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/util/timer.h"
 namespace DocumentSourceCursorTests {
 
 using boost::intrusive_ptr;
@@ -236,6 +238,85 @@ public:
     }
 };
 
+/**
+ * Compares a $group reading column batches from the cursor with one reading documents. Both must
+ * give the same results, and the time of each is logged.
+ */
+class GroupBatches : public Base {
+public:
+    void run() {
+        const int kNumDocs = 100 * 1000;
+        for (int i = 0; i < kNumDocs; i++) {
+            BSONObjBuilder doc;
+            doc.append("_id", i);
+            doc.append("k", i % 100);
+            if (i % 10) {
+                doc.append("a", i);
+            } else {
+                doc.append("a", i * 0.5);
+            }
+            doc.append("b", static_cast<long long>(i) * 3);
+            doc.append("pad", "0123456789abcdef");
+            client.insert(nss.ns(), doc.obj());
+        }
+
+        const BSONObj specs[] = {
+            BSON("_id" << BSONNULL << "total" << BSON("$sum"
+                                                      << "$a")),
+            BSON("_id"
+                 << "$k"
+                 << "total" << BSON("$sum"
+                                    << "$b")
+                 << "avg" << BSON("$avg"
+                                  << "$a")
+                 << "min" << BSON("$min"
+                                  << "$a")
+                 << "max" << BSON("$max"
+                                  << "$b")),
+        };
+        for (auto&& spec : specs) {
+            long long batchedMillis;
+            long long documentMillis;
+            BSONObj batched = runGroup(spec, true, &batchedMillis);
+            BSONObj documents = runGroup(spec, false, &documentMillis);
+            ASSERT_EQUALS(documents, batched);
+            mongo::unittest::log() << "$group " << spec << " over " << kNumDocs
+                                   << " documents: " << batchedMillis << "ms with column batches, "
+                                   << documentMillis << "ms without";
+        }
+    }
+
+private:
+    BSONObj runGroup(const BSONObj& spec, bool useBatches, long long* millis) {
+        ServerParameter* knob = ServerParameterSet::getGlobal()->getMap().find(
+            "internalDocumentSourceGroupUseBatches")->second;
+        ASSERT_OK(knob->setFromString(useBatches ? "true" : "false"));
+
+        createSource();
+        BSONObj groupSpec = BSON("$group" << spec);
+        intrusive_ptr<DocumentSource> group =
+            DocumentSourceGroup::createFromBson(groupSpec.firstElement(), ctx());
+        group->setSource(source());
+
+        Timer timer;
+        std::vector<Document> results;
+        while (boost::optional<Document> next = group->getNext()) {
+            results.push_back(*next);
+        }
+        *millis = timer.millis();
+        ASSERT_OK(knob->setFromString("true"));
+
+        std::sort(results.begin(), results.end(), [](const Document& lhs, const Document& rhs) {
+            return Value::compare(lhs["_id"], rhs["_id"]) < 0;
+        });
+        BSONArrayBuilder out;
+        for (auto&& result : results) {
+            out << result;
+        }
+        return BSON("results" << out.arr());
+    }
+};
+
 }  // namespace DocumentSourceCursor
 
 class All : public Suite {
@@ -247,6 +328,7 @@ public:
         add<DocumentSourceCursor::Dispose>();
         add<DocumentSourceCursor::IterateDispose>();
         add<DocumentSourceCursor::LimitCoalesce>();
+        add<DocumentSourceCursor::GroupBatches>();
     }
 };
 
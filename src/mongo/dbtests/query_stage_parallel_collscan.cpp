@@ -0,0 +1,232 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+/**
+ * This file tests db/exec/parallel_collection_scan.cpp.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+
+#include "mongo/client/dbclientcursor.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/exec/parallel_collection_scan.h"
+#include "mongo/db/exec/plan_stats.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/operation_context_impl.h"
+#include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/dbtests/dbtests.h"
+#include "mongo/stdx/memory.h"
+
+namespace QueryStageParallelCollectionScan {
+
+using std::unique_ptr;
+using std::vector;
+using stdx::make_unique;
+
+class Base {
+public:
+    Base()
+        : _client(&_txn),
+          _maxDOP(internalQueryExecParallelCollScanMaxDOP.load()),
+          _minRecords(internalQueryExecParallelCollScanMinRecords.load()) {
+        internalQueryExecParallelCollScanMaxDOP.store(4);
+        internalQueryExecParallelCollScanMinRecords.store(0);
+
+        OldClientWriteContext ctx(&_txn, ns());
+        for (int i = 0; i < numObj(); ++i) {
+            _client.insert(ns(), BSON("foo" << i << "pad" << std::string(i % 100, 'x')));
+        }
+    }
+
+    virtual ~Base() {
+        internalQueryExecParallelCollScanMaxDOP.store(_maxDOP);
+        internalQueryExecParallelCollScanMinRecords.store(_minRecords);
+
+        OldClientWriteContext ctx(&_txn, ns());
+        _client.dropCollection(ns());
+    }
+
+    /**
+     * Runs a parallel scan with 'filterObj' and returns the values of "foo" in the order they
+     * were returned. Fills in 'statsOut' if it is not null.
+     */
+    vector<int> run(const BSONObj& filterObj,
+                    bool ordered,
+                    ParallelCollectionScanStats* statsOut = nullptr) {
+        AutoGetCollectionForRead ctx(&_txn, ns());
+
+        CollectionScanParams params;
+        params.collection = ctx.getCollection();
+
+        StatusWithMatchExpression statusWithMatcher = MatchExpressionParser::parse(filterObj);
+        ASSERT_OK(statusWithMatcher.getStatus());
+        unique_ptr<MatchExpression> filterExpr = std::move(statusWithMatcher.getValue());
+
+        unique_ptr<WorkingSet> ws = make_unique<WorkingSet>();
+        unique_ptr<PlanStage> ps = make_unique<ParallelCollectionScan>(
+            &_txn, params, ws.get(), filterExpr.get(), ordered);
+        PlanStage* scan = ps.get();
+
+        auto statusWithPlanExecutor = PlanExecutor::make(
+            &_txn, std::move(ws), std::move(ps), params.collection, PlanExecutor::YIELD_MANUAL);
+        ASSERT_OK(statusWithPlanExecutor.getStatus());
+        unique_ptr<PlanExecutor> exec = std::move(statusWithPlanExecutor.getValue());
+
+        vector<int> out;
+        BSONObj obj;
+        PlanExecutor::ExecState state;
+        while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, NULL))) {
+            out.push_back(obj["foo"].numberInt());
+        }
+        ASSERT_EQUALS(PlanExecutor::IS_EOF, state);
+
+        if (statsOut) {
+            unique_ptr<PlanStageStats> stats = scan->getStats();
+            *statsOut = *static_cast<ParallelCollectionScanStats*>(stats->specific.get());
+        }
+        return out;
+    }
+
+    /**
+     * Returns true if the storage engine can split the collection into RecordId ranges, which is
+     * what the stage needs to run workers.
+     */
+    bool canSplit() {
+        AutoGetCollectionForRead ctx(&_txn, ns());
+        return bool(ctx.getCollection()->getRecordStore()->getCursorForRange(
+            &_txn, RecordId(), RecordId()));
+    }
+
+    static int numObj() {
+        return 5000;
+    }
+
+    static const char* ns() {
+        return "unittests.QueryStageParallelCollectionScan";
+    }
+
+protected:
+    OperationContextImpl _txn;
+
+private:
+    DBDirectClient _client;
+    const int _maxDOP;
+    const int _minRecords;
+};
+
+// Every matching document is returned exactly once, and the work is spread over several workers.
+class Unordered : public Base {
+public:
+    void run() {
+        ParallelCollectionScanStats stats;
+        vector<int> results = Base::run(fromjson("{foo: {$mod: [3, 0]}}"), false, &stats);
+        std::sort(results.begin(), results.end());
+
+        vector<int> expected;
+        for (int i = 0; i < numObj(); i += 3) {
+            expected.push_back(i);
+        }
+        ASSERT(expected == results);
+
+        if (canSplit()) {
+            ASSERT_EQUALS(4U, stats.workers);
+            ASSERT_GREATER_THAN(stats.ranges, 1U);
+            ASSERT_EQUALS(static_cast<size_t>(numObj()), stats.docsTested);
+        } else {
+            ASSERT_EQUALS(0U, stats.workers);
+        }
+    }
+};
+
+// An ordered scan returns the documents in RecordId order, which is insertion order here.
+class Ordered : public Base {
+public:
+    void run() {
+        ParallelCollectionScanStats stats;
+        vector<int> results = Base::run(BSONObj(), true, &stats);
+        ASSERT_EQUALS(static_cast<size_t>(numObj()), results.size());
+        for (int i = 0; i < numObj(); ++i) {
+            ASSERT_EQUALS(i, results[i]);
+        }
+        ASSERT(stats.ordered);
+    }
+};
+
+// Small collections, and a per-query degree of parallelism of 1, are scanned in a single thread.
+class SerialFallback : public Base {
+public:
+    void run() {
+        ParallelCollectionScanStats stats;
+
+        internalQueryExecParallelCollScanMinRecords.store(numObj() + 1);
+        ASSERT_EQUALS(static_cast<size_t>(numObj()), Base::run(BSONObj(), true, &stats).size());
+        ASSERT_EQUALS(0U, stats.workers);
+
+        internalQueryExecParallelCollScanMinRecords.store(0);
+        internalQueryExecParallelCollScanMaxDOP.store(1);
+        ASSERT_EQUALS(static_cast<size_t>(numObj()), Base::run(BSONObj(), false, &stats).size());
+        ASSERT_EQUALS(0U, stats.workers);
+    }
+};
+
+// The global limit on workers caps each scan.
+class GlobalWorkerLimit : public Base {
+public:
+    GlobalWorkerLimit() : _maxWorkers(internalQueryExecParallelCollScanMaxWorkers.load()) {}
+
+    ~GlobalWorkerLimit() {
+        internalQueryExecParallelCollScanMaxWorkers.store(_maxWorkers);
+    }
+
+    void run() {
+        if (!canSplit()) {
+            return;
+        }
+
+        ParallelCollectionScanStats stats;
+        internalQueryExecParallelCollScanMaxWorkers.store(2);
+        ASSERT_EQUALS(static_cast<size_t>(numObj()), Base::run(BSONObj(), false, &stats).size());
+        ASSERT_EQUALS(2U, stats.workers);
+
+        internalQueryExecParallelCollScanMaxWorkers.store(1);
+        ASSERT_EQUALS(static_cast<size_t>(numObj()), Base::run(BSONObj(), false, &stats).size());
+        ASSERT_EQUALS(0U, stats.workers);
+    }
+
+private:
+    const int _maxWorkers;
+};
+
+class All : public Suite {
+public:
+    All() : Suite("QueryStageParallelCollectionScan") {}
+
+    void setupTests() {
+        add<Unordered>();
+        add<Ordered>();
+        add<SerialFallback>();
+        add<GlobalWorkerLimit>();
+    }
+};
+
+SuiteInstance<All> all;
+}  // namespace QueryStageParallelCollectionScan
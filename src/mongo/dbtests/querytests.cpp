@@ -1695,6 +1695,62 @@ public:
     }
 };
 
+/**
+ * Check that many open cursors of one collection, which are spread across the partitions of its
+ * cursor manager, can each be found, pinned, invalidated and killed.
+ */
+class ManyCursors : public CollectionBase {
+public:
+    ManyCursors() : CollectionBase("manycursors") {}
+    void run() {
+        const int kNumCursors = 100;
+        for (int i = 0; i < 10; ++i) {
+            insert(ns(), BSON("_id" << i));
+        }
+
+        std::vector<std::unique_ptr<DBClientCursor>> cursors;
+        std::set<long long> cursorIds;
+        for (int i = 0; i < kNumCursors; ++i) {
+            cursors.push_back(_client.query(ns(), BSONObj(), 0, 0, 0, 0, 2));
+            ASSERT_EQUALS(2, cursors.back()->objsLeftInBatch());
+            cursorIds.insert(cursors.back()->getCursorId());
+        }
+        ASSERT_EQUALS(static_cast<size_t>(kNumCursors), cursorIds.size());
+        ASSERT_EQUALS(static_cast<size_t>(kNumCursors), numCursorsOpen());
+
+        {
+            AutoGetCollectionForRead ctx(&_txn, ns());
+            CursorManager* cursorManager = ctx.getCollection()->getCursorManager();
+            std::set<CursorId> openCursors;
+            cursorManager->getCursorIds(&openCursors);
+            ASSERT_EQUALS(static_cast<size_t>(kNumCursors), openCursors.size());
+
+            for (long long cursorId : cursorIds) {
+                ClientCursorPin pin(cursorManager, cursorId);
+                ASSERT(pin.c());
+                ASSERT_THROWS_CODE(cursorManager->find(cursorId, true), UserException, 12051);
+            }
+        }
+
+        // Every cursor still returns the documents left after a delete.
+        _client.remove(ns(), BSON("_id" << 9));
+        for (size_t i = 0; i < cursors.size(); ++i) {
+            ASSERT_EQUALS(9, cursors[i]->itcount());
+        }
+        ASSERT_EQUALS(0U, numCursorsOpen());
+
+        // Killing them empties the cursor manager.
+        for (int i = 0; i < kNumCursors; ++i) {
+            cursors[i] = _client.query(ns(), BSONObj(), 0, 0, 0, 0, 2);
+        }
+        ASSERT_EQUALS(static_cast<size_t>(kNumCursors), numCursorsOpen());
+        for (size_t i = 0; i < cursors.size(); ++i) {
+            ASSERT(CursorManager::eraseCursorGlobal(&_txn, cursors[i]->getCursorId()));
+        }
+        ASSERT_EQUALS(0U, numCursorsOpen());
+    }
+};
+
 namespace queryobjecttests {
 class names1 {
 public:
@@ -1790,6 +1846,7 @@ public:
         add<QueryCursorTimeout>();
         add<QueryReadsAll>();
         add<KillPinnedCursor>();
+        add<ManyCursors>();
 
         add<queryobjecttests::names1>();
 
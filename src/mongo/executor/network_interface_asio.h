@@ -56,6 +56,7 @@
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/net/message_compressor_manager.h"
 
 namespace mongo {
 
@@ -145,6 +146,8 @@ private:
         rpc::ProtocolSet clientProtocols() const;
         void setServerProtocols(rpc::ProtocolSet protocols);
 
+        MessageCompressorManager& compressorManager();
+
 // Explicit move construction and assignment to support MSVC
 #if defined(_MSC_VER) && _MSC_VER < 1900
         AsyncConnection(AsyncConnection&&);
@@ -162,6 +165,8 @@ private:
         // Dynamically initialized from [min max]WireVersionOutgoing.
         // Its expected that isMaster response is checked only on the caller.
         rpc::ProtocolSet _clientProtocols{rpc::supports::kNone};
+
+        MessageCompressorManager _compressorManager;
     };
 
     /**
@@ -201,6 +206,18 @@ private:
         Message& toRecv();
         MSGHEADER::Value& header();
 
+        /**
+         * Assigns toSend() a new request id and returns the message to write to the stream:
+         * toSend() itself, or its compressed form if compression was negotiated on the
+         * connection.
+         */
+        Message& prepareToSend();
+
+        /**
+         * Replaces toRecv() with its decompressed form if it arrived compressed.
+         */
+        Status decompressReceived();
+
         ResponseStatus response(rpc::Protocol protocol,
                                 Date_t now,
                                 rpc::EgressMetadataHook* metadataHook = nullptr);
@@ -213,6 +230,9 @@ private:
         Message _toSend;
         Message _toRecv;
 
+        // The OP_COMPRESSED form of _toSend, when it was sent compressed.
+        Message _toSendCompressed;
+
         // TODO: Investigate efficiency of storing header separately.
         MSGHEADER::Value _header;
 
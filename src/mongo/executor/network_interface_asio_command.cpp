@@ -79,8 +79,6 @@ template <typename Handler>
 void asyncSendMessage(AsyncStreamInterface& stream, Message* m, Handler&& handler) {
     static_assert(IsNetworkHandler<Handler>::value,
                   "Handler passed to asyncSendMessage does not conform to NetworkHandler concept");
-    m->header().setResponseTo(0);
-    m->header().setId(nextMessageId());
     // TODO: Some day we may need to support vector messages.
     fassert(28708, m->buf() != 0);
     stream.write(asio::buffer(m->buf(), m->size()), std::forward<Handler>(handler));
@@ -197,6 +195,21 @@ MSGHEADER::Value& NetworkInterfaceASIO::AsyncCommand::header() {
     return _header;
 }
 
+Message& NetworkInterfaceASIO::AsyncCommand::prepareToSend() {
+    _toSend.header().setResponseTo(0);
+    _toSend.header().setId(nextMessageId());
+
+    _toSendCompressed.reset();
+    if (_conn->compressorManager().compressMessage(_toSend, &_toSendCompressed)) {
+        return _toSendCompressed;
+    }
+    return _toSend;
+}
+
+Status NetworkInterfaceASIO::AsyncCommand::decompressReceived() {
+    return _conn->compressorManager().decompressMessage(&_toRecv);
+}
+
 ResponseStatus NetworkInterfaceASIO::AsyncCommand::response(rpc::Protocol protocol,
                                                             Date_t now,
                                                             rpc::EgressMetadataHook* metadataHook) {
@@ -371,6 +384,12 @@ void NetworkInterfaceASIO::_asyncRunCommand(AsyncOp* op, NetworkOpHandler handle
 
     // Step 4
     auto recvMessageCallback = [this, cmd, handler, op](std::error_code ec, size_t bytes) {
+        if (!ec) {
+            auto status = cmd->decompressReceived();
+            if (!status.isOK()) {
+                return handler(make_error_code(status.code()), bytes);
+            }
+        }
         // We don't call _validateAndRun here as we assume the caller will.
         handler(ec, bytes);
     };
@@ -415,7 +434,7 @@ void NetworkInterfaceASIO::_asyncRunCommand(AsyncOp* op, NetworkOpHandler handle
         };
 
     // Step 1
-    asyncSendMessage(cmd->conn().stream(), &cmd->toSend(), std::move(sendMessageCallback));
+    asyncSendMessage(cmd->conn().stream(), &cmd->prepareToSend(), std::move(sendMessageCallback));
 }
 
 void NetworkInterfaceASIO::_runConnectionHook(AsyncOp* op) {
@@ -60,13 +60,15 @@ NetworkInterfaceASIO::AsyncConnection::AsyncConnection(std::unique_ptr<AsyncStre
 NetworkInterfaceASIO::AsyncConnection::AsyncConnection(AsyncConnection&& other)
     : _stream(std::move(other._stream)),
       _serverProtocols(other._serverProtocols),
-      _clientProtocols(other._clientProtocols) {}
+      _clientProtocols(other._clientProtocols),
+      _compressorManager(std::move(other._compressorManager)) {}
 
 NetworkInterfaceASIO::AsyncConnection& NetworkInterfaceASIO::AsyncConnection::operator=(
     AsyncConnection&& other) {
     _stream = std::move(other._stream);
     _serverProtocols = other._serverProtocols;
     _clientProtocols = other._clientProtocols;
+    _compressorManager = std::move(other._compressorManager);
     return *this;
 }
 #endif
@@ -91,6 +93,10 @@ void NetworkInterfaceASIO::AsyncConnection::setServerProtocols(rpc::ProtocolSet
     _serverProtocols = protocols;
 }
 
+MessageCompressorManager& NetworkInterfaceASIO::AsyncConnection::compressorManager() {
+    return _compressorManager;
+}
+
 void NetworkInterfaceASIO::_connect(AsyncOp* op) {
     log() << "Connecting to " << op->request().target.toString();
 
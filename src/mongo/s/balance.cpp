@@ -33,6 +33,7 @@
 #include "mongo/s/balance.h"
 
 #include <algorithm>
+#include <list>
 
 #include "mongo/client/dbclientcursor.h"
 #include "mongo/client/remote_command_targeter.h"
@@ -40,8 +41,12 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/db/write_concern_options.h"
+#include "mongo/executor/task_executor.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/rpc/metadata.h"
 #include "mongo/s/balancer_policy.h"
 #include "mongo/s/catalog/catalog_cache.h"
 #include "mongo/s/catalog/catalog_manager.h"
@@ -55,6 +60,8 @@
 #include "mongo/s/grid.h"
 #include "mongo/s/client/shard.h"
 #include "mongo/s/client/shard_registry.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -79,10 +86,15 @@ class BalanceRoundDetails {
 public:
     BalanceRoundDetails() : _executionTimer() {}
 
-    void setSucceeded(int candidateChunks, int chunksMoved) {
+    void setSucceeded(int candidateChunks,
+                      int chunksMoved,
+                      int migrationsFailed,
+                      int maxConcurrentMigrations) {
         invariant(!_errMsg);
         _candidateChunks = candidateChunks;
         _chunksMoved = chunksMoved;
+        _migrationsFailed = migrationsFailed;
+        _maxConcurrentMigrations = maxConcurrentMigrations;
     }
 
     void setFailed(const string& errMsg) {
@@ -99,6 +111,8 @@ public:
         } else {
             builder.append("candidateChunks", _candidateChunks);
             builder.append("chunksMoved", _chunksMoved);
+            builder.append("migrationsFailed", _migrationsFailed);
+            builder.append("maxConcurrentMigrations", _maxConcurrentMigrations);
         }
 
         return builder.obj();
@@ -110,11 +124,93 @@ private:
     // Set only on success
     int _candidateChunks{0};
     int _chunksMoved{0};
+    int _migrationsFailed{0};
+    int _maxConcurrentMigrations{0};
 
     // Set only on failure
     boost::optional<std::string> _errMsg;
 };
 
+/**
+ * Collects the responses to the migrations which the balancer issued through the task executor.
+ */
+class MigrationResults {
+public:
+    using Result = std::pair<shared_ptr<MigrateInfo>, StatusWith<executor::RemoteCommandResponse>>;
+
+    void add(shared_ptr<MigrateInfo> migrateInfo,
+             const StatusWith<executor::RemoteCommandResponse>& response) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _results.emplace_back(std::move(migrateInfo), response);
+        _condVar.notify_one();
+    }
+
+    /**
+     * Blocks until at least one response arrived and returns all the responses received since the
+     * last call.
+     */
+    vector<Result> waitForSome() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _condVar.wait(lk, [this] { return !_results.empty(); });
+
+        vector<Result> results;
+        results.swap(_results);
+        return results;
+    }
+
+private:
+    stdx::mutex _mutex;
+    stdx::condition_variable _condVar;
+    vector<Result> _results;
+};
+
+/**
+ * Maximum number of migrations the balancer runs at the same time across the cluster.
+ */
+std::atomic<int> balancerMaxConcurrentMigrations(4);  // NOLINT
+
+class BalancerMaxConcurrentMigrationsParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
+public:
+    BalancerMaxConcurrentMigrationsParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "balancerMaxConcurrentMigrations",
+              &balancerMaxConcurrentMigrations) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "balancerMaxConcurrentMigrations has to be at least 1");
+        }
+        return Status::OK();
+    }
+} balancerMaxConcurrentMigrationsParameter;
+
+/**
+ * Maximum number of migrations a single shard takes part in at the same time. A shard can donate
+ * only one chunk and receive only one chunk at a time, so it takes part in two at most.
+ */
+std::atomic<int> balancerMaxMigrationsPerShard(1);  // NOLINT
+
+class BalancerMaxMigrationsPerShardParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
+public:
+    BalancerMaxMigrationsPerShardParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "balancerMaxMigrationsPerShard",
+              &balancerMaxMigrationsPerShard) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 1 || potentialNewValue > 2) {
+            return Status(ErrorCodes::BadValue,
+                          "balancerMaxMigrationsPerShard has to be >= 1 and <= 2");
+        }
+        return Status::OK();
+    }
+} balancerMaxMigrationsPerShardParameter;
+
 }  // namespace
 
 MONGO_FP_DECLARE(skipBalanceRound);
@@ -131,123 +227,262 @@ Balancer::Balancer() : _balancedLastTime(0), _policy(new BalancerPolicy()) {}
 
 Balancer::~Balancer() = default;
 
-int Balancer::_moveChunks(OperationContext* txn,
-                          const vector<shared_ptr<MigrateInfo>>& candidateChunks,
-                          const WriteConcernOptions* writeConcern,
-                          bool waitForDelete) {
-    int movedCount = 0;
+Balancer::MigrationStats Balancer::_moveChunks(
+    OperationContext* txn,
+    const vector<shared_ptr<MigrateInfo>>& candidateChunks,
+    const WriteConcernOptions* writeConcern,
+    bool waitForDelete) {
+    MigrationStats stats;
 
-    for (const auto& migrateInfo : candidateChunks) {
-        // If the balancer was disabled since we started this round, don't start new chunks
-        // moves.
-        const auto balSettingsResult =
-            grid.catalogManager(txn)->getGlobalSettings(txn, SettingsType::BalancerDocKey);
+    // Results of the migrations in progress are handed back to this thread, which is the only one
+    // touching the catalog cache. The callbacks may outlive this call if the round gets
+    // interrupted, so they share ownership of the results.
+    auto results = std::make_shared<MigrationResults>();
 
-        const bool isBalSettingsAbsent =
-            balSettingsResult.getStatus() == ErrorCodes::NoMatchingDocument;
+    std::list<shared_ptr<MigrateInfo>> pending(candidateChunks.begin(), candidateChunks.end());
+    map<shared_ptr<MigrateInfo>, shared_ptr<ChunkManager>> inProgress;
 
-        if (!balSettingsResult.isOK() && !isBalSettingsAbsent) {
-            warning() << balSettingsResult.getStatus();
-            return movedCount;
-        }
+    const int maxConcurrentMigrations = balancerMaxConcurrentMigrations.load();
+    MigrationShardUsage shardUsage(balancerMaxMigrationsPerShard.load());
 
-        const SettingsType& balancerConfig =
-            isBalSettingsAbsent ? SettingsType{} : balSettingsResult.getValue();
+    auto executor = grid.shardRegistry()->getExecutor();
 
-        if ((!isBalSettingsAbsent && !grid.shouldBalance(balancerConfig)) ||
-            MONGO_FAIL_POINT(skipBalanceRound)) {
-            LOG(1) << "Stopping balancing round early as balancing was disabled";
-            return movedCount;
-        }
+    while (!pending.empty() || !inProgress.empty()) {
+        for (auto it = pending.begin();
+             it != pending.end() && shardUsage.numInProgress() < maxConcurrentMigrations;) {
+            const shared_ptr<MigrateInfo> migrateInfo = *it;
+            if (!shardUsage.canStart(*migrateInfo)) {
+                ++it;
+                continue;
+            }
 
-        // Changes to metadata, borked metadata, and connectivity problems between shards
-        // should cause us to abort this chunk move, but shouldn't cause us to abort the entire
-        // round of chunks.
-        //
-        // TODO(spencer): We probably *should* abort the whole round on issues communicating
-        // with the config servers, but its impossible to distinguish those types of failures
-        // at the moment.
-        //
-        // TODO: Handle all these things more cleanly, since they're expected problems
+            it = pending.erase(it);
 
-        const NamespaceString nss(migrateInfo->ns);
+            // If the balancer was disabled since we started this round, don't start new chunks
+            // moves.
+            if (!_shouldContinueRound(txn)) {
+                pending.clear();
+                break;
+            }
 
-        try {
-            shared_ptr<DBConfig> cfg =
-                uassertStatusOK(grid.catalogCache()->getDatabase(txn, nss.db().toString()));
+            // Changes to metadata, borked metadata, and connectivity problems between shards
+            // should cause us to abort this chunk move, but shouldn't cause us to abort the entire
+            // round of chunks.
+            //
+            // TODO(spencer): We probably *should* abort the whole round on issues communicating
+            // with the config servers, but its impossible to distinguish those types of failures
+            // at the moment.
+            //
+            // TODO: Handle all these things more cleanly, since they're expected problems
+            try {
+                shared_ptr<ChunkManager> cm;
+                ChunkPtr c = _getChunkToMove(txn, *migrateInfo, &cm);
+                if (!c) {
+                    continue;
+                }
 
-            // NOTE: We purposely do not reload metadata here, since _doBalanceRound already
-            // tried to do so once.
-            shared_ptr<ChunkManager> cm = cfg->getChunkManager(txn, migrateInfo->ns);
-            uassert(28628,
-                    str::stream()
-                        << "Collection " << migrateInfo->ns
-                        << " was deleted while balancing was active. Aborting balancing round.",
-                    cm);
+                const BSONObj cmdObj = c->makeMoveChunkCommand(
+                    txn, migrateInfo->to, Chunk::MaxChunkSize, writeConcern, waitForDelete, 0);
 
-            ChunkPtr c = cm->findIntersectingChunk(txn, migrateInfo->chunk.min);
+                const auto donor = grid.shardRegistry()->getShard(txn, migrateInfo->from);
+                uassert(ErrorCodes::ShardNotFound,
+                        str::stream() << "Shard " << migrateInfo->from << " not found",
+                        donor);
 
-            if (c->getMin().woCompare(migrateInfo->chunk.min) ||
-                c->getMax().woCompare(migrateInfo->chunk.max)) {
-                // Likely a split happened somewhere, so force reload the chunk manager
-                cm = cfg->getChunkManager(txn, migrateInfo->ns, true);
-                invariant(cm);
+                const HostAndPort host = uassertStatusOK(donor->getTargeter()->findHost(
+                    ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+                    RemoteCommandTargeter::selectFindHostMaxWaitTime(txn)));
 
-                c = cm->findIntersectingChunk(txn, migrateInfo->chunk.min);
+                const executor::RemoteCommandRequest request(
+                    host,
+                    "admin",
+                    cmdObj,
+                    rpc::makeEmptyMetadata(),
+                    executor::RemoteCommandRequest::kNoTimeout);
+
+                uassertStatusOK(executor->scheduleRemoteCommand(
+                    request,
+                    [results,
+                     migrateInfo](const executor::TaskExecutor::RemoteCommandCallbackArgs& args) {
+                        results->add(migrateInfo, args.response);
+                    }));
+
+                shardUsage.started(*migrateInfo);
+                inProgress[migrateInfo] = cm;
+            } catch (const DBException& ex) {
+                warning() << "could not move chunk " << migrateInfo->chunk.toString()
+                          << ", continuing balancing round" << causedBy(ex);
+            }
+        }
 
-                if (c->getMin().woCompare(migrateInfo->chunk.min) ||
-                    c->getMax().woCompare(migrateInfo->chunk.max)) {
-                    log() << "chunk mismatch after reload, ignoring will retry issue "
-                          << migrateInfo->chunk.toString();
+        stats.maxConcurrentMigrations =
+            std::max(stats.maxConcurrentMigrations, shardUsage.numInProgress());
+        _setMigrationsInProgress(shardUsage.numInProgress());
 
-                    continue;
-                }
-            }
+        if (inProgress.empty()) {
+            // Nothing else can be started, since with no migrations in progress every pending
+            // candidate would have been allowed to.
+            invariant(pending.empty());
+            break;
+        }
+
+        for (const auto& result : results->waitForSome()) {
+            const shared_ptr<MigrateInfo>& migrateInfo = result.first;
+
+            shardUsage.finished(*migrateInfo);
+
+            auto cmIt = inProgress.find(migrateInfo);
+            invariant(cmIt != inProgress.end());
+            const shared_ptr<ChunkManager> cm = cmIt->second;
+            inProgress.erase(cmIt);
 
             BSONObj res;
-            if (c->moveAndCommit(txn,
-                                 migrateInfo->to,
-                                 Chunk::MaxChunkSize,
-                                 writeConcern,
-                                 waitForDelete,
-                                 0, /* maxTimeMS */
-                                 res)) {
-                movedCount++;
-                continue;
+            if (result.second.isOK()) {
+                res = result.second.getValue().data.getOwned();
+            } else {
+                const Status& status = result.second.getStatus();
+                res = BSON("ok" << 0 << "errmsg" << status.reason() << "code" << status.code());
+            }
+
+            try {
+                if (_processMigrationResult(txn, *migrateInfo, cm, res)) {
+                    stats.chunksMoved++;
+                } else {
+                    stats.migrationsFailed++;
+                }
+            } catch (const DBException& ex) {
+                warning() << "could not process the result of moving chunk "
+                          << migrateInfo->chunk.toString() << ", continuing balancing round"
+                          << causedBy(ex);
             }
+        }
+    }
 
-            // The move requires acquiring the collection metadata's lock, which can fail.
-            log() << "balancer move failed: " << res << " from: " << migrateInfo->from
-                  << " to: " << migrateInfo->to << " chunk: " << migrateInfo->chunk;
+    _setMigrationsInProgress(0);
 
-            if (res["chunkTooBig"].trueValue()) {
-                // Reload just to be safe
-                cm = cfg->getChunkManager(txn, migrateInfo->ns);
-                invariant(cm);
+    return stats;
+}
 
-                c = cm->findIntersectingChunk(txn, migrateInfo->chunk.min);
+bool Balancer::_shouldContinueRound(OperationContext* txn) {
+    const auto balSettingsResult =
+        grid.catalogManager(txn)->getGlobalSettings(txn, SettingsType::BalancerDocKey);
 
-                log() << "performing a split because migrate failed for size reasons";
+    const bool isBalSettingsAbsent =
+        balSettingsResult.getStatus() == ErrorCodes::NoMatchingDocument;
 
-                Status status = c->split(txn, Chunk::normal, NULL, NULL);
-                log() << "split results: " << status;
+    if (!balSettingsResult.isOK() && !isBalSettingsAbsent) {
+        warning() << balSettingsResult.getStatus();
+        return false;
+    }
 
-                if (!status.isOK()) {
-                    log() << "marking chunk as jumbo: " << c->toString();
+    const SettingsType& balancerConfig =
+        isBalSettingsAbsent ? SettingsType{} : balSettingsResult.getValue();
 
-                    c->markAsJumbo(txn);
+    if ((!isBalSettingsAbsent && !grid.shouldBalance(balancerConfig)) ||
+        MONGO_FAIL_POINT(skipBalanceRound)) {
+        LOG(1) << "Stopping balancing round early as balancing was disabled";
+        return false;
+    }
 
-                    // We increment moveCount so we do another round right away
-                    movedCount++;
-                }
-            }
-        } catch (const DBException& ex) {
-            warning() << "could not move chunk " << migrateInfo->chunk.toString()
-                      << ", continuing balancing round" << causedBy(ex);
+    return true;
+}
+
+ChunkPtr Balancer::_getChunkToMove(OperationContext* txn,
+                                   const MigrateInfo& migrateInfo,
+                                   shared_ptr<ChunkManager>* cmOut) {
+    const NamespaceString nss(migrateInfo.ns);
+
+    shared_ptr<DBConfig> cfg =
+        uassertStatusOK(grid.catalogCache()->getDatabase(txn, nss.db().toString()));
+
+    // NOTE: We purposely do not reload metadata here, since _doBalanceRound already tried to do
+    // so once.
+    shared_ptr<ChunkManager> cm = cfg->getChunkManager(txn, migrateInfo.ns);
+    uassert(28628,
+            str::stream() << "Collection " << migrateInfo.ns
+                          << " was deleted while balancing was active. Aborting balancing round.",
+            cm);
+
+    ChunkPtr c = cm->findIntersectingChunk(txn, migrateInfo.chunk.min);
+
+    if (c->getMin().woCompare(migrateInfo.chunk.min) ||
+        c->getMax().woCompare(migrateInfo.chunk.max)) {
+        // Likely a split happened somewhere, so force reload the chunk manager
+        cm = cfg->getChunkManager(txn, migrateInfo.ns, true);
+        invariant(cm);
+
+        c = cm->findIntersectingChunk(txn, migrateInfo.chunk.min);
+
+        if (c->getMin().woCompare(migrateInfo.chunk.min) ||
+            c->getMax().woCompare(migrateInfo.chunk.max)) {
+            log() << "chunk mismatch after reload, ignoring will retry issue "
+                  << migrateInfo.chunk.toString();
+
+            return ChunkPtr();
         }
     }
 
-    return movedCount;
+    *cmOut = cm;
+    return c;
+}
+
+bool Balancer::_processMigrationResult(OperationContext* txn,
+                                       const MigrateInfo& migrateInfo,
+                                       const shared_ptr<ChunkManager>& cm,
+                                       const BSONObj& res) {
+    const bool worked = getStatusFromCommandResult(res).isOK();
+
+    LOG(worked ? 1 : 0) << "moveChunk result: " << res;
+
+    // if succeeded, needs to reload to pick up the new location
+    // if failed, mongos may be stale
+    // reload is excessive here as the failure could be simply because collection metadata is taken
+    shared_ptr<ChunkManager> reloaded = cm->reload(txn);
+
+    if (worked) {
+        return true;
+    }
+
+    // The move requires acquiring the collection metadata's lock, which can fail.
+    log() << "balancer move failed: " << res << " from: " << migrateInfo.from
+          << " to: " << migrateInfo.to << " chunk: " << migrateInfo.chunk;
+
+    if (res["chunkTooBig"].trueValue() && reloaded) {
+        ChunkPtr c = reloaded->findIntersectingChunk(txn, migrateInfo.chunk.min);
+
+        log() << "performing a split because migrate failed for size reasons";
+
+        Status status = c->split(txn, Chunk::normal, NULL, NULL);
+        log() << "split results: " << status;
+
+        if (!status.isOK()) {
+            log() << "marking chunk as jumbo: " << c->toString();
+
+            c->markAsJumbo(txn);
+
+            // We count the chunk as moved so we do another round right away
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void Balancer::_setMigrationsInProgress(int migrationsInProgress) {
+    stdx::lock_guard<stdx::mutex> lk(_statusMutex);
+    _migrationsInProgress = migrationsInProgress;
+}
+
+void Balancer::appendStatus(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_statusMutex);
+    builder->append("inBalancerRound", _inBalancerRound);
+    builder->append("numBalancerRounds", _numBalancerRounds);
+    builder->append("migrationsInProgress", _migrationsInProgress);
+    builder->append("maxConcurrentMigrations", balancerMaxConcurrentMigrations.load());
+    builder->append("maxMigrationsPerShard", balancerMaxMigrationsPerShard.load());
+    if (!_lastRoundDetails.isEmpty()) {
+        builder->append("lastRound", _lastRoundDetails);
+    }
 }
 
 void Balancer::_ping(OperationContext* txn, bool waiting) {
@@ -497,11 +732,17 @@ void Balancer::_doBalanceRound(OperationContext* txn,
             continue;
         }
 
-        shared_ptr<MigrateInfo> migrateInfo(
-            _policy->balance(nss.ns(), distStatus, _balancedLastTime));
-        if (migrateInfo) {
-            candidateChunks->push_back(migrateInfo);
-        }
+        // Several chunks of the collection can be moved in this round as long as their shards
+        // are disjoint, although they will be moved one at a time since each migration holds the
+        // collection's distributed lock.
+        const auto migrations =
+            BalancerPolicy::balanceOnDisjointShards(nss.ns(),
+                                                    shardInfo,
+                                                    shardToChunksMap,
+                                                    ranges,
+                                                    _balancedLastTime,
+                                                    balancerMaxConcurrentMigrations.load());
+        candidateChunks->insert(candidateChunks->end(), migrations.begin(), migrations.end());
     }
 }
 
@@ -559,6 +800,15 @@ void Balancer::run() {
 
         BalanceRoundDetails roundDetails;
 
+        const auto finishRound = [this](const BSONObj& details) {
+            stdx::lock_guard<stdx::mutex> lk(_statusMutex);
+            _inBalancerRound = false;
+            _numBalancerRounds++;
+            if (!details.isEmpty()) {
+                _lastRoundDetails = details;
+            }
+        };
+
         try {
             // ping has to be first so we keep things in the config server in sync
             _ping(txn.get());
@@ -635,23 +885,37 @@ void Balancer::run() {
                        << "waitForDelete: " << waitForDelete << ", secondaryThrottle: "
                        << (writeConcern.get() ? writeConcern->toBSON().toString() : "default");
 
+                {
+                    stdx::lock_guard<stdx::mutex> lk(_statusMutex);
+                    _inBalancerRound = true;
+                }
+
                 vector<shared_ptr<MigrateInfo>> candidateChunks;
                 _doBalanceRound(txn.get(), &scopedDistLock.getValue(), &candidateChunks);
 
+                BSONObj details;
+
                 if (candidateChunks.size() == 0) {
                     LOG(1) << "no need to move any chunk";
                     _balancedLastTime = 0;
                 } else {
-                    _balancedLastTime =
+                    const MigrationStats stats =
                         _moveChunks(txn.get(), candidateChunks, writeConcern.get(), waitForDelete);
+                    _balancedLastTime = stats.chunksMoved;
 
                     roundDetails.setSucceeded(static_cast<int>(candidateChunks.size()),
-                                              _balancedLastTime);
+                                              stats.chunksMoved,
+                                              stats.migrationsFailed,
+                                              stats.maxConcurrentMigrations);
+
+                    details = roundDetails.toBSON();
 
                     grid.catalogManager(txn.get())
-                        ->logAction(txn.get(), "balancer.round", "", roundDetails.toBSON());
+                        ->logAction(txn.get(), "balancer.round", "", details);
                 }
 
+                finishRound(details);
+
                 LOG(1) << "*** End of balancing round";
             }
 
@@ -668,8 +932,11 @@ void Balancer::run() {
             // This round failed, tell the world!
             roundDetails.setFailed(e.what());
 
-            grid.catalogManager(txn.get())
-                ->logAction(txn.get(), "balancer.round", "", roundDetails.toBSON());
+            const BSONObj details = roundDetails.toBSON();
+            finishRound(details);
+            _setMigrationsInProgress(0);
+
+            grid.catalogManager(txn.get())->logAction(txn.get(), "balancer.round", "", details);
 
             // Sleep a fair amount before retrying because of the error
             sleepFor(balanceRoundInterval);
@@ -30,12 +30,16 @@
 
 #pragma once
 
+#include "mongo/db/jsobj.h"
 #include "mongo/s/catalog/forwarding_catalog_manager.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/background.h"
 
 namespace mongo {
 
 class BalancerPolicy;
+class Chunk;
+class ChunkManager;
 struct MigrateInfo;
 class OperationContext;
 struct WriteConcernOptions;
@@ -48,7 +52,9 @@ struct WriteConcernOptions;
  *
  * The balancer does act continuously but in "rounds". At a given round, it would decide if
  * there is an imbalance by checking the difference in chunks between the most and least
- * loaded shards. It would issue a request for a chunk migration per round, if it found so.
+ * loaded shards. It would issue requests for chunk migrations in that round, if it found so.
+ * Migrations which involve disjoint pairs of shards run at the same time, up to the limits set by
+ * the balancerMaxConcurrentMigrations and balancerMaxMigrationsPerShard server parameters.
  */
 class Balancer : public BackgroundJob {
 public:
@@ -63,7 +69,27 @@ public:
         return "Balancer";
     }
 
+    /**
+     * Appends whether a balancing round is running, the number of migrations in progress and the
+     * statistics of the last round to 'builder', for serverStatus.
+     */
+    void appendStatus(BSONObjBuilder* builder) const;
+
 private:
+    /**
+     * Statistics of the migrations issued in a balancing round.
+     */
+    struct MigrationStats {
+        // number of chunks moved, or marked as jumbo
+        int chunksMoved{0};
+
+        // number of migrations which the shards failed
+        int migrationsFailed{0};
+
+        // highest number of migrations which were in progress at the same time
+        int maxConcurrentMigrations{0};
+    };
+
     // hostname:port of my mongos
     std::string _myid;
 
@@ -76,6 +102,14 @@ private:
     // decide which chunks to move; owned here.
     std::unique_ptr<BalancerPolicy> _policy;
 
+    // protects the members below, which are only reported by appendStatus
+    mutable stdx::mutex _statusMutex;
+
+    bool _inBalancerRound{false};
+    long long _numBalancerRounds{0};
+    int _migrationsInProgress{0};
+    BSONObj _lastRoundDetails;
+
     /**
      * Checks that the balancer can connect to all servers it needs to do its job.
      *
@@ -90,25 +124,57 @@ private:
      * candidate chunks to be moved.
      *
      * @param conn is the connection with the config server(s)
-     * @param candidateChunks (IN/OUT) filled with candidate chunks, one per collection, that could
-     *                          possibly be moved
+     * @param candidateChunks (IN/OUT) filled with candidate chunks that could possibly be moved,
+     *                          no two of the same collection sharing a shard
      */
     void _doBalanceRound(OperationContext* txn,
                          ForwardingCatalogManager::ScopedDistLock* distLock,
                          std::vector<std::shared_ptr<MigrateInfo>>* candidateChunks);
 
     /**
-     * Issues chunk migration request, one at a time.
+     * Issues chunk migration requests through the task executor, starting each one as soon as
+     * none of its shards or its collection is busy with another migration, and waits for all of
+     * them to complete.
      *
      * @param candidateChunks possible chunks to move
      * @param writeConcern detailed write concern. NULL means the default write concern.
      * @param waitForDelete wait for deletes to complete after each chunk move
-     * @return number of chunks effectively moved
+     * @return statistics of the migrations, including the number of chunks effectively moved
+     */
+    MigrationStats _moveChunks(OperationContext* txn,
+                               const std::vector<std::shared_ptr<MigrateInfo>>& candidateChunks,
+                               const WriteConcernOptions* writeConcern,
+                               bool waitForDelete);
+
+    /**
+     * Returns false if the balancer was disabled since the round started, in which case no more
+     * migrations should be started.
+     */
+    bool _shouldContinueRound(OperationContext* txn);
+
+    /**
+     * Returns the chunk described by 'migrateInfo' and sets 'cm' to the chunk manager it came
+     * from, or returns nullptr if the chunk was split or merged since the round started.
+     */
+    std::shared_ptr<const Chunk> _getChunkToMove(OperationContext* txn,
+                                                 const MigrateInfo& migrateInfo,
+                                                 std::shared_ptr<ChunkManager>* cm);
+
+    /**
+     * Reloads the metadata of the collection after a migration completed with the moveChunk reply
+     * 'res'. If the chunk was too big to move, splits it or marks it as jumbo.
+     *
+     * @return true if the chunk was moved or marked as jumbo
+     */
+    bool _processMigrationResult(OperationContext* txn,
+                                 const MigrateInfo& migrateInfo,
+                                 const std::shared_ptr<ChunkManager>& cm,
+                                 const BSONObj& res);
+
+    /**
+     * Records the number of migrations in progress, for appendStatus.
      */
-    int _moveChunks(OperationContext* txn,
-                    const std::vector<std::shared_ptr<MigrateInfo>>& candidateChunks,
-                    const WriteConcernOptions* writeConcern,
-                    bool waitForDelete);
+    void _setMigrationsInProgress(int migrationsInProgress);
 
     /**
      * Marks this balancer as being live on the config server(s).
@@ -552,4 +552,83 @@ string ChunkInfo::toString() const {
     return buf.str();
 }
 
+vector<std::shared_ptr<MigrateInfo>> BalancerPolicy::balanceOnDisjointShards(
+    const string& ns,
+    const ShardInfoMap& shardInfo,
+    const ShardToChunksMap& shardToChunksMap,
+    const vector<TagRange>& ranges,
+    int balancedLastTime,
+    size_t maxMigrations) {
+    vector<std::shared_ptr<MigrateInfo>> migrations;
+
+    ShardInfoMap availableShardInfo(shardInfo);
+    ShardToChunksMap availableShardToChunksMap(shardToChunksMap);
+
+    while (migrations.size() < maxMigrations && availableShardInfo.size() >= 2) {
+        DistributionStatus distStatus(availableShardInfo, availableShardToChunksMap);
+        for (const TagRange& range : ranges) {
+            invariant(distStatus.addTagRange(range));
+        }
+
+        std::shared_ptr<MigrateInfo> migrateInfo(balance(ns, distStatus, balancedLastTime));
+        if (!migrateInfo) {
+            break;
+        }
+
+        migrations.push_back(migrateInfo);
+
+        for (const ShardId& shardId : {migrateInfo->from, migrateInfo->to}) {
+            availableShardInfo.erase(shardId);
+            availableShardToChunksMap.erase(shardId);
+        }
+    }
+
+    return migrations;
+}
+
+MigrationShardUsage::MigrationShardUsage(int maxMigrationsPerShard)
+    : _maxMigrationsPerShard(maxMigrationsPerShard) {
+    invariant(_maxMigrationsPerShard >= 1);
+}
+
+bool MigrationShardUsage::canStart(const MigrateInfo& migrateInfo) const {
+    if (_donors.count(migrateInfo.from) || _recipients.count(migrateInfo.to) ||
+        _namespaces.count(migrateInfo.ns)) {
+        return false;
+    }
+
+    for (const ShardId& shardId : {migrateInfo.from, migrateInfo.to}) {
+        auto it = _migrationsPerShard.find(shardId);
+        if (it != _migrationsPerShard.end() && it->second >= _maxMigrationsPerShard) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void MigrationShardUsage::started(const MigrateInfo& migrateInfo) {
+    invariant(canStart(migrateInfo));
+
+    _donors.insert(migrateInfo.from);
+    _recipients.insert(migrateInfo.to);
+    _namespaces.insert(migrateInfo.ns);
+    _migrationsPerShard[migrateInfo.from]++;
+    _migrationsPerShard[migrateInfo.to]++;
+    _numInProgress++;
+}
+
+void MigrationShardUsage::finished(const MigrateInfo& migrateInfo) {
+    invariant(_donors.erase(migrateInfo.from));
+    invariant(_recipients.erase(migrateInfo.to));
+    invariant(_namespaces.erase(migrateInfo.ns));
+
+    for (const ShardId& shardId : {migrateInfo.from, migrateInfo.to}) {
+        if (--_migrationsPerShard[shardId] == 0) {
+            _migrationsPerShard.erase(shardId);
+        }
+    }
+    _numInProgress--;
+}
+
 }  // namespace mongo
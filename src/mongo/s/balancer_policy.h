@@ -30,6 +30,12 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/s/catalog/type_chunk.h"
@@ -234,6 +240,61 @@ public:
     static MigrateInfo* balance(const std::string& ns,
                                 const DistributionStatus& distribution,
                                 int balancedLastTime);
+
+    /**
+     * Returns up to 'maxMigrations' suggested chunks to move within a collection's shards, no two
+     * of which involve the same shard. Each suggestion is what balance() recommends once the
+     * shards of the previous suggestions are left out of the distribution.
+     *
+     * @param ranges are the tag ranges of the collection, which must be valid for 'shardInfo'.
+     */
+    static std::vector<std::shared_ptr<MigrateInfo>> balanceOnDisjointShards(
+        const std::string& ns,
+        const ShardInfoMap& shardInfo,
+        const ShardToChunksMap& shardToChunksMap,
+        const std::vector<TagRange>& ranges,
+        int balancedLastTime,
+        size_t maxMigrations);
+};
+
+/**
+ * Keeps track of the shards and collections taking part in the migrations of a balancing round, so
+ * that the balancer only starts migrations which can run at the same time as those in progress.
+ *
+ * A shard can donate only one chunk and receive only one chunk at a time, and the donor of a chunk
+ * holds the distributed lock of its collection for the whole migration. So a migration can start
+ * if neither of its shards is already donating or receiving, respectively, if its collection has
+ * no migration in progress and if neither of its shards already takes part in
+ * 'maxMigrationsPerShard' migrations.
+ */
+class MigrationShardUsage {
+    MONGO_DISALLOW_COPYING(MigrationShardUsage);
+
+public:
+    explicit MigrationShardUsage(int maxMigrationsPerShard);
+
+    bool canStart(const MigrateInfo& migrateInfo) const;
+
+    void started(const MigrateInfo& migrateInfo);
+
+    void finished(const MigrateInfo& migrateInfo);
+
+    /**
+     * Returns the number of migrations which were started and have not finished yet.
+     */
+    int numInProgress() const {
+        return _numInProgress;
+    }
+
+private:
+    const int _maxMigrationsPerShard;
+
+    int _numInProgress{0};
+
+    std::map<ShardId, int> _migrationsPerShard;
+    std::set<ShardId> _donors;
+    std::set<ShardId> _recipients;
+    std::set<std::string> _namespaces;
 };
 
 }  // namespace mongo
@@ -620,4 +620,92 @@ TEST(BalancerPolicyTests, Simulation) {
     }
 }
 
+TEST(BalancerPolicyTests, BalanceOnDisjointShards) {
+    ShardToChunksMap chunkMap;
+    ShardInfoMap info;
+
+    for (const string shard : {"shard0", "shard1"}) {
+        vector<ChunkType> chunks;
+        for (int i = 0; i < 8; i++) {
+            ChunkType chunk;
+            chunk.setMin(BSON("x" << (shard == "shard0" ? i : 100 + i)));
+            chunk.setMax(BSON("x" << (shard == "shard0" ? i + 1 : 100 + i + 1)));
+            chunks.push_back(chunk);
+        }
+        chunkMap[shard] = chunks;
+        info[shard] = ShardInfo(0, 8, false);
+    }
+
+    for (const string shard : {"shard2", "shard3"}) {
+        chunkMap[shard] = vector<ChunkType>();
+        info[shard] = ShardInfo(0, 0, false);
+    }
+
+    const vector<TagRange> noRanges;
+
+    auto migrations =
+        BalancerPolicy::balanceOnDisjointShards("ns", info, chunkMap, noRanges, 0, 1);
+    ASSERT_EQUALS(1U, migrations.size());
+
+    migrations = BalancerPolicy::balanceOnDisjointShards("ns", info, chunkMap, noRanges, 0, 10);
+    ASSERT_EQUALS(2U, migrations.size());
+
+    std::set<ShardId> shards;
+    for (const auto& migrateInfo : migrations) {
+        ASSERT(shards.insert(migrateInfo->from).second);
+        ASSERT(shards.insert(migrateInfo->to).second);
+    }
+    ASSERT_EQUALS(4U, shards.size());
+
+    // Balanced shards yield no migrations.
+    info["shard2"] = ShardInfo(0, 8, false);
+    info["shard3"] = ShardInfo(0, 8, false);
+    chunkMap["shard2"] = chunkMap["shard0"];
+    chunkMap["shard3"] = chunkMap["shard1"];
+    ASSERT(BalancerPolicy::balanceOnDisjointShards("ns", info, chunkMap, noRanges, 0, 10).empty());
+}
+
+TEST(BalancerPolicyTests, MigrationShardUsage) {
+    const BSONObj chunk = BSON("min" << BSON("x" << 0) << "max" << BSON("x" << 10));
+    const MigrateInfo m01("ns1", "shard1", "shard0", chunk);
+    const MigrateInfo m23("ns2", "shard3", "shard2", chunk);
+    const MigrateInfo m02("ns3", "shard2", "shard0", chunk);
+    const MigrateInfo m10("ns3", "shard0", "shard1", chunk);
+    const MigrateInfo m45("ns1", "shard5", "shard4", chunk);
+
+    MigrationShardUsage usage(1);
+    ASSERT(usage.canStart(m01));
+    usage.started(m01);
+    ASSERT_EQUALS(1, usage.numInProgress());
+
+    // Disjoint shards and another collection.
+    ASSERT(usage.canStart(m23));
+    usage.started(m23);
+
+    // Shards already in use, or a collection with a migration in progress.
+    ASSERT(!usage.canStart(m02));
+    ASSERT(!usage.canStart(m10));
+    ASSERT(!usage.canStart(m45));
+
+    usage.finished(m01);
+    ASSERT_EQUALS(1, usage.numInProgress());
+    ASSERT(usage.canStart(m45));
+    ASSERT(usage.canStart(m10));
+    ASSERT(!usage.canStart(m02));
+
+    usage.finished(m23);
+    ASSERT_EQUALS(0, usage.numInProgress());
+    ASSERT(usage.canStart(m02));
+
+    // With two migrations per shard a shard can donate and receive at the same time, but still
+    // only one chunk each way.
+    MigrationShardUsage twoPerShard(2);
+    twoPerShard.started(m01);
+    ASSERT(twoPerShard.canStart(m10));
+    twoPerShard.started(m10);
+    ASSERT_EQUALS(2, twoPerShard.numInProgress());
+    ASSERT(!twoPerShard.canStart(m02));
+    ASSERT(twoPerShard.canStart(m23));
+}
+
 }  // namespace
@@ -202,11 +202,6 @@ bool Chunk::containsKey(const BSONObj& shardKey) const {
     return getMin().woCompare(shardKey) <= 0 && shardKey.woCompare(getMax()) < 0;
 }
 
-bool ChunkRange::containsKey(const BSONObj& shardKey) const {
-    // same as Chunk method
-    return getMin().woCompare(shardKey) <= 0 && shardKey.woCompare(getMax()) < 0;
-}
-
 bool Chunk::_minIsInf() const {
     return 0 == _manager->getShardKeyPattern().getKeyPattern().globalMin().woCompare(getMin());
 }
@@ -479,6 +474,29 @@ bool Chunk::moveAndCommit(OperationContext* txn,
                           bool waitForDelete,
                           int maxTimeMS,
                           BSONObj& res) const {
+    BSONObj cmdObj =
+        makeMoveChunkCommand(txn, toShardId, chunkSize, writeConcern, waitForDelete, maxTimeMS);
+
+    ShardConnection fromconn(_getShardConnectionString(txn), "");
+    bool worked = fromconn->runCommand("admin", cmdObj, res);
+    fromconn.done();
+
+    LOG(worked ? 1 : 0) << "moveChunk result: " << res;
+
+    // if succeeded, needs to reload to pick up the new location
+    // if failed, mongos may be stale
+    // reload is excessive here as the failure could be simply because collection metadata is taken
+    _manager->reload(txn);
+
+    return worked;
+}
+
+BSONObj Chunk::makeMoveChunkCommand(OperationContext* txn,
+                                    const ShardId& toShardId,
+                                    long long chunkSize /* bytes */,
+                                    const WriteConcernOptions* writeConcern,
+                                    bool waitForDelete,
+                                    int maxTimeMS) const {
     uassert(10167, "can't move shard to its current location!", getShardId() != toShardId);
 
     log() << "moving chunk ns: " << _manager->getns() << " moving ( " << toString() << ") "
@@ -518,18 +536,7 @@ bool Chunk::moveAndCommit(OperationContext* txn,
     // TODO(SERVER-20742): Remove this after 3.2, now that we're sending version it is redundant
     builder.append("epoch", _manager->getVersion().epoch());
 
-    ShardConnection fromconn(_getShardConnectionString(txn), "");
-    bool worked = fromconn->runCommand("admin", builder.done(), res);
-    fromconn.done();
-
-    LOG(worked ? 1 : 0) << "moveChunk result: " << res;
-
-    // if succeeded, needs to reload to pick up the new location
-    // if failed, mongos may be stale
-    // reload is excessive here as the failure could be simply because collection metadata is taken
-    _manager->reload(txn);
-
-    return worked;
+    return builder.obj();
 }
 
 bool Chunk::splitIfShould(OperationContext* txn, long dataWritten) const {
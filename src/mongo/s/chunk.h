@@ -193,6 +193,17 @@ public:
                        int maxTimeMS,
                        BSONObj& res) const;
 
+    /**
+     * Builds the moveChunk command which moveAndCommit sends to the shard owning this chunk, for
+     * callers which issue it themselves. Takes the same arguments as moveAndCommit.
+     */
+    BSONObj makeMoveChunkCommand(OperationContext* txn,
+                                 const ShardId& to,
+                                 long long chunkSize,
+                                 const WriteConcernOptions* writeConcern,
+                                 bool waitForDelete,
+                                 int maxTimeMS) const;
+
     /**
      * marks this chunk as a jumbo chunk
      * that means the chunk will be inelligble for migrates
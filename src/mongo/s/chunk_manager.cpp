@@ -44,6 +44,7 @@
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/s/catalog/catalog_cache.h"
 #include "mongo/s/catalog/catalog_manager.h"
 #include "mongo/s/catalog/type_chunk.h"
@@ -154,6 +155,19 @@ bool isChunkMapValid(const ChunkMap& chunkMap) {
 #undef ENSURE
 }
 
+/**
+ * Encodes a shard key for the routing table. KeyString takes keys without field names, like those
+ * of an index, and the shard key fields are all compared in ascending order.
+ */
+void encodeRoutingKey(const BSONObj& shardKey, KeyString* keyString) {
+    BSONObjBuilder keyBuilder;
+    BSONObjIterator it(shardKey);
+    while (it.more()) {
+        keyBuilder.appendAs(it.next(), "");
+    }
+    keyString->resetToKey(keyBuilder.done(), Ordering::make(BSONObj()));
+}
+
 }  // namespace
 
 AtomicUInt32 ChunkManager::NextSequenceNumber(1U);
@@ -162,15 +176,13 @@ ChunkManager::ChunkManager(const string& ns, const ShardKeyPattern& pattern, boo
     : _ns(ns),
       _keyPattern(pattern.getKeyPattern()),
       _unique(unique),
-      _sequenceNumber(NextSequenceNumber.addAndFetch(1)),
-      _chunkRanges() {}
+      _sequenceNumber(NextSequenceNumber.addAndFetch(1)) {}
 
 ChunkManager::ChunkManager(const CollectionType& coll)
     : _ns(coll.getNs().ns()),
       _keyPattern(coll.getKeyPattern()),
       _unique(coll.getUnique()),
-      _sequenceNumber(NextSequenceNumber.addAndFetch(1)),
-      _chunkRanges() {
+      _sequenceNumber(NextSequenceNumber.addAndFetch(1)) {
     // coll does not have correct version. Use same initial version as _load and createFirstChunks.
     _version = ChunkVersion(0, 0, coll.getEpoch());
 }
@@ -197,7 +209,7 @@ void ChunkManager::loadExistingRanges(OperationContext* txn, const ChunkManager*
                 _chunkMap.swap(chunkMap);
                 _shardIds.swap(shardIds);
                 _shardVersions.swap(shardVersions);
-                _chunkRanges.reloadAll(_chunkMap);
+                _routingTable = ChunkRoutingTable(_chunkMap);
 
                 return;
             }
@@ -446,13 +458,11 @@ Status ChunkManager::createFirstChunks(OperationContext* txn,
 
 ChunkPtr ChunkManager::findIntersectingChunk(OperationContext* txn, const BSONObj& shardKey) const {
     {
-        BSONObj chunkMin;
         ChunkPtr chunk;
         {
-            ChunkMap::const_iterator it = _chunkMap.upper_bound(shardKey);
-            if (it != _chunkMap.end()) {
-                chunkMin = it->first;
-                chunk = it->second;
+            const size_t i = _routingTable.upperBound(shardKey);
+            if (i < _routingTable.size()) {
+                chunk = _routingTable.getChunk(i);
             }
         }
 
@@ -461,7 +471,6 @@ ChunkPtr ChunkManager::findIntersectingChunk(OperationContext* txn, const BSONOb
                 return chunk;
             }
 
-            log() << chunkMin;
             log() << *chunk;
             log() << shardKey;
 
@@ -525,26 +534,27 @@ void ChunkManager::getShardIdsForQuery(OperationContext* txn,
     // returned.  For now, we satisfy that assumption by adding a shard with no matches rather
     // than return an empty set of shards.
     if (shardIds->empty()) {
-        massert(16068, "no chunk ranges available", !_chunkRanges.ranges().empty());
-        shardIds->insert(_chunkRanges.ranges().begin()->second->getShardId());
+        massert(16068, "no chunk ranges available", !_routingTable.empty());
+        shardIds->insert(_routingTable.getShardId(0));
     }
 }
 
 void ChunkManager::getShardIdsForRange(set<ShardId>& shardIds,
                                        const BSONObj& min,
                                        const BSONObj& max) const {
-    ChunkRangeMap::const_iterator it = _chunkRanges.upper_bound(min);
-    ChunkRangeMap::const_iterator end = _chunkRanges.upper_bound(max);
+    size_t i = _routingTable.upperBound(min);
+    size_t end = _routingTable.upperBound(max);
 
     massert(13507,
             str::stream() << "no chunks found between bounds " << min << " and " << max,
-            it != _chunkRanges.ranges().end());
+            i < _routingTable.size());
 
-    if (end != _chunkRanges.ranges().end())
+    if (end < _routingTable.size())
         ++end;
 
-    for (; it != end; ++it) {
-        shardIds.insert(it->second->getShardId());
+    // Chunks which are next to each other on the same shard are skipped over in one step.
+    for (; i < end; i = _routingTable.nextShardRun(i)) {
+        shardIds.insert(_routingTable.getShardId(i));
 
         // once we know we need to visit all shards no need to keep looping
         if (shardIds.size() == _shardIds.size())
@@ -697,114 +707,68 @@ string ChunkManager::toString() const {
 }
 
 
-ChunkRange::ChunkRange(ChunkMap::const_iterator begin, const ChunkMap::const_iterator end)
-    : _manager(begin->second->getManager()),
-      _shardId(begin->second->getShardId()),
-      _min(begin->second->getMin()),
-      _max(boost::prior(end)->second->getMax()) {
-    invariant(begin != end);
+ChunkRoutingTable::ChunkRoutingTable(const ChunkMap& chunks) {
+    _maxKeyOffsets.reserve(chunks.size() + 1);
+    _shardIndexes.reserve(chunks.size());
+    _shardRunEnds.reserve(chunks.size());
+    _versions.reserve(chunks.size());
+    _chunks.reserve(chunks.size());
 
-    DEV while (begin != end) {
-        dassert(begin->second->getManager() == _manager);
-        dassert(begin->second->getShardId() == _shardId);
-        ++begin;
-    }
-}
+    std::map<ShardId, uint32_t> shardIndexes;
+    KeyString maxKey;
 
-ChunkRange::ChunkRange(const ChunkRange& min, const ChunkRange& max)
-    : _manager(min.getManager()),
-      _shardId(min.getShardId()),
-      _min(min.getMin()),
-      _max(max.getMax()) {
-    invariant(min.getShardId() == max.getShardId());
-    invariant(min.getManager() == max.getManager());
-    invariant(min.getMax() == max.getMin());
-}
+    for (const auto& entry : chunks) {
+        const auto& chunk = entry.second;
 
-string ChunkRange::toString() const {
-    StringBuilder sb;
-    sb << "ChunkRange(min=" << _min << ", max=" << _max << ", shard=" << _shardId << ")";
+        encodeRoutingKey(chunk->getMax(), &maxKey);
+        _maxKeyOffsets.push_back(_maxKeys.size());
+        _maxKeys.append(maxKey.getBuffer(), maxKey.getSize());
 
-    return sb.str();
-}
-
-
-void ChunkRangeManager::assertValid() const {
-    if (_ranges.empty())
-        return;
-
-    try {
-        // No Nulls
-        for (ChunkRangeMap::const_iterator it = _ranges.begin(), end = _ranges.end(); it != end;
-             ++it) {
-            verify(it->second);
-        }
-
-        // Check endpoints
-        verify(allOfType(MinKey, _ranges.begin()->second->getMin()));
-        verify(allOfType(MaxKey, boost::prior(_ranges.end())->second->getMax()));
-
-        // Make sure there are no gaps or overlaps
-        for (ChunkRangeMap::const_iterator it = boost::next(_ranges.begin()), end = _ranges.end();
-             it != end;
-             ++it) {
-            ChunkRangeMap::const_iterator last = boost::prior(it);
-            verify(it->second->getMin() == last->second->getMax());
+        auto shardIndex = shardIndexes.insert(make_pair(chunk->getShardId(), _shardIds.size()));
+        if (shardIndex.second) {
+            _shardIds.push_back(chunk->getShardId());
         }
 
-        // Check Map keys
-        for (ChunkRangeMap::const_iterator it = _ranges.begin(), end = _ranges.end(); it != end;
-             ++it) {
-            verify(it->first == it->second->getMax());
+        // Close the run of the previous chunks if this one is on another shard.
+        if (!_shardIndexes.empty() && _shardIndexes.back() != shardIndex.first->second) {
+            _shardRunEnds.resize(_chunks.size(), _chunks.size());
         }
 
-        // Make sure we match the original chunks
-        const ChunkMap chunks = _ranges.begin()->second->getManager()->_chunkMap;
-        for (ChunkMap::const_iterator i = chunks.begin(); i != chunks.end(); ++i) {
-            const ChunkPtr chunk = i->second;
-
-            ChunkRangeMap::const_iterator min = _ranges.upper_bound(chunk->getMin());
-            ChunkRangeMap::const_iterator max = _ranges.lower_bound(chunk->getMax());
-
-            verify(min != _ranges.end());
-            verify(max != _ranges.end());
-            verify(min == max);
-            verify(min->second->getShardId() == chunk->getShardId());
-            verify(min->second->containsKey(chunk->getMin()));
-            verify(min->second->containsKey(chunk->getMax()) ||
-                   (min->second->getMax() == chunk->getMax()));
-        }
+        _shardIndexes.push_back(shardIndex.first->second);
+        _versions.push_back(chunk->getLastmod());
+        _chunks.push_back(chunk);
+    }
 
-    } catch (...) {
-        error() << "\t invalid ChunkRangeMap! printing ranges:";
+    _shardRunEnds.resize(_chunks.size(), _chunks.size());
+    _maxKeyOffsets.push_back(_maxKeys.size());
 
-        for (ChunkRangeMap::const_iterator it = _ranges.begin(), end = _ranges.end(); it != end;
-             ++it) {
-            log() << it->first << ": " << it->second->toString();
+    // The chunk map is ordered by BSONObj comparison, which the KeyStrings must agree with.
+    DEV {
+        for (size_t i = 1; i < _chunks.size(); i++) {
+            verify(_getMaxKey(i - 1).compare(_getMaxKey(i)) < 0);
         }
-
-        throw;
     }
 }
 
-void ChunkRangeManager::reloadAll(const ChunkMap& chunks) {
-    _ranges.clear();
-    _insertRange(chunks.begin(), chunks.end());
-
-    DEV assertValid();
-}
-
-void ChunkRangeManager::_insertRange(ChunkMap::const_iterator begin,
-                                     const ChunkMap::const_iterator end) {
-    while (begin != end) {
-        ChunkMap::const_iterator first = begin;
-        ShardId shardId = first->second->getShardId();
-        while (begin != end && (begin->second->getShardId() == shardId))
-            ++begin;
-
-        shared_ptr<ChunkRange> cr(new ChunkRange(first, begin));
-        _ranges[cr->getMax()] = cr;
+size_t ChunkRoutingTable::upperBound(const BSONObj& key) const {
+    KeyString keyString;
+    encodeRoutingKey(key, &keyString);
+    const StringData keyData(keyString.getBuffer(), keyString.getSize());
+
+    size_t first = 0;
+    size_t count = _chunks.size();
+    while (count > 0) {
+        const size_t step = count / 2;
+        const size_t mid = first + step;
+        if (_getMaxKey(mid).compare(keyData) <= 0) {
+            first = mid + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
     }
+
+    return first;
 }
 
 int ChunkManager::getCurrentDesiredChunkSize() const {
@@ -47,77 +47,72 @@ class OperationContext;
 
 typedef std::shared_ptr<ChunkManager> ChunkManagerPtr;
 
-// The key for the map is max for each Chunk or ChunkRange
+// The key for the map is max for each Chunk
 typedef std::map<BSONObj, std::shared_ptr<Chunk>, BSONObjCmp> ChunkMap;
 
-class ChunkRange {
+/**
+ * Immutable routing table of a collection, built from its chunk map once per reload. The max keys
+ * of the chunks are encoded as KeyStrings, which compare with memcmp, and stored back to back in
+ * one buffer in chunk order. The shard, version and Chunk of each chunk live in arrays parallel to
+ * it, so routing a key is a binary search over contiguous memory.
+ */
+class ChunkRoutingTable {
 public:
-    ChunkRange(ChunkMap::const_iterator begin, const ChunkMap::const_iterator end);
+    ChunkRoutingTable() = default;
+    explicit ChunkRoutingTable(const ChunkMap& chunks);
 
-    // Merge min and max (must be adjacent ranges)
-    ChunkRange(const ChunkRange& min, const ChunkRange& max);
-
-    const ChunkManager* getManager() const {
-        return _manager;
+    size_t size() const {
+        return _chunks.size();
     }
-    ShardId getShardId() const {
-        return _shardId;
+    bool empty() const {
+        return _chunks.empty();
     }
 
-    const BSONObj& getMin() const {
-        return _min;
-    }
-    const BSONObj& getMax() const {
-        return _max;
-    }
-
-    // clones of Chunk methods
-    // Returns true if this ChunkRange contains the given shard key, and false otherwise
-    //
-    // Note: this function takes an extracted *key*, not an original document
-    // (the point may be computed by, say, hashing a given field or projecting
-    //  to a subset of fields).
-    bool containsKey(const BSONObj& shardKey) const;
-
-    std::string toString() const;
-
-private:
-    const ChunkManager* _manager;
-    const ShardId _shardId;
-    const BSONObj _min;
-    const BSONObj _max;
-};
-
-typedef std::map<BSONObj, std::shared_ptr<ChunkRange>, BSONObjCmp> ChunkRangeMap;
+    /**
+     * Returns the position of the first chunk whose max is greater than 'key', which is the
+     * chunk containing 'key', or size() if there is none.
+     */
+    size_t upperBound(const BSONObj& key) const;
 
+    /**
+     * Returns the position just after the run of consecutive chunks on the same shard which
+     * contains the chunk at position 'i'.
+     */
+    size_t nextShardRun(size_t i) const {
+        return _shardRunEnds[i];
+    }
 
-class ChunkRangeManager {
-public:
-    const ChunkRangeMap& ranges() const {
-        return _ranges;
+    const ShardId& getShardId(size_t i) const {
+        return _shardIds[_shardIndexes[i]];
+    }
+    const ChunkVersion& getVersion(size_t i) const {
+        return _versions[i];
+    }
+    const ChunkPtr& getChunk(size_t i) const {
+        return _chunks[i];
     }
 
-    void clear() {
-        _ranges.clear();
+private:
+    StringData _getMaxKey(size_t i) const {
+        return StringData(_maxKeys.data() + _maxKeyOffsets[i],
+                          _maxKeyOffsets[i + 1] - _maxKeyOffsets[i]);
     }
 
-    void reloadAll(const ChunkMap& chunks);
+    // KeyString encodings of the max key of every chunk, one after the other.
+    std::string _maxKeys;
 
-    // Slow operation -- wrap with DEV
-    void assertValid() const;
+    // Offset in _maxKeys of the max key of every chunk, followed by the size of _maxKeys.
+    std::vector<uint32_t> _maxKeyOffsets;
 
-    ChunkRangeMap::const_iterator upper_bound(const BSONObj& o) const {
-        return _ranges.upper_bound(o);
-    }
-    ChunkRangeMap::const_iterator lower_bound(const BSONObj& o) const {
-        return _ranges.lower_bound(o);
-    }
+    // Position in _shardIds of the shard of every chunk.
+    std::vector<uint32_t> _shardIndexes;
+    std::vector<ShardId> _shardIds;
 
-private:
-    // assumes nothing in this range exists in _ranges
-    void _insertRange(ChunkMap::const_iterator begin, const ChunkMap::const_iterator end);
+    // Position of the first chunk after the shard run of every chunk, see nextShardRun.
+    std::vector<uint32_t> _shardRunEnds;
 
-    ChunkRangeMap _ranges;
+    std::vector<ChunkVersion> _versions;
+    std::vector<ChunkPtr> _chunks;
 };
 
 
@@ -274,7 +269,7 @@ private:
     const unsigned long long _sequenceNumber;
 
     ChunkMap _chunkMap;
-    ChunkRangeManager _chunkRanges;
+    ChunkRoutingTable _routingTable;
 
     std::set<ShardId> _shardIds;
 
@@ -317,7 +312,6 @@ private:
     //
 
     friend class Chunk;
-    friend class ChunkRangeManager;  // only needed for CRM::assertValid()
     static AtomicUInt32 NextSequenceNumber;
 
     friend class TestableChunkManager;
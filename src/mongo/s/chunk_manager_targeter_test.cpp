@@ -30,6 +30,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/config.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/namespace_string.h"
@@ -37,7 +38,10 @@
 #include "mongo/s/chunk_manager.h"
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/platform/random.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 namespace {
 
@@ -512,4 +516,110 @@ TEST(CMKeyBoundsTest, NonPointIntervalExpasion) {
     CheckBoundList(list, expectedList);
 }
 
+// Builds a chunk map for shard key { a: 1 } with a chunk boundary at every multiple of 10 below
+// 10 * 'numChunks', and places runs of three consecutive chunks on each of four shards in turn.
+ChunkMap makeChunkMap(const ChunkManager* manager, int numChunks) {
+    ChunkMap chunkMap;
+    BSONObj min = BSON("a" << MINKEY);
+    for (int i = 1; i <= numChunks; i++) {
+        BSONObj max = (i == numChunks) ? BSON("a" << MAXKEY) : BSON("a" << i * 10);
+        const ShardId shardId = str::stream() << "shard" << (i - 1) / 3 % 4;
+        std::shared_ptr<Chunk> chunk(
+            new Chunk(manager, min, max, shardId, ChunkVersion(i, 0, OID())));
+        chunkMap.insert(make_pair(max, chunk));
+        min = max;
+    }
+    return chunkMap;
+}
+
+TEST(ChunkRoutingTableTest, MatchesChunkMap) {
+    ChunkManager manager("test.foo", ShardKeyPattern(BSON("a" << 1)), false);
+    const ChunkMap chunkMap = makeChunkMap(&manager, 100);
+    const ChunkRoutingTable table(chunkMap);
+    ASSERT_EQUALS(chunkMap.size(), table.size());
+
+    // Numbers of different types compare by value in both, and the bounds of the key space route
+    // to the first and last chunks.
+    std::vector<BSONObj> keys{BSON("a" << MINKEY), BSON("a" << MAXKEY), BSON("a" << -1)};
+    for (int i = 0; i < 1000; i++) {
+        keys.push_back(BSON("a" << i));
+        keys.push_back(BSON("a" << i + 0.5));
+        keys.push_back(BSON("a" << static_cast<long long>(i)));
+    }
+    keys.push_back(BSON("a"
+                        << "a string"));
+
+    for (const BSONObj& key : keys) {
+        const size_t i = table.upperBound(key);
+        const auto it = chunkMap.upper_bound(key);
+        if (it == chunkMap.end()) {
+            ASSERT_EQUALS(table.size(), i) << key;
+            continue;
+        }
+        ASSERT_LESS_THAN(i, table.size()) << key;
+        ASSERT_EQUALS(it->second.get(), table.getChunk(i).get()) << key;
+        ASSERT_EQUALS(it->second->getShardId(), table.getShardId(i));
+        ASSERT_EQUALS(it->second->getLastmod().toLong(), table.getVersion(i).toLong());
+    }
+
+    // Every shard run ends at the next chunk on another shard.
+    for (size_t i = 0; i < table.size(); i++) {
+        const size_t next = table.nextShardRun(i);
+        ASSERT_GREATER_THAN(next, i);
+        for (size_t j = i; j < next; j++) {
+            ASSERT_EQUALS(table.getShardId(i), table.getShardId(j));
+        }
+        if (next < table.size()) {
+            ASSERT_NOT_EQUALS(table.getShardId(i), table.getShardId(next));
+        }
+    }
+
+    ASSERT_EQUALS(0U, ChunkRoutingTable().upperBound(BSON("a" << 1)));
+}
+
+// Compares the throughput of routing shard keys through the chunk map and through the routing
+// table of a collection with many chunks. It is not practical to run this on debug builds.
+#ifndef MONGO_CONFIG_DEBUG_BUILD
+
+TEST(ChunkRoutingTableTest, PerformanceTargeting) {
+    const int kNumChunks = 500 * 1000;
+    const int kNumLookups = 1000 * 1000;
+
+    ChunkManager manager("test.foo", ShardKeyPattern(BSON("a" << 1)), false);
+    const ChunkMap chunkMap = makeChunkMap(&manager, kNumChunks);
+
+    Timer buildTimer;
+    const ChunkRoutingTable table(chunkMap);
+    log() << "built routing table of " << table.size() << " chunks in " << buildTimer.millis()
+          << "ms";
+
+    PseudoRandom random(12345);
+    std::vector<BSONObj> keys;
+    keys.reserve(kNumLookups);
+    for (int i = 0; i < kNumLookups; i++) {
+        keys.push_back(BSON("a" << random.nextInt32(kNumChunks * 10)));
+    }
+
+    size_t mapSum = 0;
+    Timer mapTimer;
+    for (const BSONObj& key : keys) {
+        mapSum += chunkMap.upper_bound(key)->second->getShardId().size();
+    }
+    const double mapSeconds = static_cast<double>(mapTimer.micros()) / (1000.0 * 1000.0);
+
+    size_t tableSum = 0;
+    Timer tableTimer;
+    for (const BSONObj& key : keys) {
+        tableSum += table.getShardId(table.upperBound(key)).size();
+    }
+    const double tableSeconds = static_cast<double>(tableTimer.micros()) / (1000.0 * 1000.0);
+
+    ASSERT_EQUALS(mapSum, tableSum);
+    log() << "chunk map: " << static_cast<long long>(kNumLookups / mapSeconds) << " lookups/sec";
+    log() << "routing table: " << static_cast<long long>(kNumLookups / tableSeconds)
+          << " lookups/sec";
+}
+
+#endif  // MONGO_CONFIG_DEBUG_BUILD
+
 }  // namespace
@@ -129,7 +129,8 @@ std::unique_ptr<LiteParsedQuery> transformQueryForShards(const LiteParsedQuery&
                                           lpq.isOplogReplay(),
                                           lpq.isNoCursorTimeout(),
                                           lpq.isAwaitData(),
-                                          lpq.isAllowPartialResults());
+                                          lpq.isAllowPartialResults(),
+                                          lpq.allowDiskUse());
 }
 
 /**
@@ -30,6 +30,7 @@
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/commands/server_status.h"
+#include "mongo/s/balance.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
 
@@ -70,6 +71,11 @@ BSONObj ShardingServerStatus::generateSection(OperationContext* txn,
         grid.shardRegistry()->getConfigOpTime().append(&result, "lastSeenConfigServerOpTime");
     }
 
+    {
+        BSONObjBuilder balancerBuilder(result.subobjStart("balancer"));
+        balancer.appendStatus(&balancerBuilder);
+    }
+
     return result.obj();
 }
 
@@ -46,6 +46,7 @@ DBQuery.prototype.help = function() {
     print("\t.tailable(<isAwaitData>)");
     print("\t.noCursorTimeout()");
     print("\t.allowPartialResults()");
+    print("\t.allowDiskUse() - lets a blocking sort spill to disk instead of failing");
     print("\t.returnKey()");
     print("\t.showRecordId() - adds a $recordId field to each returned object");
 
@@ -218,6 +219,10 @@ DBQuery.prototype._convertToCommand = function(canAttachReadPref) {
         cmd["readConcern"] = this._query.readConcern;
     }
 
+    if ("$allowDiskUse" in this._query) {
+        cmd["allowDiskUse"] = this._query.$allowDiskUse;
+    }
+
     if ((this._options & DBQuery.Option.tailable) != 0) {
         cmd["tailable"] = true;
     }
@@ -520,6 +525,10 @@ DBQuery.prototype.maxScan = function(n) {
     return this._addSpecial("$maxScan", n);
 };
 
+DBQuery.prototype.allowDiskUse = function() {
+    return this._addSpecial("$allowDiskUse", true);
+};
+
 DBQuery.prototype.pretty = function() {
     this._prettyShell = true;
     return this;
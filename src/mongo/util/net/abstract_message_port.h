@@ -32,6 +32,7 @@
 
 #include "mongo/config.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/net/message_compressor_manager.h"
 #include "mongo/util/net/sock.h"
 
 namespace mongo {
@@ -64,6 +65,10 @@ public:
     }
     void setConnectionId(long long connectionId);
 
+    MessageCompressorManager& compressorManager() {
+        return _compressorManager;
+    }
+
 public:
     // TODO make this private with some helpers
 
@@ -73,6 +78,7 @@ public:
 private:
     long long _connectionId;
     std::string _x509SubjectName;
+    MessageCompressorManager _compressorManager;
 };
 
 }  // namespace mongo
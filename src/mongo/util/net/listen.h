@@ -43,6 +43,8 @@
 namespace mongo {
 
 const int DEFAULT_MAX_CONN = 1000000;
+const int DEFAULT_REACTOR_IO_THREADS = 2;
+const int DEFAULT_REACTOR_WORKER_THREADS = 64;
 
 class MessagingPort;
 
@@ -70,6 +70,7 @@ enum NetworkOp {
     // dbCommandReply_DEPRECATED = 2009, //
     dbCommand = 2010,
     dbCommandReply = 2011,
+    dbCompressed = 2012, /* envelope holding another message, see MessageCompressorManager */
 };
 
 enum class LogicalOp {
@@ -135,6 +136,8 @@ inline const char* networkOpToString(NetworkOp networkOp) {
             return "command";
         case dbCommandReply:
             return "commandReply";
+        case dbCompressed:
+            return "compressed";
         default:
             int op = static_cast<int>(networkOp);
             massert(16141, str::stream() << "cannot translate opcode " << op, !op);
@@ -563,6 +566,11 @@ public:
         return _buf;
     }
 
+    // The buffers of a message assembled with appendData(), empty when it is held in one buffer.
+    const std::vector<std::pair<char*, int>>& buffers() const {
+        return _data;
+    }
+
     void send(MessagingPort& p, const char* context);
 
     std::string toString() const;
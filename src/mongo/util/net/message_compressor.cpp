@@ -0,0 +1,161 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/net/message_compressor.h"
+
+#include <cstring>
+#include <snappy.h>
+#include <zlib.h>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+void MessageCompressorBase::appendStats(BSONObjBuilder* b) const {
+    {
+        BSONObjBuilder compressor(b->subobjStart("compressor"));
+        compressor.appendNumber("bytesIn", _compressBytesIn.load());
+        compressor.appendNumber("bytesOut", _compressBytesOut.load());
+    }
+    {
+        BSONObjBuilder decompressor(b->subobjStart("decompressor"));
+        decompressor.appendNumber("bytesIn", _decompressBytesIn.load());
+        decompressor.appendNumber("bytesOut", _decompressBytesOut.load());
+    }
+}
+
+std::size_t NoopMessageCompressor::getMaxCompressedSize(std::size_t inputSize) {
+    return inputSize;
+}
+
+StatusWith<std::size_t> NoopMessageCompressor::compressData(ConstDataRange input,
+                                                            DataRange output) {
+    if (output.length() < input.length()) {
+        return Status(ErrorCodes::BadValue, "Output too small for noop compression");
+    }
+
+    std::memcpy(const_cast<char*>(output.data()), input.data(), input.length());
+    counterHitCompress(input.length(), input.length());
+    return input.length();
+}
+
+StatusWith<std::size_t> NoopMessageCompressor::decompressData(ConstDataRange input,
+                                                              DataRange output) {
+    if (output.length() < input.length()) {
+        return Status(ErrorCodes::BadValue, "Output too small for noop decompression");
+    }
+
+    std::memcpy(const_cast<char*>(output.data()), input.data(), input.length());
+    counterHitDecompress(input.length(), input.length());
+    return input.length();
+}
+
+std::size_t SnappyMessageCompressor::getMaxCompressedSize(std::size_t inputSize) {
+    return snappy::MaxCompressedLength(inputSize);
+}
+
+StatusWith<std::size_t> SnappyMessageCompressor::compressData(ConstDataRange input,
+                                                              DataRange output) {
+    if (output.length() < snappy::MaxCompressedLength(input.length())) {
+        return Status(ErrorCodes::BadValue, "Output too small for snappy compression");
+    }
+
+    std::size_t outLength = output.length();
+    snappy::RawCompress(
+        input.data(), input.length(), const_cast<char*>(output.data()), &outLength);
+
+    counterHitCompress(input.length(), outLength);
+    return outLength;
+}
+
+StatusWith<std::size_t> SnappyMessageCompressor::decompressData(ConstDataRange input,
+                                                                DataRange output) {
+    std::size_t expectedLength = 0;
+    if (!snappy::GetUncompressedLength(input.data(), input.length(), &expectedLength) ||
+        expectedLength != output.length()) {
+        return Status(ErrorCodes::BadValue, "Compressed message has an invalid snappy header");
+    }
+
+    if (!snappy::RawUncompress(
+            input.data(), input.length(), const_cast<char*>(output.data()))) {
+        return Status(ErrorCodes::BadValue, "Compressed message is not valid snappy data");
+    }
+
+    counterHitDecompress(input.length(), output.length());
+    return output.length();
+}
+
+std::size_t ZlibMessageCompressor::getMaxCompressedSize(std::size_t inputSize) {
+    // The vendored zlib only carries the streaming API, so size the output for a single deflate()
+    // call with the default window and memory level.
+    return ::deflateBound(nullptr, inputSize);
+}
+
+StatusWith<std::size_t> ZlibMessageCompressor::compressData(ConstDataRange input,
+                                                            DataRange output) {
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+
+    int ret = ::deflateInit(&stream, Z_DEFAULT_COMPRESSION);
+    if (ret != Z_OK) {
+        return Status(ErrorCodes::ZLibError, str::stream() << "deflateInit failed with " << ret);
+    }
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = input.length();
+    stream.next_out = reinterpret_cast<Bytef*>(const_cast<char*>(output.data()));
+    stream.avail_out = output.length();
+
+    ret = ::deflate(&stream, Z_FINISH);
+    const std::size_t outLength = stream.total_out;
+    ::deflateEnd(&stream);
+    if (ret != Z_STREAM_END) {
+        return Status(ErrorCodes::ZLibError, str::stream() << "deflate failed with " << ret);
+    }
+
+    counterHitCompress(input.length(), outLength);
+    return outLength;
+}
+
+StatusWith<std::size_t> ZlibMessageCompressor::decompressData(ConstDataRange input,
+                                                              DataRange output) {
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+
+    int ret = ::inflateInit(&stream);
+    if (ret != Z_OK) {
+        return Status(ErrorCodes::ZLibError, str::stream() << "inflateInit failed with " << ret);
+    }
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = input.length();
+    stream.next_out = reinterpret_cast<Bytef*>(const_cast<char*>(output.data()));
+    stream.avail_out = output.length();
+
+    ret = ::inflate(&stream, Z_FINISH);
+    const std::size_t outLength = stream.total_out;
+    ::inflateEnd(&stream);
+    if (ret != Z_STREAM_END) {
+        return Status(ErrorCodes::ZLibError, str::stream() << "inflate failed with " << ret);
+    }
+
+    counterHitDecompress(input.length(), outLength);
+    return outLength;
+}
+
+}  // namespace mongo
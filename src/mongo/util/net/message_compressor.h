@@ -0,0 +1,133 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "mongo/base/data_range.h"
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Identifies the algorithm an OP_COMPRESSED message was compressed with. The values are part of
+ * the wire protocol and must never change.
+ */
+enum class MessageCompressorId : uint8_t { kNoop = 0, kSnappy = 1, kZlib = 2 };
+
+/**
+ * A message compression algorithm. Implementations must be thread-safe: a single instance, owned
+ * by the MessageCompressorRegistry, is shared by every connection of the process.
+ *
+ * Each instance counts the bytes passing through it in both directions so the effect of
+ * compression can be reported in serverStatus.
+ */
+class MessageCompressorBase {
+    MONGO_DISALLOW_COPYING(MessageCompressorBase);
+
+public:
+    virtual ~MessageCompressorBase() = default;
+
+    const std::string& getName() const {
+        return _name;
+    }
+
+    MessageCompressorId getId() const {
+        return _id;
+    }
+
+    /**
+     * Returns the size of the buffer compressData() needs in order to compress "inputSize" bytes.
+     */
+    virtual std::size_t getMaxCompressedSize(std::size_t inputSize) = 0;
+
+    /**
+     * Compresses "input" into "output" and returns the number of bytes written to "output".
+     */
+    virtual StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) = 0;
+
+    /**
+     * Decompresses "input" into "output" and returns the number of bytes written to "output".
+     */
+    virtual StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) = 0;
+
+    /**
+     * Appends {compressor: {bytesIn, bytesOut}, decompressor: {bytesIn, bytesOut}} to "b".
+     */
+    void appendStats(BSONObjBuilder* b) const;
+
+protected:
+    MessageCompressorBase(MessageCompressorId id, std::string name)
+        : _id(id), _name(std::move(name)) {}
+
+    void counterHitCompress(std::size_t bytesIn, std::size_t bytesOut) {
+        _compressBytesIn.addAndFetch(bytesIn);
+        _compressBytesOut.addAndFetch(bytesOut);
+    }
+
+    void counterHitDecompress(std::size_t bytesIn, std::size_t bytesOut) {
+        _decompressBytesIn.addAndFetch(bytesIn);
+        _decompressBytesOut.addAndFetch(bytesOut);
+    }
+
+private:
+    const MessageCompressorId _id;
+    const std::string _name;
+
+    AtomicInt64 _compressBytesIn;
+    AtomicInt64 _compressBytesOut;
+    AtomicInt64 _decompressBytesIn;
+    AtomicInt64 _decompressBytesOut;
+};
+
+/**
+ * Wraps an uncompressed message body in an OP_COMPRESSED envelope without compressing it. It is
+ * never advertised during negotiation, but lets a client mark a connection as able to receive
+ * compressed messages while sending requests that are too small to be worth compressing.
+ */
+class NoopMessageCompressor final : public MessageCompressorBase {
+public:
+    NoopMessageCompressor() : MessageCompressorBase(MessageCompressorId::kNoop, "noop") {}
+
+    std::size_t getMaxCompressedSize(std::size_t inputSize) override;
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override;
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
+};
+
+class SnappyMessageCompressor final : public MessageCompressorBase {
+public:
+    SnappyMessageCompressor() : MessageCompressorBase(MessageCompressorId::kSnappy, "snappy") {}
+
+    std::size_t getMaxCompressedSize(std::size_t inputSize) override;
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override;
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
+};
+
+class ZlibMessageCompressor final : public MessageCompressorBase {
+public:
+    ZlibMessageCompressor() : MessageCompressorBase(MessageCompressorId::kZlib, "zlib") {}
+
+    std::size_t getMaxCompressedSize(std::size_t inputSize) override;
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override;
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
+};
+
+}  // namespace mongo
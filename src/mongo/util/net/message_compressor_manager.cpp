@@ -0,0 +1,275 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/net/message_compressor_manager.h"
+
+#include <cstring>
+
+#include "mongo/base/data_view.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/util/allocator.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/message_compressor_registry.h"
+
+namespace mongo {
+
+namespace {
+
+// OP_COMPRESSED layout, following the standard message header:
+//     int32 originalOpcode     the opcode of the wrapped message
+//     int32 uncompressedSize   the size of the wrapped message, without its header
+//     uint8 compressorId       a MessageCompressorId
+//     char* compressedMessage  the wrapped message body, compressed
+const size_t kOriginalOpcodeOffset = 0;
+const size_t kUncompressedSizeOffset = 4;
+const size_t kCompressorIdOffset = 8;
+const size_t kCompressedHeaderSize = 9;
+
+/**
+ * Returns the body of "msg", without its header, as one contiguous range. Multi-buffer messages
+ * are copied into "scratch".
+ */
+ConstDataRange messageBody(const Message& msg, std::vector<char>* scratch) {
+    if (msg.buffers().empty()) {
+        return ConstDataRange(msg.singleData().data(), msg.dataSize());
+    }
+
+    // The first buffer holds the header.
+    scratch->clear();
+    for (const auto& piece : msg.buffers()) {
+        scratch->insert(scratch->end(), piece.first, piece.first + piece.second);
+    }
+    return ConstDataRange(scratch->data() + MsgData::MsgDataHeaderSize,
+                          scratch->size() - MsgData::MsgDataHeaderSize);
+}
+
+}  // namespace
+
+const char MessageCompressorManager::kCompressionFieldName[] = "compression";
+
+MessageCompressorManager::MessageCompressorManager()
+    : MessageCompressorManager(&MessageCompressorRegistry::get()) {}
+
+MessageCompressorManager::MessageCompressorManager(MessageCompressorRegistry* registry)
+    : _registry(registry) {}
+
+void MessageCompressorManager::clientBegin(BSONObjBuilder* output) {
+    _negotiated = nullptr;
+    _peerAcceptsCompressed = false;
+    _mustSignalPeer = false;
+
+    const auto& names = _registry->getEnabledCompressorNames();
+    if (names.empty()) {
+        return;
+    }
+
+    BSONArrayBuilder compressors(output->subarrayStart(kCompressionFieldName));
+    for (const auto& name : names) {
+        compressors.append(name);
+    }
+}
+
+void MessageCompressorManager::clientFinish(const BSONObj& input) {
+    BSONElement elem = input[kCompressionFieldName];
+    if (elem.type() != Array) {
+        LOG(3) << "server did not agree on a message compressor";
+        return;
+    }
+
+    for (const auto& name : elem.Obj()) {
+        if (name.type() != String) {
+            continue;
+        }
+
+        auto compressor = _registry->getCompressor(name.valueStringData());
+        if (compressor) {
+            LOG(3) << "using " << compressor->getName() << " to compress network messages";
+            _negotiated = compressor;
+            _peerAcceptsCompressed = true;
+            _mustSignalPeer = true;
+            return;
+        }
+    }
+}
+
+void MessageCompressorManager::serverNegotiate(const BSONObj& input, BSONObjBuilder* output) {
+    BSONElement elem = input[kCompressionFieldName];
+    if (elem.eoo()) {
+        return;
+    }
+
+    // A client that asks again starts over, even if it finds nothing in common this time.
+    _negotiated = nullptr;
+    _peerAcceptsCompressed = false;
+
+    if (elem.type() != Array) {
+        return;
+    }
+
+    BSONArrayBuilder agreed;
+    for (const auto& name : elem.Obj()) {
+        if (name.type() != String) {
+            continue;
+        }
+
+        auto compressor = _registry->getCompressor(name.valueStringData());
+        if (!compressor) {
+            continue;
+        }
+
+        if (!_negotiated) {
+            _negotiated = compressor;
+        }
+        agreed.append(compressor->getName());
+    }
+
+    if (_negotiated) {
+        output->append(kCompressionFieldName, agreed.arr());
+    }
+}
+
+bool MessageCompressorManager::compressMessage(const Message& msg, Message* out) {
+    if (!_negotiated || !_peerAcceptsCompressed || msg.operation() == dbCompressed) {
+        return false;
+    }
+
+    std::vector<char> scratch;
+    const ConstDataRange body = messageBody(msg, &scratch);
+
+    MessageCompressorBase* compressor = _negotiated;
+    if (body.length() < static_cast<size_t>(_registry->getThresholdBytes())) {
+        if (!_mustSignalPeer) {
+            return false;
+        }
+        compressor = _registry->getCompressor(MessageCompressorId::kNoop);
+    }
+
+    const size_t maxSize = MsgData::MsgDataHeaderSize + kCompressedHeaderSize +
+        compressor->getMaxCompressedSize(body.length());
+    char* buf = reinterpret_cast<char*>(mongoMalloc(maxSize));
+    Message compressed(buf, true);
+
+    MsgData::View header(buf);
+    header.setId(msg.header().getId());
+    header.setResponseTo(msg.header().getResponseTo());
+    header.setOperation(dbCompressed);
+
+    DataView envelope(header.data());
+    envelope.write(tagLittleEndian<int32_t>(msg.operation()), kOriginalOpcodeOffset);
+    envelope.write(tagLittleEndian<int32_t>(body.length()), kUncompressedSizeOffset);
+    envelope.write(static_cast<uint8_t>(compressor->getId()),
+                   kCompressorIdOffset);
+
+    char* payload = header.data() + kCompressedHeaderSize;
+    auto sws = compressor->compressData(
+        body, DataRange(payload, maxSize - (payload - buf)));
+    if (!sws.isOK()) {
+        warning() << "failed to compress outgoing message with " << compressor->getName() << ": "
+                  << sws.getStatus();
+        return false;
+    }
+
+    size_t compressedSize = sws.getValue();
+    if (compressor != _registry->getCompressor(MessageCompressorId::kNoop) &&
+        compressedSize >= body.length()) {
+        // Not worth it. The server just sends the message as is, a client still has to wrap it.
+        if (!_mustSignalPeer) {
+            return false;
+        }
+        compressor = _registry->getCompressor(MessageCompressorId::kNoop);
+        envelope.write(static_cast<uint8_t>(compressor->getId()),
+                       kCompressorIdOffset);
+        compressedSize = fassertStatusOK(
+            40116, compressor->compressData(body, DataRange(payload, maxSize - (payload - buf))));
+    }
+
+    header.setLen(MsgData::MsgDataHeaderSize + kCompressedHeaderSize + compressedSize);
+    *out = std::move(compressed);
+    return true;
+}
+
+Status MessageCompressorManager::decompressMessage(Message* msg) {
+    if (msg->operation() != dbCompressed) {
+        return Status::OK();
+    }
+
+    const MsgData::ConstView header = msg->singleData();
+    if (header.dataLen() < static_cast<int>(kCompressedHeaderSize)) {
+        return Status(ErrorCodes::BadValue, "Compressed message is too short");
+    }
+
+    ConstDataView envelope(header.data());
+    const int32_t originalOpcode =
+        envelope.read<LittleEndian<int32_t>>(kOriginalOpcodeOffset);
+    const int32_t uncompressedSize =
+        envelope.read<LittleEndian<int32_t>>(kUncompressedSizeOffset);
+    const auto compressorId =
+        static_cast<MessageCompressorId>(envelope.read<uint8_t>(kCompressorIdOffset));
+
+    if (originalOpcode == dbCompressed || uncompressedSize < 0 ||
+        static_cast<size_t>(uncompressedSize) >
+            MaxMessageSizeBytes - MsgData::MsgDataHeaderSize) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "Invalid compressed message header, original opcode: "
+                                    << originalOpcode
+                                    << ", uncompressed size: " << uncompressedSize);
+    }
+
+    auto compressor = _registry->getCompressor(compressorId);
+    if (!compressor) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "Message compressed with unsupported compressor id "
+                                    << static_cast<int>(compressorId));
+    }
+
+    const size_t totalSize = MsgData::MsgDataHeaderSize + uncompressedSize;
+    char* buf = reinterpret_cast<char*>(mongoMalloc(totalSize));
+    Message decompressed(buf, true);
+
+    MsgData::View decompressedHeader(buf);
+    decompressedHeader.setLen(totalSize);
+    decompressedHeader.setId(header.getId());
+    decompressedHeader.setResponseTo(header.getResponseTo());
+    decompressedHeader.setOperation(originalOpcode);
+
+    auto sws = compressor->decompressData(
+        ConstDataRange(header.data() + kCompressedHeaderSize,
+                       header.dataLen() - kCompressedHeaderSize),
+        DataRange(decompressedHeader.data(), uncompressedSize));
+    if (!sws.isOK()) {
+        return sws.getStatus();
+    }
+
+    if (sws.getValue() != static_cast<size_t>(uncompressedSize)) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "Decompressed message has " << sws.getValue()
+                                    << " bytes, expected " << uncompressedSize);
+    }
+
+    // The other side only compresses once it is done negotiating, so it's now safe to compress
+    // messages going its way.
+    _peerAcceptsCompressed = true;
+
+    decompressed._from = msg->_from;
+    *msg = std::move(decompressed);
+    return Status::OK();
+}
+
+}  // namespace mongo
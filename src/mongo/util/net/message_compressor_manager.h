@@ -0,0 +1,98 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#pragma once
+
+#include "mongo/base/status.h"
+#include "mongo/util/net/message.h"
+
+namespace mongo {
+
+class BSONObj;
+class BSONObjBuilder;
+class MessageCompressorBase;
+class MessageCompressorRegistry;
+
+/**
+ * Per-connection message compression state.
+ *
+ * Compression is negotiated through isMaster: the client lists the compressors it is willing to
+ * use in a "compression" array (clientBegin), the server answers with the ones it shares, in the
+ * client's order of preference (serverNegotiate), and the client adopts the first one
+ * (clientFinish).
+ *
+ * The server doesn't compress anything until it has received an OP_COMPRESSED message on the
+ * connection, which guarantees the client has seen the isMaster reply. For that reason a client
+ * wraps every message in an OP_COMPRESSED envelope once negotiation is done, using the noop
+ * compressor when a message is too small or compresses badly. A server only compresses
+ * messages that shrink, and sends the rest as they are.
+ *
+ * A connection is used by one thread at a time, so no locking is needed.
+ */
+class MessageCompressorManager {
+public:
+    static const char kCompressionFieldName[];
+
+    MessageCompressorManager();
+    explicit MessageCompressorManager(MessageCompressorRegistry* registry);
+
+    /**
+     * Appends the enabled compressors to an outgoing isMaster request.
+     */
+    void clientBegin(BSONObjBuilder* output);
+
+    /**
+     * Adopts the first compressor listed in the isMaster reply, if any.
+     */
+    void clientFinish(const BSONObj& input);
+
+    /**
+     * Picks the compressors listed in an incoming isMaster request that are also enabled here and
+     * appends them to the reply. Leaves an earlier negotiation alone if the request has no
+     * "compression" field.
+     */
+    void serverNegotiate(const BSONObj& input, BSONObjBuilder* output);
+
+    /**
+     * If "msg" should go out compressed, stores its OP_COMPRESSED form, with the same header ids,
+     * in "out" and returns true. Otherwise leaves "out" alone and returns false.
+     */
+    bool compressMessage(const Message& msg, Message* out);
+
+    /**
+     * Replaces an OP_COMPRESSED "msg" with the message it contains. Leaves other messages alone.
+     */
+    Status decompressMessage(Message* msg);
+
+    /**
+     * Returns the compressor negotiated for this connection, or nullptr.
+     */
+    MessageCompressorBase* getNegotiatedCompressor() const {
+        return _negotiated;
+    }
+
+private:
+    MessageCompressorRegistry* _registry;
+    MessageCompressorBase* _negotiated = nullptr;
+
+    // Whether the remote side is known to understand OP_COMPRESSED.
+    bool _peerAcceptsCompressed = false;
+
+    // Whether every outgoing message has to be wrapped, so the remote side (the server) finds out
+    // that this side has finished negotiating.
+    bool _mustSignalPeer = false;
+};
+
+}  // namespace mongo
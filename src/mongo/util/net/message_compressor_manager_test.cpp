@@ -0,0 +1,235 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/net/message.h"
+#include "mongo/util/net/message_compressor_manager.h"
+#include "mongo/util/net/message_compressor_registry.h"
+
+namespace mongo {
+namespace {
+
+const int kRequestId = 7;
+const int kResponseTo = 3;
+
+/**
+ * Builds a query message whose body compresses well when "repetitive" is true.
+ */
+void makeMessage(Message* msg, int bodySize, bool repetitive = true) {
+    std::string body(bodySize, 'x');
+    if (!repetitive) {
+        unsigned seed = 12345;
+        for (auto& c : body) {
+            seed = seed * 1103515245 + 12345;
+            c = static_cast<char>(seed >> 16);
+        }
+    }
+    msg->setData(dbQuery, body.data(), body.size());
+    msg->header().setId(kRequestId);
+    msg->header().setResponseTo(kResponseTo);
+}
+
+void assertSameMessage(const Message& expected, const Message& actual) {
+    ASSERT_EQUALS(expected.operation(), actual.operation());
+    ASSERT_EQUALS(expected.header().getId(), actual.header().getId());
+    ASSERT_EQUALS(expected.header().getResponseTo(), actual.header().getResponseTo());
+    ASSERT_EQUALS(expected.size(), actual.size());
+    ASSERT_EQUALS(0,
+                  memcmp(expected.singleData().data(),
+                         actual.singleData().data(),
+                         expected.dataSize()));
+}
+
+/**
+ * Runs the isMaster handshake between "client" and "server" and returns the server's reply.
+ */
+BSONObj negotiate(MessageCompressorManager* client, MessageCompressorManager* server) {
+    BSONObjBuilder request;
+    request.append("isMaster", 1);
+    client->clientBegin(&request);
+
+    BSONObjBuilder reply;
+    server->serverNegotiate(request.obj(), &reply);
+    BSONObj replyObj = reply.obj();
+    client->clientFinish(replyObj);
+    return replyObj;
+}
+
+class MessageCompressorManagerTest : public mongo::unittest::Test {
+protected:
+    void setUp() override {
+        ASSERT_OK(clientRegistry.setEnabledCompressors({"snappy", "zlib"}));
+        ASSERT_OK(serverRegistry.setEnabledCompressors({"zlib", "snappy"}));
+    }
+
+    MessageCompressorRegistry clientRegistry;
+    MessageCompressorRegistry serverRegistry;
+    MessageCompressorManager client{&clientRegistry};
+    MessageCompressorManager server{&serverRegistry};
+};
+
+TEST_F(MessageCompressorManagerTest, NegotiatesClientPreference) {
+    BSONObj reply = negotiate(&client, &server);
+    ASSERT_EQUALS(BSON("compression" << BSON_ARRAY("snappy"
+                                                   << "zlib")),
+                  reply);
+    ASSERT_EQUALS("snappy", client.getNegotiatedCompressor()->getName());
+    ASSERT_EQUALS("snappy", server.getNegotiatedCompressor()->getName());
+}
+
+TEST_F(MessageCompressorManagerTest, NoCommonCompressor) {
+    ASSERT_OK(serverRegistry.setEnabledCompressors({"zlib"}));
+    ASSERT_OK(clientRegistry.setEnabledCompressors({"snappy"}));
+
+    BSONObj reply = negotiate(&client, &server);
+    ASSERT_TRUE(reply.isEmpty());
+    ASSERT_FALSE(client.getNegotiatedCompressor());
+    ASSERT_FALSE(server.getNegotiatedCompressor());
+
+    Message msg;
+    makeMessage(&msg, 4096);
+    Message compressed;
+    ASSERT_FALSE(client.compressMessage(msg, &compressed));
+}
+
+TEST_F(MessageCompressorManagerTest, UnknownAndDisabledNames) {
+    ASSERT_NOT_OK(clientRegistry.setEnabledCompressors({"snappy", "lz4"}));
+    ASSERT_NOT_OK(clientRegistry.setEnabledCompressors({"noop"}));
+
+    ASSERT_OK(serverRegistry.setEnabledCompressors({}));
+    BSONObjBuilder reply;
+    server.serverNegotiate(BSON("isMaster" << 1 << "compression" << BSON_ARRAY("snappy")),
+                           &reply);
+    ASSERT_TRUE(reply.obj().isEmpty());
+    ASSERT_FALSE(server.getNegotiatedCompressor());
+}
+
+TEST_F(MessageCompressorManagerTest, IsMasterWithoutCompressionKeepsNegotiation) {
+    negotiate(&client, &server);
+
+    BSONObjBuilder reply;
+    server.serverNegotiate(BSON("isMaster" << 1), &reply);
+    ASSERT_TRUE(reply.obj().isEmpty());
+    ASSERT_EQUALS("snappy", server.getNegotiatedCompressor()->getName());
+}
+
+TEST_F(MessageCompressorManagerTest, RoundTripEachCompressor) {
+    for (auto name : {"snappy", "zlib"}) {
+        ASSERT_OK(clientRegistry.setEnabledCompressors({name}));
+        MessageCompressorManager clientManager(&clientRegistry);
+        MessageCompressorManager serverManager(&serverRegistry);
+        negotiate(&clientManager, &serverManager);
+
+        Message original;
+        makeMessage(&original, 64 * 1024);
+
+        Message compressed;
+        ASSERT_TRUE(clientManager.compressMessage(original, &compressed));
+        ASSERT_EQUALS(dbCompressed, compressed.operation());
+        ASSERT_EQUALS(kRequestId, compressed.header().getId());
+        ASSERT_LESS_THAN(compressed.size(), original.size() / 10);
+
+        ASSERT_OK(serverManager.decompressMessage(&compressed));
+        assertSameMessage(original, compressed);
+    }
+}
+
+TEST_F(MessageCompressorManagerTest, ServerCompressesOnlyAfterReceivingCompressedMessage) {
+    negotiate(&client, &server);
+
+    Message reply;
+    makeMessage(&reply, 64 * 1024);
+    Message compressedReply;
+    ASSERT_FALSE(server.compressMessage(reply, &compressedReply));
+
+    // The client wraps even a small request, so the server learns it may compress.
+    Message request;
+    makeMessage(&request, 16);
+    Message compressedRequest;
+    ASSERT_TRUE(client.compressMessage(request, &compressedRequest));
+    ASSERT_OK(server.decompressMessage(&compressedRequest));
+    assertSameMessage(request, compressedRequest);
+
+    ASSERT_TRUE(server.compressMessage(reply, &compressedReply));
+    ASSERT_OK(client.decompressMessage(&compressedReply));
+    assertSameMessage(reply, compressedReply);
+}
+
+TEST_F(MessageCompressorManagerTest, ServerSendsSmallAndIncompressibleRepliesAsIs) {
+    negotiate(&client, &server);
+
+    Message request;
+    makeMessage(&request, 16);
+    Message compressedRequest;
+    ASSERT_TRUE(client.compressMessage(request, &compressedRequest));
+    ASSERT_OK(server.decompressMessage(&compressedRequest));
+
+    Message smallReply;
+    makeMessage(&smallReply, MessageCompressorRegistry::kDefaultThresholdBytes - 1);
+    Message out;
+    ASSERT_FALSE(server.compressMessage(smallReply, &out));
+
+    Message randomReply;
+    makeMessage(&randomReply, 64 * 1024, false);
+    ASSERT_FALSE(server.compressMessage(randomReply, &out));
+
+    // The client still wraps an incompressible request, without growing it more than the
+    // envelope header.
+    Message randomRequest;
+    makeMessage(&randomRequest, 64 * 1024, false);
+    ASSERT_TRUE(client.compressMessage(randomRequest, &out));
+    ASSERT_EQUALS(randomRequest.size() + 9, out.size());
+    ASSERT_OK(server.decompressMessage(&out));
+    assertSameMessage(randomRequest, out);
+}
+
+TEST_F(MessageCompressorManagerTest, DecompressLeavesUncompressedMessagesAlone) {
+    Message msg;
+    makeMessage(&msg, 128);
+    const char* data = msg.singleData().view2ptr();
+    ASSERT_OK(server.decompressMessage(&msg));
+    ASSERT_EQUALS(data, msg.singleData().view2ptr());
+}
+
+TEST_F(MessageCompressorManagerTest, RejectsCorruptMessages) {
+    negotiate(&client, &server);
+
+    Message original;
+    makeMessage(&original, 64 * 1024);
+
+    // Claim a larger uncompressed size than the payload holds.
+    Message compressed;
+    ASSERT_TRUE(client.compressMessage(original, &compressed));
+    DataView(compressed.singleData().data()).write(tagLittleEndian<int32_t>(64 * 1024 + 1), 4);
+    ASSERT_NOT_OK(server.decompressMessage(&compressed));
+
+    // Name a compressor that isn't enabled on the receiving side.
+    ASSERT_OK(serverRegistry.setEnabledCompressors({"zlib"}));
+    ASSERT_TRUE(client.compressMessage(original, &compressed));
+    ASSERT_NOT_OK(server.decompressMessage(&compressed));
+
+    // Truncate the envelope itself.
+    ASSERT_TRUE(client.compressMessage(original, &compressed));
+    compressed.header().setLen(MsgData::MsgDataHeaderSize + 4);
+    ASSERT_NOT_OK(server.decompressMessage(&compressed));
+}
+
+}  // namespace
+}  // namespace mongo
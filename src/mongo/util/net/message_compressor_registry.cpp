@@ -0,0 +1,101 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/net/message_compressor_registry.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+MessageCompressorRegistry::MessageCompressorRegistry() : _thresholdBytes(kDefaultThresholdBytes) {
+    _compressors[static_cast<size_t>(MessageCompressorId::kNoop)].reset(
+        new NoopMessageCompressor());
+    _compressors[static_cast<size_t>(MessageCompressorId::kSnappy)].reset(
+        new SnappyMessageCompressor());
+    _compressors[static_cast<size_t>(MessageCompressorId::kZlib)].reset(
+        new ZlibMessageCompressor());
+
+    _enabled.fill(false);
+    _enabled[static_cast<size_t>(MessageCompressorId::kNoop)] = true;
+    _enabled[static_cast<size_t>(MessageCompressorId::kSnappy)] = true;
+    _enabledNames.push_back("snappy");
+}
+
+MessageCompressorRegistry& MessageCompressorRegistry::get() {
+    // Never destroyed, since connections may still be in use while the process exits.
+    static MessageCompressorRegistry* registry = new MessageCompressorRegistry();
+    return *registry;
+}
+
+Status MessageCompressorRegistry::setEnabledCompressors(const std::vector<std::string>& names) {
+    std::array<bool, kNumCompressors> enabled;
+    enabled.fill(false);
+    enabled[static_cast<size_t>(MessageCompressorId::kNoop)] = true;
+
+    for (const auto& name : names) {
+        bool found = false;
+        for (size_t i = 0; i < kNumCompressors; i++) {
+            const auto id = static_cast<MessageCompressorId>(i);
+            if (id != MessageCompressorId::kNoop && _compressors[i]->getName() == name) {
+                enabled[i] = true;
+                found = true;
+            }
+        }
+
+        if (!found) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "Unsupported network message compressor: " << name);
+        }
+    }
+
+    _enabled = enabled;
+    _enabledNames = names;
+    return Status::OK();
+}
+
+MessageCompressorBase* MessageCompressorRegistry::getCompressor(MessageCompressorId id) const {
+    const auto index = static_cast<size_t>(id);
+    if (index >= kNumCompressors || !_enabled[index]) {
+        return nullptr;
+    }
+    return _compressors[index].get();
+}
+
+MessageCompressorBase* MessageCompressorRegistry::getCompressor(StringData name) const {
+    // The noop compressor is never negotiated, so it can only be looked up by id.
+    for (size_t i = 0; i < kNumCompressors; i++) {
+        if (_enabled[i] && static_cast<MessageCompressorId>(i) != MessageCompressorId::kNoop &&
+            _compressors[i]->getName() == name) {
+            return _compressors[i].get();
+        }
+    }
+    return nullptr;
+}
+
+void MessageCompressorRegistry::appendStats(BSONObjBuilder* b) const {
+    for (size_t i = 0; i < kNumCompressors; i++) {
+        if (!_enabled[i] || static_cast<MessageCompressorId>(i) == MessageCompressorId::kNoop) {
+            continue;
+        }
+
+        BSONObjBuilder compressorStats(b->subobjStart(_compressors[i]->getName()));
+        _compressors[i]->appendStats(&compressorStats);
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,92 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/net/message_compressor.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * The process-wide set of message compressors. Every implementation is always registered, but
+ * only the enabled ones, in the order of preference set at startup, are advertised in isMaster
+ * and accepted on incoming OP_COMPRESSED messages. The noop compressor is always accepted.
+ *
+ * The enabled set and threshold are configured during startup option parsing, before any
+ * connection exists, and are read-only afterwards.
+ */
+class MessageCompressorRegistry {
+    MONGO_DISALLOW_COPYING(MessageCompressorRegistry);
+
+public:
+    static const int kDefaultThresholdBytes = 1024;
+
+    MessageCompressorRegistry();
+
+    static MessageCompressorRegistry& get();
+
+    /**
+     * Enables exactly the compressors in "names", most preferred first. An empty list disables
+     * compression. Returns BadValue for an unknown name.
+     */
+    Status setEnabledCompressors(const std::vector<std::string>& names);
+
+    const std::vector<std::string>& getEnabledCompressorNames() const {
+        return _enabledNames;
+    }
+
+    /**
+     * Returns the compressor with the given id or name, or nullptr if it isn't enabled.
+     */
+    MessageCompressorBase* getCompressor(MessageCompressorId id) const;
+    MessageCompressorBase* getCompressor(StringData name) const;
+
+    /**
+     * Message bodies smaller than this many bytes are sent uncompressed.
+     */
+    int getThresholdBytes() const {
+        return _thresholdBytes.load();
+    }
+
+    void setThresholdBytes(int thresholdBytes) {
+        _thresholdBytes.store(thresholdBytes);
+    }
+
+    /**
+     * Appends a subdocument of byte counters for each enabled compressor to "b".
+     */
+    void appendStats(BSONObjBuilder* b) const;
+
+private:
+    static const size_t kNumCompressors = 3;
+
+    std::array<std::unique_ptr<MessageCompressorBase>, kNumCompressors> _compressors;
+    std::array<bool, kNumCompressors> _enabled;
+    std::vector<std::string> _enabledNames;
+    AtomicInt32 _thresholdBytes;
+};
+
+}  // namespace mongo
@@ -199,6 +199,14 @@ bool MessagingPort::recv(Message& m) {
 
         guard.Dismiss();
         m.setData(md.view2ptr(), true);
+
+        Status status = compressorManager().decompressMessage(&m);
+        if (!status.isOK()) {
+            LOG(0) << "recv(): failed to decompress message from " << remote() << ": "
+                   << status;
+            m.reset();
+            return false;
+        }
         return true;
 
     } catch (const SocketException& e) {
@@ -252,6 +260,12 @@ void MessagingPort::say(Message& toSend, int responseTo) {
     mmm(log() << "*  say()  thr:" << GetCurrentThreadId() << endl;)
         toSend.header().setId(nextMessageId());
     toSend.header().setResponseTo(responseTo);
+
+    Message compressed;
+    if (compressorManager().compressMessage(toSend, &compressed)) {
+        compressed.send(*this, "say");
+        return;
+    }
     toSend.send(*this, "say");
 }
 
@@ -75,7 +75,8 @@ public:
     virtual bool setupSockets() = 0;
 };
 
-// TODO use a factory here to decide between port and asio variations
+// Returns the thread-per-connection server, or the asio reactor when
+// serverGlobalParams.serviceExecutor is "reactor".
 MessageServer* createServer(const MessageServer::Options& opts,
                             std::shared_ptr<MessageHandler> handler);
 }
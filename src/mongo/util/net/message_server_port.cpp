@@ -52,6 +52,8 @@
 #include "mongo/util/net/message.h"
 #include "mongo/util/net/message_port.h"
 #include "mongo/util/net/message_server.h"
+#include "mongo/util/net/message_server_reactor.h"
+#include "mongo/util/net/ssl_options.h"
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/scopeguard.h"
 
@@ -261,6 +263,18 @@ private:
 
 MessageServer* createServer(const MessageServer::Options& opts,
                             std::shared_ptr<MessageHandler> handler) {
+#ifndef _WIN32
+    if (serverGlobalParams.serviceExecutor == "reactor") {
+        // The readiness of an SSL socket does not reflect records already buffered by the SSL
+        // layer, so SSL-capable listeners keep the thread-per-connection model for now.
+        if (sslGlobalParams.sslMode.load() != SSLParams::SSLMode_disabled) {
+            warning() << "serviceExecutor=reactor is not supported together with SSL, "
+                      << "falling back to one thread per connection";
+        } else {
+            return createReactorServer(opts, std::move(handler));
+        }
+    }
+#endif
     return new PortMessageServer(opts, std::move(handler));
 }
 
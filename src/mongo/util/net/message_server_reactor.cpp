@@ -0,0 +1,362 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/net/message_server_reactor.h"
+
+#ifndef _WIN32
+
+#include <algorithm>
+#include <asio.hpp>
+#include <fcntl.h>
+#include <memory>
+#include <unistd.h>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/client.h"
+#include "mongo/db/server_options.h"
+#include "mongo/db/stats/counters.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/synchronization.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/exit.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/listen.h"
+#include "mongo/util/net/message.h"
+#include "mongo/util/net/message_port.h"
+#include "mongo/util/net/reactor_worker_pool.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+namespace {
+
+// Upper bound on the number of pipelined requests a worker services for one connection before
+// putting it back behind the other readable connections.
+const int kMaxRequestsPerDispatch = 16;
+
+/**
+ * Per-connection state. The MessagingPort owns the accepted socket and is used for all reads and
+ * writes; the stream descriptor wraps a dup() of the same socket and is only ever used to wait
+ * for readability on one of the event loops.
+ *
+ * At any time a connection is either parked on its event loop waiting to become readable, queued
+ * for a worker, or being serviced by exactly one worker, so none of its members need locking.
+ */
+class ReactorConnection {
+    MONGO_DISALLOW_COPYING(ReactorConnection);
+
+public:
+    ReactorConnection(asio::io_service& ioService,
+                      const std::shared_ptr<Socket>& socket,
+                      long long connectionId)
+        : port(socket),
+          readiness(ioService),
+          threadName(str::stream() << "conn" << connectionId),
+          connTicketReleaser(&Listener::globalTicketHolder) {
+        port.setConnectionId(connectionId);
+    }
+
+    MessagingPort port;
+    asio::posix::stream_descriptor readiness;
+    const std::string threadName;
+
+    // The connection's Client, parked here while no worker is servicing the connection.
+    ServiceContext::UniqueClient client;
+
+    int64_t counter = 0;
+
+private:
+    TicketHolderReleaser connTicketReleaser;
+};
+
+}  // namespace
+
+class ReactorMessageServer : public MessageServer, public Listener {
+public:
+    ReactorMessageServer(const MessageServer::Options& opts,
+                         std::shared_ptr<MessageHandler> handler)
+        : Listener("", opts.ipList, opts.port),
+          _handler(std::move(handler)),
+          _workers(_makeWorkerPoolOptions()) {
+        for (int i = 0; i < serverGlobalParams.reactorIOThreads; i++) {
+            _ioServices.emplace_back(new asio::io_service());
+        }
+    }
+
+    virtual void accepted(std::shared_ptr<Socket> psocket, long long connectionId) {
+        if (!Listener::globalTicketHolder.tryAcquire()) {
+            log() << "connection refused because too many open connections: "
+                  << Listener::globalTicketHolder.used();
+            sleepmillis(2);
+            return;
+        }
+
+        auto& ioService = *_ioServices[_nextIOService.fetchAndAdd(1) % _ioServices.size()];
+        auto conn = std::make_shared<ReactorConnection>(ioService, psocket, connectionId);
+
+        int fd = ::dup(psocket->rawFD());
+        asio::error_code ec;
+        if (fd >= 0) {
+            conn->readiness.assign(fd, ec);
+            if (ec) {
+                ::close(fd);
+            }
+        } else {
+            ec = asio::error_code(errno, asio::error::get_system_category());
+        }
+
+        if (!ec) {
+            // asio switches a descriptor to non-blocking mode before its first asynchronous wait.
+            // Since both descriptors share one open file description that would also make the
+            // MessagingPort's reads non-blocking, so let asio record the descriptor as already
+            // non-blocking and then put the socket back into blocking mode.
+            conn->readiness.native_non_blocking(true, ec);
+            if (!ec) {
+                int flags = ::fcntl(fd, F_GETFL);
+                if (flags < 0 || ::fcntl(fd, F_SETFL, flags & ~O_NONBLOCK) < 0) {
+                    ec = asio::error_code(errno, asio::error::get_system_category());
+                }
+            }
+        }
+
+        if (ec) {
+            log() << "failed to register new connection with the service executor: "
+                  << ec.message() << ", closing connection";
+            conn->port.shutdown();
+            sleepmillis(2);
+            return;
+        }
+
+        serviceExecutorCounter.gotConnection();
+        _schedule(conn, &ReactorMessageServer::_startSession);
+    }
+
+    virtual void setAsTimeTracker() {
+        Listener::setAsTimeTracker();
+    }
+
+    virtual bool setupSockets() {
+        return Listener::setupSockets();
+    }
+
+    void run() {
+        _workers.startup();
+        serviceExecutorCounter.setWorkerStatsAppender([this](BSONObjBuilder& b) {
+            const ReactorWorkerPool::Stats stats = _workers.getStats();
+            b.append("current", static_cast<long long>(stats.numWorkers));
+            b.append("idle", static_cast<long long>(stats.numIdleWorkers));
+            b.append("blocked", static_cast<long long>(stats.numBlockedWorkers));
+            b.append("queuedTasks", static_cast<long long>(stats.numQueuedTasks));
+            b.append("extraStarted", stats.numExtraWorkersStarted);
+        });
+
+        for (auto& ioService : _ioServices) {
+            asio::io_service* service = ioService.get();
+            _ioWork.emplace_back(new asio::io_service::work(*service));
+
+            const std::string threadName =
+                str::stream() << "reactorIO-" << (_ioWork.size() - 1);
+            stdx::thread thr([service, threadName] {
+                setThreadName(threadName);
+                service->run();
+            });
+            thr.detach();
+        }
+
+        log() << "servicing connections with " << _ioServices.size() << " event loop(s) and "
+              << serverGlobalParams.reactorWorkerThreads << " worker thread(s)";
+
+        initAndListen();
+    }
+
+    virtual bool useUnixSockets() const {
+        return true;
+    }
+
+private:
+    typedef void (ReactorMessageServer::*ConnectionTask)(const std::shared_ptr<ReactorConnection>&);
+
+    static ReactorWorkerPool::Options _makeWorkerPoolOptions() {
+        ReactorWorkerPool::Options options;
+        options.threadNamePrefix = "reactorWorker-";
+        options.numCoreWorkers = serverGlobalParams.reactorWorkerThreads;
+        // Workers blocked in long operations, such as awaitData getMores, make the pool start
+        // extra workers. A connection occupies at most one worker, so the number of connections
+        // bounds the pool as it bounds the threads of the thread-per-connection model.
+        options.maxWorkers = std::max(serverGlobalParams.reactorWorkerThreads,
+                                      serverGlobalParams.maxConns);
+        return options;
+    }
+
+    /**
+     * Queues "task" to run against "conn" on the worker pool, recording how long it waited.
+     */
+    void _schedule(const std::shared_ptr<ReactorConnection>& conn, ConnectionTask task) {
+        const unsigned long long enqueuedAt = curTimeMicros64();
+        serviceExecutorCounter.enqueued();
+
+        Status status = _workers.schedule([this, conn, task, enqueuedAt] {
+            serviceExecutorCounter.dequeued(curTimeMicros64() - enqueuedAt);
+            (this->*task)(conn);
+        });
+
+        if (!status.isOK()) {
+            // Only happens once the pool is shutting down, at which point the process is exiting.
+            serviceExecutorCounter.dequeued(0);
+            serviceExecutorCounter.closedConnection();
+            LOG(1) << "unable to schedule work for " << conn->threadName << ": " << status;
+        }
+    }
+
+    /**
+     * Parks "conn" on its event loop until the client sends more data or disconnects.
+     */
+    void _waitForRequest(const std::shared_ptr<ReactorConnection>& conn) {
+        conn->readiness.async_read_some(
+            asio::null_buffers(), [this, conn](const asio::error_code& ec, size_t) {
+                // Errors, including the peer closing the connection, surface from the
+                // MessagingPort's recv.
+                _schedule(conn, &ReactorMessageServer::_serviceRequests);
+            });
+    }
+
+    /**
+     * Runs on a worker: gives the handler a chance to set up per-connection state, such as the
+     * Client, and then detaches it from the worker thread.
+     */
+    void _startSession(const std::shared_ptr<ReactorConnection>& conn) {
+        conn->port.psock->setLogLevel(logger::LogSeverity::Debug(1));
+        _handler->connected(&conn->port);
+        conn->client = Client::releaseCurrent();
+        _waitForRequest(conn);
+    }
+
+    /**
+     * Runs on a worker: services every request already readable on "conn", up to
+     * kMaxRequestsPerDispatch, then either re-arms the readiness wait or ends the session.
+     */
+    void _serviceRequests(const std::shared_ptr<ReactorConnection>& conn) {
+        Timer timer;
+        long long requests = 0;
+        bool keepOpen = true;
+
+        setThreadName(conn->threadName);
+        Client::setCurrent(std::move(conn->client));
+
+        Message m;
+        try {
+            do {
+                if (inShutdown()) {
+                    keepOpen = false;
+                    break;
+                }
+
+                m.reset();
+                conn->port.psock->clearCounters();
+
+                if (!conn->port.recv(m)) {
+                    if (!serverGlobalParams.quiet) {
+                        int conns = Listener::globalTicketHolder.used() - 1;
+                        const char* word = (conns == 1 ? " connection" : " connections");
+                        log() << "end connection " << conn->port.psock->remoteString() << " ("
+                              << conns << word << " now open)";
+                    }
+                    keepOpen = false;
+                    break;
+                }
+
+                _handler->process(m, &conn->port);
+                networkCounter.hit(conn->port.psock->getBytesIn(),
+                                   conn->port.psock->getBytesOut());
+                requests++;
+
+                // Occasionally we want to see if we're using too much memory.
+                if ((conn->counter++ & 0xf) == 0) {
+                    markThreadIdle();
+                }
+            } while (requests < kMaxRequestsPerDispatch && _hasBufferedInput(conn));
+        } catch (AssertionException& e) {
+            log() << "AssertionException handling request, closing client connection: " << e;
+            keepOpen = false;
+        } catch (SocketException& e) {
+            log() << "SocketException handling request, closing client connection: " << e;
+            keepOpen = false;
+        } catch (const DBException& e) {
+            // must be right above std::exception to avoid catching subclasses
+            log() << "DBException handling request, closing client connection: " << e;
+            keepOpen = false;
+        } catch (std::exception& e) {
+            error() << "Uncaught std::exception: " << e.what() << ", terminating";
+            dbexit(EXIT_UNCAUGHT);
+        }
+
+        serviceExecutorCounter.ran(requests, timer.micros());
+
+        if (!keepOpen) {
+            _endSession(conn);
+            return;
+        }
+
+        conn->client = Client::releaseCurrent();
+        _waitForRequest(conn);
+    }
+
+    /**
+     * Runs on a worker which currently owns the connection's Client.
+     */
+    void _endSession(const std::shared_ptr<ReactorConnection>& conn) {
+        _handler->close();
+        conn->port.shutdown();
+
+        asio::error_code ec;
+        conn->readiness.close(ec);
+
+        serviceExecutorCounter.closedConnection();
+    }
+
+    static bool _hasBufferedInput(const std::shared_ptr<ReactorConnection>& conn) {
+        asio::posix::descriptor_base::bytes_readable command;
+        asio::error_code ec;
+        conn->readiness.io_control(command, ec);
+        return !ec && command.get() > 0;
+    }
+
+    const std::shared_ptr<MessageHandler> _handler;
+
+    std::vector<std::unique_ptr<asio::io_service>> _ioServices;
+    std::vector<std::unique_ptr<asio::io_service::work>> _ioWork;
+    AtomicUInt64 _nextIOService;
+
+    ReactorWorkerPool _workers;
+};
+
+
+MessageServer* createReactorServer(const MessageServer::Options& opts,
+                                   std::shared_ptr<MessageHandler> handler) {
+    return new ReactorMessageServer(opts, std::move(handler));
+}
+
+}  // namespace mongo
+
+#endif  // _WIN32
@@ -0,0 +1,43 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "mongo/util/net/abstract_message_port.h"
+#include "mongo/util/net/message.h"
+#include "mongo/util/net/message_server.h"
+
+namespace mongo {
+
+#ifndef _WIN32
+/**
+ * Creates a MessageServer which, instead of dedicating a thread to every accepted connection,
+ * waits for connections to become readable on a small number of asio event loops and hands each
+ * readable connection to a pool of worker threads. A worker reads and processes the pending
+ * request(s) through the connection's MessagingPort, then re-arms the readiness wait. The pool
+ * starts extra workers while requests are queued behind workers blocked in long operations.
+ *
+ * The number of event loops and core workers come from serverGlobalParams.reactorIOThreads and
+ * serverGlobalParams.reactorWorkerThreads. Queue depth, wait times and the state of the worker
+ * pool are reported in the "network.serviceExecutor" section of serverStatus.
+ */
+MessageServer* createReactorServer(const MessageServer::Options& opts,
+                                   std::shared_ptr<MessageHandler> handler);
+#endif
+
+}  // namespace mongo
@@ -0,0 +1,184 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/net/reactor_worker_pool.h"
+
+#include <algorithm>
+
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+ReactorWorkerPool::ReactorWorkerPool(Options options) : _options(std::move(options)) {
+    invariant(_options.numCoreWorkers >= 1);
+    invariant(_options.maxWorkers >= _options.numCoreWorkers);
+}
+
+ReactorWorkerPool::~ReactorWorkerPool() {
+    shutdown();
+    join();
+}
+
+void ReactorWorkerPool::startup() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(!_started);
+    _started = true;
+
+    for (size_t i = 0; i < _options.numCoreWorkers; i++) {
+        _startWorker_inlock(false);
+    }
+    _stallMonitor = stdx::thread([this] { _stallMonitorLoop(); });
+}
+
+void ReactorWorkerPool::shutdown() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _inShutdown = true;
+    _workAvailable.notify_all();
+    _stateChanged.notify_all();
+}
+
+void ReactorWorkerPool::join() {
+    {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        invariant(_inShutdown);
+        _stateChanged.wait(lk, [this] { return _numWorkers == 0; });
+    }
+
+    if (_stallMonitor.joinable()) {
+        _stallMonitor.join();
+    }
+}
+
+Status ReactorWorkerPool::schedule(Task task) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_inShutdown) {
+        return Status(ErrorCodes::ShutdownInProgress, "reactor worker pool is shutting down");
+    }
+
+    _queue.push_back(QueuedTask{std::move(task), Date_t::now()});
+    _workAvailable.notify_one();
+    return Status::OK();
+}
+
+ReactorWorkerPool::Stats ReactorWorkerPool::getStats() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Stats stats;
+    stats.numWorkers = _numWorkers;
+    stats.numIdleWorkers = _numIdleWorkers;
+
+    const Date_t blockedBefore = Date_t::now() - _options.stallThreshold;
+    for (auto it = _taskStartTimes.begin(); it != _taskStartTimes.end() && *it <= blockedBefore;
+         ++it) {
+        ++stats.numBlockedWorkers;
+    }
+
+    stats.numQueuedTasks = _queue.size();
+    stats.numExtraWorkersStarted = _numExtraWorkersStarted;
+    return stats;
+}
+
+void ReactorWorkerPool::_startWorker_inlock(bool extra) {
+    const std::string threadName = str::stream() << _options.threadNamePrefix << _nextWorkerId++;
+    stdx::thread worker([this, extra, threadName] {
+        setThreadName(threadName);
+        _workerLoop(extra);
+    });
+    worker.detach();
+
+    ++_numWorkers;
+    if (extra) {
+        ++_numExtraWorkersStarted;
+    }
+}
+
+void ReactorWorkerPool::_workerLoop(bool extra) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (true) {
+        if (!_queue.empty()) {
+            Task task = std::move(_queue.front().task);
+            _queue.pop_front();
+            const auto startTime = _taskStartTimes.insert(Date_t::now());
+
+            lk.unlock();
+            task();
+            // The task may hold the last reference to a connection, release it outside the lock.
+            task = nullptr;
+            lk.lock();
+            _taskStartTimes.erase(startTime);
+            continue;
+        }
+
+        if (_inShutdown) {
+            break;
+        }
+
+        ++_numIdleWorkers;
+        bool timedOut = false;
+        if (extra) {
+            const Date_t deadline = Date_t::now() + _options.extraWorkerIdleTimeout;
+            timedOut = !_workAvailable.wait_until(lk, deadline.toSystemTimePoint(), [this] {
+                return !_queue.empty() || _inShutdown;
+            });
+        } else {
+            _workAvailable.wait(lk);
+        }
+        --_numIdleWorkers;
+
+        if (timedOut) {
+            break;
+        }
+    }
+
+    --_numWorkers;
+    _stateChanged.notify_all();
+}
+
+void ReactorWorkerPool::_stallMonitorLoop() {
+    setThreadName(_options.threadNamePrefix + "monitor");
+
+    const Milliseconds checkInterval = std::max(Milliseconds(1), _options.stallThreshold / 2);
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (!_inShutdown) {
+        _stateChanged.wait_until(lk, (Date_t::now() + checkInterval).toSystemTimePoint());
+
+        if (_inShutdown || _queue.empty() || _numIdleWorkers > 0 ||
+            _numWorkers >= _options.maxWorkers) {
+            continue;
+        }
+
+        const Milliseconds waited = Date_t::now() - _queue.front().enqueuedAt;
+        if (waited < _options.stallThreshold) {
+            continue;
+        }
+
+        LOG(1) << "starting an extra reactor worker because a task waited " << waited
+               << " with all " << _numWorkers << " workers occupied";
+        try {
+            _startWorker_inlock(true);
+        } catch (const std::exception& ex) {
+            warning() << "failed to start an extra reactor worker: " << ex.what();
+        }
+    }
+}
+
+}  // namespace mongo
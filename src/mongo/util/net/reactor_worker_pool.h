@@ -0,0 +1,134 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#pragma once
+
+#include <deque>
+#include <set>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * The worker pool of the reactor service executor. It keeps a fixed number of core workers, and
+ * starts extra workers while tasks wait in the queue because every worker is occupied, which is
+ * what happens when workers block in operations such as awaitData getMores or long lock waits.
+ * Extra workers exit once they found no work for a while, so the pool shrinks back to its core
+ * workers when the blocking operations finish.
+ */
+class ReactorWorkerPool {
+    MONGO_DISALLOW_COPYING(ReactorWorkerPool);
+
+public:
+    using Task = stdx::function<void()>;
+
+    struct Options {
+        // Prefix used to name the worker threads, followed by an integer.
+        std::string threadNamePrefix = "reactorWorker-";
+
+        // Number of workers which are started with the pool and run until it is shut down.
+        size_t numCoreWorkers = 1;
+
+        // The pool never runs more than this many workers, core workers included.
+        size_t maxWorkers = 1;
+
+        // An extra worker is started when the oldest queued task has waited this long while no
+        // worker was idle.
+        Milliseconds stallThreshold{50};
+
+        // Extra workers exit after finding no work for this long.
+        Milliseconds extraWorkerIdleTimeout{1000};
+    };
+
+    struct Stats {
+        size_t numWorkers = 0;
+        size_t numIdleWorkers = 0;
+
+        // Workers which have been running their current task for stallThreshold or longer.
+        size_t numBlockedWorkers = 0;
+
+        size_t numQueuedTasks = 0;
+        long long numExtraWorkersStarted = 0;
+    };
+
+    explicit ReactorWorkerPool(Options options);
+
+    /**
+     * Shuts the pool down and waits for its workers to exit.
+     */
+    ~ReactorWorkerPool();
+
+    /**
+     * Starts the core workers and the thread which watches for stalled tasks.
+     */
+    void startup();
+
+    /**
+     * Stops accepting tasks. Queued tasks still run before the workers exit.
+     */
+    void shutdown();
+
+    /**
+     * Waits for every worker to exit. Must be called after shutdown().
+     */
+    void join();
+
+    /**
+     * Queues 'task' to run on a worker. Fails with ShutdownInProgress once the pool is shut down.
+     */
+    Status schedule(Task task);
+
+    Stats getStats() const;
+
+private:
+    struct QueuedTask {
+        Task task;
+        Date_t enqueuedAt;
+    };
+
+    void _startWorker_inlock(bool extra);
+    void _workerLoop(bool extra);
+    void _stallMonitorLoop();
+
+    const Options _options;
+
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _workAvailable;
+    stdx::condition_variable _stateChanged;
+
+    std::deque<QueuedTask> _queue;
+
+    // When each busy worker started its current task.
+    std::multiset<Date_t> _taskStartTimes;
+
+    size_t _numWorkers = 0;
+    size_t _numIdleWorkers = 0;
+    size_t _nextWorkerId = 0;
+    long long _numExtraWorkersStarted = 0;
+    bool _started = false;
+    bool _inShutdown = false;
+
+    stdx::thread _stallMonitor;
+};
+
+}  // namespace mongo
@@ -0,0 +1,155 @@
+/**
+ *    Tencent is pleased to support the open source community by making CMONGO available.
+ *
+ *    Copyright (C) 2018 THL A29 Limited, a Tencent company. All rights reserved.
+ *
+ *    Licensed under the GNU Affero General Public License Version 3 (the "License");
+ *    you may not use this file except in compliance with the License. You may obtain a
+ *    copy of the License at https://www.gnu.org/licenses/agpl-3.0.en.html
+ *
+ *    Unless required by applicable law or agreed to in writing, software distributed under
+ *    the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ *    either express or implied. See the License for the specific language governing permissions
+ *    and limitations under the License.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/net/reactor_worker_pool.h"
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Blocks the tasks which wait on it until it is opened.
+ */
+class Gate {
+public:
+    void wait() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _cv.wait(lk, [this] { return _open; });
+    }
+
+    void open() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _open = true;
+        _cv.notify_all();
+    }
+
+private:
+    stdx::mutex _mutex;
+    stdx::condition_variable _cv;
+    bool _open = false;
+};
+
+/**
+ * Polls 'condition' for up to ten seconds and returns whether it became true.
+ */
+template <typename Condition>
+bool waitFor(Condition condition) {
+    const Date_t deadline = Date_t::now() + Seconds(10);
+    while (!condition()) {
+        if (Date_t::now() > deadline) {
+            return false;
+        }
+        sleepmillis(1);
+    }
+    return true;
+}
+
+ReactorWorkerPool::Options makeOptions(size_t numCoreWorkers, size_t maxWorkers) {
+    ReactorWorkerPool::Options options;
+    options.threadNamePrefix = "reactorWorkerTest-";
+    options.numCoreWorkers = numCoreWorkers;
+    options.maxWorkers = maxWorkers;
+    options.stallThreshold = Milliseconds(10);
+    options.extraWorkerIdleTimeout = Milliseconds(50);
+    return options;
+}
+
+TEST(ReactorWorkerPoolTest, RunsQueuedTasksBeforeShutdown) {
+    AtomicInt32 numRun;
+    ReactorWorkerPool pool(makeOptions(2, 2));
+    pool.startup();
+
+    for (int i = 0; i < 100; i++) {
+        ASSERT_OK(pool.schedule([&numRun] { numRun.fetchAndAdd(1); }));
+    }
+
+    pool.shutdown();
+    ASSERT_EQUALS(ErrorCodes::ShutdownInProgress, pool.schedule([] {}));
+    pool.join();
+    ASSERT_EQUALS(100, numRun.load());
+}
+
+TEST(ReactorWorkerPoolTest, BlockedWorkersDoNotStallOtherTasks) {
+    Gate gate;
+    AtomicInt32 numBlocked;
+    AtomicInt32 numRun;
+    ReactorWorkerPool pool(makeOptions(2, 8));
+    pool.startup();
+
+    // Occupy every core worker with a task which blocks, like an awaitData getMore.
+    for (int i = 0; i < 2; i++) {
+        ASSERT_OK(pool.schedule([&] {
+            numBlocked.fetchAndAdd(1);
+            gate.wait();
+        }));
+    }
+    ASSERT(waitFor([&] { return numBlocked.load() == 2; }));
+
+    for (int i = 0; i < 10; i++) {
+        ASSERT_OK(pool.schedule([&numRun] { numRun.fetchAndAdd(1); }));
+    }
+    ASSERT(waitFor([&] { return numRun.load() == 10; }));
+    ASSERT_GREATER_THAN_OR_EQUALS(pool.getStats().numExtraWorkersStarted, 1);
+
+    // The blocked core workers are reported as such once they pass the stall threshold.
+    ASSERT(waitFor([&] { return pool.getStats().numBlockedWorkers == 2; }));
+
+    gate.open();
+
+    // The extra workers exit once they are idle.
+    ASSERT(waitFor([&] { return pool.getStats().numWorkers == 2; }));
+    ASSERT_EQUALS(0U, pool.getStats().numBlockedWorkers);
+
+    pool.shutdown();
+    pool.join();
+}
+
+TEST(ReactorWorkerPoolTest, DoesNotExceedMaxWorkers) {
+    Gate gate;
+    AtomicInt32 numBlocked;
+    ReactorWorkerPool pool(makeOptions(1, 2));
+    pool.startup();
+
+    for (int i = 0; i < 3; i++) {
+        ASSERT_OK(pool.schedule([&] {
+            numBlocked.fetchAndAdd(1);
+            gate.wait();
+        }));
+    }
+    ASSERT(waitFor([&] { return numBlocked.load() == 2; }));
+
+    // Give the pool several chances to start another worker.
+    sleepmillis(100);
+    ASSERT_EQUALS(2, numBlocked.load());
+    ReactorWorkerPool::Stats stats = pool.getStats();
+    ASSERT_EQUALS(2U, stats.numWorkers);
+    ASSERT_EQUALS(1U, stats.numQueuedTasks);
+
+    gate.open();
+    ASSERT(waitFor([&] { return numBlocked.load() == 3; }));
+
+    pool.shutdown();
+    pool.join();
+}
+
+}  // namespace
+}  // namespace mongo